@@ -14,6 +14,7 @@
 #include "registers.c"
 #include "protection.c"
 #include "memory.c"
+#include "pcb.c"
 #include "smm.c"
 #include "x87.c"
 #include "x86.c"
@@ -175,6 +176,7 @@ void x80_reset(x80_state_t * emu, bool reset)
 	{
 		emu->parser->fetch8 = _x80_fetch8;
 		emu->parser->fetch16 = _x80_fetch16;
+		x80_flags_initialize();
 	}
 
 	emu->pc = 0;
@@ -388,6 +390,7 @@ void x86_reset(x86_state_t * emu, bool reset)
 	if(emu->x80.cpu_method == X80_CPUMETHOD_EMULATED)
 	{
 		x80_reset(&emu->x80, reset);
+		x80_memory_window_invalidate(emu);
 	}
 
 	if(emu->cpu_type == X86_CPU_V25 && emu->cpu_traits.cpu_subtype == X86_CPU_V25_V25S)
@@ -487,9 +490,11 @@ void x86_reset(x86_state_t * emu, bool reset)
 	emu->x80.peripheral_data_length = emu->x80.peripheral_data_pointer = 0;
 	emu->x80.peripheral_data = NULL;
 
+	emu->pcb_deadline = X86_PCB_NEVER;
 	if(emu->cpu_type == X86_CPU_186)
 	{
 		emu->pcb[X86_PCB_PCR] = 0x20FF;
+		x86_pcb_reset(emu);
 	}
 	else if(emu->cpu_type == X86_CPU_V25)
 	{
@@ -540,6 +545,7 @@ void x86_reset(x86_state_t * emu, bool reset)
 
 		emu->v25_int_pending = 0;
 	}
+	x86_port_reset(emu);
 	if(emu->cpu_type == X86_CPU_V55)
 	{
 		x86_memory_write8(emu, 0xFFE18, 0x90); // PAC0
@@ -650,6 +656,62 @@ void x86_reset(x86_state_t * emu, bool reset)
 	emu->state = X86_STATE_RUNNING;
 }
 
+void x86_restore_state(x86_state_t * emu, const x86_state_t * saved)
+{
+	// the saved copy holds host pointers of the process that made it, keep the ones from the running instance
+	x86_state_t * host = malloc(sizeof(x86_state_t));
+	if(host == NULL)
+		return;
+	memcpy(host, emu, sizeof(x86_state_t));
+	memcpy(emu, saved, sizeof(x86_state_t));
+
+	emu->cpu_traits.description = host->cpu_traits.description;
+	emu->parser->opcode_translation_table = host->parser->opcode_translation_table;
+	memcpy(emu->parser->debug_output, host->parser->debug_output, sizeof emu->parser->debug_output);
+	emu->parser->debug_length = host->parser->debug_length;
+	emu->parser->fetch8 = host->parser->fetch8;
+	emu->parser->fetch16 = host->parser->fetch16;
+	emu->parser->fetch32 = host->parser->fetch32;
+	emu->parser->fetch64 = host->parser->fetch64;
+
+	emu->x80.parser->fetch8 = host->x80.parser->fetch8;
+	emu->x80.parser->fetch16 = host->x80.parser->fetch16;
+	emu->x80.memory_fetch = host->x80.memory_fetch;
+	emu->x80.memory_read = host->x80.memory_read;
+	emu->x80.memory_write = host->x80.memory_write;
+	emu->x80.port_read = host->x80.port_read;
+	emu->x80.port_write = host->x80.port_write;
+	emu->x80.port_read_block = host->x80.port_read_block;
+	emu->x80.port_write_block = host->x80.port_write_block;
+	// bytes of a pending 8080 interrupt are not part of the copy
+	emu->x80.peripheral_data = NULL;
+	emu->x80.peripheral_data_length = 0;
+	emu->x80.peripheral_data_pointer = 0;
+
+	emu->memory_read = host->memory_read;
+	emu->memory_write = host->memory_write;
+	emu->memory_get_pointer = host->memory_get_pointer;
+	emu->port_read = host->port_read;
+	emu->port_write = host->port_write;
+	emu->port_handlers = host->port_handlers;
+	emu->dirty_pages = host->dirty_pages;
+	emu->dirty_page_count = host->dirty_page_count;
+	emu->dirty_summary = host->dirty_summary;
+	emu->coverage_map = host->coverage_map;
+	emu->coverage_mask = host->coverage_mask;
+	emu->pcb_port_claimed = host->pcb_port_claimed;
+	emu->pcb_port = host->pcb_port;
+	memcpy(emu->pcb_shadowed_ports, host->pcb_shadowed_ports, sizeof emu->pcb_shadowed_ports);
+	memcpy(emu->exc, host->exc, sizeof emu->exc);
+	emu->option_disassemble = host->option_disassemble;
+	free(host);
+
+	// the peripheral control block may have been relocated, and guest memory may not match the bitmap cache
+	x86_pcb_update_ports(emu);
+	emu->tss_bitmaps_valid = false;
+	x80_memory_window_invalidate(emu);
+}
+
 static void x86_debug64(FILE * file, x86_state_t * emu)
 {
 	fprintf(file, "RAX=%016"PRIX64",RCX=%016"PRIX64",RDX=%016"PRIX64",RBX=%016"PRIX64"\n",
@@ -1195,6 +1257,8 @@ void x86_disassemble(x86_parser_t * prs, x86_state_t * emu);
 
 x86_result_t x86_step(x86_state_t * emu)
 {
+	emu->pcb_clock += X86_PCB_CLOCKS_PER_STEP;
+
 	emu->emulation_result = X86_RESULT(X86_RESULT_SUCCESS, 0);
 
 	switch(emu->state)
@@ -1203,10 +1267,14 @@ x86_result_t x86_step(x86_state_t * emu)
 		break;
 	case X86_STATE_HALTED:
 	case X86_STATE_STOPPED:
+		// the 80186 peripherals keep running while the CPU is halted, an interrupt wakes it up for the next step
+		if(emu->pcb_clock >= emu->pcb_deadline)
+			x86_pcb_expire(emu);
 		return X86_RESULT(X86_RESULT_HALT, 0);
 	}
 
 	emu->current_exception = X86_EXC_CLASS_BENIGN;
+	emu->coverage_source = emu->sr[X86_R_CS].base + emu->xip;
 
 	if(emu->option_disassemble)
 	{
@@ -1222,10 +1290,12 @@ x86_result_t x86_step(x86_state_t * emu)
 		{
 			emu->x80.parser->debug_output[0] = '\0';
 			emu->x80.parser->index_prefix = NONE;
+			if(emu->x80.code_window_base != emu->sr[X86_R_CS].base || emu->x80.data_window_base != emu->sr[X86_R_DS].base)
+				x80_memory_window_update(emu);
 			emu->emulation_result = x80_execute(&emu->x80, emu);
 		}
 
-		strcat(emu->parser->debug_output, emu->x80.parser->debug_output);
+		debug_string(emu->parser->debug_output, &emu->parser->debug_length, emu->x80.parser->debug_output);
 	}
 	else
 	{
@@ -1269,6 +1339,10 @@ x86_result_t x86_step(x86_state_t * emu)
 		}
 	}
 
+	// the 80186 peripherals see the result of the instruction, an interrupt is entered here so that the next step starts at the handler
+	if(emu->pcb_clock >= emu->pcb_deadline)
+		x86_pcb_expire(emu);
+
 	return emu->emulation_result;
 }
 
@@ -1286,7 +1360,7 @@ void x86_disassemble(x86_parser_t * prs, x86_state_t * emu)
 	{
 		emu->x80.parser->debug_output[0] = '\0';
 		x80_disassemble(emu->x80.parser);
-		strcat(emu->parser->debug_output, emu->x80.parser->debug_output);
+		debug_string(emu->parser->debug_output, &emu->parser->debug_length, emu->x80.parser->debug_output);
 	}
 	else
 	{
@@ -1302,7 +1376,10 @@ void x86_disassemble(x86_parser_t * prs, x86_state_t * emu)
 		prs->simd_prefix = X86_PREF_NONE;
 		prs->lock_prefix = prs->user_mode = false;
 
-		prs->address_size = prs->code_size = x86_get_code_size(emu);
+		if(emu != NULL)
+			prs->code_size = x86_get_code_size(emu);
+		// otherwise the caller must set the code size
+		prs->address_size = prs->code_size;
 		prs->operation_size = prs->code_size == X86_SIZE_WORD ? X86_SIZE_WORD : X86_SIZE_DWORD;
 
 		prs->rex_prefix = 0;
@@ -1319,7 +1396,8 @@ void x86_disassemble(x86_parser_t * prs, x86_state_t * emu)
 		prs->current_position = old_xip; // TODO
 
 		// reset the prefetch queue to the starting position
-		x86_prefetch_queue_rewind(emu);
+		if(emu != NULL)
+			x86_prefetch_queue_rewind(emu);
 	}
 }
 
@@ -1692,10 +1770,62 @@ void x89_step(x86_state_t * emu)
 	}
 }
 
+// emu may be NULL if the parser is not attached to an emulated channel
 void x89_disassemble(x89_parser_t * prs, x86_state_t * emu, unsigned channel_number)
 {
+	if(emu == NULL)
+	{
+		x89_parse(prs, NULL, channel_number, true, false);
+		return;
+	}
+
 	x89_address_t old_tp = emu->x89.channel[channel_number].r[X89_R_TP];
 	x89_parse(prs, NULL, channel_number, true, false);
 	emu->x89.channel[channel_number].r[X89_R_TP] = old_tp;
 }
 
+
+#if X86_OPCODE_COUNTERS
+//// Instruction statistics
+
+static int _x86_opcode_counter_compare(const void * a, const void * b)
+{
+	uint64_t count_a = x86_opcode_counters[*(const uint16_t *)a];
+	uint64_t count_b = x86_opcode_counters[*(const uint16_t *)b];
+	if(count_a != count_b)
+		return count_a < count_b ? 1 : -1;
+	// keep the order of the instruction table for equal counts
+	return (int)*(const uint16_t *)a - (int)*(const uint16_t *)b;
+}
+
+void x86_opcode_counters_dump(FILE * file)
+{
+	uint16_t order[X86_OPCODE_FORM_COUNT];
+	uint64_t total = 0;
+
+	for(uint16_t form_id = 0; form_id < X86_OPCODE_FORM_COUNT; form_id++)
+	{
+		order[form_id] = form_id;
+		total += x86_opcode_counters[form_id];
+	}
+
+	qsort(order, X86_OPCODE_FORM_COUNT, sizeof order[0], _x86_opcode_counter_compare);
+
+	fprintf(file, "Executed instructions: %"PRIu64"\n", total);
+	for(uint16_t index = 0; index < X86_OPCODE_FORM_COUNT; index++)
+	{
+		const x86_opcode_form_t * form = &x86_opcode_forms[order[index]];
+		uint64_t count = x86_opcode_counters[order[index]];
+		if(count == 0)
+			break;
+		fprintf(file, "%14"PRIu64" %6.2f%%\t%s\t%-12s%-24s%s\n",
+			count, 100.0 * count / total,
+			form->instruction_set, form->mnemonic, form->path, form->operands);
+	}
+}
+
+void x86_opcode_counters_reset(void)
+{
+	memset(x86_opcode_counters, 0, sizeof(uint64_t) * X86_OPCODE_FORM_COUNT);
+}
+#endif
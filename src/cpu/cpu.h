@@ -1204,8 +1204,81 @@ enum
 	X86_EXC_VALUE_PF_ID = 0x00000010,
 
 	// 80186 peripheral control block registers, accessed via emu->pcb[]
+	X86_PCB_EOI = 0x22 >> 1,
+	X86_PCB_POLL = 0x24 >> 1,
+	X86_PCB_POLLSTS = 0x26 >> 1,
+	X86_PCB_IMASK = 0x28 >> 1,
+	X86_PCB_PRIMSK = 0x2A >> 1,
+	X86_PCB_INSERV = 0x2C >> 1,
+	X86_PCB_REQST = 0x2E >> 1,
+	X86_PCB_INSTS = 0x30 >> 1,
+	X86_PCB_TCUCON = 0x32 >> 1, // followed by DMA0CON, DMA1CON, I0CON to I3CON
+	X86_PCB_T0CNT = 0x50 >> 1, // the registers of timer n start at X86_PCB_T0CNT + 4 * n
+	X86_PCB_D0SRCL = 0xC0 >> 1, // the registers of DMA channel n start at X86_PCB_D0SRCL + 8 * n
 	X86_PCB_PCR = 0xFE >> 1,
 
+	// timer registers, relative to the first one
+	X86_PCB_TCNT = 0,
+	X86_PCB_TCMPA = 1,
+	X86_PCB_TCMPB = 2, // not present on timer 2
+	X86_PCB_TCON = 3,
+
+	// DMA channel registers, relative to the first one
+	X86_PCB_DSRCL = 0,
+	X86_PCB_DSRCH = 1,
+	X86_PCB_DDSTL = 2,
+	X86_PCB_DDSTH = 3,
+	X86_PCB_DTC = 4,
+	X86_PCB_DCON = 5,
+
+	// interrupt sources, as bits of IMASK, INSERV and REQST
+	X86_PCB_INT_TMR = 0x0001,
+	X86_PCB_INT_D0 = 0x0004,
+	X86_PCB_INT_D1 = 0x0008,
+	X86_PCB_INT_I0 = 0x0010,
+	X86_PCB_INT_I1 = 0x0020,
+	X86_PCB_INT_I2 = 0x0040,
+	X86_PCB_INT_I3 = 0x0080,
+	X86_PCB_INT_SOURCES = 0x00FD,
+
+	X86_PCB_EOI_TYPE = 0x001F,
+	X86_PCB_EOI_NSPEC = 0x8000,
+
+	X86_PCB_POLL_INTREQ = 0x8000,
+
+	// interrupt control registers (TCUCON, DMA0CON, DMA1CON, I0CON to I3CON)
+	X86_PCB_INTCON_PR = 0x0007,
+	X86_PCB_INTCON_MSK = 0x0008,
+
+	X86_PCB_INSTS_IRT0 = 0x0001, // IRT1 and IRT2 follow
+	X86_PCB_INSTS_DHLT = 0x8000,
+
+	X86_PCB_TCON_CONT = 0x0001,
+	X86_PCB_TCON_ALT = 0x0002,
+	X86_PCB_TCON_EXT = 0x0004,
+	X86_PCB_TCON_P = 0x0008,
+	X86_PCB_TCON_RTG = 0x0010,
+	X86_PCB_TCON_MC = 0x0020,
+	X86_PCB_TCON_RIU = 0x1000,
+	X86_PCB_TCON_INT = 0x2000,
+	X86_PCB_TCON_INH = 0x4000,
+	X86_PCB_TCON_EN = 0x8000,
+
+	X86_PCB_DCON_BW = 0x0001,
+	X86_PCB_DCON_ST = 0x0002,
+	X86_PCB_DCON_CHG = 0x0004,
+	X86_PCB_DCON_TDRQ = 0x0010,
+	X86_PCB_DCON_P = 0x0020,
+	X86_PCB_DCON_SYN_MASK = 0x00C0,
+	X86_PCB_DCON_INT = 0x0100,
+	X86_PCB_DCON_TC = 0x0200,
+	X86_PCB_DCON_SINC = 0x0400,
+	X86_PCB_DCON_SDEC = 0x0800,
+	X86_PCB_DCON_SMIO = 0x1000, // source in memory
+	X86_PCB_DCON_DINC = 0x2000,
+	X86_PCB_DCON_DDEC = 0x4000,
+	X86_PCB_DCON_DMIO = 0x8000, // destination in memory
+
 	X86_PCB_PCR_ADDRESS = 0x0FFF,
 	X86_PCB_PCR_MIO = 0x1000,
 	X86_PCB_PCR_RMX = 0x4000, // TODO
@@ -1609,6 +1682,7 @@ struct x89_parser_t
 	uint32_t current_position;
 
 	char debug_output[256];
+	size_t debug_length; // characters in debug_output, writing 0 to debug_output[0] also empties it
 
 	uint8_t (* fetch8)(x89_parser_t *);
 	uint16_t (* fetch16)(x89_parser_t *);
@@ -1700,6 +1774,7 @@ struct x80_parser_t
 	x80_regnum_t index_prefix; // DD: and FD: prefixes */
 
 	char debug_output[256];
+	size_t debug_length; // characters in debug_output, writing 0 to debug_output[0] also empties it
 
 	uint8_t (* fetch8)(x80_parser_t *);
 	uint16_t (* fetch16)(x80_parser_t *);
@@ -1762,6 +1837,13 @@ struct x80_state_t
 	void (* memory_write)(x80_state_t * emu, uint16_t address, const void * buffer, size_t count);
 	uint8_t (* port_read)(x80_state_t * emu, uint16_t port);
 	void (* port_write)(x80_state_t * emu, uint16_t port, uint8_t value);
+	// Optional, used by INIR/INDR/OTIR/OTDR, port is that of the first byte and byte i belongs to port - (i << 8), returns the number of bytes transferred, 0 if they must be transferred one at a time
+	size_t (* port_read_block)(x80_state_t * emu, uint16_t port, size_t count, void * buffer);
+	size_t (* port_write_block)(x80_state_t * emu, uint16_t port, size_t count, const void * buffer);
+
+	// 8080 emulation mode: host pointers to the 64 KiB of the CS and DS segments, NULL if they are accessed through the x86 memory routines
+	uint8_t * code_window, * data_window;
+	uaddr_t code_window_base, data_window_base; // segment bases the windows were resolved for
 };
 
 /* The x87 floating point coprocessor state */
@@ -1833,7 +1915,7 @@ struct x87_state_t
 	uint16_t queued_offset;
 
 	/* Replica of the address_text field, kept here for the debugger for asynchronous behavior */
-	char address_text[24];
+	char address_text[32];
 };
 
 /* Entire state of the x86 instruction parser, including current prefixes and the memory/register operand */
@@ -1884,7 +1966,7 @@ struct x86_parser_t
 	int register_field; // value of the register field (bits 3 to 5)
 	uoff_t address_offset; // calculated offset (only for memory operands)
 	bool ip_relative; // needed to add EIP/RIP after the instruction has been fetched
-	char address_text[24]; // textual representation of the (memory) operand
+	char address_text[32]; // textual representation of the (memory) operand
 
 	/* Whether a LOCK prefix (0xF0) is present */
 	bool lock_prefix;
@@ -1908,6 +1990,7 @@ struct x86_parser_t
 	int evex_a;
 
 	char debug_output[256];
+	size_t debug_length; // characters in debug_output, writing 0 to debug_output[0] also empties it
 
 	uint8_t (* fetch8)(x86_parser_t *);
 	uint16_t (* fetch16)(x86_parser_t *);
@@ -2118,8 +2201,27 @@ struct \
 	} __name; \
 }
 
-/* The complete x86 emulation state */
 typedef struct x86_state_t x86_state_t;
+
+/* Device callbacks claiming a range of I/O ports, see x86_port_register */
+typedef struct x86_port_handler_t
+{
+	void * data; // passed to the callbacks
+	// missing 8-bit callbacks ignore the access
+	uint8_t (* read8)(x86_state_t * emu, void * data, uint16_t port);
+	void (* write8)(x86_state_t * emu, void * data, uint16_t port, uint8_t value);
+	// wider accesses are split into bytes unless the callback is present and all ports belong to the same handler
+	uint16_t (* read16)(x86_state_t * emu, void * data, uint16_t port);
+	void (* write16)(x86_state_t * emu, void * data, uint16_t port, uint16_t value);
+	uint32_t (* read32)(x86_state_t * emu, void * data, uint16_t port);
+	void (* write32)(x86_state_t * emu, void * data, uint16_t port, uint32_t value);
+	// optional, block transfers (REP INS/OUTS, 8089 channel transfers) move count elements of size bytes (stored in little endian) from or to the same port in a single call
+	// Z80 INIR/INDR/OTIR/OTDR are the exception: size is 1 and byte i belongs to port - (i << 8), as B is decremented after each byte, the handler must claim all of these ports
+	void (* read_block)(x86_state_t * emu, void * data, uint16_t port, unsigned size, size_t count, void * buffer);
+	void (* write_block)(x86_state_t * emu, void * data, uint16_t port, unsigned size, size_t count, const void * buffer);
+} x86_port_handler_t;
+
+/* The complete x86 emulation state */
 struct x86_state_t
 {
 	// by placing these fields inside a union, the same pointer can be used as an x80_parser_t or x80_state_t instance
@@ -2272,6 +2374,17 @@ struct x86_state_t
 	// 186
 	/* Peripheral control block, stored in little endian format */
 	uint16_t pcb[128];
+	/* Whether the peripheral control block is claimed in port_handlers, starting at pcb_port */
+	bool pcb_port_claimed;
+	uint16_t pcb_port;
+	/* Handlers that were replaced by the peripheral control block, restored when it is relocated */
+	const x86_port_handler_t * pcb_shadowed_ports[0x100];
+	/* CPU clocks elapsed, used to time the on-chip timers and DMA channels */
+	uint64_t pcb_clock;
+	/* The clock the peripheral registers were last brought up to date */
+	uint64_t pcb_synchronized_clock;
+	/* The clock of the next timer interrupt or DMA transfer, UINT64_MAX if the peripherals are idle */
+	uint64_t pcb_deadline;
 
 	/* 8080 emulation (for NEC V20) and Z80 emulation (for µPD9002), the state must be synchronized with the main state */
 	x80_state_t x80;
@@ -2501,6 +2614,15 @@ struct x86_state_t
 	x86_tile_register_t tmm[8];
 	uint64_t tilecfg;
 
+	/* Decoded copy of the I/O permission and interrupt redirection bitmaps of the current TSS, rebuilt when invalidated or when TR changes */
+	bool tss_bitmaps_valid;
+	uaddr_t tss_bitmaps_base;
+	uint32_t tss_bitmaps_limit;
+	// a set bit denies access to the port, the final byte is needed for accesses ending at port 0xFFFF
+	uint8_t io_permission_bitmap[0x2001];
+	// a set bit sends the software interrupt through the IDT in virtual 8086 mode
+	uint8_t interrupt_redirection_bitmap[32];
+
 	/* Cyrix configuration control registers */
 	bool port22_accessed; // whether a configuration control register is available at the next I/O instruction on port 0x23
 	uint8_t port_number;
@@ -2550,8 +2672,21 @@ struct x86_state_t
 
 	void (* memory_read)(x86_state_t * emu, x86_cpu_level_t level, uaddr_t address, void * buffer, size_t count);
 	void (* memory_write)(x86_state_t * emu, x86_cpu_level_t level, uaddr_t address, const void * buffer, size_t count);
+	/* Optional, returns a host pointer to count bytes of physical memory that can be read and written directly, NULL if they need memory_read/memory_write */
+	/* 8080 emulation mode keeps the pointer until the next port access or the next switch into emulation mode */
+	uint8_t * (* memory_get_pointer)(x86_state_t * emu, uaddr_t address, size_t count);
 	void (* port_read)(x86_state_t * emu, uint16_t port, void * buffer, size_t count);
 	void (* port_write)(x86_state_t * emu, uint16_t port, const void * buffer, size_t count);
+	/* Handler for each I/O port, ports without a handler are passed to port_read/port_write, allocated on first registration */
+	const x86_port_handler_t ** port_handlers;
+	/* One bit for each 4 KiB page of physical memory written to since the last x86_dirty_pages_fetch, NULL when tracking is disabled */
+	uint64_t * dirty_pages;
+	uaddr_t dirty_page_count; // number of pages covered, writes above them are not recorded
+	uint64_t * dirty_summary; // one bit for each word of dirty_pages that has bits set, so that fetching skips the clean parts of large bitmaps
+	/* AFL style edge coverage map, each control transfer increments the entry selected by its source and target, NULL when disabled */
+	uint8_t * coverage_map;
+	uint32_t coverage_mask; // number of entries minus 1, the size must be a power of 2
+	uaddr_t coverage_source; // linear address of the instruction being executed, taken before it can change CS
 
 	// CPU execution state
 	x86_result_t emulation_result; // result to return from emulation function
@@ -2563,6 +2698,7 @@ struct x86_state_t
 	} fetch_mode; // used to index the exc[] variable
 	uoff_t old_xip; // IP/EIP/RIP on instruction start, used for faults
 	x86_exception_class_t current_exception; // the class of the latest exception (benign if none occured), required to escalate to double/triple fault
+	int last_exception; // exception number and X86_EXC_* flags of the latest interrupt raised by an instruction, tells faults apart from INT n
 
 	// queue of data bytes read during execution
 #define X86_PREFETCH_QUEUE_MAX_SIZE 16
@@ -2729,6 +2865,67 @@ void x86_memory_write_external(x86_state_t * emu, uaddr_t address, uaddr_t count
 
 void x86_memory_read(x86_state_t * emu, uaddr_t address, uaddr_t count, void * buffer);
 void x86_memory_write(x86_state_t * emu, uaddr_t address, uaddr_t count, const void * buffer);
+// Reads linear memory without faulting, triggering breakpoints or setting accessed/dirty bits, returns false if part of it is not mapped
+bool x86_memory_read_debug(x86_state_t * emu, uaddr_t address, uaddr_t count, void * buffer);
+
+// Claims count ports starting at port for a device, a NULL handler returns them to port_read/port_write
+// Note: internal registers (80186 PCB, V33, Cyrix configuration registers) are claimed by x86_reset, devices should be registered afterwards
+void x86_port_register(x86_state_t * emu, uint16_t port, uint32_t count, const x86_port_handler_t * handler);
+// I/O accesses through the port handlers, without triggering breakpoints
+void x86_port_input(x86_state_t * emu, uint16_t port, uint16_t count, void * buffer);
+void x86_port_output(x86_state_t * emu, uint16_t port, uint16_t count, const void * buffer);
+// Z80 INIR/INDR/OTIR/OTDR transfers, byte i belongs to port - (i << 8) as the upper byte of the port is decremented after each byte
+// Only done if a single handler with block callbacks claims all of these ports, the callback receives the port of the first byte, returns the number of bytes transferred or 0
+size_t x86_port_input_z80_block(x86_state_t * emu, uint16_t port, size_t count, void * buffer);
+size_t x86_port_output_z80_block(x86_state_t * emu, uint16_t port, size_t count, const void * buffer);
+
+// Starts recording the pages written to in the first memory_size bytes of physical memory, returns false if the bitmap cannot be allocated
+bool x86_dirty_pages_enable(x86_state_t * emu, uaddr_t memory_size);
+void x86_dirty_pages_disable(x86_state_t * emu);
+// Copies the bitmap into buffer and clears it, buffer must hold x86_dirty_pages_size words, returns the number of words copied
+size_t x86_dirty_pages_fetch(x86_state_t * emu, uint64_t * buffer);
+
+static inline size_t x86_dirty_pages_size(x86_state_t * emu)
+{
+	return (emu->dirty_page_count + 63) >> 6;
+}
+
+// Called by x86_memory_write_external, embedders that write guest memory directly should also call it
+static inline void x86_dirty_pages_mark(x86_state_t * emu, uaddr_t address, uaddr_t count)
+{
+	if(emu->dirty_pages == NULL || count == 0 || (address >> 12) >= emu->dirty_page_count)
+		return;
+
+	uaddr_t last = min((address + count - 1) >> 12, emu->dirty_page_count - 1);
+	for(uaddr_t page = address >> 12; page <= last; page++)
+	{
+		uint64_t bit = (uint64_t)1 << (page & 63);
+		// only the first write to a page needs the locked update
+		if((__atomic_load_n(&emu->dirty_pages[page >> 6], __ATOMIC_RELAXED) & bit) == 0)
+		{
+			__atomic_fetch_or(&emu->dirty_pages[page >> 6], bit, __ATOMIC_RELAXED);
+			// set after the page, a fetch that misses the page still leaves the summary bit for the next fetch
+			__atomic_fetch_or(&emu->dirty_summary[page >> 12], (uint64_t)1 << ((page >> 6) & 63), __ATOMIC_RELAXED);
+		}
+	}
+}
+
+// Returns the first page at or after page that is set in a bitmap returned by x86_dirty_pages_fetch, or (uaddr_t)-1 if there is none
+static inline uaddr_t x86_dirty_pages_next(const uint64_t * bitmap, size_t word_count, uaddr_t page)
+{
+	size_t index = page >> 6;
+	if(index >= word_count)
+		return (uaddr_t)-1;
+
+	uint64_t word = bitmap[index] & (~(uint64_t)0 << (page & 63));
+	while(word == 0)
+	{
+		if(++index >= word_count)
+			return (uaddr_t)-1;
+		word = bitmap[index];
+	}
+	return ((uaddr_t)index << 6) + _ctz64(word);
+}
 
 static inline uint8_t x86_memory_read8_external(x86_state_t * emu, uaddr_t address)
 {
@@ -2823,6 +3020,9 @@ static inline void x86_memory_write64(x86_state_t * emu, uaddr_t address, uint64
 void x80_reset(x80_state_t * emu, bool reset);
 // Note: also resets the x87
 void x86_reset(x86_state_t * emu, bool reset);
+/* Replaces the guest state with a copy of an x86_state_t taken by the same build, possibly in another process
+ * The callbacks, port handlers and parser hooks of emu are kept, guest memory must be restored separately */
+void x86_restore_state(x86_state_t * emu, const x86_state_t * saved);
 
 bool x80_hardware_interrupt(x80_state_t * emu, x80_interrupt_t exception_type, size_t data_length, void * data);
 
@@ -2838,6 +3038,7 @@ void x86_debug(FILE * file, x86_state_t * emu);
 
 void x80_disassemble(x80_parser_t * prs);
 // Note: the emu argument can be NULL, but optionally it can be used to determine if the CPU is in 8080 emulation mode
+// When emu is NULL, prs->code_size must be set and the fetch callbacks must advance prs->current_position
 void x86_disassemble(x86_parser_t * prs, x86_state_t * emu);
 
 x89_parser_t * x89_setup_parser(x86_state_t * emu, unsigned channel_number);
@@ -2850,6 +3051,29 @@ x86_result_t x86_step(x86_state_t * emu);
 void x87_step(x86_state_t * emu);
 void x89_step(x86_state_t * emu);
 
+/*
+ * Per instruction form execution counters, enabled by compiling with -DX86_OPCODE_COUNTERS=1
+ * Every form listed in x86.isa (mnemonic, opcode path and operands) gets its own counter, for each of x86, x87 and 8080/Z80
+ * Every time a REP prefixed string instruction is restarted, it is counted again
+ */
+#ifndef X86_OPCODE_COUNTERS
+# define X86_OPCODE_COUNTERS 0
+#endif
+
+#if X86_OPCODE_COUNTERS
+typedef struct x86_opcode_form_t
+{
+	const char * instruction_set; // "x86", "x87" or "x80"
+	const char * mnemonic;
+	const char * path; // opcode bytes as they would appear in Intel documentation
+	const char * operands;
+} x86_opcode_form_t;
+
+// Prints all instruction forms that have been executed, most frequent first
+void x86_opcode_counters_dump(FILE * file);
+void x86_opcode_counters_reset(void);
+#endif
+
 // various CPUID Vendor IDs
 #define X86_CPUID_VENDOR_INTEL         .ebx = 0x756E6547, .edx = 0x49656E69, .ecx = 0x6C65746E // "GenuineIntel"
 #define X86_CPUID_VENDOR_INTEL_ALT     .ebx = 0x756E6547, .edx = 0x49656E69, .ecx = 0x6C65746F // "GenuineIotel"
@@ -35,6 +35,7 @@ static inline void x86_load_register_bank(x86_state_t * emu);
 
 static inline void x86_load_x80_registers(x86_state_t * emu);
 static inline void x86_store_x80_registers(x86_state_t * emu);
+static inline void x80_memory_window_invalidate(x86_state_t * emu);
 
 static inline uint8_t x86_sfr_get(x86_state_t * emu, uint16_t index);
 static inline uint16_t x86_sfr_get16(x86_state_t * emu, uint16_t index);
@@ -108,6 +109,10 @@ static inline uint32_t x86_memory_segmented_read32_exec(x86_state_t * emu, x86_s
 
 static inline void x86_input(x86_state_t * emu, uint16_t port, uint16_t count, void * buffer);
 static inline void x86_output(x86_state_t * emu, uint16_t port, uint16_t count, const void * buffer);
+static void x86_pcb_update_ports(x86_state_t * emu);
+static void x86_pcb_read(x86_state_t * emu, unsigned offset, unsigned count, void * buffer);
+static void x86_pcb_write(x86_state_t * emu, unsigned offset, unsigned count, const void * buffer);
+static void x86_port_reset(x86_state_t * emu);
 
 static inline void x86_prefetch_queue_rewind(x86_state_t * emu);
 static inline void x86_prefetch_queue_flush(x86_state_t * emu);
@@ -124,11 +129,6 @@ static inline bool x86_dmint_instruction_valid(x86_state_t * emu);
 
 extern const x87_float80_t FLOAT80_ZERO;
 extern const x87_float80_t FLOAT80_ONE;
-extern const x87_float80_t FLOAT80_PI;
-extern const x87_float80_t FLOAT80_LOG2E;
-extern const x87_float80_t FLOAT80_LOG2_10;
-extern const x87_float80_t FLOAT80_LOG10_2;
-extern const x87_float80_t FLOAT80_LN2;
 
 static inline x87_float80_t x87_float80_make_zero(bool sign);
 #if _SUPPORT_FLOAT80
@@ -181,10 +181,12 @@ static inline uint64_t x86_fetch64(x86_parser_t * prs, x86_state_t * emu);
 static inline void x86_push16(x86_state_t * emu, uint16_t value);
 static inline void x86_push32(x86_state_t * emu, uint32_t value);
 static inline void x86_push64(x86_state_t * emu, uint64_t value);
+static inline bool x86_push_block(x86_state_t * emu, const void * buffer, uoff_t count);
 
 static inline uint16_t x86_pop16(x86_state_t * emu);
 static inline uint32_t x86_pop32(x86_state_t * emu);
 static inline uint64_t x86_pop64(x86_state_t * emu);
+static inline bool x86_pop_block(x86_state_t * emu, void * buffer, uoff_t count);
 
 static inline uoff_t x86_get_stack_pointer(x86_state_t * emu);
 static inline void x86_stack_adjust(x86_state_t * emu, uoff_t value);
@@ -196,12 +198,198 @@ static inline bool x86_overflow(uaddr_t base, uaddr_t count, uaddr_t limit)
 	return base > UADDR_MAX - count || base + (count - 1) > limit;
 }
 
-static inline void debug_printf(char debug_output[256], const char * fmt, ...)
+static inline size_t debug_append_number(char * buffer, size_t size, size_t length, uint64_t value, unsigned base, int width)
+{
+	static const char digit_text[] = "0123456789ABCDEF";
+	char digits[24];
+	int count = 0;
+	if(base == 16)
+	{
+		do
+		{
+			digits[count++] = digit_text[value & 0xF];
+			value >>= 4;
+		} while(value != 0);
+	}
+	else
+	{
+		do
+		{
+			digits[count++] = digit_text[value % base];
+			value /= base;
+		} while(value != 0);
+	}
+	while(count < width && count < (int)sizeof digits)
+		digits[count++] = '0';
+	while(count > 0 && length + 1 < size)
+		buffer[length++] = digits[--count];
+	return length;
+}
+
+static inline size_t debug_append_text(char * buffer, size_t size, size_t length, const char * text)
+{
+	while(*text != '\0' && length + 1 < size)
+		buffer[length++] = *text++;
+	return length;
+}
+
+/*
+	Appends formatted text to buffer, truncating it the same way vsnprintf would
+	Only the conversions used by the disassembler (%s, %c, %d, %u, %X with an optional zero padded width and l/ll modifiers) are handled here, the rest of the format string is handed over to vsnprintf after the first unsupported conversion
+*/
+static inline size_t debug_vformat(char * buffer, size_t size, size_t length, const char * fmt, va_list ap)
+{
+	while(*fmt != '\0')
+	{
+		if(*fmt != '%')
+		{
+			if(length + 1 < size)
+				buffer[length++] = *fmt;
+			fmt++;
+			continue;
+		}
+
+		const char * spec = fmt++;
+		int width = 0;
+		if(*fmt == '0')
+		{
+			fmt++;
+			while('0' <= *fmt && *fmt <= '9')
+				width = width * 10 + *fmt++ - '0';
+		}
+		int longs = 0;
+		while(*fmt == 'l')
+		{
+			longs++;
+			fmt++;
+		}
+
+		uint64_t value;
+		switch(*fmt)
+		{
+		case '%':
+			if(width != 0 || longs != 0)
+				goto fallback;
+			if(length + 1 < size)
+				buffer[length++] = '%';
+			break;
+		case 'c':
+			if(width != 0 || longs != 0)
+				goto fallback;
+			if(length + 1 < size)
+				buffer[length++] = (char)va_arg(ap, int);
+			break;
+		case 's':
+			if(width != 0 || longs != 0)
+				goto fallback;
+			{
+				const char * text = va_arg(ap, const char *);
+				if(text == NULL)
+					text = "(null)";
+				while(*text != '\0' && length + 1 < size)
+					buffer[length++] = *text++;
+			}
+			break;
+		case 'd':
+			if(width != 0)
+				goto fallback;
+			{
+				int64_t signed_value = longs == 0 ? va_arg(ap, int) : longs == 1 ? va_arg(ap, long) : va_arg(ap, long long);
+				if(signed_value < 0)
+				{
+					if(length + 1 < size)
+						buffer[length++] = '-';
+					value = -(uint64_t)signed_value;
+				}
+				else
+				{
+					value = signed_value;
+				}
+			}
+			length = debug_append_number(buffer, size, length, value, 10, 0);
+			break;
+		case 'u':
+		case 'X':
+			value = longs == 0 ? va_arg(ap, unsigned) : longs == 1 ? va_arg(ap, unsigned long) : va_arg(ap, unsigned long long);
+			length = debug_append_number(buffer, size, length, value, *fmt == 'X' ? 16 : 10, width);
+			break;
+		default:
+		fallback:
+			if(length < size)
+			{
+				vsnprintf(&buffer[length], size - length, spec, ap);
+				length += strlen(&buffer[length]);
+			}
+			return length;
+		}
+		fmt++;
+	}
+
+	if(length < size)
+		buffer[length] = '\0';
+	return length;
+}
+
+// Returns the number of characters in the disassembly output, callers may empty it by only clearing the first character
+static inline size_t debug_get_length(char debug_output[256], size_t * length)
+{
+	if(debug_output[0] == '\0')
+		*length = 0;
+	return *length;
+}
+
+static inline void debug_printf(char debug_output[256], size_t * length, const char * fmt, ...)
+{
+	va_list ap;
+	va_start(ap, fmt);
+	*length = debug_vformat(debug_output, 256, debug_get_length(debug_output, length), fmt, ap);
+	va_end(ap);
+}
+
+/* The following functions append a single fragment to the disassembly output, they are used by the generated parser instead of formatting */
+
+static inline void debug_text(char debug_output[256], size_t * length, const char * text, size_t count)
+{
+	size_t current = debug_get_length(debug_output, length);
+	if(count > 255 - current)
+		count = 255 - current;
+	memcpy(&debug_output[current], text, count);
+	debug_output[*length = current + count] = '\0';
+}
+
+static inline void debug_string(char debug_output[256], size_t * length, const char * text)
+{
+	debug_text(debug_output, length, text, strlen(text));
+}
+
+static inline void debug_hex(char debug_output[256], size_t * length, uint64_t value)
+{
+	*length = debug_append_number(debug_output, 256, debug_get_length(debug_output, length), value, 16, 0);
+	debug_output[*length] = '\0';
+}
+
+static inline void debug_decimal(char debug_output[256], size_t * length, int64_t value)
+{
+	size_t current = debug_get_length(debug_output, length);
+	if(value < 0 && current < 255)
+		debug_output[current++] = '-';
+	*length = debug_append_number(debug_output, 256, current, value < 0 ? -(uint64_t)value : (uint64_t)value, 10, 0);
+	debug_output[*length] = '\0';
+}
+
+static inline void debug_appendf(char * buffer, size_t size, const char * fmt, ...)
+{
+	va_list ap;
+	va_start(ap, fmt);
+	debug_vformat(buffer, size, strlen(buffer), fmt, ap);
+	va_end(ap);
+}
+
+static inline void debug_snprintf(char * buffer, size_t size, const char * fmt, ...)
 {
 	va_list ap;
 	va_start(ap, fmt);
-	size_t length = strlen(debug_output);
-	vsnprintf(&debug_output[length], 256 - length, fmt, ap);
+	debug_vformat(buffer, size, 0, fmt, ap);
 	va_end(ap);
 }
 
@@ -781,6 +781,21 @@ def print_file(*parts, file = None):
 	print(parts, file = file)
 	file_line += parts.count('\n') + 1
 
+def debug_statement(text, args):
+	""" Turns a format string of DEBUG and its arguments into statements that append the fragments directly, without parsing the format at runtime """
+	text = text.replace('%"PRIX64 "', '\0X').replace('%"PRIX64"', '\0X').replace('%s', '\0s').replace('%d', '\0d')
+	pieces = text.split('\0')
+	assert len(pieces) == len(args) + 1
+	statements = []
+	for i in range(len(pieces)):
+		if i > 0:
+			statements.append({'X': 'DEBUG_HEX', 's': 'DEBUG_STRING', 'd': 'DEBUG_DECIMAL'}[pieces[i][0]] + f'({args[i - 1]});')
+			pieces[i] = pieces[i][1:]
+		assert '%' not in pieces[i] and '"' not in pieces[i]
+		if pieces[i] != '':
+			statements.append(f'DEBUG_TEXT("{pieces[i]}");')
+	return ' '.join(statements)
+
 # x86 operand details
 
 OPERAND_CODE = {
@@ -1348,12 +1363,14 @@ X80_OPERAND_CODE = {
 		'prepare': 'soff_t imm$# = (int8_t)x80_fetch8$fetch();',
 		'read':    "_read80b(emu->ix + imm$#)",
 		'write':   "_write80b(emu->ix + imm$#, $$)",
+		'index':   'X80_R_IX',
 		'format':  ('(ix+%"PRIX64")', ["(uoff_t)imm$#"]),
 	},
 	'(IY+Ib)': {
 		'prepare': 'soff_t imm$# = (int8_t)x80_fetch8$fetch();',
 		'read':    "_read80b(emu->iy + imm$#)",
 		'write':   "_write80b(emu->iy + imm$#, $$)",
+		'index':   'X80_R_IY',
 		'format':  ('(ix+%"PRIX64")', ["(uoff_t)imm$#"]),
 	},
 	'(C)': {
@@ -1743,6 +1760,12 @@ def gen_code80(line_infile_code, *ops, indent = '', **kwds):
 			replacements['$dsp'] = 'imm0'
 			break
 
+	# the DD/FD prefixed CB instructions have an (IX+d)/(IY+d) operand
+	replacements['$index'] = 'NONE'
+	for op in ops:
+		if 'index' in op:
+			replacements['$index'] = op['index']
+
 	for i, op in enumerate(ops):
 		replacements[f'${i}'] = replace(op.get('read', '/*TODO*/'), registers80)
 		replacements[f'${i}='] = replace(op.get('write', '/*TODO*/'), registers80)
@@ -1939,6 +1962,22 @@ registers80 = {
 }
 
 MISSING = set()
+
+# Instruction forms that receive an execution counter in the step functions, the position in the list is the identifier
+OPCODE_FORMS = []
+OPCODE_FORM_IDS = {}
+
+def get_opcode_form(mode, path, entry, modrm):
+	""" Returns a stable identifier for an instruction form, the same entry reached through the same opcode gets the same identifier """
+	key = (mode, str(path), entry.kwds['mnem'], tuple(entry.kwds['opds']), modrm)
+	if key not in OPCODE_FORM_IDS:
+		OPCODE_FORM_IDS[key] = len(OPCODE_FORMS)
+		OPCODE_FORMS.append(key)
+	return OPCODE_FORM_IDS[key]
+
+def c_string(text):
+	return '"' + text.replace('\\', '\\\\').replace('"', '\\"') + '"'
+
 def print_instruction(path, indent, actual_range, entry, discriminator, index, file, mode, modrm, method):
 	global INSTRUCTIONS
 	global MISSING
@@ -1955,6 +1994,9 @@ def print_instruction(path, indent, actual_range, entry, discriminator, index, f
 	if modrm is None and 'modrm' in entry.kwds:
 		assert False
 
+	if method == 'step' and not entry.kwds['mnem'].endswith(':'):
+		print_file(f"{indent}COUNT_OPCODE({get_opcode_form(mode, path + Path((index, discriminator)), entry, modrm)});", file = file)
+
 	if entry.kwds['mnem'] in {'ES:', 'CS:', 'SS:', 'DS:', 'FS:', 'GS:', 'DS2:', 'DS3:', 'IRAM:'}:
 		segreg = entry.kwds['mnem'][:-1]
 		print_file(f"{indent}if({parser_object}->rex_prefix)", file = file)
@@ -2211,7 +2253,7 @@ def print_instruction(path, indent, actual_range, entry, discriminator, index, f
 						_opds.append(opd)
 
 				pars = ""
-				args = ""
+				args = []
 				for opd in _opds:
 					if 'format' not in opd:
 						print(f"Undefined operand: {opd['original']}", file = sys.stderr)
@@ -2222,14 +2264,13 @@ def print_instruction(path, indent, actual_range, entry, discriminator, index, f
 					if pars != "":
 						pars += ", "
 					pars += fmt[0]
-					for arg in fmt[1]:
-						args += ", " + arg
+					args += fmt[1]
 
 				if pars == "":
-					assert args == ""
-					line = f'DEBUG("{_mnem}\\n");'
+					assert args == []
+					line = debug_statement(f'{_mnem}\\n', args)
 				else:
-					line = f'DEBUG("{_mnem}\\t{pars}\\n"{args});'
+					line = debug_statement(f'{_mnem}\\t{pars}\\n', args)
 
 				if len(syntaxes) == 1:
 					print_file(f'{indent1}{line}', file = file)
@@ -2413,7 +2454,7 @@ def print_instruction(path, indent, actual_range, entry, discriminator, index, f
 							_opds.append(opd)
 
 					pars = ""
-					args = ""
+					args = []
 					for opd in _opds:
 						if 'format' not in opd:
 							print(f"Undefined operand: {opd['original']}", file = sys.stderr)
@@ -2426,13 +2467,13 @@ def print_instruction(path, indent, actual_range, entry, discriminator, index, f
 						pars += replace_patterns(fmt[0], size, opd['size'])
 						for arg in fmt[1]:
 							#assert type(arg) is not dict
-							args += ", " + replace_patterns(arg, size, opd['size'])
+							args.append(replace_patterns(arg, size, opd['size']))
 
 					if pars == "":
-						assert args == ""
-						line = f'DEBUG("{_mnem}\\n");'
+						assert args == []
+						line = debug_statement(f'{_mnem}\\n', args)
 					else:
-						line = f'DEBUG("{_mnem}\\t{pars}\\n"{args});'
+						line = debug_statement(f'{_mnem}\\t{pars}\\n', args)
 
 					if not (mode == '87' and not x87_async) and _mnem == 'esc':
 						print_file(f'{indent1}if(prs->fpu_type == X87_FPU_NONE)', file = file)
@@ -3163,6 +3204,19 @@ with open(outfile, 'w') as fp:
 	print_file("}", file = fp)
 	print_file("#undef USE_PRS", file = fp)
 
+	print_file("#if X86_OPCODE_COUNTERS", file = fp)
+	print_file(f"#define X86_OPCODE_FORM_COUNT {len(OPCODE_FORMS)}", file = fp)
+	print_file("uint64_t x86_opcode_counters[X86_OPCODE_FORM_COUNT];", file = fp)
+	print_file("static const x86_opcode_form_t x86_opcode_forms[X86_OPCODE_FORM_COUNT] =", file = fp)
+	print_file("{", file = fp)
+	for form_id, (mode, path, mnem, opds, modrm) in enumerate(OPCODE_FORMS):
+		instruction_set = {'32': 'x86', '87': 'x87', '8': 'x80'}[mode]
+		if modrm is not None and not path.endswith((' M', ' R')) and ' M ' not in path and ' R ' not in path:
+			path += {'mem': ' M', 'reg': ' R'}[modrm]
+		print_file(f"\t[{form_id}] = {{ {c_string(instruction_set)}, {c_string(mnem)}, {c_string(path)}, {c_string(', '.join(opds))} }},", file = fp)
+	print_file("};", file = fp)
+	print_file("#endif", file = fp)
+
 if len(MISSING) > 0:
 	print("Missing operations: " + ', '.join(sorted(MISSING)))
 
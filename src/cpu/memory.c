@@ -109,8 +109,8 @@ void x86_memory_read_external(x86_state_t * emu, uaddr_t address, uaddr_t count,
 
 		if(address < pcb_address + 0x100)
 		{
-			actual_count = min(count, 0x100);
-			memcpy(buffer, (uint8_t *)emu->pcb + (address - pcb_address), actual_count);
+			actual_count = min(count, pcb_address + 0x100 - address);
+			x86_pcb_read(emu, address - pcb_address, actual_count, buffer);
 			if(actual_count == count)
 				return;
 			address += actual_count;
@@ -125,6 +125,7 @@ void x86_memory_read_external(x86_state_t * emu, uaddr_t address, uaddr_t count,
 void x86_memory_write_external(x86_state_t * emu, uaddr_t address, uaddr_t count, const void * buffer)
 {
 	x86_cpu_level_t memory_space = emu->parser->user_mode ? X86_LEVEL_USER : emu->cpu_level;
+	x86_dirty_pages_mark(emu, address, count);
 	if(emu->cpu_type == X86_CPU_186 && (le16toh(emu->pcb[X86_PCB_PCR]) & X86_PCB_PCR_MIO) == 0)
 	{
 		// The 80186 checks for its internal registers
@@ -144,8 +145,8 @@ void x86_memory_write_external(x86_state_t * emu, uaddr_t address, uaddr_t count
 
 		if(address < pcb_address + 0x100)
 		{
-			actual_count = min(count, 0x100);
-			memcpy((uint8_t *)emu->pcb + (address - pcb_address), buffer, actual_count);
+			actual_count = min(count, pcb_address + 0x100 - address);
+			x86_pcb_write(emu, address - pcb_address, actual_count, buffer);
 			if(actual_count == count)
 				return;
 			address += actual_count;
@@ -157,6 +158,50 @@ void x86_memory_write_external(x86_state_t * emu, uaddr_t address, uaddr_t count
 		emu->memory_write(emu, memory_space, address, buffer, count);
 }
 
+bool x86_dirty_pages_enable(x86_state_t * emu, uaddr_t memory_size)
+{
+	uaddr_t page_count = (memory_size + 0xFFF) >> 12;
+	size_t word_count = (page_count + 63) >> 6;
+	// the summary is stored after the bitmap
+	uint64_t * bitmap = calloc(word_count + ((word_count + 63) >> 6), sizeof(uint64_t));
+	if(bitmap == NULL)
+		return false;
+	free(emu->dirty_pages);
+	emu->dirty_pages = bitmap;
+	emu->dirty_summary = bitmap + word_count;
+	emu->dirty_page_count = page_count;
+	return true;
+}
+
+void x86_dirty_pages_disable(x86_state_t * emu)
+{
+	free(emu->dirty_pages);
+	emu->dirty_pages = NULL;
+	emu->dirty_summary = NULL;
+	emu->dirty_page_count = 0;
+}
+
+size_t x86_dirty_pages_fetch(x86_state_t * emu, uint64_t * buffer)
+{
+	size_t word_count = x86_dirty_pages_size(emu);
+	for(size_t summary_index = 0; summary_index << 6 < word_count; summary_index++)
+	{
+		size_t first = summary_index << 6;
+		size_t count = min(word_count - first, 64);
+		uint64_t summary = __atomic_load_n(&emu->dirty_summary[summary_index], __ATOMIC_RELAXED);
+		if(summary != 0)
+			summary = __atomic_exchange_n(&emu->dirty_summary[summary_index], 0, __ATOMIC_RELAXED);
+		memset(buffer + first, 0, count * sizeof(uint64_t));
+		for(; summary != 0; summary &= summary - 1)
+		{
+			size_t index = first + _ctz64(summary);
+			// each word is swapped out in one step, so a page marked concurrently is either returned now or by the next call
+			buffer[index] = __atomic_exchange_n(&emu->dirty_pages[index], 0, __ATOMIC_RELAXED);
+		}
+	}
+	return word_count;
+}
+
 // Memory access without paging, typically the same as external memory (only required for V25 which uses on-chip RAM)
 static inline void x86_memory_read_no_paging(x86_state_t * emu, uaddr_t address, uaddr_t count, void * buffer)
 {
@@ -181,7 +226,6 @@ static inline void x86_memory_read_no_paging(x86_state_t * emu, uaddr_t address,
 				address += actual_count;
 				count -= actual_count;
 			}
-			x86_store_register_bank(emu);
 		}
 		else
 		{
@@ -201,6 +245,7 @@ static inline void x86_memory_read_no_paging(x86_state_t * emu, uaddr_t address,
 		if(address < idb + 0x1000)
 		{
 			actual_count = min(count, idb + 0x1000 - address);
+			x86_store_register_bank_range(emu, address - (0xE00 + idb), actual_count);
 			memcpy(_buffer, &emu->iram[address - (0xE00 + idb)], actual_count);
 			if(actual_count == count)
 				return;
@@ -257,7 +302,6 @@ static inline void x86_memory_write_no_paging(x86_state_t * emu, uaddr_t address
 				address += actual_count;
 				count -= actual_count;
 			}
-			x86_store_register_bank(emu);
 		}
 		else
 		{
@@ -277,11 +321,10 @@ static inline void x86_memory_write_no_paging(x86_state_t * emu, uaddr_t address
 		if(address < idb + 0x1000)
 		{
 			actual_count = min(count, idb + 0x1000 - address);
+			// a partially written word of the current bank keeps its other byte
+			x86_store_register_bank_range(emu, address - (0xE00 + idb), actual_count);
 			memcpy(&emu->iram[address - (0xE00 + idb)], _buffer, actual_count);
-			if(address < idb + 0xF00)
-			{
-				x86_load_register_bank(emu);
-			}
+			x86_load_register_bank_range(emu, address - (0xE00 + idb), actual_count);
 			if(actual_count == count)
 				return;
 			_buffer += actual_count;
@@ -314,8 +357,19 @@ static inline void x86_memory_write_no_paging(x86_state_t * emu, uaddr_t address
 	}
 }
 
-static inline uint32_t x86_page_fetch32(x86_state_t * emu, uaddr_t full_address, uaddr_t table_address, uoff_t index, bool write, bool exec, bool user)
+static inline uint32_t x86_page_fetch32(x86_state_t * emu, uaddr_t full_address, uaddr_t table_address, uoff_t index, bool write, bool exec, bool user, bool * present)
 {
+	if(present != NULL)
+	{
+		// probing, missing entries are reported instead of faulting and the accessed/dirty bits are left alone
+		if(!*present)
+			return 0;
+		uint32_t entry = x86_memory_read32_external(emu, table_address + index * 4);
+		if((entry & X86_PAGE_ENTRY_P) == 0)
+			*present = false;
+		return entry;
+	}
+
 	uint32_t entry = x86_memory_read32_external(emu, table_address + index * 4);
 	// TODO: check other flags and when they were introduced
 	uint32_t error_code = (write ? X86_EXC_VALUE_PF_WR : 0) | (user ? X86_EXC_VALUE_PF_US : 0) | (exec ? X86_EXC_VALUE_PF_ID : 0);
@@ -344,8 +398,19 @@ static inline uint32_t x86_page_fetch32(x86_state_t * emu, uaddr_t full_address,
 	return entry;
 }
 
-static inline uint64_t x86_page_fetch64(x86_state_t * emu, uaddr_t full_address, uaddr_t table_address, uoff_t index, bool write, bool exec, bool user)
+static inline uint64_t x86_page_fetch64(x86_state_t * emu, uaddr_t full_address, uaddr_t table_address, uoff_t index, bool write, bool exec, bool user, bool * present)
 {
+	if(present != NULL)
+	{
+		// probing, missing entries are reported instead of faulting and the accessed/dirty bits are left alone
+		if(!*present)
+			return 0;
+		uint64_t entry = x86_memory_read64_external(emu, table_address + index * 4);
+		if((entry & X86_PAGE_ENTRY_P) == 0)
+			*present = false;
+		return entry;
+	}
+
 	uint64_t entry = x86_memory_read64_external(emu, table_address + index * 4);
 	// TODO: check other flags and when they were introduced
 	uint32_t error_code = (write ? X86_EXC_VALUE_PF_WR : 0) | (user ? X86_EXC_VALUE_PF_US : 0) | (exec ? X86_EXC_VALUE_PF_ID : 0);
@@ -375,7 +440,8 @@ static inline uint64_t x86_page_fetch64(x86_state_t * emu, uaddr_t full_address,
 }
 
 /* Translates the virtual (linear) address into physical address and stores the number of bytes beyond the address that belong to the same page */
-static inline uaddr_t x86_page_translate(x86_state_t * emu, uaddr_t full_address, bool write, bool exec, bool user, uoff_t * length)
+/* If present is not NULL, no faults are generated and it is cleared when the address is not mapped */
+static inline uaddr_t x86_page_translate(x86_state_t * emu, uaddr_t full_address, bool write, bool exec, bool user, uoff_t * length, bool * present)
 {
 	uaddr_t address = full_address;
 	if(emu->cpu_type == X86_CPU_V33)
@@ -408,8 +474,8 @@ static inline uaddr_t x86_page_translate(x86_state_t * emu, uaddr_t full_address
 		{
 			// 36-bit paging
 			// TODO: other CR3 fields?
-			uint64_t pml3 = x86_page_fetch64(emu, full_address, emu->cr[3] & ~0xFFF, (address >> 30) & 3, write, exec, user);
-			uint64_t pml2 = x86_page_fetch64(emu, full_address, pml3 & 0x000FFFFFFFFFF000LL, (address >> 21) & 0x1FF, write, exec, user);
+			uint64_t pml3 = x86_page_fetch64(emu, full_address, emu->cr[3] & ~0xFFF, (address >> 30) & 3, write, exec, user, present);
+			uint64_t pml2 = x86_page_fetch64(emu, full_address, pml3 & 0x000FFFFFFFFFF000LL, (address >> 21) & 0x1FF, write, exec, user, present);
 			if((pml2 & X86_PAGE_ENTRY_PS) != 0)
 			{
 				address &= 0x1FFFFF;
@@ -418,7 +484,7 @@ static inline uaddr_t x86_page_translate(x86_state_t * emu, uaddr_t full_address
 			}
 			else
 			{
-				uint64_t pml1 = x86_page_fetch64(emu, full_address, pml3 & 0x000FFFFFFFFFF000LL, (address >> 12) & 0x1FF, write, exec, user);
+				uint64_t pml1 = x86_page_fetch64(emu, full_address, pml3 & 0x000FFFFFFFFFF000LL, (address >> 12) & 0x1FF, write, exec, user, present);
 				address &= 0xFFF;
 				*length = 0x1000 - address;
 				return (pml1 & 0x000FFFFFFFFFF000LL) + address;
@@ -428,7 +494,7 @@ static inline uaddr_t x86_page_translate(x86_state_t * emu, uaddr_t full_address
 		{
 			// 32-bit paging
 			// TODO: other CR3 fields
-			uint32_t pml2 = x86_page_fetch32(emu, full_address, emu->cr[3] & ~0xFFF, (address >> 22) & 0xFFF, write, exec, user);
+			uint32_t pml2 = x86_page_fetch32(emu, full_address, emu->cr[3] & ~0xFFF, (address >> 22) & 0xFFF, write, exec, user, present);
 			if((emu->cr[4] & X86_CR4_PSE) != 0 && (pml2 & X86_PAGE_ENTRY_PS) != 0)
 			{
 				address &= 0x3FFFFF;
@@ -437,7 +503,7 @@ static inline uaddr_t x86_page_translate(x86_state_t * emu, uaddr_t full_address
 			}
 			else
 			{
-				uint64_t pml1 = x86_page_fetch32(emu, full_address, pml2 & 0xFFFFF000, (address >> 12) & 0xFFF, write, exec, user);
+				uint64_t pml1 = x86_page_fetch32(emu, full_address, pml2 & 0xFFFFF000, (address >> 12) & 0xFFF, write, exec, user, present);
 				address &= 0xFFF;
 				*length = 0x1000 - address;
 				return (pml1 & 0xFFFFF000) + address;
@@ -448,28 +514,28 @@ static inline uaddr_t x86_page_translate(x86_state_t * emu, uaddr_t full_address
 	{
 		// 4-level paging
 		// TODO: other CR3 fields
-		uint64_t pml4 = x86_page_fetch64(emu, full_address, emu->cr[3] & ~0xFFF, (address >> 39) & 0x1FF, write, exec, user);
+		uint64_t pml4 = x86_page_fetch64(emu, full_address, emu->cr[3] & ~0xFFF, (address >> 39) & 0x1FF, write, exec, user, present);
 		if((pml4 & X86_PAGE_ENTRY_PS) != 0)
 		{
 			address &= 0x7FFFFFFFFF;
 			*length = 0x8000000000 - address;
 			return (pml4 & 0x000FFF8000000000LL) + address;
 		}
-		uint64_t pml3 = x86_page_fetch64(emu, full_address, pml4 & 0x000FFFFFFFFFF000LL, (address >> 30) & 0x1FF, write, exec, user);
+		uint64_t pml3 = x86_page_fetch64(emu, full_address, pml4 & 0x000FFFFFFFFFF000LL, (address >> 30) & 0x1FF, write, exec, user, present);
 		if((pml3 & X86_PAGE_ENTRY_PS) != 0)
 		{
 			address &= 0x3FFFFFFF;
 			*length = 0x40000000 - address;
 			return (pml3 & 0x000FFFFFC0000000LL) + address;
 		}
-		uint64_t pml2 = x86_page_fetch64(emu, full_address, pml3 & 0x000FFFFFFFFFF000LL, (address >> 21) & 0x1FF, write, exec, user);
+		uint64_t pml2 = x86_page_fetch64(emu, full_address, pml3 & 0x000FFFFFFFFFF000LL, (address >> 21) & 0x1FF, write, exec, user, present);
 		if((pml2 & X86_PAGE_ENTRY_PS) != 0)
 		{
 			address &= 0x1FFFFF;
 			*length = 0x200000 - address;
 			return (pml2 & 0x000FFFFFFFE00000LL) + address;
 		}
-		uint64_t pml1 = x86_page_fetch64(emu, full_address, pml2 & 0x000FFFFFFFFFF000LL, (address >> 12) & 0x1FF, write, exec, user);
+		uint64_t pml1 = x86_page_fetch64(emu, full_address, pml2 & 0x000FFFFFFFFFF000LL, (address >> 12) & 0x1FF, write, exec, user, present);
 		address &= 0xFFF;
 		*length = 0x1000 - address;
 		return (pml1 & 0xFFFFF000) + address;
@@ -478,35 +544,35 @@ static inline uaddr_t x86_page_translate(x86_state_t * emu, uaddr_t full_address
 	{
 		// 5-level paging
 		// TODO: other CR3 fields
-		uint64_t pml5 = x86_page_fetch64(emu, full_address, emu->cr[3] & ~0xFFF, (address >> 48) & 0x1FF, write, exec, user);
+		uint64_t pml5 = x86_page_fetch64(emu, full_address, emu->cr[3] & ~0xFFF, (address >> 48) & 0x1FF, write, exec, user, present);
 		if((pml5 & X86_PAGE_ENTRY_PS) != 0)
 		{
 			address &= 0xFFFFFFFFFFFF;
 			*length = 0x1000000000000 - address;
 			return (pml5 & 0x000F000000000000LL) + address;
 		}
-		uint64_t pml4 = x86_page_fetch64(emu, full_address, pml5 & 0x000FFFFFFFFFF000LL, (address >> 39) & 0x1FF, write, exec, user);
+		uint64_t pml4 = x86_page_fetch64(emu, full_address, pml5 & 0x000FFFFFFFFFF000LL, (address >> 39) & 0x1FF, write, exec, user, present);
 		if((pml4 & X86_PAGE_ENTRY_PS) != 0)
 		{
 			address &= 0x7FFFFFFFFF;
 			*length = 0x8000000000 - address;
 			return (pml4 & 0x000FFF8000000000LL) + address;
 		}
-		uint64_t pml3 = x86_page_fetch64(emu, full_address, pml4 & 0x000FFFFFFFFFF000LL, (address >> 30) & 0x1FF, write, exec, user);
+		uint64_t pml3 = x86_page_fetch64(emu, full_address, pml4 & 0x000FFFFFFFFFF000LL, (address >> 30) & 0x1FF, write, exec, user, present);
 		if((pml3 & X86_PAGE_ENTRY_PS) != 0)
 		{
 			address &= 0x3FFFFFFF;
 			*length = 0x40000000 - address;
 			return (pml3 & 0x000FFFFFC0000000LL) + address;
 		}
-		uint64_t pml2 = x86_page_fetch64(emu, full_address, pml3 & 0x000FFFFFFFFFF000LL, (address >> 21) & 0x1FF, write, exec, user);
+		uint64_t pml2 = x86_page_fetch64(emu, full_address, pml3 & 0x000FFFFFFFFFF000LL, (address >> 21) & 0x1FF, write, exec, user, present);
 		if((pml2 & X86_PAGE_ENTRY_PS) != 0)
 		{
 			address &= 0x1FFFFF;
 			*length = 0x200000 - address;
 			return (pml2 & 0x000FFFFFFFE00000LL) + address;
 		}
-		uint64_t pml1 = x86_page_fetch64(emu, full_address, pml2 & 0x000FFFFFFFFFF000LL, (address >> 12) & 0x1FF, write, exec, user);
+		uint64_t pml1 = x86_page_fetch64(emu, full_address, pml2 & 0x000FFFFFFFFFF000LL, (address >> 12) & 0x1FF, write, exec, user, present);
 		address &= 0xFFF;
 		*length = 0x1000 - address;
 		return (pml1 & 0xFFFFF000) + address;
@@ -550,14 +616,34 @@ inline void x86_memory_read(x86_state_t * emu, uaddr_t address, uaddr_t count, v
 	while(count > 0)
 	{
 		uoff_t actual_length;
-		uaddr_t physical_address = x86_page_translate(emu, address, false, false, emu->cpl == 3, &actual_length);
+		uaddr_t physical_address = x86_page_translate(emu, address, false, false, emu->cpl == 3, &actual_length, NULL);
+		if(actual_length > count || actual_length == 0)
+			actual_length = count;
+		x86_memory_read_no_paging(emu, physical_address, actual_length, buffer);
+		address += actual_length;
+		buffer += actual_length;
+		count -= actual_length;
+	}
+}
+
+// reads memory for the debugger and tools, without faulting, triggering breakpoints or updating the page tables
+bool x86_memory_read_debug(x86_state_t * emu, uaddr_t address, uaddr_t count, void * buffer)
+{
+	while(count > 0)
+	{
+		uoff_t actual_length;
+		bool present = true;
+		uaddr_t physical_address = x86_page_translate(emu, address, false, false, false, &actual_length, &present);
+		if(!present)
+			return false;
 		if(actual_length > count || actual_length == 0)
 			actual_length = count;
-		x86_memory_read_no_paging(emu, physical_address, count, buffer);
+		x86_memory_read_no_paging(emu, physical_address, actual_length, buffer);
 		address += actual_length;
 		buffer += actual_length;
 		count -= actual_length;
 	}
+	return true;
 }
 
 // accesses system memory, ignoring current privilege
@@ -568,10 +654,10 @@ static inline void x86_memory_read_system(x86_state_t * emu, uaddr_t address, ua
 	while(count > 0)
 	{
 		uoff_t actual_length;
-		uaddr_t physical_address = x86_page_translate(emu, address, false, false, false, &actual_length);
+		uaddr_t physical_address = x86_page_translate(emu, address, false, false, false, &actual_length, NULL);
 		if(actual_length > count || actual_length == 0)
 			actual_length = count;
-		x86_memory_read_no_paging(emu, physical_address, count, buffer);
+		x86_memory_read_no_paging(emu, physical_address, actual_length, buffer);
 		address += actual_length;
 		buffer += actual_length;
 		count -= actual_length;
@@ -584,10 +670,10 @@ static inline void x86_memory_read_prefetch(x86_state_t * emu, uaddr_t address,
 	while(count > 0)
 	{
 		uoff_t actual_length;
-		uaddr_t physical_address = x86_page_translate(emu, address, false, true, emu->cpl == 3, &actual_length);
+		uaddr_t physical_address = x86_page_translate(emu, address, false, true, emu->cpl == 3, &actual_length, NULL);
 		if(actual_length > count || actual_length == 0)
 			actual_length = count;
-		x86_memory_read_external(emu, physical_address, count, buffer);
+		x86_memory_read_external(emu, physical_address, actual_length, buffer);
 		address += actual_length;
 		buffer += actual_length;
 		count -= actual_length;
@@ -615,17 +701,25 @@ static inline void x86_memory_read_exec(x86_state_t * emu, uaddr_t address, uadd
 	x86_memory_read_prefetch(emu, address, count, buffer);
 }
 
+// Writes to the bitmaps of the current TSS invalidate their decoded copy
+static inline void x86_tss_bitmaps_check_write(x86_state_t * emu, uaddr_t address, uaddr_t count)
+{
+	if(emu->tss_bitmaps_valid && address <= emu->tss_bitmaps_base + emu->tss_bitmaps_limit && address + count > emu->tss_bitmaps_base + 0x66)
+		emu->tss_bitmaps_valid = false;
+}
+
 void x86_memory_write(x86_state_t * emu, uaddr_t address, uaddr_t count, const void * buffer)
 {
 	x86_check_breakpoints(emu, X86_ACCESS_WRITE, address, count);
+	x86_tss_bitmaps_check_write(emu, address, count);
 
 	while(count > 0)
 	{
 		uoff_t actual_length;
-		uaddr_t physical_address = x86_page_translate(emu, address, true, false, emu->cpl == 3, &actual_length);
+		uaddr_t physical_address = x86_page_translate(emu, address, true, false, emu->cpl == 3, &actual_length, NULL);
 		if(actual_length > count || actual_length == 0)
 			actual_length = count;
-		x86_memory_write_no_paging(emu, physical_address, count, buffer);
+		x86_memory_write_no_paging(emu, physical_address, actual_length, buffer);
 		address += actual_length;
 		buffer += actual_length;
 		count -= actual_length;
@@ -636,14 +730,15 @@ void x86_memory_write(x86_state_t * emu, uaddr_t address, uaddr_t count, const v
 static inline void x86_memory_write_system(x86_state_t * emu, uaddr_t address, uaddr_t count, const void * buffer)
 {
 	x86_check_breakpoints(emu, X86_ACCESS_WRITE, address, count);
+	x86_tss_bitmaps_check_write(emu, address, count);
 
 	while(count > 0)
 	{
 		uoff_t actual_length;
-		uaddr_t physical_address = x86_page_translate(emu, address, true, false, false, &actual_length);
+		uaddr_t physical_address = x86_page_translate(emu, address, true, false, false, &actual_length, NULL);
 		if(actual_length > count || actual_length == 0)
 			actual_length = count;
-		x86_memory_write_no_paging(emu, physical_address, count, buffer);
+		x86_memory_write_no_paging(emu, physical_address, actual_length, buffer);
 		address += actual_length;
 		buffer += actual_length;
 		count -= actual_length;
@@ -674,9 +769,10 @@ static inline void x86_prefetch_queue_fill(x86_state_t * emu)
 		x86_prefetch_queue_flush(emu);
 	}
 
-	if(emu->prefetch_queue_data_offset != 0 && emu->prefetch_queue_data_size != 0)
+	if(emu->prefetch_queue_data_offset != 0)
 	{
-		memcpy(&emu->prefetch_queue[0], &emu->prefetch_queue[emu->prefetch_queue_data_offset], emu->prefetch_queue_data_size);
+		// also needed for an empty queue, otherwise the new bytes are written past the end of the buffer
+		memmove(&emu->prefetch_queue[0], &emu->prefetch_queue[emu->prefetch_queue_data_offset], emu->prefetch_queue_data_size);
 		emu->prefetch_queue_data_offset = 0;
 	}
 
@@ -770,10 +866,10 @@ static inline void x86_memory_segmented_read(x86_state_t * emu, x86_segnum_t seg
 		// IRAM uses the internal RAM
 		char * _buffer = buffer;
 		offset &= 0x1FF;
-		x86_store_register_bank(emu);
 		for(;;)
 		{
 			size_t actual_count = min(count, 0x200 - offset);
+			x86_store_register_bank_range(emu, offset, actual_count);
 			memcpy(_buffer, &emu->iram[offset], actual_count);
 			if(actual_count == count)
 				return;
@@ -834,10 +930,10 @@ static inline void x87_memory_segmented_read(x86_state_t * emu, x86_segnum_t seg
 	{
 		char * _buffer = buffer;
 		offset &= 0x1FF;
-		x86_store_register_bank(emu);
 		for(;;)
 		{
 			size_t actual_count = min(count, 0x200 - offset);
+			x86_store_register_bank_range(emu, offset, actual_count);
 			memcpy(_buffer, &emu->iram[offset], actual_count);
 			if(actual_count == count)
 				return;
@@ -989,12 +1085,12 @@ static inline void x86_memory_segmented_write(x86_state_t * emu, x86_segnum_t se
 	{
 		const char * _buffer = buffer;
 		offset &= 0x1FF;
-		x86_store_register_bank(emu);
 		for(;;)
 		{
 			size_t actual_count = min(count, 0x200 - offset);
+			x86_store_register_bank_range(emu, offset, actual_count);
 			memcpy(&emu->iram[offset], _buffer, actual_count);
-			x86_load_register_bank(emu);
+			x86_load_register_bank_range(emu, offset, actual_count);
 			if(actual_count == count)
 				return;
 			_buffer += actual_count;
@@ -1053,12 +1149,12 @@ static inline void x87_memory_segmented_write(x86_state_t * emu, x86_segnum_t se
 	{
 		const char * _buffer = buffer;
 		offset &= 0x1FF;
-		x86_store_register_bank(emu);
 		for(;;)
 		{
 			size_t actual_count = min(count, 0x200 - offset);
+			x86_store_register_bank_range(emu, offset, actual_count);
 			memcpy(&emu->iram[offset], _buffer, actual_count);
-			x86_load_register_bank(emu);
+			x86_load_register_bank_range(emu, offset, actual_count);
 			if(actual_count == count)
 				return;
 			_buffer += actual_count;
@@ -1176,86 +1272,340 @@ static inline void x87_memory_segmented_write80fp(x86_state_t * emu, x86_segnum_
 
 // I/O
 
-static inline void x86_input(x86_state_t * emu, uint16_t port, uint16_t count, void * buffer)
+void x86_port_register(x86_state_t * emu, uint16_t port, uint32_t count, const x86_port_handler_t * handler)
 {
-	x86_check_breakpoints(emu, X86_ACCESS_IO, port, count);
+	if(emu->port_handlers == NULL)
+	{
+		if(handler == NULL)
+			return;
+		emu->port_handlers = calloc(0x10000, sizeof(emu->port_handlers[0]));
+		assert(emu->port_handlers != NULL);
+	}
 
-	if(emu->cpu_type == X86_CPU_186 && (emu->pcb[X86_PCB_PCR] & X86_PCB_PCR_MIO) != 0)
+	for(uint32_t i = 0; i < count && port + i <= 0xFFFF; i++)
 	{
-		// The 80186 checks for its internal registers
-		uaddr_t actual_count;
-		uint16_t pcb_port = (emu->pcb[X86_PCB_PCR] & X86_PCB_PCR_ADDRESS) << 8;
-		if(port < pcb_port)
+		uint16_t number = port + i;
+		if(emu->pcb_port_claimed && (uint16_t)(number - emu->pcb_port) < 0x100)
+			// the 80186 internal registers take precedence, the device becomes visible once they are relocated
+			emu->pcb_shadowed_ports[(uint16_t)(number - emu->pcb_port)] = handler;
+		else
+			emu->port_handlers[number] = handler;
+	}
+}
+
+static const x86_port_handler_t x86_cyrix_port_handler;
+
+void x86_port_input(x86_state_t * emu, uint16_t port, uint16_t count, void * buffer)
+{
+	uint8_t * bytes = buffer;
+
+	// the port might switch memory banks in the 8080 window
+	x80_memory_window_invalidate(emu);
+
+	if(emu->port_handlers == NULL)
+	{
+		emu->port22_accessed = false;
+		if(emu->port_read != NULL)
+			emu->port_read(emu, port, buffer, count);
+		return;
+	}
+
+	while(count > 0)
+	{
+		const x86_port_handler_t * handler = emu->port_handlers[port];
+		uint16_t actual_count = 1;
+
+		if(handler != &x86_cyrix_port_handler)
+			emu->port22_accessed = false;
+
+		if(handler == NULL)
 		{
-			actual_count = min(count, pcb_port - port);
+			// pass the entire unclaimed range in a single callback
+			while(actual_count < count && emu->port_handlers[(uint16_t)(port + actual_count)] == NULL)
+				actual_count++;
 			if(emu->port_read != NULL)
-				emu->port_read(emu, port, buffer, count);
-			if(actual_count == count)
-				return;
-			port = pcb_port;
-			buffer = (char *)buffer + actual_count;
-			count -= actual_count;
+				emu->port_read(emu, port, bytes, actual_count);
 		}
-
-		if(port < pcb_port + 0x100)
+		else if(count >= 4 && handler->read32 != NULL
+		&& emu->port_handlers[(uint16_t)(port + 1)] == handler
+		&& emu->port_handlers[(uint16_t)(port + 2)] == handler
+		&& emu->port_handlers[(uint16_t)(port + 3)] == handler)
 		{
-			actual_count = min(count, 0x100);
-			memcpy(buffer, (uint8_t *)emu->pcb + (port - pcb_port), actual_count);
-			if(actual_count == count)
-				return;
-			port += actual_count;
-			buffer = (char *)buffer + actual_count;
-			count -= actual_count;
+			uint32_t value = htole32(handler->read32(emu, handler->data, port));
+			actual_count = 4;
+			memcpy(bytes, &value, 4);
 		}
+		else if(count >= 2 && handler->read16 != NULL
+		&& emu->port_handlers[(uint16_t)(port + 1)] == handler)
+		{
+			uint16_t value = htole16(handler->read16(emu, handler->data, port));
+			actual_count = 2;
+			memcpy(bytes, &value, 2);
+		}
+		else if(handler->read8 != NULL)
+		{
+			bytes[0] = handler->read8(emu, handler->data, port);
+		}
+
+		port += actual_count;
+		bytes += actual_count;
+		count -= actual_count;
 	}
-	else if(emu->cpu_type == X86_CPU_V33)
+}
+
+void x86_port_output(x86_state_t * emu, uint16_t port, uint16_t count, const void * buffer)
+{
+	const uint8_t * bytes = buffer;
+
+	// the port might switch memory banks in the 8080 window
+	x80_memory_window_invalidate(emu);
+
+	if(emu->port_handlers == NULL)
 	{
-		// V33 internal registers
-		uaddr_t actual_count;
-		if(port < 0xFF00)
+		emu->port22_accessed = false;
+		if(emu->port_write != NULL)
+			emu->port_write(emu, port, buffer, count);
+		return;
+	}
+
+	while(count > 0)
+	{
+		const x86_port_handler_t * handler = emu->port_handlers[port];
+		uint16_t actual_count = 1;
+
+		if(handler != &x86_cyrix_port_handler)
+			emu->port22_accessed = false;
+
+		if(handler == NULL)
 		{
-			actual_count = min(count, 0xFF00 - port);
-			if(emu->port_read != NULL)
-				emu->port_read(emu, port, buffer, count);
-			if(actual_count == count)
-				return;
-			port = 0xFF00;
-			buffer = (char *)buffer + actual_count;
-			count -= actual_count;
+			// pass the entire unclaimed range in a single callback
+			while(actual_count < count && emu->port_handlers[(uint16_t)(port + actual_count)] == NULL)
+				actual_count++;
+			if(emu->port_write != NULL)
+				emu->port_write(emu, port, bytes, actual_count);
 		}
-
-		if(port < 0xFF81)
+		else if(count >= 4 && handler->write32 != NULL
+		&& emu->port_handlers[(uint16_t)(port + 1)] == handler
+		&& emu->port_handlers[(uint16_t)(port + 2)] == handler
+		&& emu->port_handlers[(uint16_t)(port + 3)] == handler)
 		{
-			actual_count = min(count, 0x81);
-			memcpy(buffer, &emu->v33_io[port - 0xFF00], actual_count);
-			if(actual_count == count)
-				return;
-			port += actual_count;
-			buffer = (char *)buffer + actual_count;
-			count -= actual_count;
+			uint32_t value;
+			memcpy(&value, bytes, 4);
+			actual_count = 4;
+			handler->write32(emu, handler->data, port, le32toh(value));
+		}
+		else if(count >= 2 && handler->write16 != NULL
+		&& emu->port_handlers[(uint16_t)(port + 1)] == handler)
+		{
+			uint16_t value;
+			memcpy(&value, bytes, 2);
+			actual_count = 2;
+			handler->write16(emu, handler->data, port, le16toh(value));
 		}
+		else if(handler->write8 != NULL)
+		{
+			handler->write8(emu, handler->data, port, bytes[0]);
+		}
+
+		port += actual_count;
+		bytes += actual_count;
+		count -= actual_count;
 	}
-	else if(emu->cpu_type == X86_CPU_CYRIX)
+}
+
+// 80186 peripheral control block, when mapped to I/O ports
+
+static uint8_t x86_pcb_port_read8(x86_state_t * emu, void * data, uint16_t port)
+{
+	(void) data;
+	uint8_t value;
+	x86_pcb_read(emu, port & 0xFF, 1, &value);
+	return value;
+}
+
+static uint16_t x86_pcb_port_read16(x86_state_t * emu, void * data, uint16_t port)
+{
+	if((port & 0xFF) != 0xFF)
+	{
+		uint16_t value;
+		x86_pcb_read(emu, port & 0xFF, 2, &value);
+		return le16toh(value);
+	}
+	else
+		return x86_pcb_port_read8(emu, data, port) | (x86_pcb_port_read8(emu, data, port + 1) << 8);
+}
+
+static void x86_pcb_port_write8(x86_state_t * emu, void * data, uint16_t port, uint8_t value)
+{
+	(void) data;
+	x86_pcb_write(emu, port & 0xFF, 1, &value);
+}
+
+static void x86_pcb_port_write16(x86_state_t * emu, void * data, uint16_t port, uint16_t value)
+{
+	if((port & 0xFF) != 0xFF)
+	{
+		// both bytes of the relocation register are written before the block moves
+		value = htole16(value);
+		x86_pcb_write(emu, port & 0xFF, 2, &value);
+	}
+	else
+	{
+		x86_pcb_port_write8(emu, data, port, value);
+		x86_pcb_port_write8(emu, data, port + 1, value >> 8);
+	}
+}
+
+static const x86_port_handler_t x86_pcb_port_handler =
+{
+	.read8 = x86_pcb_port_read8,
+	.write8 = x86_pcb_port_write8,
+	.read16 = x86_pcb_port_read16,
+	.write16 = x86_pcb_port_write16,
+};
+
+// Claims the I/O ports selected by the relocation register, restoring the devices at the previous location
+static void x86_pcb_update_ports(x86_state_t * emu)
+{
+	uint16_t pcr = le16toh(emu->pcb[X86_PCB_PCR]);
+	bool claimed = emu->cpu_type == X86_CPU_186 && (pcr & X86_PCB_PCR_MIO) != 0;
+	uint16_t pcb_port = (pcr & X86_PCB_PCR_ADDRESS) << 8;
+
+	if(claimed == emu->pcb_port_claimed && (!claimed || pcb_port == emu->pcb_port))
+		return;
+
+	if(emu->pcb_port_claimed)
+	{
+		emu->pcb_port_claimed = false;
+		for(int i = 0; i < 0x100; i++)
+			emu->port_handlers[(uint16_t)(emu->pcb_port + i)] = emu->pcb_shadowed_ports[i];
+	}
+
+	if(claimed)
 	{
-		// Cyrix configuration registers
-		if(port == 0x0023 && emu->port22_accessed)
+		// make sure the table exists
+		x86_port_register(emu, pcb_port, 0, &x86_pcb_port_handler);
+		for(int i = 0; i < 0x100; i++)
 		{
-			// otherwise, another I/O clears the access anyway
-			*(char *)buffer = x86_cyrix_register_get(emu, emu->port_number);
-			port += 1;
-			buffer = (char *)buffer + 1;
-			count -= 1;
+			emu->pcb_shadowed_ports[i] = emu->port_handlers[(uint16_t)(pcb_port + i)];
+			emu->port_handlers[(uint16_t)(pcb_port + i)] = &x86_pcb_port_handler;
 		}
-		emu->port22_accessed = false;
+		emu->pcb_port = pcb_port;
+		emu->pcb_port_claimed = true;
+	}
+}
 
-		if(count == 0)
-			return;
-		else
+// V33 internal registers
+
+static uint8_t x86_v33_port_read8(x86_state_t * emu, void * data, uint16_t port)
+{
+	(void) data;
+	return emu->v33_io[port - 0xFF00];
+}
+
+static void x86_v33_port_write8(x86_state_t * emu, void * data, uint16_t port, uint8_t value)
+{
+	(void) data;
+	emu->v33_io[port - 0xFF00] = value;
+}
+
+static const x86_port_handler_t x86_v33_port_handler =
+{
+	.read8 = x86_v33_port_read8,
+	.write8 = x86_v33_port_write8,
+};
+
+// Cyrix configuration registers, accessed by writing the index to port 0x22, then accessing port 0x23
+
+static uint8_t x86_cyrix_port_read8(x86_state_t * emu, void * data, uint16_t port)
+{
+	(void) data;
+	uint8_t value = 0;
+	if(port == 0x0023 && emu->port22_accessed)
+	{
+		value = x86_cyrix_register_get(emu, emu->port_number);
+	}
+	else if(emu->port_read != NULL)
+	{
+		emu->port_read(emu, port, &value, 1);
+	}
+	// any other I/O clears the access anyway
+	emu->port22_accessed = false;
+	return value;
+}
+
+static void x86_cyrix_port_write8(x86_state_t * emu, void * data, uint16_t port, uint8_t value)
+{
+	(void) data;
+	if(port == 0x0022)
+	{
+		emu->port_number = value;
+		switch(emu->cpu_traits.cpu_subtype)
+		{
+		case X86_CPU_CYRIX_CX486SLC:
+		case X86_CPU_CYRIX_CX486SLCE:
+			emu->port22_accessed = 0xC0 <= emu->port_number && emu->port_number <= 0xCF;
+			break;
+		case X86_CPU_CYRIX_5X86:
+		case X86_CPU_CYRIX_6X86:
+			emu->port22_accessed =
+				(0xC0 <= emu->port_number && emu->port_number <= 0xCF)
+				|| 0xFE <= emu->port_number
+				|| ((emu->ccr[3] & X86_CCR3_MAPEN_MASK) >> X86_CCR3_MAPEN_SHIFT) == 0x01;
+			break;
+		case X86_CPU_CYRIX_MEDIAGX:
+		case X86_CPU_CYRIX_GXM:
+		case X86_CPU_CYRIX_GX1:
+			emu->port22_accessed =
+				(0xC0 <= emu->port_number && emu->port_number <= 0xCF)
+				|| 0xFE <= emu->port_number
+				|| (emu->ccr[3] & X86_CCR3_MAPEN) != 0;
+			break;
+		default:
+		case X86_CPU_CYRIX_GX2:
+		case X86_CPU_CYRIX_LX:
 			emu->port22_accessed = false;
+			break;
+		case X86_CPU_CYRIX_M2:
+		case X86_CPU_CYRIX_III:
+			emu->port22_accessed =
+				(0xC0 <= emu->port_number && emu->port_number <= 0xCF)
+				|| 0xFE <= emu->port_number
+				|| ((emu->ccr[3] & X86_CCR3_MAPEN_MASK) >> X86_CCR3_MAPEN_SHIFT) != 0;
+			break;
+		}
 	}
+	else if(emu->port22_accessed)
+	{
+		x86_cyrix_register_set(emu, emu->port_number, value);
+		emu->port22_accessed = false;
+	}
+	else if(emu->port_write != NULL)
+	{
+		emu->port_write(emu, port, &value, 1);
+	}
+}
+
+static const x86_port_handler_t x86_cyrix_port_handler =
+{
+	.read8 = x86_cyrix_port_read8,
+	.write8 = x86_cyrix_port_write8,
+};
 
-	if(emu->port_read != NULL)
-		emu->port_read(emu, port, buffer, count);
+// Claims the I/O ports of the internal registers after reset
+static void x86_port_reset(x86_state_t * emu)
+{
+	if(emu->cpu_type == X86_CPU_V33)
+		x86_port_register(emu, 0xFF00, 0x81, &x86_v33_port_handler);
+	else if(emu->cpu_type == X86_CPU_CYRIX)
+		x86_port_register(emu, 0x0022, 2, &x86_cyrix_port_handler);
+	x86_pcb_update_ports(emu);
+}
+
+static inline void x86_input(x86_state_t * emu, uint16_t port, uint16_t count, void * buffer)
+{
+	x86_check_breakpoints(emu, X86_ACCESS_IO, port, count);
+	x86_port_input(emu, port, count, buffer);
 }
 
 static inline uint8_t x86_input8(x86_state_t * emu, uint16_t port)
@@ -1282,142 +1632,125 @@ static inline uint32_t x86_input32(x86_state_t * emu, uint16_t port)
 static inline void x86_output(x86_state_t * emu, uint16_t port, uint16_t count, const void * buffer)
 {
 	x86_check_breakpoints(emu, X86_ACCESS_IO, port, count);
+	x86_port_output(emu, port, count, buffer);
+}
 
-	if(emu->cpu_type == X86_CPU_186 && (emu->pcb[X86_PCB_PCR] & X86_PCB_PCR_MIO) != 0)
-	{
-		// The 80186 checks for its internal registers
-		uaddr_t actual_count;
-		uint16_t pcb_port = (emu->pcb[X86_PCB_PCR] & X86_PCB_PCR_ADDRESS) << 8;
-		if(port < pcb_port)
-		{
-			actual_count = min(count, pcb_port - port);
-			if(emu->port_write != NULL)
-				emu->port_write(emu, port, buffer, count);
-			if(actual_count == count)
-				return;
-			port = pcb_port;
-			buffer = (const char *)buffer + actual_count;
-			count -= actual_count;
-		}
+// Block transfers for REP INS/OUTS, used when the device provides block callbacks
+// Each transfer stays within a single page of guest memory, so that faults happen before the device is accessed
 
-		if(port < pcb_port + 0x100)
-		{
-			actual_count = min(count, 0x100);
-			memcpy((uint8_t *)emu->pcb + (port - pcb_port), buffer, actual_count);
-			if(actual_count == count)
-				return;
-			port += actual_count;
-			buffer = (const char *)buffer + actual_count;
-			count -= actual_count;
-		}
-	}
-	else if(emu->cpu_type == X86_CPU_V33)
-	{
-		// V33 internal registers
-		uaddr_t actual_count;
-		if(port < 0xFF00)
-		{
-			actual_count = min(count, 0xFF00 - port);
-			if(emu->port_write != NULL)
-				emu->port_write(emu, port, buffer, count);
-			if(actual_count == count)
-				return;
-			port = 0xFF00;
-			buffer = (const char *)buffer + actual_count;
-			count -= actual_count;
-		}
+#define X86_PORT_BLOCK_SIZE 0x1000
 
-		if(port < 0xFF81)
-		{
-			actual_count = min(count, 0x81);
-			memcpy(&emu->v33_io[port - 0xFF00], buffer, actual_count);
-			if(actual_count == count)
-				return;
-			port += actual_count;
-			buffer = (const char *)buffer + actual_count;
-			count -= actual_count;
-		}
-	}
-	else if(emu->cpu_type == X86_CPU_CYRIX)
+static inline const x86_port_handler_t * x86_port_get_block_handler(x86_state_t * emu, uint16_t port, unsigned size)
+{
+	if(emu->port_handlers == NULL)
+		return NULL;
+
+	const x86_port_handler_t * handler = emu->port_handlers[port];
+	for(unsigned i = 1; i < size; i++)
 	{
-		// Cyrix configuration registers
-		if(port < 0x0022)
-		{
-			size_t actual_count = min(count, 0x0022 - port);
-			emu->port_write(emu, port, buffer, actual_count);
-			if(actual_count == count)
-				return;
-			port += actual_count;
-			buffer = (const char *)buffer + actual_count;
-			count -= actual_count;
+		if(emu->port_handlers[(uint16_t)(port + i)] != handler)
+			return NULL;
+	}
+	return handler;
+}
 
-			emu->port22_accessed = true;
-		}
+// Number of elements that fit in the page, the address size and the segment limit
+static inline uoff_t x86_port_block_count(x86_state_t * emu, x86_segnum_t segment_number, uoff_t offset, uoff_t offset_mask, unsigned size, uoff_t count)
+{
+	uaddr_t linear = x86_memory_segmented_to_linear(emu, segment_number, offset);
+	uoff_t length = X86_PORT_BLOCK_SIZE - (linear & (X86_PORT_BLOCK_SIZE - 1));
+	uoff_t available;
 
-		if(port == 0x0022)
-		{
-			emu->port_number = *(const char *)buffer;
-			switch(emu->cpu_traits.cpu_subtype)
-			{
-			case X86_CPU_CYRIX_CX486SLC:
-			case X86_CPU_CYRIX_CX486SLCE:
-				emu->port22_accessed = 0xC0 <= emu->port_number && emu->port_number <= 0xCF;
-				break;
-			case X86_CPU_CYRIX_5X86:
-			case X86_CPU_CYRIX_6X86:
-				emu->port22_accessed =
-					(0xC0 <= emu->port_number && emu->port_number <= 0xCF)
-					|| 0xFE <= emu->port_number
-					|| ((emu->ccr[3] & X86_CCR3_MAPEN_MASK) >> X86_CCR3_MAPEN_SHIFT) == 0x01;
-				break;
-			case X86_CPU_CYRIX_MEDIAGX:
-			case X86_CPU_CYRIX_GXM:
-			case X86_CPU_CYRIX_GX1:
-				emu->port22_accessed =
-					(0xC0 <= emu->port_number && emu->port_number <= 0xCF)
-					|| 0xFE <= emu->port_number
-					|| (emu->ccr[3] & X86_CCR3_MAPEN) != 0;
-				break;
-			default:
-			case X86_CPU_CYRIX_GX2:
-			case X86_CPU_CYRIX_LX:
-				emu->port22_accessed = false;
-				break;
-			case X86_CPU_CYRIX_M2:
-			case X86_CPU_CYRIX_III:
-				emu->port22_accessed =
-					(0xC0 <= emu->port_number && emu->port_number <= 0xCF)
-					|| 0xFE <= emu->port_number
-					|| ((emu->ccr[3] & X86_CCR3_MAPEN_MASK) >> X86_CCR3_MAPEN_SHIFT) != 0;
-				break;
-			}
+	if(offset_mask - offset < length)
+		length = offset_mask - offset + 1;
+	available = x86_segment_get_available(emu, segment_number, offset);
+	if(available < length)
+		length = available;
 
-			if(emu->port22_accessed)
-			{
-				*(char *)buffer = x86_cyrix_register_get(emu, emu->port_number);
-				port += 1;
-				buffer = (char *)buffer + 1;
-				count -= 1;
-			}
-		}
+	return min(length / size, count);
+}
 
-		if(port == 0x0023 && emu->port22_accessed)
-		{
-			x86_cyrix_register_set(emu, emu->port_number, *(char *)buffer);
-			port += 1;
-			buffer = (char *)buffer + 1;
-			count -= 1;
-			emu->port22_accessed = false;
-		}
+// Returns the number of elements read into memory, 0 if the instruction must transfer a single element
+static inline uoff_t x86_input_block(x86_state_t * emu, x86_segnum_t segment_number, uoff_t offset, uoff_t offset_mask, uint16_t port, unsigned size, uoff_t count)
+{
+	const x86_port_handler_t * handler = x86_port_get_block_handler(emu, port, size);
+	if(handler == NULL || handler->read_block == NULL)
+		return 0;
 
-		if(count == 0)
-			return;
-		else
-			emu->port22_accessed = false;
+	count = x86_port_block_count(emu, segment_number, offset, offset_mask, size, count);
+	if(count < 2)
+		return 0;
+
+	uint8_t buffer[X86_PORT_BLOCK_SIZE];
+	uoff_t length;
+	x86_segment_check_write(emu, segment_number);
+	x86_page_translate(emu, x86_memory_segmented_to_linear(emu, segment_number, offset), true, false, emu->cpl == 3, &length, NULL);
+
+	x86_check_breakpoints(emu, X86_ACCESS_IO, port, size);
+	emu->port22_accessed = false;
+	handler->read_block(emu, handler->data, port, size, count, buffer);
+	x86_memory_segmented_write(emu, segment_number, offset, count * size, buffer);
+	return count;
+}
+
+// Returns the number of elements written from memory, 0 if the instruction must transfer a single element
+static inline uoff_t x86_output_block(x86_state_t * emu, x86_segnum_t segment_number, uoff_t offset, uoff_t offset_mask, uint16_t port, unsigned size, uoff_t count)
+{
+	const x86_port_handler_t * handler = x86_port_get_block_handler(emu, port, size);
+	if(handler == NULL || handler->write_block == NULL)
+		return 0;
+
+	count = x86_port_block_count(emu, segment_number, offset, offset_mask, size, count);
+	if(count < 2)
+		return 0;
+
+	uint8_t buffer[X86_PORT_BLOCK_SIZE];
+	x86_memory_segmented_read(emu, segment_number, offset, count * size, buffer);
+
+	x86_check_breakpoints(emu, X86_ACCESS_IO, port, size);
+	emu->port22_accessed = false;
+	handler->write_block(emu, handler->data, port, size, count, buffer);
+	return count;
+}
+
+static inline const x86_port_handler_t * x86_port_get_z80_block_handler(x86_state_t * emu, uint16_t port, size_t count)
+{
+	if(emu->port_handlers == NULL)
+		return NULL;
+
+	const x86_port_handler_t * handler = emu->port_handlers[port];
+	for(size_t i = 1; i < count; i++)
+	{
+		if(emu->port_handlers[(uint16_t)(port - (i << 8))] != handler)
+			return NULL;
 	}
+	return handler;
+}
+
+size_t x86_port_input_z80_block(x86_state_t * emu, uint16_t port, size_t count, void * buffer)
+{
+	const x86_port_handler_t * handler = x86_port_get_z80_block_handler(emu, port, count);
+	if(handler == NULL || handler->read_block == NULL)
+		return 0;
+
+	x80_memory_window_invalidate(emu);
+	x86_check_breakpoints(emu, X86_ACCESS_IO, port, 1);
+	emu->port22_accessed = false;
+	handler->read_block(emu, handler->data, port, 1, count, buffer);
+	return count;
+}
+
+size_t x86_port_output_z80_block(x86_state_t * emu, uint16_t port, size_t count, const void * buffer)
+{
+	const x86_port_handler_t * handler = x86_port_get_z80_block_handler(emu, port, count);
+	if(handler == NULL || handler->write_block == NULL)
+		return 0;
 
-	if(emu->port_write != NULL)
-		emu->port_write(emu, port, buffer, count);
+	x80_memory_window_invalidate(emu);
+	x86_check_breakpoints(emu, X86_ACCESS_IO, port, 1);
+	emu->port22_accessed = false;
+	handler->write_block(emu, handler->data, port, 1, count, buffer);
+	return count;
 }
 
 static inline void x86_output8(x86_state_t * emu, uint16_t port, uint8_t value)
@@ -1445,12 +1778,50 @@ static inline x86_state_t * _x80_get_x86(x80_state_t * emu)
 	return (void *)emu - offsetof(x86_state_t, x80);
 }
 
+// 8080 emulation mode on the V20/µPD9002: the 64 KiB address space is a single segment, so it is resolved to host memory once
+
+#define X80_WINDOW_INVALID ((uaddr_t)-1)
+
+static inline void x80_memory_window_invalidate(x86_state_t * emu)
+{
+	// the windows are resolved again before the next 8080 instruction
+	emu->x80.code_window_base = emu->x80.data_window_base = X80_WINDOW_INVALID;
+}
+
+static inline uint8_t * x80_memory_window_resolve(x86_state_t * emu, x86_segnum_t segment_number)
+{
+	if(emu->memory_get_pointer == NULL || !x86_is_real_mode(emu) || emu->sr[segment_number].limit < 0xFFFF)
+		return NULL;
+
+	if((emu->dr[7] & (X86_DR7_L0 | X86_DR7_G0 | X86_DR7_L1 | X86_DR7_G1 | X86_DR7_L2 | X86_DR7_G2 | X86_DR7_L3 | X86_DR7_G3)) != 0)
+		// breakpoints must be checked on every access
+		return NULL;
+
+	uaddr_t base = emu->sr[segment_number].base;
+	uaddr_t mask = x86_get_memory_mask(emu);
+	if(base > mask || mask - base < 0xFFFF)
+		// the segment wraps around the end of the address space
+		return NULL;
+
+	return emu->memory_get_pointer(emu, base, 0x10000);
+}
+
+static inline void x80_memory_window_update(x86_state_t * emu)
+{
+	emu->x80.code_window_base = emu->sr[X86_R_CS].base;
+	emu->x80.code_window = x80_memory_window_resolve(emu, X86_R_CS);
+	emu->x80.data_window_base = emu->sr[X86_R_DS].base;
+	emu->x80.data_window = x80_memory_window_resolve(emu, X86_R_DS);
+}
+
 // for emulated CPUs, reverts to x86 routines, otherwise it accesses its own callbacks
 
 static inline uint8_t x80_memory_read8(x80_state_t * emu, uint16_t address)
 {
 	if(emu->cpu_method == X80_CPUMETHOD_EMULATED)
 	{
+		if(emu->data_window != NULL)
+			return emu->data_window[address];
 		return x86_memory_segmented_read8(_x80_get_x86(emu), X86_R_DS, address);
 	}
 	else
@@ -1465,6 +1836,9 @@ static inline uint16_t x80_memory_read16(x80_state_t * emu, uint16_t address)
 {
 	if(emu->cpu_method == X80_CPUMETHOD_EMULATED)
 	{
+		// the last byte wraps around the segment
+		if(emu->data_window != NULL && address != 0xFFFF)
+			return le16toh(*(uint16_t *)&emu->data_window[address]);
 		return x86_memory_segmented_read16(_x80_get_x86(emu), X86_R_DS, address);
 	}
 	else
@@ -1479,7 +1853,15 @@ static inline void x80_memory_write8(x80_state_t * emu, uint16_t address, uint8_
 {
 	if(emu->cpu_method == X80_CPUMETHOD_EMULATED)
 	{
-		x86_memory_segmented_write8(_x80_get_x86(emu), X86_R_DS, address, value);
+		if(emu->data_window != NULL)
+		{
+			emu->data_window[address] = value;
+			x86_dirty_pages_mark(_x80_get_x86(emu), emu->data_window_base + address, 1);
+		}
+		else
+		{
+			x86_memory_segmented_write8(_x80_get_x86(emu), X86_R_DS, address, value);
+		}
 	}
 	else
 	{
@@ -1491,7 +1873,15 @@ static inline void x80_memory_write16(x80_state_t * emu, uint16_t address, uint1
 {
 	if(emu->cpu_method == X80_CPUMETHOD_EMULATED)
 	{
-		x86_memory_segmented_write16(_x80_get_x86(emu), X86_R_DS, address, value);
+		if(emu->data_window != NULL && address != 0xFFFF)
+		{
+			*(uint16_t *)&emu->data_window[address] = htole16(value);
+			x86_dirty_pages_mark(_x80_get_x86(emu), emu->data_window_base + address, 2);
+		}
+		else
+		{
+			x86_memory_segmented_write16(_x80_get_x86(emu), X86_R_DS, address, value);
+		}
 	}
 	else
 	{
@@ -1515,6 +1905,8 @@ static inline uint8_t x80_memory_fetch8(x80_state_t * emu)
 		emu->pc += 1;
 		if(emu->cpu_method == X80_CPUMETHOD_EMULATED)
 		{
+			if(emu->code_window != NULL)
+				return emu->code_window[pc];
 			return x86_memory_segmented_read8_exec(_x80_get_x86(emu), X86_R_CS, pc);
 		}
 		else
@@ -1547,6 +1939,8 @@ static inline uint16_t x80_memory_fetch16(x80_state_t * emu)
 		emu->pc += 2;
 		if(emu->cpu_method == X80_CPUMETHOD_EMULATED)
 		{
+			if(emu->code_window != NULL && pc != 0xFFFF)
+				return le16toh(*(uint16_t *)&emu->code_window[pc]);
 			return x86_memory_segmented_read16_exec(_x80_get_x86(emu), X86_R_CS, pc);
 		}
 		else
@@ -1582,3 +1976,62 @@ static inline void x80_output8(x80_state_t * emu, uint16_t port, uint8_t value)
 	}
 }
 
+// Block transfers for the Z80 block instructions, address + count must not exceed 0x10000
+
+static inline void x80_memory_read_block(x80_state_t * emu, uint16_t address, size_t count, void * buffer)
+{
+	if(emu->cpu_method == X80_CPUMETHOD_EMULATED)
+	{
+		if(emu->data_window != NULL)
+			memcpy(buffer, &emu->data_window[address], count);
+		else
+			x86_memory_segmented_read(_x80_get_x86(emu), X86_R_DS, address, count, buffer);
+	}
+	else
+	{
+		emu->memory_read(emu, address, buffer, count);
+	}
+}
+
+static inline void x80_memory_write_block(x80_state_t * emu, uint16_t address, size_t count, const void * buffer)
+{
+	if(emu->cpu_method == X80_CPUMETHOD_EMULATED)
+	{
+		if(emu->data_window != NULL)
+		{
+			memcpy(&emu->data_window[address], buffer, count);
+			x86_dirty_pages_mark(_x80_get_x86(emu), emu->data_window_base + address, count);
+		}
+		else
+		{
+			x86_memory_segmented_write(_x80_get_x86(emu), X86_R_DS, address, count, buffer);
+		}
+	}
+	else
+	{
+		emu->memory_write(emu, address, buffer, count);
+	}
+}
+
+// Returns the number of bytes read, 0 if they must be read one at a time
+static inline size_t x80_input_block(x80_state_t * emu, uint16_t port, size_t count, void * buffer)
+{
+	if(emu->cpu_method == X80_CPUMETHOD_EMULATED)
+		return x86_port_input_z80_block(_x80_get_x86(emu), port, count, buffer);
+	else if(emu->port_read_block != NULL)
+		return emu->port_read_block(emu, port, count, buffer);
+	else
+		return 0;
+}
+
+// Returns the number of bytes written, 0 if they must be written one at a time
+static inline size_t x80_output_block(x80_state_t * emu, uint16_t port, size_t count, const void * buffer)
+{
+	if(emu->cpu_method == X80_CPUMETHOD_EMULATED)
+		return x86_port_output_z80_block(_x80_get_x86(emu), port, count, buffer);
+	else if(emu->port_write_block != NULL)
+		return emu->port_write_block(emu, port, count, buffer);
+	else
+		return 0;
+}
+
@@ -1,9 +1,25 @@
 
 // Related to parsing and interpreting the instruction flow
 
+static const char x86_scale_text[4][4] = { "*1+", "*2+", "*4+", "*8+" };
+
+// Formats a memory operand as [segment:registers+offset], the registers are given with a trailing + if present
+static inline void x86_format_address_text(x86_parser_t * prs, const char * registers, uint32_t offset)
+{
+	size_t length = 0;
+	prs->address_text[length++] = '[';
+	length = debug_append_text(prs->address_text, sizeof prs->address_text, length, x86_segment_name(prs, prs->segment));
+	prs->address_text[length++] = ':';
+	length = debug_append_text(prs->address_text, sizeof prs->address_text, length, registers);
+	length = debug_append_number(prs->address_text, sizeof prs->address_text, length, offset, 16, 0);
+	if(length + 1 < sizeof prs->address_text)
+		prs->address_text[length++] = ']';
+	prs->address_text[length] = '\0';
+}
+
 static inline void x86_parse_modrm16(x86_parser_t * prs, x86_state_t * emu, bool execute)
 {
-	const char * format;
+	const char * registers;
 	int default_segment;
 	int disp_size = (prs->modrm_byte >> 6);
 	prs->register_field = (prs->modrm_byte >> 3) & 7;
@@ -16,37 +32,37 @@ static inline void x86_parse_modrm16(x86_parser_t * prs, x86_state_t * emu, bool
 		if(execute)
 			emu->parser->address_offset = x86_register_get16(emu, X86_R_BX) + x86_register_get16(emu, X86_R_SI);
 		default_segment = X86_R_DS;
-		format = prs->use_nec_syntax ? "[%s:bw+ix+%X]" : "[%s:bx+si+%X]";
+		registers = prs->use_nec_syntax ? "bw+ix+" : "bx+si+";
 		break;
 	case 1:
 		if(execute)
 			emu->parser->address_offset = x86_register_get16(emu, X86_R_BX) + x86_register_get16(emu, X86_R_DI);
 		default_segment = X86_R_DS;
-		format = prs->use_nec_syntax ? "[%s:bw+iy+%X]" : "[%s:bx+di+%X]";
+		registers = prs->use_nec_syntax ? "bw+iy+" : "bx+di+";
 		break;
 	case 2:
 		if(execute)
 			emu->parser->address_offset = x86_register_get16(emu, X86_R_BP) + x86_register_get16(emu, X86_R_SI);
 		default_segment = X86_R_SS;
-		format = prs->use_nec_syntax ? "[%s:bp+ix+%X]" : "[%s:bp+si+%X]";
+		registers = prs->use_nec_syntax ? "bp+ix+" : "bp+si+";
 		break;
 	case 3:
 		if(execute)
 			emu->parser->address_offset = x86_register_get16(emu, X86_R_BP) + x86_register_get16(emu, X86_R_DI);
 		default_segment = X86_R_SS;
-		format = prs->use_nec_syntax ? "[%s:bp+iy+%X]" : "[%s:bp+di+%X]";
+		registers = prs->use_nec_syntax ? "bp+iy+" : "bp+di+";
 		break;
 	case 4:
 		if(execute)
 			emu->parser->address_offset = x86_register_get16(emu, X86_R_SI);
 		default_segment = X86_R_DS;
-		format = prs->use_nec_syntax ? "[%s:ix+%X]" : "[%s:si+%X]";
+		registers = prs->use_nec_syntax ? "ix+" : "si+";
 		break;
 	case 5:
 		if(execute)
 			emu->parser->address_offset = x86_register_get16(emu, X86_R_DI);
 		default_segment = X86_R_DS;
-		format = prs->use_nec_syntax ? "[%s:iy+%X]" : "[%s:di+%X]";
+		registers = prs->use_nec_syntax ? "iy+" : "di+";
 		break;
 	case 6:
 		if(disp_size == 0)
@@ -55,21 +71,21 @@ static inline void x86_parse_modrm16(x86_parser_t * prs, x86_state_t * emu, bool
 				emu->parser->address_offset = 0;
 			default_segment = X86_R_DS;
 			disp_size = 2;
-			format = "[%s:%X]";
+			registers = "";
 		}
 		else
 		{
 			if(execute)
 				emu->parser->address_offset = x86_register_get16(emu, X86_R_BP);
 			default_segment = X86_R_SS;
-			format = "[%s:bp+%X]";
+			registers = "bp+";
 		}
 		break;
 	case 7:
 		if(execute)
 			emu->parser->address_offset = x86_register_get16(emu, X86_R_BX);
 		default_segment = X86_R_DS;
-		format = prs->use_nec_syntax ? "[%s:bw+%X]" : "[%s:bx+%X]";
+		registers = prs->use_nec_syntax ? "bw+" : "bx+";
 		break;
 	}
 
@@ -89,12 +105,12 @@ static inline void x86_parse_modrm16(x86_parser_t * prs, x86_state_t * emu, bool
 		prs->segment = default_segment;
 	}
 
-	sprintf(prs->address_text, format, x86_segment_name(prs, prs->segment), (int16_t)prs->address_offset);
+	x86_format_address_text(prs, registers, (int16_t)prs->address_offset);
 }
 
 static inline void x86_parse_modrm16_parser(x86_parser_t * prs)
 {
-	const char * format;
+	const char * registers;
 	int default_segment;
 	int disp_size = (prs->modrm_byte >> 6);
 	prs->register_field = (prs->modrm_byte >> 3) & 7;
@@ -105,44 +121,44 @@ static inline void x86_parse_modrm16_parser(x86_parser_t * prs)
 	{
 	case 0:
 		default_segment = X86_R_DS;
-		format = prs->use_nec_syntax ? "[%s:bw+ix+%X]" : "[%s:bx+si+%X]";
+		registers = prs->use_nec_syntax ? "bw+ix+" : "bx+si+";
 		break;
 	case 1:
 		default_segment = X86_R_DS;
-		format = prs->use_nec_syntax ? "[%s:bw+iy+%X]" : "[%s:bx+di+%X]";
+		registers = prs->use_nec_syntax ? "bw+iy+" : "bx+di+";
 		break;
 	case 2:
 		default_segment = X86_R_SS;
-		format = prs->use_nec_syntax ? "[%s:bp+ix+%X]" : "[%s:bp+si+%X]";
+		registers = prs->use_nec_syntax ? "bp+ix+" : "bp+si+";
 		break;
 	case 3:
 		default_segment = X86_R_SS;
-		format = prs->use_nec_syntax ? "[%s:bp+iy+%X]" : "[%s:bp+di+%X]";
+		registers = prs->use_nec_syntax ? "bp+iy+" : "bp+di+";
 		break;
 	case 4:
 		default_segment = X86_R_DS;
-		format = prs->use_nec_syntax ? "[%s:ix+%X]" : "[%s:si+%X]";
+		registers = prs->use_nec_syntax ? "ix+" : "si+";
 		break;
 	case 5:
 		default_segment = X86_R_DS;
-		format = prs->use_nec_syntax ? "[%s:iy+%X]" : "[%s:di+%X]";
+		registers = prs->use_nec_syntax ? "iy+" : "di+";
 		break;
 	case 6:
 		if(disp_size == 0)
 		{
 			default_segment = X86_R_DS;
 			disp_size = 2;
-			format = "[%s:%X]";
+			registers = "";
 		}
 		else
 		{
 			default_segment = X86_R_SS;
-			format = "[%s:bp+%X]";
+			registers = "bp+";
 		}
 		break;
 	case 7:
 		default_segment = X86_R_DS;
-		format = prs->use_nec_syntax ? "[%s:bw+%X]" : "[%s:bx+%X]";
+		registers = prs->use_nec_syntax ? "bw+" : "bx+";
 		break;
 	}
 
@@ -162,7 +178,7 @@ static inline void x86_parse_modrm16_parser(x86_parser_t * prs)
 		prs->segment = default_segment;
 	}
 
-	sprintf(prs->address_text, format, x86_segment_name(prs, prs->segment), (int16_t)prs->address_offset);
+	x86_format_address_text(prs, registers, (int16_t)prs->address_offset);
 }
 
 static inline void x86_parse_modrm16_emulator(x86_state_t * emu)
@@ -238,7 +254,7 @@ static inline void x86_parse_modrm16_emulator(x86_state_t * emu)
 
 static inline void x86_parse_modrm32(x86_parser_t * prs, x86_state_t * emu, bool execute)
 {
-	char format[24];
+	char registers[24];
 	int default_segment;
 	int disp_size = (prs->modrm_byte >> 6);
 	int reg = prs->modrm_byte & 7;
@@ -278,16 +294,17 @@ static inline void x86_parse_modrm32(x86_parser_t * prs, x86_state_t * emu, bool
 			default_segment = reg == 4 || reg == 5 ? X86_R_SS : X86_R_DS;
 		}
 
-		strcpy(format, "[%s:");
+		registers[0] = '\0';
 		if(!(reg == 5 && disp_size == 0))
 		{
-			snprintf(format + strlen(format), sizeof(format) - strlen(format), "%s+", x86_register_name32(prs, reg));
+			strcat(registers, x86_register_name32(prs, reg));
+			strcat(registers, "+");
 		}
 		if(i != 4)
 		{
-			snprintf(format + strlen(format), sizeof(format) - strlen(format), "%s*%d+", x86_register_name32(prs, i), 1 << s);
+			strcat(registers, x86_register_name32(prs, i));
+			strcat(registers, x86_scale_text[s]);
 		}
-		strcat(format, "%X]");
 	}
 	else if((reg & 7) == 5 && disp_size == 0)
 	{
@@ -295,14 +312,15 @@ static inline void x86_parse_modrm32(x86_parser_t * prs, x86_state_t * emu, bool
 			emu->parser->address_offset = 0;
 		default_segment = X86_R_DS;
 		disp_size = 2;
-		strcpy(format, "[%s:%X]");
+		registers[0] = '\0';
 	}
 	else
 	{
 		if(execute)
 			emu->parser->address_offset = x86_register_get32(emu, reg);
 		default_segment = reg == 5 ? X86_R_SS : X86_R_DS;
-		snprintf(format, sizeof format, "[%%s:%s+%%X]", x86_register_name32(prs, reg));
+		strcpy(registers, x86_register_name32(prs, reg));
+		strcat(registers, "+");
 	}
 
 	switch(disp_size)
@@ -321,12 +339,12 @@ static inline void x86_parse_modrm32(x86_parser_t * prs, x86_state_t * emu, bool
 		prs->segment = default_segment;
 	}
 
-	sprintf(prs->address_text, format, x86_segment_name(prs, prs->segment), (int32_t)prs->address_offset);
+	x86_format_address_text(prs, registers, (int32_t)prs->address_offset);
 }
 
 static inline void x86_parse_modrm32_parser(x86_parser_t * prs)
 {
-	char format[24];
+	char registers[24];
 	int default_segment;
 	int disp_size = (prs->modrm_byte >> 6);
 	int reg = prs->modrm_byte & 7;
@@ -352,27 +370,29 @@ static inline void x86_parse_modrm32_parser(x86_parser_t * prs)
 			default_segment = reg == 4 || reg == 5 ? X86_R_SS : X86_R_DS;
 		}
 
-		strcpy(format, "[%s:");
+		registers[0] = '\0';
 		if(!(reg == 5 && disp_size == 0))
 		{
-			snprintf(format + strlen(format), sizeof(format) - strlen(format), "%s+", x86_register_name32(prs, reg));
+			strcat(registers, x86_register_name32(prs, reg));
+			strcat(registers, "+");
 		}
 		if(i != 4)
 		{
-			snprintf(format + strlen(format), sizeof(format) - strlen(format), "%s*%d+", x86_register_name32(prs, i), 1 << s);
+			strcat(registers, x86_register_name32(prs, i));
+			strcat(registers, x86_scale_text[s]);
 		}
-		strcat(format, "%X]");
 	}
 	else if((reg & 7) == 5 && disp_size == 0)
 	{
 		default_segment = X86_R_DS;
 		disp_size = 2;
-		strcpy(format, "[%s:%X]");
+		registers[0] = '\0';
 	}
 	else
 	{
 		default_segment = reg == 5 ? X86_R_SS : X86_R_DS;
-		snprintf(format, sizeof format, "[%%s:%s+%%X]", x86_register_name32(prs, reg));
+		strcpy(registers, x86_register_name32(prs, reg));
+		strcat(registers, "+");
 	}
 
 	switch(disp_size)
@@ -391,7 +411,7 @@ static inline void x86_parse_modrm32_parser(x86_parser_t * prs)
 		prs->segment = default_segment;
 	}
 
-	sprintf(prs->address_text, format, x86_segment_name(prs, prs->segment), (int32_t)prs->address_offset);
+	x86_format_address_text(prs, registers, (int32_t)prs->address_offset);
 }
 
 static inline void x86_parse_modrm32_emulator(x86_state_t * emu)
@@ -463,7 +483,7 @@ static inline void x86_parse_modrm32_emulator(x86_state_t * emu)
 
 static inline void x86_parse_modrm64_32(x86_parser_t * prs, x86_state_t * emu, bool execute)
 {
-	char format[24];
+	char registers[24];
 	int disp_size = (prs->modrm_byte >> 6);
 	int reg = prs->modrm_byte & 7;
 	int32_t displacement = 0;
@@ -505,28 +525,30 @@ static inline void x86_parse_modrm64_32(x86_parser_t * prs, x86_state_t * emu, b
 				emu->parser->address_offset += x86_register_get32(emu, reg);
 		}
 
-		strcpy(format, "[%s:");
+		registers[0] = '\0';
 		if(!((reg & 7) == 5 && disp_size == 0))
 		{
-			snprintf(format + strlen(format), sizeof(format) - strlen(format), "%s+", x86_register_name32(prs, reg));
+			strcat(registers, x86_register_name32(prs, reg));
+			strcat(registers, "+");
 		}
 		if(i != 4)
 		{
-			snprintf(format + strlen(format), sizeof(format) - strlen(format), "%s*%d+", x86_register_name32(prs, i), 1 << s);
+			strcat(registers, x86_register_name32(prs, i));
+			strcat(registers, x86_scale_text[s]);
 		}
-		strcat(format, "%X]");
 	}
 	else if((reg & 7) == 5 && disp_size == 0)
 	{
 		prs->ip_relative = true;
 		disp_size = 2;
-		strcpy(format, "[%s:eip+%X]");
+		strcpy(registers, "eip+");
 	}
 	else
 	{
 		if(execute)
 			emu->parser->address_offset = x86_register_get32(emu, reg);
-		snprintf(format, sizeof format, "[%%s:%s+%%X]", x86_register_name32(prs, reg));
+		strcpy(registers, x86_register_name32(prs, reg));
+		strcat(registers, "+");
 	}
 
 	switch(disp_size)
@@ -545,12 +567,12 @@ static inline void x86_parse_modrm64_32(x86_parser_t * prs, x86_state_t * emu, b
 		prs->segment = X86_R_DS;
 	}
 
-	sprintf(prs->address_text, format, x86_segment_name(prs, prs->segment), (int32_t)displacement);
+	x86_format_address_text(prs, registers, (int32_t)displacement);
 }
 
 static inline void x86_parse_modrm64_32_parser(x86_parser_t * prs)
 {
-	char format[24];
+	char registers[24];
 	int disp_size = (prs->modrm_byte >> 6);
 	int reg = prs->modrm_byte & 7;
 	int32_t displacement = 0;
@@ -575,26 +597,28 @@ static inline void x86_parse_modrm64_32_parser(x86_parser_t * prs)
 			disp_size = 2;
 		}
 
-		strcpy(format, "[%s:");
+		registers[0] = '\0';
 		if(!((reg & 7) == 5 && disp_size == 0))
 		{
-			snprintf(format + strlen(format), sizeof(format) - strlen(format), "%s+", x86_register_name32(prs, reg));
+			strcat(registers, x86_register_name32(prs, reg));
+			strcat(registers, "+");
 		}
 		if(i != 4)
 		{
-			snprintf(format + strlen(format), sizeof(format) - strlen(format), "%s*%d+", x86_register_name32(prs, i), 1 << s);
+			strcat(registers, x86_register_name32(prs, i));
+			strcat(registers, x86_scale_text[s]);
 		}
-		strcat(format, "%X]");
 	}
 	else if((reg & 7) == 5 && disp_size == 0)
 	{
 		prs->ip_relative = true;
 		disp_size = 2;
-		strcpy(format, "[%s:eip+%X]");
+		strcpy(registers, "eip+");
 	}
 	else
 	{
-		snprintf(format, sizeof format, "[%%s:%s+%%X]", x86_register_name32(prs, reg));
+		strcpy(registers, x86_register_name32(prs, reg));
+		strcat(registers, "+");
 	}
 
 	switch(disp_size)
@@ -613,7 +637,7 @@ static inline void x86_parse_modrm64_32_parser(x86_parser_t * prs)
 		prs->segment = X86_R_DS;
 	}
 
-	sprintf(prs->address_text, format, x86_segment_name(prs, prs->segment), (int32_t)displacement);
+	x86_format_address_text(prs, registers, (int32_t)displacement);
 }
 
 static inline void x86_parse_modrm64_32_emulator(x86_state_t * emu)
@@ -685,7 +709,7 @@ static inline void x86_parse_modrm64_32_emulator(x86_state_t * emu)
 
 static inline void x86_parse_modrm64(x86_parser_t * prs, x86_state_t * emu, bool execute)
 {
-	char format[24];
+	char registers[24];
 	int disp_size = (prs->modrm_byte >> 6);
 	int reg = prs->modrm_byte & 7;
 	int32_t displacement = 0;
@@ -727,28 +751,30 @@ static inline void x86_parse_modrm64(x86_parser_t * prs, x86_state_t * emu, bool
 				emu->parser->address_offset += x86_register_get64(emu, reg);
 		}
 
-		strcpy(format, "[%s:");
+		registers[0] = '\0';
 		if(!((reg & 7) == 5 && disp_size == 0))
 		{
-			snprintf(format + strlen(format), sizeof(format) - strlen(format), "%s+", x86_register_name64(prs, reg));
+			strcat(registers, x86_register_name64(prs, reg));
+			strcat(registers, "+");
 		}
 		if(i != 4)
 		{
-			snprintf(format + strlen(format), sizeof(format) - strlen(format), "%s*%d+", x86_register_name64(prs, i), 1 << s);
+			strcat(registers, x86_register_name64(prs, i));
+			strcat(registers, x86_scale_text[s]);
 		}
-		strcat(format, "%X]");
 	}
 	else if((reg & 7) == 5 && disp_size == 0)
 	{
 		prs->ip_relative = true;
 		disp_size = 2;
-		strcpy(format, "[%s:rip+%X]");
+		strcpy(registers, "rip+");
 	}
 	else
 	{
 		if(execute)
 			emu->parser->address_offset = x86_register_get64(emu, reg);
-		snprintf(format, sizeof format, "[%%s:%s+%%X]", x86_register_name64(prs, reg));
+		strcpy(registers, x86_register_name64(prs, reg));
+		strcat(registers, "+");
 	}
 
 	switch(disp_size)
@@ -766,12 +792,12 @@ static inline void x86_parse_modrm64(x86_parser_t * prs, x86_state_t * emu, bool
 		prs->segment = X86_R_DS;
 	}
 
-	sprintf(prs->address_text, format, x86_segment_name(prs, prs->segment), (int32_t)displacement);
+	x86_format_address_text(prs, registers, (int32_t)displacement);
 }
 
 static inline void x86_parse_modrm64_parser(x86_parser_t * prs)
 {
-	char format[24];
+	char registers[24];
 	int disp_size = (prs->modrm_byte >> 6);
 	int reg = prs->modrm_byte & 7;
 	int32_t displacement = 0;
@@ -796,26 +822,28 @@ static inline void x86_parse_modrm64_parser(x86_parser_t * prs)
 			disp_size = 2;
 		}
 
-		strcpy(format, "[%s:");
+		registers[0] = '\0';
 		if(!((reg & 7) == 5 && disp_size == 0))
 		{
-			snprintf(format + strlen(format), sizeof(format) - strlen(format), "%s+", x86_register_name64(prs, reg));
+			strcat(registers, x86_register_name64(prs, reg));
+			strcat(registers, "+");
 		}
 		if(i != 4)
 		{
-			snprintf(format + strlen(format), sizeof(format) - strlen(format), "%s*%d+", x86_register_name64(prs, i), 1 << s);
+			strcat(registers, x86_register_name64(prs, i));
+			strcat(registers, x86_scale_text[s]);
 		}
-		strcat(format, "%X]");
 	}
 	else if((reg & 7) == 5 && disp_size == 0)
 	{
 		prs->ip_relative = true;
 		disp_size = 2;
-		strcpy(format, "[%s:rip+%X]");
+		strcpy(registers, "rip+");
 	}
 	else
 	{
-		snprintf(format, sizeof format, "[%%s:%s+%%X]", x86_register_name64(prs, reg));
+		strcpy(registers, x86_register_name64(prs, reg));
+		strcat(registers, "+");
 	}
 
 	switch(disp_size)
@@ -833,7 +861,7 @@ static inline void x86_parse_modrm64_parser(x86_parser_t * prs)
 		prs->segment = X86_R_DS;
 	}
 
-	sprintf(prs->address_text, format, x86_segment_name(prs, prs->segment), (int32_t)displacement);
+	x86_format_address_text(prs, registers, (int32_t)displacement);
 }
 
 static inline void x86_parse_modrm64_emulator(x86_state_t * emu)
@@ -1107,7 +1135,12 @@ static inline void x86_undefined_instruction(x86_state_t * emu)
 #define _sub_overflow32(x, y, z) (((((x) & ~(y) & ~(z)) | (~(x) & (y) & (z))) & 0x80000000) != 0)
 #define _sub_overflow64(x, y, z) (((((x) & ~(y) & ~(z)) | (~(x) & (y) & (z))) & 0x8000000000000000) != 0)
 
-#define DEBUG(...) do { debug_printf((prs)->debug_output, __VA_ARGS__); } while(0) // TODO: better type
+#define DEBUG(...) do { debug_printf((prs)->debug_output, &(prs)->debug_length, __VA_ARGS__); } while(0) // TODO: better type
+// used by the generated parser, appending the fragments of the format separately
+#define DEBUG_TEXT(text) debug_text((prs)->debug_output, &(prs)->debug_length, text, sizeof(text) - 1)
+#define DEBUG_STRING(text) debug_string((prs)->debug_output, &(prs)->debug_length, text)
+#define DEBUG_HEX(value) debug_hex((prs)->debug_output, &(prs)->debug_length, value)
+#define DEBUG_DECIMAL(value) debug_decimal((prs)->debug_output, &(prs)->debug_length, value)
 
 // Called when the instruction is not defined, returns without any action
 #define UNDEFINED_PARSE() \
@@ -1160,6 +1193,14 @@ static inline void x86_undefined_instruction(x86_state_t * emu)
 		} \
 	} while(0)
 
+// Placed at the start of every instruction form in the step functions, identifiers are assigned by generate.py
+#if X86_OPCODE_COUNTERS
+extern uint64_t x86_opcode_counters[];
+# define COUNT_OPCODE(id) (x86_opcode_counters[id] ++)
+#else
+# define COUNT_OPCODE(id) ((void)0)
+#endif
+
 // Should be called before I/O instructions, only relevant for v25/v55
 #define IO_PRIVILEGED() \
 	do \
@@ -1168,6 +1209,9 @@ static inline void x86_undefined_instruction(x86_state_t * emu)
 			x86_trigger_interrupt(emu, X86_EXC_IO() | X86_EXC_FAULT, 0); \
 	} while(0)
 
+// Should be called before accessing I/O ports, checks IOPL and the I/O permission bitmap in protected mode
+#define IO_PERMITTED(port, count) x86_check_io_permission(emu, port, count)
+
 #define REGFLDVAL(prs) (((prs)->modrm_byte >> 3) & 7)
 #define REGFLD(prs) (REGFLDVAL(prs) | ((prs)->rex_r))
 #define REGFLDLOCK(prs) (REGFLDVAL(prs) | ((prs)->rex_r) | ((prs)->lock_prefix ? 8 : 0))
@@ -1244,13 +1288,13 @@ static inline void x86_undefined_instruction(x86_state_t * emu)
 #define _trget32(x) x86_test_register_get32(emu, x)
 #define _trset32(x,y) x86_test_register_set32(emu, x, y)
 
-#define X80_CHECK_C(emu)  (((emu)->bank[0].af & X86_FL_CF) != 0)
+#define X80_CHECK_C(emu)  (((emu)->bank[(emu)->af_bank].af & X86_FL_CF) != 0)
 #define X80_CHECK_NC(emu) (!X80_CHECK_C(emu))
-#define X80_CHECK_Z(emu)  (((emu)->bank[0].af & X86_FL_ZF) != 0)
+#define X80_CHECK_Z(emu)  (((emu)->bank[(emu)->af_bank].af & X86_FL_ZF) != 0)
 #define X80_CHECK_NZ(emu) (!X80_CHECK_Z(emu))
-#define X80_CHECK_M(emu)  (((emu)->bank[0].af & X86_FL_SF) != 0)
+#define X80_CHECK_M(emu)  (((emu)->bank[(emu)->af_bank].af & X86_FL_SF) != 0)
 #define X80_CHECK_P(emu)  (!X80_CHECK_M(emu))
-#define X80_CHECK_PE(emu) (((emu)->bank[0].af & X86_FL_PF) != 0)
+#define X80_CHECK_PE(emu) (((emu)->bank[(emu)->af_bank].af & X86_FL_PF) != 0)
 #define X80_CHECK_PO(emu) (!X80_CHECK_PE(emu))
 
 #define _jmpf(seg, off) x86_jump_far(emu, seg, off)
@@ -1464,8 +1508,12 @@ static inline void x87_execute(x86_state_t * emu, bool sync, uint16_t fop, uint1
 #include "x86.gen.c"
 
 #undef DEBUG
+#undef DEBUG_TEXT
+#undef DEBUG_STRING
+#undef DEBUG_HEX
+#undef DEBUG_DECIMAL
 
-#define DEBUG(...) do { if(disassemble) debug_printf((emu) ? (emu)->parser->debug_output : (prs)->debug_output, __VA_ARGS__); } while(0) // TODO: better type
+#define DEBUG(...) do { if(disassemble) debug_printf((emu) ? (emu)->parser->debug_output : (prs)->debug_output, (emu) ? &(emu)->parser->debug_length : &(prs)->debug_length, __VA_ARGS__); } while(0) // TODO: better type
 
 static inline void x89_parse(x89_parser_t * prs, x86_state_t * emu, unsigned channel_number, bool disassemble, bool execute)
 {
@@ -2411,5 +2459,5 @@ restart:
 
 #undef DEBUG
 
-#define DEBUG(...) do { debug_printf((prs)->debug_output, __VA_ARGS__); } while(0) // TODO: better type
+#define DEBUG(...) do { debug_printf((prs)->debug_output, &(prs)->debug_length, __VA_ARGS__); } while(0) // TODO: better type
 
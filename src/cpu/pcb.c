@@ -0,0 +1,669 @@
+
+//// 80186 on-chip peripherals: timers, DMA channels and interrupt controller
+
+/*
+	The peripherals are not stepped along with the CPU
+	Their registers in the peripheral control block are brought up to date when they are accessed, and when the clock reaches pcb_deadline,
+	the earliest point something happens without the CPU looking: a timer interrupt, a DMA transfer requested by timer 2, a running
+	unsynchronized DMA transfer or a pending interrupt request
+	When all of them are idle, the deadline is never reached, and the CPU loop only advances the clock
+*/
+
+// The emulation does not count cycles, this is a typical instruction length on the 80186
+#define X86_PCB_CLOCKS_PER_STEP 8
+// Internally clocked timers count every fourth CPU clock
+#define X86_PCB_TIMER_PRESCALE 4
+// Unsynchronized DMA without a terminal count is run in chunks of this size per step
+#define X86_PCB_DMA_BLOCK_SIZE 0x1000
+#define X86_PCB_NEVER UINT64_MAX
+
+static inline uint16_t x86_pcb_get(x86_state_t * emu, unsigned index)
+{
+	return le16toh(emu->pcb[index]);
+}
+
+static inline void x86_pcb_set(x86_state_t * emu, unsigned index, uint16_t value)
+{
+	emu->pcb[index] = htole16(value);
+}
+
+// Timers
+
+static inline unsigned x86_pcb_timer_register(unsigned timer, unsigned reg)
+{
+	return X86_PCB_T0CNT + 4 * timer + reg;
+}
+
+// Number of input ticks of the compare register in use (first) and the one used after it (second)
+static inline void x86_pcb_timer_periods(x86_state_t * emu, unsigned timer, uint32_t * first, uint32_t * second)
+{
+	uint16_t control = x86_pcb_get(emu, x86_pcb_timer_register(timer, X86_PCB_TCON));
+	uint32_t a = x86_pcb_get(emu, x86_pcb_timer_register(timer, X86_PCB_TCMPA));
+	if(a == 0)
+		a = 0x10000;
+
+	if(timer == 2 || (control & X86_PCB_TCON_ALT) == 0)
+	{
+		*first = *second = a;
+		return;
+	}
+
+	uint32_t b = x86_pcb_get(emu, x86_pcb_timer_register(timer, X86_PCB_TCMPB));
+	if(b == 0)
+		b = 0x10000;
+
+	if((control & X86_PCB_TCON_RIU) == 0)
+	{
+		*first = a;
+		*second = b;
+	}
+	else
+	{
+		*first = b;
+		*second = a;
+	}
+}
+
+// Number of input ticks until the timer next reaches its maximum count, 0 if it is stopped
+static inline uint32_t x86_pcb_timer_distance(x86_state_t * emu, unsigned timer)
+{
+	if((x86_pcb_get(emu, x86_pcb_timer_register(timer, X86_PCB_TCON)) & X86_PCB_TCON_EN) == 0)
+		return 0;
+
+	uint32_t first, second;
+	x86_pcb_timer_periods(emu, timer, &first, &second);
+	// a count beyond the maximum wraps around first
+	return ((first - x86_pcb_get(emu, x86_pcb_timer_register(timer, X86_PCB_TCNT)) - 1) & 0xFFFF) + 1;
+}
+
+// Advances a timer by a number of input ticks, returns how many times it reached its maximum count
+static inline uint64_t x86_pcb_timer_advance(x86_state_t * emu, unsigned timer, uint64_t ticks)
+{
+	uint16_t control = x86_pcb_get(emu, x86_pcb_timer_register(timer, X86_PCB_TCON));
+	if((control & X86_PCB_TCON_EN) == 0 || ticks == 0)
+		return 0;
+
+	uint32_t distance = x86_pcb_timer_distance(emu, timer);
+	if(ticks < distance)
+	{
+		x86_pcb_set(emu, x86_pcb_timer_register(timer, X86_PCB_TCNT), x86_pcb_get(emu, x86_pcb_timer_register(timer, X86_PCB_TCNT)) + ticks);
+		return 0;
+	}
+
+	uint32_t first, second;
+	x86_pcb_timer_periods(emu, timer, &first, &second);
+	bool alternate = timer != 2 && (control & X86_PCB_TCON_ALT) != 0;
+	uint64_t expirations = 1;
+	uint64_t count;
+
+	ticks -= distance;
+	if((control & X86_PCB_TCON_CONT) != 0)
+	{
+		// after the first expiration, the compare registers follow each other
+		uint64_t cycle = alternate ? (uint64_t)first + second : second;
+		expirations += (ticks / cycle) * (alternate ? 2 : 1);
+		count = ticks % cycle;
+		if(alternate && count >= second)
+		{
+			expirations++;
+			count -= second;
+		}
+	}
+	else if(alternate && (control & X86_PCB_TCON_RIU) == 0 && ticks < second)
+	{
+		// single run through both compare registers, continuing with the second one
+		count = ticks;
+	}
+	else
+	{
+		if(alternate && (control & X86_PCB_TCON_RIU) == 0)
+			expirations++;
+		count = 0;
+		control &= ~X86_PCB_TCON_EN;
+	}
+
+	if(alternate && (expirations & 1) != 0)
+		control ^= X86_PCB_TCON_RIU;
+	control |= X86_PCB_TCON_MC;
+	x86_pcb_set(emu, x86_pcb_timer_register(timer, X86_PCB_TCON), control);
+	x86_pcb_set(emu, x86_pcb_timer_register(timer, X86_PCB_TCNT), count);
+
+	if((control & X86_PCB_TCON_INT) != 0)
+	{
+		x86_pcb_set(emu, X86_PCB_INSTS, x86_pcb_get(emu, X86_PCB_INSTS) | (X86_PCB_INSTS_IRT0 << timer));
+		x86_pcb_set(emu, X86_PCB_REQST, x86_pcb_get(emu, X86_PCB_REQST) | X86_PCB_INT_TMR);
+	}
+
+	return expirations;
+}
+
+// DMA channels
+
+static inline unsigned x86_pcb_dma_register(unsigned channel, unsigned reg)
+{
+	return X86_PCB_D0SRCL + 8 * channel + reg;
+}
+
+static inline bool x86_pcb_dma_active(x86_state_t * emu, unsigned channel)
+{
+	return (x86_pcb_get(emu, x86_pcb_dma_register(channel, X86_PCB_DCON)) & X86_PCB_DCON_ST) != 0
+		&& (x86_pcb_get(emu, X86_PCB_INSTS) & X86_PCB_INSTS_DHLT) == 0;
+}
+
+// Unsynchronized channels transfer continuously, the others wait for a request
+static inline bool x86_pcb_dma_unsynchronized(x86_state_t * emu, unsigned channel)
+{
+	return (x86_pcb_get(emu, x86_pcb_dma_register(channel, X86_PCB_DCON)) & (X86_PCB_DCON_SYN_MASK | X86_PCB_DCON_TDRQ)) == 0;
+}
+
+static inline uaddr_t x86_pcb_dma_get_address(x86_state_t * emu, unsigned index)
+{
+	return x86_pcb_get(emu, index) | ((uaddr_t)(x86_pcb_get(emu, index + 1) & 0xF) << 16);
+}
+
+static inline void x86_pcb_dma_set_address(x86_state_t * emu, unsigned index, uaddr_t address)
+{
+	x86_pcb_set(emu, index, address);
+	x86_pcb_set(emu, index + 1, (address >> 16) & 0xF);
+}
+
+// Address increment per transfer, from the increment and decrement bits of the control register
+static inline int x86_pcb_dma_step(uint16_t control, uint16_t increment, uint16_t decrement, unsigned size)
+{
+	if((control & (increment | decrement)) == increment)
+		return size;
+	else if((control & (increment | decrement)) == decrement)
+		return -(int)size;
+	else
+		return 0;
+}
+
+// Number of elements that can be accessed as a single block, incrementing memory addresses stay within a page
+// Devices are only accessed as a block through a fixed port that provides block callbacks
+static inline uint32_t x86_pcb_dma_run(x86_state_t * emu, bool memory, uaddr_t address, int step, unsigned size, bool input, const x86_port_handler_t ** handler)
+{
+	if(memory)
+	{
+		if(step <= 0)
+			return 1;
+		return (X86_PCB_DMA_BLOCK_SIZE - (address & (X86_PCB_DMA_BLOCK_SIZE - 1))) / size;
+	}
+
+	if(step != 0)
+		return 1;
+	*handler = x86_port_get_block_handler(emu, (uint16_t)address, size);
+	if(*handler == NULL || (input ? (*handler)->read_block == NULL : (*handler)->write_block == NULL))
+	{
+		*handler = NULL;
+		return 1;
+	}
+	return X86_PCB_DMA_BLOCK_SIZE / size;
+}
+
+// Performs up to count transfers on a channel, stopping when the transfer count terminates it
+static void x86_pcb_dma_transfer(x86_state_t * emu, unsigned channel, uint64_t count)
+{
+	uint16_t control = x86_pcb_get(emu, x86_pcb_dma_register(channel, X86_PCB_DCON));
+	unsigned size = (control & X86_PCB_DCON_BW) != 0 ? 2 : 1;
+	bool source_memory = (control & X86_PCB_DCON_SMIO) != 0;
+	bool destination_memory = (control & X86_PCB_DCON_DMIO) != 0;
+	int source_step = x86_pcb_dma_step(control, X86_PCB_DCON_SINC, X86_PCB_DCON_SDEC, size);
+	int destination_step = x86_pcb_dma_step(control, X86_PCB_DCON_DINC, X86_PCB_DCON_DDEC, size);
+	uaddr_t source = x86_pcb_dma_get_address(emu, x86_pcb_dma_register(channel, X86_PCB_DSRCL));
+	uaddr_t destination = x86_pcb_dma_get_address(emu, x86_pcb_dma_register(channel, X86_PCB_DDSTL));
+	uint32_t transfer_count = x86_pcb_get(emu, x86_pcb_dma_register(channel, X86_PCB_DTC));
+	bool terminated = false;
+	uint8_t buffer[X86_PCB_DMA_BLOCK_SIZE];
+
+	if((control & X86_PCB_DCON_TC) != 0)
+		count = min(count, transfer_count == 0 ? 0x10000 : transfer_count);
+
+	while(count > 0)
+	{
+		const x86_port_handler_t * source_handler = NULL;
+		const x86_port_handler_t * destination_handler = NULL;
+		uint64_t run = min(count, x86_pcb_dma_run(emu, source_memory, source, source_step, size, true, &source_handler));
+		run = min(run, x86_pcb_dma_run(emu, destination_memory, destination, destination_step, size, false, &destination_handler));
+
+		if(source_memory && destination_memory && source < destination && destination - source < run * size)
+		{
+			// the source must not be read after it was overwritten
+			run = (destination - source) / size;
+		}
+
+		if(run < 2)
+		{
+			run = 1;
+			source_handler = destination_handler = NULL;
+		}
+
+		if(source_memory)
+		{
+			x86_memory_read_external(emu, source, run * size, buffer);
+		}
+		else if(source_handler != NULL)
+		{
+			x86_check_breakpoints(emu, X86_ACCESS_IO, (uint16_t)source, size);
+			emu->port22_accessed = false;
+			source_handler->read_block(emu, source_handler->data, (uint16_t)source, size, run, buffer);
+		}
+		else
+		{
+			x86_input(emu, (uint16_t)source, size, buffer);
+		}
+
+		if(destination_memory)
+		{
+			x86_memory_write_external(emu, destination, run * size, buffer);
+		}
+		else if(destination_handler != NULL)
+		{
+			x86_check_breakpoints(emu, X86_ACCESS_IO, (uint16_t)destination, size);
+			emu->port22_accessed = false;
+			destination_handler->write_block(emu, destination_handler->data, (uint16_t)destination, size, run, buffer);
+		}
+		else
+		{
+			x86_output(emu, (uint16_t)destination, size, buffer);
+		}
+
+		source = (source + source_step * run) & (source_memory ? 0xFFFFF : 0xFFFF);
+		destination = (destination + destination_step * run) & (destination_memory ? 0xFFFFF : 0xFFFF);
+		transfer_count = (transfer_count - run) & 0xFFFF;
+		count -= run;
+
+		if((control & X86_PCB_DCON_TC) != 0 && transfer_count == 0)
+		{
+			terminated = true;
+			break;
+		}
+	}
+
+	x86_pcb_dma_set_address(emu, x86_pcb_dma_register(channel, X86_PCB_DSRCL), source);
+	x86_pcb_dma_set_address(emu, x86_pcb_dma_register(channel, X86_PCB_DDSTL), destination);
+	x86_pcb_set(emu, x86_pcb_dma_register(channel, X86_PCB_DTC), transfer_count);
+
+	if(terminated)
+	{
+		x86_pcb_set(emu, x86_pcb_dma_register(channel, X86_PCB_DCON), x86_pcb_get(emu, x86_pcb_dma_register(channel, X86_PCB_DCON)) & ~X86_PCB_DCON_ST);
+		if((control & X86_PCB_DCON_INT) != 0)
+			x86_pcb_set(emu, X86_PCB_REQST, x86_pcb_get(emu, X86_PCB_REQST) | (channel == 0 ? X86_PCB_INT_D0 : X86_PCB_INT_D1));
+	}
+}
+
+// Interrupt controller (master mode)
+
+// Control register of an interrupt source, given as its bit number in the request register
+static inline unsigned x86_pcb_interrupt_control(unsigned source)
+{
+	return X86_PCB_TCUCON + (source == 0 ? 0 : source - 1);
+}
+
+static inline int x86_pcb_interrupt_priority(x86_state_t * emu, unsigned source)
+{
+	return x86_pcb_get(emu, x86_pcb_interrupt_control(source)) & X86_PCB_INTCON_PR;
+}
+
+// Returns the requesting source with the highest priority that is neither masked nor blocked by an interrupt in service, -1 if there is none
+static inline int x86_pcb_interrupt_source(x86_state_t * emu)
+{
+	uint16_t requests = x86_pcb_get(emu, X86_PCB_REQST) & ~x86_pcb_get(emu, X86_PCB_IMASK) & X86_PCB_INT_SOURCES;
+	if(requests == 0)
+		return -1;
+
+	uint16_t in_service = x86_pcb_get(emu, X86_PCB_INSERV) & X86_PCB_INT_SOURCES;
+	int limit = x86_pcb_get(emu, X86_PCB_PRIMSK) & X86_PCB_INTCON_PR;
+	for(unsigned source = 0; source < 8; source++)
+	{
+		if((in_service & (1 << source)) != 0 && x86_pcb_interrupt_priority(emu, source) <= limit)
+			limit = x86_pcb_interrupt_priority(emu, source) - 1;
+	}
+
+	// on equal priority, the lower bit wins
+	int result = -1;
+	for(unsigned source = 0; source < 8; source++)
+	{
+		if((requests & (1 << source)) != 0 && x86_pcb_interrupt_priority(emu, source) <= limit)
+		{
+			limit = x86_pcb_interrupt_priority(emu, source) - 1;
+			result = source;
+		}
+	}
+	return result;
+}
+
+static inline uint8_t x86_pcb_interrupt_vector(x86_state_t * emu, unsigned source)
+{
+	switch(source)
+	{
+	case 0:
+		if((x86_pcb_get(emu, X86_PCB_INSTS) & X86_PCB_INSTS_IRT0) != 0)
+			return X86_EXC_TIMER0;
+		else if((x86_pcb_get(emu, X86_PCB_INSTS) & (X86_PCB_INSTS_IRT0 << 1)) != 0)
+			return X86_EXC_TIMER1;
+		else
+			return X86_EXC_TIMER2;
+	case 2:
+		return X86_EXC_DMA0;
+	case 3:
+		return X86_EXC_DMA1;
+	default:
+		return X86_EXC_INT0 + source - 4;
+	}
+}
+
+// Moves a request into service, on an interrupt acknowledge or when the poll register is read
+static inline void x86_pcb_interrupt_acknowledge(x86_state_t * emu, unsigned source)
+{
+	x86_pcb_set(emu, X86_PCB_INSERV, x86_pcb_get(emu, X86_PCB_INSERV) | (1 << source));
+	if(source == 0)
+	{
+		// the timers share a request, each one has its own status bit
+		uint16_t status = x86_pcb_get(emu, X86_PCB_INSTS);
+		status &= ~(status & -status & (X86_PCB_INSTS_IRT0 * 7));
+		x86_pcb_set(emu, X86_PCB_INSTS, status);
+		if((status & (X86_PCB_INSTS_IRT0 * 7)) != 0)
+			return;
+	}
+	x86_pcb_set(emu, X86_PCB_REQST, x86_pcb_get(emu, X86_PCB_REQST) & ~(1 << source));
+}
+
+static inline void x86_pcb_interrupt_end(x86_state_t * emu, uint16_t value)
+{
+	uint16_t in_service = x86_pcb_get(emu, X86_PCB_INSERV) & X86_PCB_INT_SOURCES;
+	int source = -1;
+
+	if((value & X86_PCB_EOI_NSPEC) != 0)
+	{
+		// nonspecific, the source in service with the highest priority
+		int priority = X86_PCB_INTCON_PR + 1;
+		for(unsigned bit = 0; bit < 8; bit++)
+		{
+			if((in_service & (1 << bit)) != 0 && x86_pcb_interrupt_priority(emu, bit) < priority)
+			{
+				priority = x86_pcb_interrupt_priority(emu, bit);
+				source = bit;
+			}
+		}
+	}
+	else
+	{
+		switch(value & X86_PCB_EOI_TYPE)
+		{
+		case X86_EXC_TIMER0:
+		case X86_EXC_TIMER1:
+		case X86_EXC_TIMER2:
+			source = 0;
+			break;
+		case X86_EXC_DMA0:
+			source = 2;
+			break;
+		case X86_EXC_DMA1:
+			source = 3;
+			break;
+		case X86_EXC_INT0:
+		case X86_EXC_INT1:
+		case X86_EXC_INT2:
+		case X86_EXC_INT3:
+			source = (value & X86_PCB_EOI_TYPE) - X86_EXC_INT0 + 4;
+			break;
+		}
+	}
+
+	if(source >= 0)
+		x86_pcb_set(emu, X86_PCB_INSERV, in_service & ~(1 << source));
+}
+
+// Attempts to interrupt the CPU with the pending request
+static inline void x86_pcb_interrupt(x86_state_t * emu)
+{
+	int source = x86_pcb_interrupt_source(emu);
+	if(source < 0)
+		return;
+
+	if(x86_hardware_interrupt(emu, x86_pcb_interrupt_vector(emu, source), 0, NULL))
+		x86_pcb_interrupt_acknowledge(emu, source);
+}
+
+// Scheduling
+
+// Computes the clock of the next event that must not wait until the registers are accessed
+static void x86_pcb_schedule(x86_state_t * emu)
+{
+	uint64_t deadline = X86_PCB_NEVER;
+	uint64_t tick = emu->pcb_synchronized_clock / X86_PCB_TIMER_PRESCALE;
+
+	if(x86_pcb_interrupt_source(emu) >= 0)
+	{
+		// retried on every step until the CPU accepts it
+		emu->pcb_deadline = emu->pcb_clock;
+		return;
+	}
+
+	bool timer2_requests = (x86_pcb_get(emu, x86_pcb_timer_register(2, X86_PCB_TCON)) & X86_PCB_TCON_INT) != 0;
+	for(unsigned channel = 0; channel < 2; channel++)
+	{
+		if(!x86_pcb_dma_active(emu, channel))
+			continue;
+		if(x86_pcb_dma_unsynchronized(emu, channel))
+		{
+			emu->pcb_deadline = emu->pcb_clock;
+			return;
+		}
+		if((x86_pcb_get(emu, x86_pcb_dma_register(channel, X86_PCB_DCON)) & X86_PCB_DCON_TDRQ) != 0)
+			timer2_requests = true;
+	}
+
+	uint32_t prescaler_distance = x86_pcb_timer_distance(emu, 2);
+	uint32_t prescaler_period, unused;
+	x86_pcb_timer_periods(emu, 2, &prescaler_period, &unused);
+	bool prescaler_repeats = (x86_pcb_get(emu, x86_pcb_timer_register(2, X86_PCB_TCON)) & X86_PCB_TCON_CONT) != 0;
+
+	if(timer2_requests && prescaler_distance != 0)
+		deadline = (tick + prescaler_distance) * X86_PCB_TIMER_PRESCALE;
+
+	for(unsigned timer = 0; timer < 2; timer++)
+	{
+		uint16_t control = x86_pcb_get(emu, x86_pcb_timer_register(timer, X86_PCB_TCON));
+		// external clock inputs are not connected
+		if((control & (X86_PCB_TCON_EN | X86_PCB_TCON_INT | X86_PCB_TCON_EXT)) != (X86_PCB_TCON_EN | X86_PCB_TCON_INT))
+			continue;
+
+		uint64_t ticks = x86_pcb_timer_distance(emu, timer);
+		if((control & X86_PCB_TCON_P) != 0)
+		{
+			// counts the times timer 2 reaches its maximum count
+			if(prescaler_distance == 0 || (ticks > 1 && !prescaler_repeats))
+				continue;
+			ticks = prescaler_distance + (ticks - 1) * prescaler_period;
+		}
+
+		if((tick + ticks) * X86_PCB_TIMER_PRESCALE < deadline)
+			deadline = (tick + ticks) * X86_PCB_TIMER_PRESCALE;
+	}
+
+	emu->pcb_deadline = deadline;
+}
+
+// Brings the timers and the DMA channels requested by timer 2 up to the current clock
+static void x86_pcb_synchronize(x86_state_t * emu)
+{
+	uint64_t ticks = emu->pcb_clock / X86_PCB_TIMER_PRESCALE - emu->pcb_synchronized_clock / X86_PCB_TIMER_PRESCALE;
+	emu->pcb_synchronized_clock = emu->pcb_clock;
+
+	if(ticks != 0)
+	{
+		uint64_t prescaled = x86_pcb_timer_advance(emu, 2, ticks);
+		for(unsigned timer = 0; timer < 2; timer++)
+		{
+			uint16_t control = x86_pcb_get(emu, x86_pcb_timer_register(timer, X86_PCB_TCON));
+			x86_pcb_timer_advance(emu, timer,
+				(control & X86_PCB_TCON_EXT) != 0 ? 0 : (control & X86_PCB_TCON_P) != 0 ? prescaled : ticks);
+		}
+
+		for(unsigned channel = 0; channel < 2 && prescaled != 0; channel++)
+		{
+			// one transfer each time timer 2 reaches its maximum count
+			if(x86_pcb_dma_active(emu, channel) && (x86_pcb_get(emu, x86_pcb_dma_register(channel, X86_PCB_DCON)) & X86_PCB_DCON_TDRQ) != 0)
+				x86_pcb_dma_transfer(emu, channel, min(prescaled, 0x10000));
+		}
+	}
+
+	x86_pcb_schedule(emu);
+}
+
+// Called from x86_step when the clock reaches the deadline
+static void x86_pcb_expire(x86_state_t * emu)
+{
+	x86_pcb_synchronize(emu);
+
+	for(unsigned channel = 0; channel < 2; channel++)
+	{
+		if(x86_pcb_dma_active(emu, channel) && x86_pcb_dma_unsynchronized(emu, channel))
+			x86_pcb_dma_transfer(emu, channel, X86_PCB_DMA_BLOCK_SIZE);
+	}
+
+	// no interrupt is accepted right after an instruction that loads SS or sets IF,
+	// or one whose result the caller still has to act on, such as an interrupt serviced by the host
+	switch(X86_RESULT_TYPE(emu->emulation_result))
+	{
+	case X86_RESULT_SUCCESS:
+	case X86_RESULT_STRING:
+		x86_pcb_interrupt(emu);
+		break;
+	default:
+		break;
+	}
+
+	x86_pcb_schedule(emu);
+}
+
+// Register access
+
+static inline void x86_pcb_register_written(x86_state_t * emu, unsigned index, uint16_t old_value)
+{
+	uint16_t value = x86_pcb_get(emu, index);
+	switch(index)
+	{
+	case X86_PCB_EOI:
+		x86_pcb_interrupt_end(emu, value);
+		break;
+	case X86_PCB_POLL:
+	case X86_PCB_POLLSTS:
+		x86_pcb_set(emu, index, old_value);
+		break;
+	case X86_PCB_IMASK:
+		// the mask bits are shared with the control registers
+		for(unsigned source = 0; source < 8; source++)
+		{
+			if((X86_PCB_INT_SOURCES & (1 << source)) == 0)
+				continue;
+			uint16_t control = x86_pcb_get(emu, x86_pcb_interrupt_control(source));
+			x86_pcb_set(emu, x86_pcb_interrupt_control(source),
+				(value & (1 << source)) != 0 ? control | X86_PCB_INTCON_MSK : control & ~X86_PCB_INTCON_MSK);
+		}
+		break;
+	case X86_PCB_TCUCON:
+	case X86_PCB_TCUCON + 1:
+	case X86_PCB_TCUCON + 2:
+	case X86_PCB_TCUCON + 3:
+	case X86_PCB_TCUCON + 4:
+	case X86_PCB_TCUCON + 5:
+	case X86_PCB_TCUCON + 6:
+		{
+			unsigned source = index == X86_PCB_TCUCON ? 0 : index - X86_PCB_TCUCON + 1;
+			uint16_t mask = x86_pcb_get(emu, X86_PCB_IMASK);
+			x86_pcb_set(emu, X86_PCB_IMASK, (value & X86_PCB_INTCON_MSK) != 0 ? mask | (1 << source) : mask & ~(1 << source));
+		}
+		break;
+	case X86_PCB_INSTS:
+	case X86_PCB_REQST:
+		// the timer request follows the timer status bits
+		if((x86_pcb_get(emu, X86_PCB_INSTS) & (X86_PCB_INSTS_IRT0 * 7)) != 0)
+			x86_pcb_set(emu, X86_PCB_REQST, x86_pcb_get(emu, X86_PCB_REQST) | X86_PCB_INT_TMR);
+		else
+			x86_pcb_set(emu, X86_PCB_REQST, x86_pcb_get(emu, X86_PCB_REQST) & ~X86_PCB_INT_TMR);
+		break;
+	case X86_PCB_T0CNT + X86_PCB_TCON:
+	case X86_PCB_T0CNT + 4 + X86_PCB_TCON:
+	case X86_PCB_T0CNT + 8 + X86_PCB_TCON:
+		// EN is only written along with INH, RIU is read only
+		if((value & X86_PCB_TCON_INH) == 0)
+			value = (value & ~X86_PCB_TCON_EN) | (old_value & X86_PCB_TCON_EN);
+		value = (value & ~(X86_PCB_TCON_INH | X86_PCB_TCON_RIU)) | (old_value & X86_PCB_TCON_RIU);
+		x86_pcb_set(emu, index, value);
+		break;
+	case X86_PCB_D0SRCL + X86_PCB_DCON:
+	case X86_PCB_D0SRCL + 8 + X86_PCB_DCON:
+		// ST is only written along with CHG
+		if((value & X86_PCB_DCON_CHG) == 0)
+			value = (value & ~X86_PCB_DCON_ST) | (old_value & X86_PCB_DCON_ST);
+		x86_pcb_set(emu, index, value & ~X86_PCB_DCON_CHG);
+		break;
+	case X86_PCB_PCR:
+		x86_pcb_update_ports(emu);
+		break;
+	}
+}
+
+// Reads from the peripheral control block, offset + count must not exceed its size
+static void x86_pcb_read(x86_state_t * emu, unsigned offset, unsigned count, void * buffer)
+{
+	unsigned first = offset >> 1;
+	unsigned last = (offset + count - 1) >> 1;
+	bool poll = first <= X86_PCB_POLL && X86_PCB_POLL <= last;
+	int source = -1;
+
+	x86_pcb_synchronize(emu);
+
+	if(poll || (first <= X86_PCB_POLLSTS && X86_PCB_POLLSTS <= last))
+	{
+		source = x86_pcb_interrupt_source(emu);
+		uint16_t status = source < 0 ? 0 : X86_PCB_POLL_INTREQ | x86_pcb_interrupt_vector(emu, source);
+		x86_pcb_set(emu, X86_PCB_POLL, status);
+		x86_pcb_set(emu, X86_PCB_POLLSTS, status);
+	}
+
+	memcpy(buffer, (uint8_t *)emu->pcb + offset, count);
+
+	if(poll && source >= 0)
+	{
+		// reading the poll register acknowledges the interrupt
+		x86_pcb_interrupt_acknowledge(emu, source);
+		x86_pcb_schedule(emu);
+	}
+}
+
+// Writes to the peripheral control block, offset + count must not exceed its size
+static void x86_pcb_write(x86_state_t * emu, unsigned offset, unsigned count, const void * buffer)
+{
+	uint16_t old_values[sizeof emu->pcb / sizeof emu->pcb[0]];
+
+	x86_pcb_synchronize(emu);
+
+	memcpy(old_values, emu->pcb, sizeof old_values);
+	memcpy((uint8_t *)emu->pcb + offset, buffer, count);
+	for(unsigned index = offset >> 1; index <= (offset + count - 1) >> 1; index++)
+		x86_pcb_register_written(emu, index, le16toh(old_values[index]));
+
+	x86_pcb_schedule(emu);
+}
+
+static void x86_pcb_reset(x86_state_t * emu)
+{
+	x86_pcb_set(emu, X86_PCB_IMASK, X86_PCB_INT_SOURCES);
+	x86_pcb_set(emu, X86_PCB_PRIMSK, X86_PCB_INTCON_PR);
+	x86_pcb_set(emu, X86_PCB_INSERV, 0);
+	x86_pcb_set(emu, X86_PCB_REQST, 0);
+	x86_pcb_set(emu, X86_PCB_INSTS, 0);
+	for(unsigned index = X86_PCB_TCUCON; index <= X86_PCB_TCUCON + 6; index++)
+		x86_pcb_set(emu, index, X86_PCB_INTCON_MSK | X86_PCB_INTCON_PR);
+	for(unsigned timer = 0; timer < 3; timer++)
+		x86_pcb_set(emu, x86_pcb_timer_register(timer, X86_PCB_TCON), 0);
+	for(unsigned channel = 0; channel < 2; channel++)
+		x86_pcb_set(emu, x86_pcb_dma_register(channel, X86_PCB_DCON), x86_pcb_get(emu, x86_pcb_dma_register(channel, X86_PCB_DCON)) & ~X86_PCB_DCON_ST);
+
+	emu->pcb_synchronized_clock = emu->pcb_clock;
+	emu->pcb_deadline = X86_PCB_NEVER;
+}
+
@@ -144,7 +144,7 @@ static inline unsigned x86_descriptor_get_dpl(uint8_t * descriptor)
 	return x86_access_get_dpl(x86_descriptor_get_word(descriptor, X86_DESCWORD_ACCESS));
 }
 
-static inline bool x86_descriptor_get_parameter_count(uint8_t * descriptor)
+static inline unsigned x86_descriptor_get_parameter_count(uint8_t * descriptor)
 {
 	// only for 16/32-bit call gate
 	return x86_descriptor_get_word(descriptor, X86_DESCWORD_ACCESS) & 0x1F;
@@ -356,6 +356,32 @@ static inline void x86_segment_check_limit(x86_state_t * emu, x86_segnum_t segme
 	}
 }
 
+// Number of bytes from offset that can be accessed without exceeding the segment limit, used to bound block transfers
+static inline uoff_t x86_segment_get_available(x86_state_t * emu, x86_segnum_t segment_number, uoff_t offset)
+{
+	if(x86_is_64bit_mode(emu))
+	{
+		if((emu->efer & X86_EFER_LMSLE) && segment_number != X86_R_CS && segment_number != X86_R_GS)
+			return 0;
+		return UADDR_MAX;
+	}
+	else if(emu->cpu_type >= X86_CPU_286)
+	{
+		if(x86_segment_is_executable(&emu->sr[segment_number]) || !x86_segment_is_expand_down(&emu->sr[segment_number]))
+			return offset <= emu->sr[segment_number].limit ? emu->sr[segment_number].limit - offset + 1 : 0;
+		else if(offset <= emu->sr[segment_number].limit)
+			return 0;
+		else if(emu->cpu_type >= X86_CPU_386 && x86_segment_is_big(&emu->sr[segment_number]))
+			return (uoff_t)0xFFFFFFFF - offset + 1;
+		else
+			return offset <= 0xFFFF ? 0xFFFF - offset + 1 : 0;
+	}
+	else
+	{
+		return UADDR_MAX;
+	}
+}
+
 // 80287 and 80387 invoke a separate interrupt when accessing beyond the first 2 bytes of the memory operand fails
 static inline void x87_segment_check_limit(x86_state_t * emu, x86_segnum_t segment_number, uoff_t x86_offset, uoff_t offset, uoff_t size, uoff_t error_code)
 {
@@ -535,10 +561,11 @@ static inline void x86_descriptor_load_extension(x86_state_t * emu, uint16_t sel
 
 static inline void x86_segment_load_protected_mode_286(x86_state_t * emu, x86_segnum_t segment_number, uint16_t selector, uint8_t * descriptor)
 {
-	if((descriptor[X86_DESCBYTE_ACCESS] & (X86_DESC_A >> 8)) != 0)
+	// system descriptors use the same bit for their type
+	if(!x86_descriptor_is_system_segment(descriptor) && (descriptor[X86_DESCBYTE_ACCESS] & (X86_DESC_A >> 8)) == 0)
 	{
 		descriptor[X86_DESCBYTE_ACCESS] |= X86_DESC_A >> 8;
-		x86_descriptor_write_selector(emu, segment_number, X86_DESCBYTE_ACCESS, &descriptor[X86_DESCBYTE_ACCESS], 1);
+		x86_descriptor_write_selector(emu, selector, X86_DESCBYTE_ACCESS, &descriptor[X86_DESCBYTE_ACCESS], 1);
 	}
 
 	emu->sr[segment_number].selector = selector;
@@ -555,10 +582,11 @@ static inline void x86_segment_load_protected_mode_286(x86_state_t * emu, x86_se
 
 static inline void x86_segment_load_protected_mode_386(x86_state_t * emu, x86_segnum_t segment_number, uint16_t selector, uint8_t * descriptor)
 {
-	if((descriptor[X86_DESCBYTE_ACCESS] & (X86_DESC_A >> 8)) != 0)
+	// system descriptors use the same bit for their type
+	if(!x86_descriptor_is_system_segment(descriptor) && (descriptor[X86_DESCBYTE_ACCESS] & (X86_DESC_A >> 8)) == 0)
 	{
 		descriptor[X86_DESCBYTE_ACCESS] |= X86_DESC_A >> 8;
-		x86_descriptor_write_selector(emu, segment_number, X86_DESCBYTE_ACCESS, &descriptor[X86_DESCBYTE_ACCESS], 1);
+		x86_descriptor_write_selector(emu, selector, X86_DESCBYTE_ACCESS, &descriptor[X86_DESCBYTE_ACCESS], 1);
 	}
 
 	emu->sr[segment_number].selector = selector;
@@ -681,10 +709,7 @@ static inline void x86_ldtr_load_switch_task(x86_state_t * emu, uint16_t selecto
 	uint8_t descriptor[8];
 	if(x86_selector_is_null(selector))
 	{
-		if(x86_overflow(0, 0, emu->sr[X86_R_GDTR].limit))
-		{
-			x86_trigger_interrupt(emu, X86_EXC_TS | X86_EXC_FAULT | X86_EXC_VALUE, selector);
-		}
+		// tasks without an LDT are permitted
 		x86_segment_load_null(emu, X86_R_LDTR, selector);
 	}
 	else
@@ -754,6 +779,7 @@ static inline void x86_tr_load(x86_state_t * emu, uint16_t selector)
 
 		descriptor[X86_DESCBYTE_ACCESS] |= X86_DESC_BUSY >> 8;
 		x86_descriptor_write_selector(emu, selector, X86_DESCBYTE_ACCESS, &descriptor[X86_DESCBYTE_ACCESS], 1);
+		emu->tss_bitmaps_valid = false;
 
 		if(x86_is_long_mode(emu))
 		{
@@ -848,9 +874,13 @@ static inline void x86_segment_set(x86_state_t * emu, x86_segnum_t segment_numbe
 		x86_ia64_intercept(emu, 0); // TODO
 }
 
-static inline void x86_segment_set_switch_task(x86_state_t * emu, x86_segnum_t segment_number, uint16_t value)
+/*
+	Identical to x86_segment_set, except issues TS instead of GP (except if not present), and only valid in non-long mode
+	If cached is not NULL, it holds the descriptor for the same selector that was already read during the task switch
+	The descriptor used is stored into loaded, for the following segment registers
+*/
+static inline void x86_segment_set_switch_task(x86_state_t * emu, x86_segnum_t segment_number, uint16_t value, const uint8_t * cached, uint8_t * loaded)
 {
-	// identical to x86_segment_set, except issues TS instead of GP (except if not present), and only valid in non-long mode
 	if(x86_is_virtual_8086_mode(emu))
 	{
 		x86_segment_load_real_mode_full(emu, segment_number, value);
@@ -871,8 +901,11 @@ static inline void x86_segment_set_switch_task(x86_state_t * emu, x86_segnum_t s
 			return;
 		}
 
-		uint8_t descriptor[8];
-		x86_descriptor_load(emu, value, descriptor, X86_EXC_GP);
+		uint8_t * descriptor = loaded;
+		if(cached != NULL)
+			memcpy(descriptor, cached, 8);
+		else
+			x86_descriptor_load(emu, value, descriptor, X86_EXC_GP);
 
 		// TODO: assert D=1?
 
@@ -982,7 +1015,7 @@ static inline uint32_t x86_load_access_rights32(uint8_t * descriptor)
 //// Task switching
 static inline uoff_t x86_load_task_stack16(x86_state_t * emu, int dpl, uint16_t * ss)
 {
-	if(x86_overflow(emu->sr[X86_R_TR].base, dpl * 4 + 4, emu->sr[X86_R_TR].limit))
+	if(x86_overflow(dpl * 4 + 2, 4, emu->sr[X86_R_TR].limit))
 		x86_trigger_interrupt(emu, X86_EXC_TS | X86_EXC_FAULT | X86_EXC_VALUE, emu->sr[X86_R_TR].selector);
 	*ss = x86_memory_segmented_read16(emu, X86_R_TR, dpl * 4 + 4);
 	return x86_memory_segmented_read16(emu, X86_R_TR, dpl * 4 + 2);
@@ -990,7 +1023,7 @@ static inline uoff_t x86_load_task_stack16(x86_state_t * emu, int dpl, uint16_t
 
 static inline uoff_t x86_load_task_stack32(x86_state_t * emu, int dpl, uint16_t * ss)
 {
-	if(x86_overflow(emu->sr[X86_R_TR].base, dpl * 4 + 8, emu->sr[X86_R_TR].limit))
+	if(x86_overflow(dpl * 8 + 4, 6, emu->sr[X86_R_TR].limit))
 		x86_trigger_interrupt(emu, X86_EXC_TS | X86_EXC_FAULT | X86_EXC_VALUE, emu->sr[X86_R_TR].selector);
 	*ss = x86_memory_segmented_read16(emu, X86_R_TR, dpl * 8 + 8);
 	return x86_memory_segmented_read32(emu, X86_R_TR, dpl * 8 + 4);
@@ -998,7 +1031,7 @@ static inline uoff_t x86_load_task_stack32(x86_state_t * emu, int dpl, uint16_t
 
 static inline uoff_t x86_load_task_stack64(x86_state_t * emu, int dpl, uint16_t * ss)
 {
-	if(x86_overflow(emu->sr[X86_R_TR].base, dpl * 8 + 12, emu->sr[X86_R_TR].limit))
+	if(x86_overflow(dpl * 8 + 4, 8, emu->sr[X86_R_TR].limit))
 		x86_trigger_interrupt(emu, X86_EXC_TS | X86_EXC_FAULT | X86_EXC_VALUE, emu->sr[X86_R_TR].selector);
 	*ss = dpl; /* NULL segment */
 	return x86_memory_segmented_read64(emu, X86_R_TR, dpl * 8 + 4);
@@ -1006,7 +1039,7 @@ static inline uoff_t x86_load_task_stack64(x86_state_t * emu, int dpl, uint16_t
 
 static inline uoff_t x86_load_task_ist_stack(x86_state_t * emu, int ist)
 {
-	if(x86_overflow(emu->sr[X86_R_TR].base, ist * 8 + 0x2C, emu->sr[X86_R_TR].limit))
+	if(x86_overflow(ist * 8 + 0x24, 8, emu->sr[X86_R_TR].limit))
 		x86_trigger_interrupt(emu, X86_EXC_TS | X86_EXC_FAULT | X86_EXC_VALUE, emu->sr[X86_R_TR].selector);
 	return x86_memory_segmented_read64(emu, X86_R_TR, ist * 8 + 0x24);
 }
@@ -1029,37 +1062,112 @@ static inline uoff_t x86_load_task_stack(x86_state_t * emu, int dpl, uint16_t *
 	}
 }
 
+// Decodes the I/O permission and interrupt redirection bitmaps of the current TSS
+// Ports beyond the TSS limit are denied and interrupts beyond it are not redirected, as are all of them for 16-bit TSSs
+static void x86_tss_bitmaps_refresh(x86_state_t * emu)
+{
+	uint32_t limit = emu->sr[X86_R_TR].limit;
+
+	emu->tss_bitmaps_valid = false;
+	memset(emu->io_permission_bitmap, 0xFF, sizeof emu->io_permission_bitmap);
+	memset(emu->interrupt_redirection_bitmap, 0xFF, sizeof emu->interrupt_redirection_bitmap);
+
+	switch(x86_segment_get_type(&emu->sr[X86_R_TR]))
+	{
+	case X86_DESC_TYPE_TSS32_A:
+	case X86_DESC_TYPE_TSS32_B:
+		if(limit >= 0x67)
+		{
+			uint32_t iopb = x86_memory_segmented_read16(emu, X86_R_TR, 0x66);
+			if(iopb >= 32 && iopb - 32 <= limit)
+				x86_memory_segmented_read(emu, X86_R_TR, iopb - 32,
+					min(sizeof emu->interrupt_redirection_bitmap, limit + 1 - (iopb - 32)), emu->interrupt_redirection_bitmap);
+			if(iopb <= limit)
+				x86_memory_segmented_read(emu, X86_R_TR, iopb,
+					min(sizeof emu->io_permission_bitmap, limit + 1 - iopb), emu->io_permission_bitmap);
+		}
+		break;
+	default:
+		break;
+	}
+
+	emu->tss_bitmaps_base = emu->sr[X86_R_TR].base;
+	emu->tss_bitmaps_limit = limit;
+	emu->tss_bitmaps_valid = true;
+}
+
+static inline void x86_tss_bitmaps_update(x86_state_t * emu)
+{
+	if(!emu->tss_bitmaps_valid || emu->tss_bitmaps_base != emu->sr[X86_R_TR].base || emu->tss_bitmaps_limit != emu->sr[X86_R_TR].limit)
+		x86_tss_bitmaps_refresh(emu);
+}
+
+// Called before I/O instructions, protected mode code above IOPL and virtual 8086 code may only access ports permitted by the TSS
+static inline void x86_check_io_permission(x86_state_t * emu, uint16_t port, unsigned count)
+{
+	if(x86_is_real_mode(emu) || (!x86_is_virtual_8086_mode(emu) && emu->iopl >= x86_get_cpl(emu)))
+		return;
+
+	x86_tss_bitmaps_update(emu);
+	unsigned bits = emu->io_permission_bitmap[port >> 3] | (emu->io_permission_bitmap[(port >> 3) + 1] << 8);
+	if(((bits >> (port & 7)) & ((1 << count) - 1)) != 0)
+		x86_trigger_interrupt(emu, X86_EXC_GP | X86_EXC_FAULT | X86_EXC_VALUE, 0);
+}
+
+static inline uint32_t x86_tss_get32(uint8_t * tss, size_t offset)
+{
+	return x86_descriptor_get_word(tss, offset >> 1) | ((uint32_t)x86_descriptor_get_word(tss, (offset >> 1) + 1) << 16);
+}
+
+static inline void x86_tss_set32(uint8_t * tss, size_t offset, uint32_t value)
+{
+	x86_descriptor_set_word(tss, offset >> 1, value);
+	x86_descriptor_set_word(tss, (offset >> 1) + 1, value >> 16);
+}
+
+/*
+	The dynamic fields of the outgoing TSS and the complete incoming TSS are each moved as a single block through a host buffer
+	Only the selectors are loaded here, the caller loads the descriptors with x86_load_selectors_after_switch
+*/
 static inline int x86_switch_task(x86_state_t * emu, uint16_t tss_selector, uint8_t * tss_descriptor)
 {
+	emu->tss_bitmaps_valid = false;
+
 	int selector_count = 0;
+	uint8_t tss[0x68];
 
 	switch(x86_segment_get_type(&emu->sr[X86_R_TR]))
 	{
 	case X86_DESC_TYPE_TSS16_A:
 	case X86_DESC_TYPE_TSS16_B:
-		x86_memory_segmented_write16(emu, X86_R_TR, 0x0E, emu->xip);
-		x86_memory_segmented_write16(emu, X86_R_TR, 0x10, x86_flags_get16(emu));
+		// IP, FLAGS, general registers and selectors at 0x0E to 0x29
+		x86_descriptor_set_word(tss, 0x0E >> 1, emu->xip);
+		x86_descriptor_set_word(tss, 0x10 >> 1, x86_flags_get16(emu));
 		for(int register_number = 0; register_number < 8; register_number++)
 		{
-			x86_memory_segmented_write16(emu, X86_R_TR, 0x12 + 2 * register_number, emu->gpr[X86_R_AX + register_number]);
+			x86_descriptor_set_word(tss, (0x12 >> 1) + register_number, emu->gpr[X86_R_AX + register_number]);
 		}
 		for(int register_number = 0; register_number < 4; register_number++)
 		{
-			x86_memory_segmented_write16(emu, X86_R_TR, 0x22 + 2 * register_number, emu->sr[X86_R_ES + register_number].selector);
+			x86_descriptor_set_word(tss, (0x22 >> 1) + register_number, emu->sr[X86_R_ES + register_number].selector);
 		}
+		x86_memory_segmented_write(emu, X86_R_TR, 0x0E, 0x2A - 0x0E, tss + 0x0E);
 		break;
 	case X86_DESC_TYPE_TSS32_A:
 	case X86_DESC_TYPE_TSS32_B:
-		x86_memory_segmented_write32(emu, X86_R_TR, 0x20, emu->xip);
-		x86_memory_segmented_write32(emu, X86_R_TR, 0x24, x86_flags_get32(emu));
+		// EIP, EFLAGS, general registers and selectors at 0x20 to 0x5F, the reserved upper halves of the selector fields are preserved
+		x86_memory_segmented_read(emu, X86_R_TR, 0x48, 0x60 - 0x48, tss + 0x48);
+		x86_tss_set32(tss, 0x20, emu->xip);
+		x86_tss_set32(tss, 0x24, x86_flags_get32(emu));
 		for(int register_number = 0; register_number < 8; register_number++)
 		{
-			x86_memory_segmented_write32(emu, X86_R_TR, 0x28 + 4 * register_number, emu->gpr[X86_R_AX + register_number]);
+			x86_tss_set32(tss, 0x28 + 4 * register_number, emu->gpr[X86_R_AX + register_number]);
 		}
 		for(int register_number = 0; register_number < 6; register_number++)
 		{
-			x86_memory_segmented_write16(emu, X86_R_TR, 0x48 + 4 * register_number, emu->sr[X86_R_ES + register_number].selector);
+			x86_descriptor_set_word(tss, (0x48 >> 1) + 2 * register_number, emu->sr[X86_R_ES + register_number].selector);
 		}
+		x86_memory_segmented_write(emu, X86_R_TR, 0x20, 0x60 - 0x20, tss + 0x20);
 		break;
 	default:
 		assert(false);
@@ -1078,47 +1186,44 @@ static inline int x86_switch_task(x86_state_t * emu, uint16_t tss_selector, uint
 		x86_segment_load_protected_mode_286(emu, X86_R_TR, tss_selector, tss_descriptor);
 	}
 
-	uint32_t pdbr = 0;
-
 	switch(x86_segment_get_type(&emu->sr[X86_R_TR]))
 	{
 	case X86_DESC_TYPE_TSS16_A:
 	case X86_DESC_TYPE_TSS16_B:
-		x86_set_xip(emu, x86_memory_segmented_read16(emu, X86_R_TR, 0x0E));
-		x86_flags_set16(emu, x86_memory_segmented_read16(emu, X86_R_TR, 0x10));
+		x86_memory_segmented_read(emu, X86_R_TR, 0, 0x2C, tss);
+		x86_set_xip(emu, x86_descriptor_get_word(tss, 0x0E >> 1));
+		x86_flags_set16(emu, x86_descriptor_get_word(tss, 0x10 >> 1));
 		for(int register_number = 0; register_number < 8; register_number++)
 		{
-			emu->gpr[X86_R_AX + register_number] = x86_memory_segmented_read16(emu, X86_R_TR, 0x12 + 2 * register_number);
+			emu->gpr[X86_R_AX + register_number] = x86_descriptor_get_word(tss, (0x12 >> 1) + register_number);
 		}
-		emu->sr[X86_R_LDTR].selector = x86_memory_segmented_read16(emu, X86_R_TR, 0x2A);
+		emu->sr[X86_R_LDTR].selector = x86_descriptor_get_word(tss, 0x2A >> 1);
 		selector_count = 4;
 		for(int register_number = 0; register_number < selector_count; register_number++)
 		{
 			// only load the selectors
-			//x86_segment_set(emu, X86_R_CS + register_number, x86_memory_segmented_read16(emu, X86_R_TR, 0x22 + 2 * register_number));
-			emu->sr[X86_R_CS + register_number].selector = x86_memory_segmented_read16(emu, X86_R_TR, 0x22 + 2 * register_number);
+			emu->sr[X86_R_ES + register_number].selector = x86_descriptor_get_word(tss, (0x22 >> 1) + register_number);
 		}
 		break;
 	case X86_DESC_TYPE_TSS32_A:
 	case X86_DESC_TYPE_TSS32_B:
-		x86_set_xip(emu, x86_memory_segmented_read32(emu, X86_R_TR, 0x20));
-		x86_flags_set32(emu, x86_memory_segmented_read32(emu, X86_R_TR, 0x24));
+		x86_memory_segmented_read(emu, X86_R_TR, 0, 0x68, tss);
+		x86_set_xip(emu, x86_tss_get32(tss, 0x20));
+		x86_flags_set32(emu, x86_tss_get32(tss, 0x24));
 		for(int register_number = 0; register_number < 8; register_number++)
 		{
-			emu->gpr[X86_R_AX + register_number] = x86_memory_segmented_read32(emu, X86_R_TR, 0x28 + 4 * register_number);
+			emu->gpr[X86_R_AX + register_number] = x86_tss_get32(tss, 0x28 + 4 * register_number);
 		}
-		pdbr = x86_memory_segmented_read32(emu, X86_R_TR, 0x1C);
-		if((emu->cr[0] == X86_CR0_PG) != 0)
+		if((emu->cr[0] & X86_CR0_PG) != 0)
 		{
-			emu->cr[3] = pdbr;
+			emu->cr[3] = x86_tss_get32(tss, 0x1C);
 		}
-		emu->sr[X86_R_LDTR].selector = x86_memory_segmented_read16(emu, X86_R_TR, 0x60);
+		emu->sr[X86_R_LDTR].selector = x86_descriptor_get_word(tss, 0x60 >> 1);
 		selector_count = 6;
 		for(int register_number = 0; register_number < selector_count; register_number++)
 		{
 			// only load the selectors
-			//x86_segment_set(emu, X86_R_CS + register_number, x86_memory_segmented_read16(emu, X86_R_TR, 0x48 + 2 * register_number));
-			emu->sr[X86_R_CS + register_number].selector = x86_memory_segmented_read16(emu, X86_R_TR, 0x22 + 2 * register_number);
+			emu->sr[X86_R_ES + register_number].selector = x86_descriptor_get_word(tss, (0x48 >> 1) + 2 * register_number);
 		}
 		break;
 	default:
@@ -1130,7 +1235,8 @@ static inline int x86_switch_task(x86_state_t * emu, uint16_t tss_selector, uint
 	emu->dr[7] &= ~(X86_DR7_L0 | X86_DR7_L1 | X86_DR7_L2 | X86_DR7_L3);
 
 	// TODO: what is the proper placement of this check?
-	if((x86_memory_segmented_read8(emu, X86_R_TR, 0x64) & 0x01) != 0)
+	// only 32-bit TSSs have a debug trap bit
+	if(selector_count == 6 && (tss[0x64] & 0x01) != 0)
 	{
 		emu->dr[6] |= X86_DR6_BT;
 		x86_trigger_interrupt(emu, X86_EXC_DB | X86_EXC_TRAP, 0);
@@ -1166,9 +1272,24 @@ static inline void x86_load_selectors_after_switch(x86_state_t * emu, int select
 {
 	x86_ldtr_load_switch_task(emu, emu->sr[X86_R_LDTR].selector);
 
-	for(int register_number = 0; register_number < selector_count; register_number++)
+	// CS comes first so that the other segments are checked against the new CPL, the first 4 are the segment registers of the 80286
+	static const x86_segnum_t order[6] = { X86_R_CS, X86_R_SS, X86_R_ES, X86_R_DS, X86_R_FS, X86_R_GS };
+
+	// segment registers usually share a few selectors, each descriptor is only read from the table once
+	uint8_t descriptors[6][8];
+	for(int index = 0; index < selector_count; index++)
 	{
-		x86_segment_set_switch_task(emu, X86_R_CS + register_number, emu->sr[register_number].selector);
+		uint16_t selector = emu->sr[order[index]].selector;
+		const uint8_t * cached = NULL;
+		for(int previous = 0; previous < index; previous++)
+		{
+			if(!x86_selector_is_null(selector) && (emu->sr[order[previous]].selector & ~X86_SEL_RPL_MASK) == (selector & ~X86_SEL_RPL_MASK))
+			{
+				cached = descriptors[previous];
+				break;
+			}
+		}
+		x86_segment_set_switch_task(emu, order[index], selector, cached, descriptors[index]);
 	}
 }
 
@@ -1511,6 +1632,8 @@ static inline void x86_call_via_call_gate##__size(x86_state_t * emu, uint16_t ga
 { \
 	uint16_t segment_selector = x86_descriptor_get_word(gate_descriptor, X86_DESCWORD_GATE_SELECTOR); \
 	unsigned cpl = x86_get_cpl(emu); \
+	/* x86_set_cpl updates the RPL of CS, the return address needs the original one */ \
+	uint16_t old_cs = emu->sr[X86_R_CS].selector; \
 	unsigned gate_dpl = x86_descriptor_get_dpl(gate_descriptor); \
 	unsigned gate_rpl = gate_selector & X86_SEL_RPL_MASK; \
  \
@@ -1569,11 +1692,10 @@ static inline void x86_call_via_call_gate##__size(x86_state_t * emu, uint16_t ga
  \
 		_IF_NOT64(__size, ( \
 			unsigned count = x86_descriptor_get_parameter_count(gate_descriptor); \
-			uint##__size##_t parameters[count]; \
-			for(unsigned i = 0; i < count; i++) \
-			{ \
-				parameters[i] = x86_memory_segmented_read##__size(emu, X86_R_SS, old_rsp + (__size >> 3) * i); \
-			} \
+			/* parameters in memory order, followed by the old stack pointer and stack segment */ \
+			uint##__size##_t frame[count + 2]; \
+			if(count > 0) \
+				x86_memory_segmented_read(emu, X86_R_SS, old_rsp, (__size >> 3) * count, frame); \
 		)) \
  \
 		/* fetch new stack */ \
@@ -1616,15 +1738,21 @@ static inline void x86_call_via_call_gate##__size(x86_state_t * emu, uint16_t ga
 		x86_segment_load_protected_mode(emu, X86_R_SS, new_ss, stack_descriptor); \
 		emu->gpr[X86_R_SP] = new_rsp; \
  \
-		/* push old stack */ \
-		x86_push##__size(emu, old_ss); \
-		x86_push##__size(emu, old_rsp); \
- \
+		/* push old stack and parameters */ \
+		_IF_64(__size, ( \
+			x86_push##__size(emu, old_ss); \
+			x86_push##__size(emu, old_rsp); \
+		)) \
 		_IF_NOT64(__size, ( \
-			/* push parameters */ \
-			for(unsigned i = 0; i < count; i++) \
+			frame[count] = htole##__size(old_rsp); \
+			frame[count + 1] = htole##__size(old_ss); \
+			if(!x86_push_block(emu, frame, sizeof frame)) \
 			{ \
-				x86_push##__size(emu, parameters[count - i - 1]); \
+				/* the stack pointer wraps around within the frame */ \
+				for(unsigned i = count + 2; i > 0; i--) \
+				{ \
+					x86_push##__size(emu, le##__size##toh(frame[i - 1])); \
+				} \
 			} \
 		)) \
 	} \
@@ -1639,9 +1767,9 @@ static inline void x86_call_via_call_gate##__size(x86_state_t * emu, uint16_t ga
 			x86_check_canonical_address(emu, X86_R_CS, new_ip, 0); \
 		)) \
 	} \
-	x86_push##__size(emu, emu->sr[X86_R_CS].selector); \
+	x86_push##__size(emu, old_cs); \
 	x86_push##__size(emu, emu->xip); \
-	x86_segment_load_protected_mode(emu, X86_R_CS, (segment_selector & X86_SEL_INDEX_MASK) | cpl, segment_descriptor); \
+	x86_segment_load_protected_mode(emu, X86_R_CS, (segment_selector & X86_SEL_INDEX_MASK) | new_cpl, segment_descriptor); \
 	x86_set_xip(emu, new_ip); \
 }
 
@@ -1939,6 +2067,8 @@ static inline void x86_interrupt_via_gate##__size(x86_state_t * emu, int excepti
  \
 	unsigned cpl = x86_get_cpl(emu); \
 	unsigned new_cpl = cpl; \
+	/* x86_set_cpl updates the RPL of CS, the return address needs the original one */ \
+	uint16_t old_cs = emu->sr[X86_R_CS].selector; \
 	if(!x86_descriptor_is_conforming(segment_descriptor)) \
 	{ \
 		new_cpl = dpl; \
@@ -1960,7 +2090,7 @@ static inline void x86_interrupt_via_gate##__size(x86_state_t * emu, int excepti
 	)) \
 	{ \
 		uint16_t ss = emu->sr[X86_R_SS].selector; \
-		uoff_t rsp = emu->xip; \
+		uoff_t rsp = emu->gpr[X86_R_SP]; \
  \
 		/* fetch new stack */ \
 		_IF_64(__size, ( \
@@ -2060,8 +2190,8 @@ static inline void x86_interrupt_via_gate##__size(x86_state_t * emu, int excepti
 			x86_descriptor_check_limit(emu, X86_R_CS, segment_descriptor, offset, 1, 0); \
 		} \
 	)) \
-	x86_push##__size(emu, x86_flags_get16(emu)); \
-	x86_push##__size(emu, emu->sr[X86_R_CS].selector); \
+	x86_push##__size(emu, x86_flags_get##__size(emu)); \
+	x86_push##__size(emu, old_cs); \
 	x86_push##__size(emu, emu->xip); \
 	emu->tf = 0; \
 	emu->vm = 0; \
@@ -2069,7 +2199,7 @@ static inline void x86_interrupt_via_gate##__size(x86_state_t * emu, int excepti
 	emu->nt = 0; \
 	if(is_interrupt_gate) \
 		emu->_if = 0; \
-	x86_segment_load_protected_mode(emu, X86_R_CS, (segment_selector & X86_SEL_INDEX_MASK) | cpl, segment_descriptor); \
+	x86_segment_load_protected_mode(emu, X86_R_CS, (segment_selector & X86_SEL_INDEX_MASK) | new_cpl, segment_descriptor); \
 	x86_set_xip(emu, offset); \
 }
 
@@ -2077,6 +2207,92 @@ _DEFINE_x86_interrupt_via_gate(16)
 _DEFINE_x86_interrupt_via_gate(32)
 _DEFINE_x86_interrupt_via_gate(64)
 
+// Fast path for interrupt and trap gates to the current code segment, that do not change privilege, operating mode or stack
+// The segment registers stay as they are, and the frame is pushed with a single access
+// Returns false if the interrupt must go through the full gate logic
+static inline bool x86_interrupt_via_gate_same_segment(x86_state_t * emu, int exception, uint8_t * gate_descriptor, bool is_interrupt_gate, uoff_t error_code)
+{
+	uint8_t segment_descriptor[8];
+	uint16_t segment_selector = x86_descriptor_get_word(gate_descriptor, X86_DESCWORD_GATE_SELECTOR);
+	uoff_t ext = (exception & (X86_EXC_INT_N|X86_EXC_INT_SW)) == 0 ? 1 : 0;
+
+	if(emu->vm || x86_selector_is_null(segment_selector)
+	|| ((segment_selector ^ emu->sr[X86_R_CS].selector) & ~X86_SEL_RPL_MASK) != 0)
+		return false;
+
+	// compatibility mode interrupts switch to 64-bit mode
+	if(x86_is_long_mode(emu) && !x86_is_64bit_mode(emu))
+		return false;
+
+	// the table entry might have changed since CS was loaded, these faults are the same the full gate logic raises first
+	x86_table_check_limit_selector(emu, segment_selector, 0, 8, X86_EXC_GP);
+	x86_descriptor_load(emu, segment_selector, segment_descriptor, X86_EXC_GP);
+
+	if(x86_descriptor_is_system_segment(segment_descriptor) || !x86_descriptor_is_executable(segment_descriptor)
+	|| !x86_descriptor_is_present(segment_descriptor))
+		return false;
+
+	if(((x86_load_access_rights32(segment_descriptor) ^ emu->sr[X86_R_CS].access) & (X86_DESC_L | X86_DESC_D)) != 0)
+		return false;
+
+	unsigned dpl = x86_descriptor_get_dpl(segment_descriptor);
+	if(x86_descriptor_is_conforming(segment_descriptor) ? dpl > x86_get_cpl(emu) : dpl != x86_get_cpl(emu))
+		return false;
+
+	if(x86_is_long_mode(emu))
+	{
+		if(x86_descriptor_get_ist(gate_descriptor) != 0)
+			return false;
+
+		uoff_t offset = x86_descriptor_get_gate_offset_64(gate_descriptor);
+		uint64_t rsp = emu->gpr[X86_R_SP];
+		uint64_t frame[6];
+		int count = 0;
+
+		x86_check_canonical_address(emu, X86_R_SS, rsp & ~0xF, ext);
+		x86_check_canonical_address(emu, X86_R_CS, offset, ext);
+
+		if((exception & X86_EXC_VALUE))
+			frame[count++] = htole64(error_code);
+		frame[count++] = htole64(emu->xip);
+		frame[count++] = htole64(emu->sr[X86_R_CS].selector);
+		frame[count++] = htole64(x86_flags_get64(emu));
+		frame[count++] = htole64(rsp);
+		frame[count++] = htole64(emu->sr[X86_R_SS].selector);
+
+		// RSP only changes once the whole frame is written
+		rsp = (rsp & ~0xF) - count * sizeof frame[0];
+		x86_memory_segmented_write(emu, X86_R_SS, rsp, count * sizeof frame[0], frame);
+		emu->gpr[X86_R_SP] = rsp;
+		x86_set_xip(emu, offset);
+	}
+	else
+	{
+		uoff_t offset = x86_descriptor_get_gate_offset_32(gate_descriptor);
+		uint32_t frame[4];
+		int count = 0;
+
+		if((exception & X86_EXC_VALUE))
+			frame[count++] = htole32(error_code);
+		frame[count++] = htole32(emu->xip);
+		frame[count++] = htole32(emu->sr[X86_R_CS].selector);
+		frame[count++] = htole32(x86_flags_get32(emu));
+
+		x86_stack_segment_check_limit(emu, count * sizeof frame[0], ext);
+		x86_segment_check_limit(emu, X86_R_CS, offset, 1, 0);
+		if(!x86_push_block(emu, frame, count * sizeof frame[0]))
+			return false;
+		x86_set_xip(emu, offset);
+	}
+
+	emu->tf = 0;
+	emu->rf = 0;
+	emu->nt = 0;
+	if(is_interrupt_gate)
+		emu->_if = 0;
+	return true;
+}
+
 static inline void x86_interrupt_via_task_gate(x86_state_t * emu, int exception, uint8_t * gate_descriptor)
 {
 	uint16_t tss_selector = x86_descriptor_get_word(gate_descriptor, X86_DESCWORD_GATE_SELECTOR);
@@ -2134,15 +2350,21 @@ static inline void x86_enter_interrupt(x86_state_t * emu, int exception, uoff_t
 	{
 		x86_table_check_limit_exception(emu, exception & 0xFF, 4, 0);
 		x86_stack_segment_check_limit(emu, 6, 0);
-		x86_push16(emu, x86_flags_get16(emu));
+		uint32_t vector = x86_memory_segmented_read32(emu, X86_R_IDTR, (exception & 0xFF) * 4);
+		uint16_t frame[3] = { htole16(emu->xip), htole16(emu->sr[X86_R_CS].selector), htole16(x86_flags_get16(emu)) };
+		if(!x86_push_block(emu, frame, sizeof frame))
+		{
+			// the stack pointer wraps around within the frame
+			x86_push16(emu, x86_flags_get16(emu));
+			x86_push16(emu, emu->sr[X86_R_CS].selector);
+			x86_push16(emu, emu->xip);
+		}
 		emu->_if = 0;
 		emu->tf = 0;
 		emu->md = x86_native_state_flag(emu);
 		emu->ac = 0;
-		x86_push16(emu, emu->sr[X86_R_CS].selector);
-		x86_push16(emu, emu->xip);
-		x86_segment_load_real_mode(emu, X86_R_CS, x86_memory_segmented_read16(emu, X86_R_IDTR, (exception & 0xFF) * 4 + 2));
-		x86_set_xip(emu, x86_memory_segmented_read16(emu, X86_R_IDTR, (exception & 0xFF) * 4));
+		x86_segment_load_real_mode(emu, X86_R_CS, vector >> 16);
+		x86_set_xip(emu, vector & 0xFFFF);
 	}
 	else
 	{
@@ -2155,12 +2377,9 @@ static inline void x86_enter_interrupt(x86_state_t * emu, int exception, uoff_t
 			else if((emu->cr[4] & X86_CR4_VME) != 0)
 			{
 				/* look up interrupt redirection map in TSS */
-				//x86_table_check_limit(emu, X86_R_TR, 0x66, 2, X86_EXC_GP | X86_EXC_FAULT | X86_EXC_VALUE, 0); // TODO
-				uint16_t iopb = x86_memory_segmented_read16(emu, X86_R_TR, 0x66);
+				x86_tss_bitmaps_update(emu);
 				int intno = exception & 0xFF;
-				//x86_table_check_limit(emu, X86_R_TR, iopb - 32 + (intno >> 3), 1, X86_EXC_GP | X86_EXC_FAULT | X86_EXC_VALUE, 0); // TODO
-				uint8_t bitmap = x86_memory_segmented_read8(emu, X86_R_TR, iopb - 32 + (intno >> 3));
-				if(((bitmap >> (intno & 7)) & 1) == 0)
+				if(((emu->interrupt_redirection_bitmap[intno >> 3] >> (intno & 7)) & 1) == 0)
 				{
 					x86_push16(emu, x86_flags_get_image16(emu));
 					x86_push16(emu, emu->sr[X86_R_CS].selector);
@@ -2214,6 +2433,13 @@ static inline void x86_enter_interrupt(x86_state_t * emu, int exception, uoff_t
 			x86_trigger_interrupt(emu, X86_EXC_NP | X86_EXC_FAULT | X86_EXC_VALUE, exception_error_code);
 		}
 
+		if((type == X86_DESC_TYPE_INTGATE32 || type == X86_DESC_TYPE_TRAPGATE32)
+		&& x86_interrupt_via_gate_same_segment(emu, exception, descriptor, type == X86_DESC_TYPE_INTGATE32, error_code))
+		{
+			x86_load_x80_registers(emu);
+			return;
+		}
+
 		switch(type)
 		{
 		case X86_DESC_TYPE_TASKGATE:
@@ -2356,6 +2582,8 @@ static inline _Noreturn void x86_trigger_interrupt(x86_state_t * emu, int except
 	if(emu->fetch_mode == FETCH_MODE_PREFETCH)
 		longjmp(emu->exc[emu->fetch_mode], 1); // simply return to the prefetch start
 
+	emu->last_exception = exception;
+
 	if(emu->capture_transitions)
 	{
 		emu->emulation_result = X86_RESULT(X86_RESULT_INTERRUPT, exception & 0xFF);
@@ -2918,7 +3146,7 @@ static inline void x86_return_far##__size(x86_state_t * emu, unsigned bytes) \
 			x86_set_cpl(emu, cs & X86_SEL_RPL_MASK); \
  \
 			emu->gpr[X86_R_SP] = rsp; \
-			x86_segment_load_protected_mode(emu, X86_R_CS, ss, stack_descriptor); \
+			x86_segment_load_protected_mode(emu, X86_R_SS, ss, stack_descriptor); \
  \
 			for(int i = 0; i <= 8; i++) \
 			{ \
@@ -6,6 +6,21 @@ static inline void x86_set_xip(x86_state_t * emu, uoff_t value)
 	emu->restarted_instruction.opcode = 0;
 	emu->xip = value;
 	x86_prefetch_queue_flush(emu);
+
+	if(emu->coverage_map != NULL)
+	{
+		// the edge is identified by the transferring instruction and the target, using the block numbering of the QEMU mode of AFL
+		// far transfers have already loaded the new CS, so the source is taken at the start of the step
+		uaddr_t source = emu->coverage_source;
+		uaddr_t target = emu->sr[X86_R_CS].base + value;
+		// instructions restarting themselves (REP iterations, waiting) are not edges
+		if(target != source)
+		{
+			uint32_t location = (target >> 4) ^ (target << 8);
+			uint32_t previous = ((source >> 4) ^ (source << 8)) >> 1;
+			emu->coverage_map[(location ^ previous) & emu->coverage_mask]++;
+		}
+	}
 }
 
 // General purpose registers
@@ -164,55 +179,84 @@ static inline int x86_register_bank_number(x86_state_t * emu, int value)
 
 static inline int x86_retrieve_register_bank_number(x86_state_t * emu, uint16_t flags)
 {
-	return x86_register_bank_number(emu, flags >> 4);
+	return x86_register_bank_number(emu, flags >> X86_FL_RB_SHIFT);
 }
 
-// Synchronizes V25/V55 banks to register values
-static inline void x86_store_register_bank(x86_state_t * emu)
+/*
+	The registers of the current bank (emu->rb) are held in the register file, the copy of that bank in the internal RAM is stale
+	Only the words of the current bank that an access to the internal RAM touches are synchronized
+*/
+
+// Synchronizes words first to last of the current V25/V55 bank to register values
+static inline void x86_store_register_bank_words(x86_state_t * emu, int first, int last)
 {
-	int word_index;
-	if(emu->cpu_type == X86_CPU_V55)
+	for(int word_index = first; word_index <= last; word_index++)
 	{
-		for(word_index = 0; word_index < 2; word_index++)
-		{
+		if(word_index >= 8)
+			emu->bank[emu->rb].w[word_index] = htole16(x86_register_get16(emu, 15 - word_index));
+		else if(word_index >= 4 || (emu->cpu_type == X86_CPU_V55 && word_index < 2))
 			emu->bank[emu->rb].w[word_index] = htole16(emu->sr[7 - word_index].selector);
-		}
-	}
-	for(word_index = 4; word_index < 8; word_index++)
-	{
-		emu->bank[emu->rb].w[word_index] = htole16(emu->sr[7 - word_index].selector);
 	}
-	for(word_index = 8; word_index < 16; word_index++)
+}
+
+// Synchronizes register values to words first to last of the current V25/V55 bank
+static inline void x86_load_register_bank_words(x86_state_t * emu, int first, int last)
+{
+	for(int word_index = first; word_index <= last; word_index++)
 	{
-		emu->bank[emu->rb].w[word_index] = htole16(x86_register_get16(emu, 15 - word_index));
+		if(word_index >= 8)
+			x86_register_set16(emu, 15 - word_index, le16toh(emu->bank[emu->rb].w[word_index]));
+		else if(word_index >= 4 || (emu->cpu_type == X86_CPU_V55 && word_index < 2))
+			x86_segment_load_real_mode(emu, 7 - word_index, le16toh(emu->bank[emu->rb].w[word_index]));
 	}
 }
 
+// Synchronizes V25/V55 banks to register values
+static inline void x86_store_register_bank(x86_state_t * emu)
+{
+	x86_store_register_bank_words(emu, 0, 15);
+}
+
 // Synchronizes register values to V25/V55 banks
 static inline void x86_load_register_bank(x86_state_t * emu)
 {
-	int word_index;
-	if(emu->cpu_type == X86_CPU_V55)
-	{
-		for(word_index = 0; word_index < 2; word_index++)
-		{
-			x86_segment_load_real_mode(emu, 7 - word_index, le16toh(emu->bank[emu->rb].w[word_index]));
-		}
-	}
-	for(word_index = 4; word_index < 8; word_index++)
-	{
-		x86_segment_load_real_mode(emu, 7 - word_index, le16toh(emu->bank[emu->rb].w[word_index]));
-	}
-	for(word_index = 8; word_index < 16; word_index++)
-	{
-		x86_register_set16(emu, 15 - word_index, le16toh(emu->bank[emu->rb].w[word_index]));
-	}
+	x86_load_register_bank_words(emu, 0, 15);
+}
+
+// Finds the words of the current bank that overlap an internal RAM access, returns false if there are none
+static inline bool x86_register_bank_overlap(x86_state_t * emu, uaddr_t offset, uaddr_t count, int * first, int * last)
+{
+	uaddr_t bank_offset = emu->rb * sizeof emu->bank[0];
+	if(count == 0 || offset >= bank_offset + sizeof emu->bank[0] || offset + count <= bank_offset)
+		return false;
+	*first = offset <= bank_offset ? 0 : (offset - bank_offset) >> 1;
+	*last = offset + count >= bank_offset + sizeof emu->bank[0] ? 15 : (offset + count - 1 - bank_offset) >> 1;
+	return true;
+}
+
+// Synchronizes the internal RAM to register values before it is accessed
+static inline void x86_store_register_bank_range(x86_state_t * emu, uaddr_t offset, uaddr_t count)
+{
+	int first, last;
+	if(x86_register_bank_overlap(emu, offset, count, &first, &last))
+		x86_store_register_bank_words(emu, first, last);
+}
+
+// Synchronizes register values to the internal RAM after it is written
+static inline void x86_load_register_bank_range(x86_state_t * emu, uaddr_t offset, uaddr_t count)
+{
+	int first, last;
+	if(x86_register_bank_overlap(emu, offset, count, &first, &last))
+		x86_load_register_bank_words(emu, first, last);
 }
 
 static inline void x86_set_register_bank_number(x86_state_t * emu, int number)
 {
+	number = x86_register_bank_number(emu, number);
+	if(number == (int)emu->rb)
+		return;
 	x86_store_register_bank(emu);
-	emu->rb = x86_register_bank_number(emu, number);
+	emu->rb = number;
 	x86_load_register_bank(emu);
 }
 
@@ -2935,6 +2979,8 @@ static inline void x86_cyrix_register_set(x86_state_t * emu, uint8_t number, uin
 // Synchronizes 8080/Z80 registers to x86 values
 static inline void x86_load_x80_registers(x86_state_t * emu)
 {
+	// entering emulation mode, the segments or the memory map might have changed
+	x80_memory_window_invalidate(emu);
 	emu->x80.bank[emu->x80.af_bank].af = (x86_register_get8_low(emu, X86_R_AX) << 8) | x86_flags_get8(emu);
 	emu->x80.bank[emu->x80.main_bank].bc = x86_register_get16(emu, X86_R_CX);
 	emu->x80.bank[emu->x80.main_bank].de = x86_register_get16(emu, X86_R_DX);
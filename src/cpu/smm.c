@@ -1,44 +1,83 @@
 
 //// ICE (in-circuit emulator)/LOADALL (286, 386, 486) and system management mode (SMM) implementation
 
+// State images
+
+/*
+	The register state saved by STOREALL and on SMM entry, and loaded by LOADALL and RSM, is assembled in a host buffer and moved to or from memory in a single access
+	The layouts are described by tables of fields, with offsets as given in the documentation
+*/
+
+static inline uint16_t x86_image_get16(const uint8_t * image, size_t offset)
+{
+	uint16_t value;
+	memcpy(&value, &image[offset], 2);
+	return le16toh(value);
+}
+
+static inline uint32_t x86_image_get32(const uint8_t * image, size_t offset)
+{
+	uint32_t value;
+	memcpy(&value, &image[offset], 4);
+	return le32toh(value);
+}
+
+static inline uint64_t x86_image_get64(const uint8_t * image, size_t offset)
+{
+	uint64_t value;
+	memcpy(&value, &image[offset], 8);
+	return le64toh(value);
+}
+
+static inline void x86_image_set16(uint8_t * image, size_t offset, uint16_t value)
+{
+	value = htole16(value);
+	memcpy(&image[offset], &value, 2);
+}
+
+static inline void x86_image_set32(uint8_t * image, size_t offset, uint32_t value)
+{
+	value = htole32(value);
+	memcpy(&image[offset], &value, 4);
+}
+
+static inline void x86_image_set64(uint8_t * image, size_t offset, uint64_t value)
+{
+	value = htole64(value);
+	memcpy(&image[offset], &value, 8);
+}
+
 // Register caches
 
 // Robert R. Collins: The Segment Register Cache
-static inline void x86_descriptor_cache_read_286(x86_state_t * emu, uaddr_t offset, x86_segment_t * segment)
+static inline void x86_descriptor_cache_decode_286(const uint8_t * cache, x86_segment_t * segment)
 {
-	uint8_t cache[6];
-	x86_memory_read(emu, offset, 6, cache);
 	segment->base = cache[0] | (cache[1] << 8) | ((uint32_t)cache[2] << 16);
 	segment->access = cache[3] << 8;
 	segment->limit = cache[4] | (cache[5] << 8);
 }
 
-static inline void x86_descriptor_cache_write_286(x86_state_t * emu, uaddr_t offset, const x86_segment_t * segment)
+static inline void x86_descriptor_cache_encode_286(uint8_t * cache, const x86_segment_t * segment)
 {
-	uint8_t cache[6];
 	cache[0] = segment->base;
 	cache[1] = segment->base >> 8;
 	cache[2] = segment->base >> 16;
 	cache[3] = segment->access >> 8;
 	cache[4] = segment->limit;
 	cache[5] = segment->limit >> 8;
-	x86_memory_write(emu, offset, 6, cache);
 }
 
 // Robert R. Collins: The Segment Register Cache
-static inline void x86_descriptor_cache_read_386(x86_state_t * emu, uaddr_t offset, x86_segment_t * segment)
+static inline void x86_descriptor_cache_decode_386(const uint8_t * cache, x86_segment_t * segment)
 {
-	uint8_t cache[12];
-	x86_memory_read(emu, offset, 12, cache);
 	segment->access = (cache[2] << 8) | ((uint32_t)(cache[1] & 0x40) << 16);
 	// the G flag is lost
 	segment->base = cache[4] | (cache[5] << 8) | ((uint32_t)cache[6] << 16) | ((uint32_t)cache[7] << 24);
 	segment->limit = cache[8] | (cache[9] << 8) | ((uint32_t)cache[10] << 16) | ((uint32_t)cache[11] << 24);
 }
 
-static inline void x86_descriptor_cache_write_386(x86_state_t * emu, uaddr_t offset, const x86_segment_t * segment)
+static inline void x86_descriptor_cache_encode_386(uint8_t * cache, const x86_segment_t * segment)
 {
-	uint8_t cache[12];
 	cache[0]  = 0;
 	// the G flag is lost
 	cache[1]  = (segment->access >> 16) & 0x40;
@@ -52,22 +91,18 @@ static inline void x86_descriptor_cache_write_386(x86_state_t * emu, uaddr_t off
 	cache[9]  = segment->limit >> 8;
 	cache[10] = segment->limit >> 16;
 	cache[11] = segment->limit >> 24;
-	x86_memory_write(emu, offset, 12, cache);
 }
 
 // Robert R. Collins: The Segment Register Cache
-static inline void x86_descriptor_cache_read_p5(x86_state_t * emu, uaddr_t offset, x86_segment_t * segment)
+static inline void x86_descriptor_cache_decode_p5(const uint8_t * cache, x86_segment_t * segment)
 {
-	uint8_t cache[12];
-	x86_memory_read(emu, offset, 12, cache);
 	segment->limit = cache[0] | (cache[1] << 8) | ((uint32_t)cache[2] << 16) | ((uint32_t)cache[3] << 24);
 	segment->base = cache[4] | (cache[5] << 8) | ((uint32_t)cache[6] << 16) | ((uint32_t)cache[7] << 24);
 	segment->access = (cache[8] << 8) | ((uint32_t)(cache[9] & 0x40) << 16);
 }
 
-static inline void x86_descriptor_cache_write_p5(x86_state_t * emu, uaddr_t offset, const x86_segment_t * segment)
+static inline void x86_descriptor_cache_encode_p5(uint8_t * cache, const x86_segment_t * segment)
 {
-	uint8_t cache[12];
 	cache[0]  = segment->limit;
 	cache[1]  = segment->limit >> 8;
 	cache[2]  = segment->limit >> 16;
@@ -81,23 +116,19 @@ static inline void x86_descriptor_cache_write_p5(x86_state_t * emu, uaddr_t offs
 	cache[8]  = segment->access >> 8;
 	cache[10] = 0;
 	cache[11] = 0;
-	x86_memory_write(emu, offset, 12, cache);
 }
 
 // Robert R. Collins: The Segment Register Cache
-static inline void x86_descriptor_cache_read_p6(x86_state_t * emu, uaddr_t offset, x86_segment_t * segment)
+static inline void x86_descriptor_cache_decode_p6(const uint8_t * cache, x86_segment_t * segment)
 {
-	uint8_t cache[12];
-	x86_memory_read(emu, offset, 12, cache);
 	segment->selector = cache[0] | (cache[1] << 8);
 	segment->access = (cache[2] << 8) | ((uint32_t)(cache[3] & 0x40) << 16);
 	segment->limit = cache[4] | (cache[5] << 8) | ((uint32_t)cache[6] << 16) | ((uint32_t)cache[7] << 24);
 	segment->base = cache[8] | (cache[9] << 8) | ((uint32_t)cache[10] << 16) | ((uint32_t)cache[11] << 24);
 }
 
-static inline void x86_descriptor_cache_write_p6(x86_state_t * emu, uaddr_t offset, const x86_segment_t * segment)
+static inline void x86_descriptor_cache_encode_p6(uint8_t * cache, const x86_segment_t * segment)
 {
-	uint8_t cache[12];
 	cache[0]  = segment->selector;
 	cache[1]  = segment->selector >> 8;
 	cache[2]  = segment->access >> 8;
@@ -111,14 +142,11 @@ static inline void x86_descriptor_cache_write_p6(x86_state_t * emu, uaddr_t offs
 	cache[9]  = segment->base >> 8;
 	cache[10] = segment->base >> 16;
 	cache[11] = segment->base >> 24;
-	x86_memory_write(emu, offset, 12, cache);
 }
 
 // sandpile.org
-static inline void x86_descriptor_cache_read_p4(x86_state_t * emu, uaddr_t offset, x86_segment_t * segment)
+static inline void x86_descriptor_cache_decode_p4(const uint8_t * cache, x86_segment_t * segment)
 {
-	uint8_t cache[12];
-	x86_memory_read(emu, offset, 12, cache);
 	//if((cache[4] & 1) != 1)
 	//	TODO: null selector
 	segment->base = cache[0] | (cache[1] << 8) | ((uint32_t)cache[2] << 16) | ((uint32_t)cache[3] << 24);
@@ -126,9 +154,8 @@ static inline void x86_descriptor_cache_read_p4(x86_state_t * emu, uaddr_t offse
 	segment->limit = cache[8] | (cache[9] << 8) | ((uint32_t)cache[10] << 16) | ((uint32_t)cache[11] << 24);
 }
 
-static inline void x86_descriptor_cache_write_p4(x86_state_t * emu, uaddr_t offset, const x86_segment_t * segment)
+static inline void x86_descriptor_cache_encode_p4(uint8_t * cache, const x86_segment_t * segment)
 {
-	uint8_t cache[12];
 	cache[0] = segment->base;
 	cache[1] = segment->base >> 8;
 	cache[2] = segment->base >> 16;
@@ -149,14 +176,11 @@ static inline void x86_descriptor_cache_write_p4(x86_state_t * emu, uaddr_t offs
 	cache[9]  = segment->limit >> 8;
 	cache[10] = segment->limit >> 16;
 	cache[11] = segment->limit >> 24;
-	x86_memory_write(emu, offset, 12, cache);
 }
 
 // TODO: attribute word format unknown
-static inline void x86_descriptor_cache_read_k5(x86_state_t * emu, uaddr_t offset, x86_segment_t * segment)
+static inline void x86_descriptor_cache_decode_k5(const uint8_t * cache, x86_segment_t * segment)
 {
-	uint8_t cache[12];
-	x86_memory_read(emu, offset, 12, cache);
 	segment->access = (cache[8] << 8) | ((uint32_t)(cache[9] & 0x0F) << 20); // TODO: guessing
 	segment->limit = cache[0] | (cache[1] << 8) | ((uint32_t)(cache[2] & 0x0F) << 16);
 	if((segment->access & X86_DESC_G))
@@ -167,10 +191,8 @@ static inline void x86_descriptor_cache_read_k5(x86_state_t * emu, uaddr_t offse
 	segment->base = cache[4] | (cache[5] << 8) | ((uint32_t)cache[6] << 16) | ((uint32_t)cache[7] << 24);
 }
 
-static inline void x86_descriptor_cache_read_k5_no_access(x86_state_t * emu, uaddr_t offset, x86_segment_t * segment)
+static inline void x86_descriptor_cache_decode_k5_no_access(const uint8_t * cache, x86_segment_t * segment)
 {
-	uint8_t cache[8];
-	x86_memory_read(emu, offset, 8, cache);
 	segment->limit = cache[0] | (cache[1] << 8) | ((uint32_t)(cache[2] & 0x0F) << 16);
 	if((segment->access & X86_DESC_G))
 	{
@@ -180,9 +202,8 @@ static inline void x86_descriptor_cache_read_k5_no_access(x86_state_t * emu, uad
 	segment->base = cache[4] | (cache[5] << 8) | ((uint32_t)cache[6] << 16) | ((uint32_t)cache[7] << 24);
 }
 
-static inline void x86_descriptor_cache_write_k5(x86_state_t * emu, uaddr_t offset, const x86_segment_t * segment)
+static inline void x86_descriptor_cache_encode_k5(uint8_t * cache, const x86_segment_t * segment)
 {
-	uint8_t cache[12];
 	uint32_t limit = segment->limit;
 	if((segment->access & X86_DESC_G))
 	{
@@ -200,12 +221,10 @@ static inline void x86_descriptor_cache_write_k5(x86_state_t * emu, uaddr_t offs
 	cache[9] = (segment->access >> 20) & 0x0F; // TODO: guessing
 	cache[10] = 0;
 	cache[11] = 0;
-	x86_memory_write(emu, offset, 12, cache);
 }
 
-static inline void x86_descriptor_cache_write_k5_no_access(x86_state_t * emu, uaddr_t offset, const x86_segment_t * segment)
+static inline void x86_descriptor_cache_encode_k5_no_access(uint8_t * cache, const x86_segment_t * segment)
 {
-	uint8_t cache[8];
 	uint32_t limit = segment->limit;
 	if((segment->access & X86_DESC_G))
 	{
@@ -219,14 +238,11 @@ static inline void x86_descriptor_cache_write_k5_no_access(x86_state_t * emu, ua
 	cache[5] = segment->base >> 8;
 	cache[6] = segment->base >> 16;
 	cache[7] = segment->base >> 24;
-	x86_memory_write(emu, offset, 8, cache);
 }
 
 // TODO: attribute word format unknown
-static inline void x86_descriptor_cache_read_amd64(x86_state_t * emu, uaddr_t offset, x86_segment_t * segment)
+static inline void x86_descriptor_cache_decode_amd64(const uint8_t * cache, x86_segment_t * segment)
 {
-	uint8_t cache[16];
-	x86_memory_read(emu, offset, 16, cache);
 	segment->selector = cache[0] | (cache[1] << 8);
 	segment->access = (cache[2] << 8) | ((uint32_t)(cache[3] & 0xF0) << 16); // TODO: guessing
 	segment->limit = cache[4] | (cache[5] << 8) | ((uint32_t)cache[6] << 16) | ((uint32_t)cache[7] << 24);
@@ -234,9 +250,8 @@ static inline void x86_descriptor_cache_read_amd64(x86_state_t * emu, uaddr_t of
 		| ((uint64_t)cache[12] << 32) | ((uint64_t)cache[13] << 40) | ((uint64_t)cache[14] << 48) | ((uint64_t)cache[15] << 56);
 }
 
-static inline void x86_descriptor_cache_write_amd64(x86_state_t * emu, uaddr_t offset, const x86_segment_t * segment)
+static inline void x86_descriptor_cache_encode_amd64(uint8_t * cache, const x86_segment_t * segment)
 {
-	uint8_t cache[16];
 	cache[0]  = segment->selector;
 	cache[1]  = segment->selector >> 8;
 	// TODO: guessing
@@ -254,7 +269,6 @@ static inline void x86_descriptor_cache_write_amd64(x86_state_t * emu, uaddr_t o
 	cache[13] = segment->base >> 40;
 	cache[14] = segment->base >> 48;
 	cache[15] = segment->base >> 56;
-	x86_memory_write(emu, offset, 16, cache);
 }
 
 // similar functionality to x86_segment_load_protected_mode_386
@@ -273,36 +287,317 @@ static inline void x86_descriptor_cache_read_cyrix(x86_state_t * emu, x86_segnum
 	}
 }
 
+// Layout tables
+
+typedef enum x86_image_field_type_t
+{
+	X86_FIELD_END,
+	X86_FIELD_GPR16,
+	X86_FIELD_GPR32,
+	X86_FIELD_GPR64,
+	X86_FIELD_IP16,
+	X86_FIELD_IP32,
+	X86_FIELD_IP64,
+	X86_FIELD_FLAGS32,
+	X86_FIELD_FLAGS64,
+	X86_FIELD_CR32,
+	X86_FIELD_CR64,
+	X86_FIELD_DR32,
+	X86_FIELD_DR64,
+	X86_FIELD_EFER,
+	X86_FIELD_SELECTOR16,
+	X86_FIELD_SELECTOR32,
+	// GDTR/IDTR/LDTR fields that are not stored as a descriptor cache
+	X86_FIELD_BASE32,
+	X86_FIELD_BASE_HIGH32,
+	X86_FIELD_LIMIT32,
+	X86_FIELD_CACHE_286,
+	X86_FIELD_CACHE_386,
+	X86_FIELD_CACHE_P5,
+	X86_FIELD_CACHE_P6,
+	X86_FIELD_CACHE_P4,
+	X86_FIELD_CACHE_K5,
+	X86_FIELD_CACHE_K5_NO_ACCESS,
+	X86_FIELD_CACHE_AMD64,
+
+	X86_FIELD_TYPE_MASK = 0x7F,
+	// not loaded when an I/O instruction is restarted, the value is taken from the I/O restart fields instead
+	X86_FIELD_IO_RESTART = 0x80,
+} x86_image_field_type_t;
+
+typedef struct x86_image_field_t
+{
+	uint16_t offset;
+	uint8_t type;
+	uint8_t number; // register or segment number
+} x86_image_field_t;
+
+static inline void x86_image_store_fields(x86_state_t * emu, uint8_t * image, size_t start, const x86_image_field_t * fields)
+{
+	for(; fields->type != X86_FIELD_END; fields++)
+	{
+		size_t offset = fields->offset - start;
+		switch(fields->type & X86_FIELD_TYPE_MASK)
+		{
+		case X86_FIELD_GPR16:
+			x86_image_set16(image, offset, emu->gpr[fields->number]);
+			break;
+		case X86_FIELD_GPR32:
+			x86_image_set32(image, offset, emu->gpr[fields->number]);
+			break;
+		case X86_FIELD_GPR64:
+			x86_image_set64(image, offset, emu->gpr[fields->number]);
+			break;
+		case X86_FIELD_IP16:
+			x86_image_set16(image, offset, emu->xip);
+			break;
+		case X86_FIELD_IP32:
+			x86_image_set32(image, offset, emu->xip);
+			break;
+		case X86_FIELD_IP64:
+			x86_image_set64(image, offset, emu->xip);
+			break;
+		case X86_FIELD_FLAGS32:
+			x86_image_set32(image, offset, x86_flags_get32(emu));
+			break;
+		case X86_FIELD_FLAGS64:
+			x86_image_set64(image, offset, x86_flags_get64(emu));
+			break;
+		case X86_FIELD_CR32:
+			x86_image_set32(image, offset, emu->cr[fields->number]);
+			break;
+		case X86_FIELD_CR64:
+			x86_image_set64(image, offset, emu->cr[fields->number]);
+			break;
+		case X86_FIELD_DR32:
+			x86_image_set32(image, offset, emu->dr[fields->number]);
+			break;
+		case X86_FIELD_DR64:
+			x86_image_set64(image, offset, emu->dr[fields->number]);
+			break;
+		case X86_FIELD_EFER:
+			x86_image_set64(image, offset, emu->efer);
+			break;
+		case X86_FIELD_SELECTOR16:
+			x86_image_set16(image, offset, emu->sr[fields->number].selector);
+			break;
+		case X86_FIELD_SELECTOR32:
+			x86_image_set32(image, offset, emu->sr[fields->number].selector);
+			break;
+		case X86_FIELD_BASE32:
+			x86_image_set32(image, offset, emu->sr[fields->number].base);
+			break;
+		case X86_FIELD_BASE_HIGH32:
+			x86_image_set32(image, offset, (uint64_t)emu->sr[fields->number].base >> 32);
+			break;
+		case X86_FIELD_LIMIT32:
+			x86_image_set32(image, offset, emu->sr[fields->number].limit);
+			break;
+		case X86_FIELD_CACHE_286:
+			x86_descriptor_cache_encode_286(&image[offset], &emu->sr[fields->number]);
+			break;
+		case X86_FIELD_CACHE_386:
+			x86_descriptor_cache_encode_386(&image[offset], &emu->sr[fields->number]);
+			break;
+		case X86_FIELD_CACHE_P5:
+			x86_descriptor_cache_encode_p5(&image[offset], &emu->sr[fields->number]);
+			break;
+		case X86_FIELD_CACHE_P6:
+			x86_descriptor_cache_encode_p6(&image[offset], &emu->sr[fields->number]);
+			break;
+		case X86_FIELD_CACHE_P4:
+			x86_descriptor_cache_encode_p4(&image[offset], &emu->sr[fields->number]);
+			break;
+		case X86_FIELD_CACHE_K5:
+			x86_descriptor_cache_encode_k5(&image[offset], &emu->sr[fields->number]);
+			break;
+		case X86_FIELD_CACHE_K5_NO_ACCESS:
+			x86_descriptor_cache_encode_k5_no_access(&image[offset], &emu->sr[fields->number]);
+			break;
+		case X86_FIELD_CACHE_AMD64:
+			x86_descriptor_cache_encode_amd64(&image[offset], &emu->sr[fields->number]);
+			break;
+		default:
+			assert(false);
+		}
+	}
+}
+
+static inline void x86_image_load_fields(x86_state_t * emu, const uint8_t * image, size_t start, const x86_image_field_t * fields, bool restart_io)
+{
+	for(; fields->type != X86_FIELD_END; fields++)
+	{
+		size_t offset = fields->offset - start;
+		if(restart_io && (fields->type & X86_FIELD_IO_RESTART) != 0)
+			continue;
+		switch(fields->type & X86_FIELD_TYPE_MASK)
+		{
+		case X86_FIELD_GPR16:
+			emu->gpr[fields->number] = x86_image_get16(image, offset);
+			break;
+		case X86_FIELD_GPR32:
+			emu->gpr[fields->number] = x86_image_get32(image, offset);
+			break;
+		case X86_FIELD_GPR64:
+			emu->gpr[fields->number] = x86_image_get64(image, offset);
+			break;
+		case X86_FIELD_IP16:
+			x86_set_xip(emu, x86_image_get16(image, offset));
+			break;
+		case X86_FIELD_IP32:
+			x86_set_xip(emu, x86_image_get32(image, offset));
+			break;
+		case X86_FIELD_IP64:
+			x86_set_xip(emu, x86_image_get64(image, offset));
+			break;
+		case X86_FIELD_FLAGS32:
+			x86_flags_set32(emu, x86_image_get32(image, offset));
+			break;
+		case X86_FIELD_FLAGS64:
+			x86_flags_set64(emu, x86_image_get64(image, offset));
+			break;
+		case X86_FIELD_CR32:
+			emu->cr[fields->number] = x86_image_get32(image, offset);
+			break;
+		case X86_FIELD_CR64:
+			emu->cr[fields->number] = x86_image_get64(image, offset);
+			break;
+		case X86_FIELD_DR32:
+			emu->dr[fields->number] = x86_image_get32(image, offset);
+			break;
+		case X86_FIELD_DR64:
+			emu->dr[fields->number] = x86_image_get64(image, offset);
+			break;
+		case X86_FIELD_EFER:
+			emu->efer = x86_image_get64(image, offset);
+			break;
+		case X86_FIELD_SELECTOR16:
+		case X86_FIELD_SELECTOR32:
+			emu->sr[fields->number].selector = x86_image_get16(image, offset);
+			break;
+		case X86_FIELD_BASE32:
+			emu->sr[fields->number].base = ((uint64_t)emu->sr[fields->number].base & ~(uint64_t)0xFFFFFFFF) | x86_image_get32(image, offset);
+			break;
+		case X86_FIELD_BASE_HIGH32:
+			emu->sr[fields->number].base = ((uint64_t)emu->sr[fields->number].base & 0xFFFFFFFF) | ((uint64_t)x86_image_get32(image, offset) << 32);
+			break;
+		case X86_FIELD_LIMIT32:
+			emu->sr[fields->number].limit = x86_image_get32(image, offset);
+			break;
+		case X86_FIELD_CACHE_286:
+			x86_descriptor_cache_decode_286(&image[offset], &emu->sr[fields->number]);
+			break;
+		case X86_FIELD_CACHE_386:
+			x86_descriptor_cache_decode_386(&image[offset], &emu->sr[fields->number]);
+			break;
+		case X86_FIELD_CACHE_P5:
+			x86_descriptor_cache_decode_p5(&image[offset], &emu->sr[fields->number]);
+			break;
+		case X86_FIELD_CACHE_P6:
+			x86_descriptor_cache_decode_p6(&image[offset], &emu->sr[fields->number]);
+			break;
+		case X86_FIELD_CACHE_P4:
+			x86_descriptor_cache_decode_p4(&image[offset], &emu->sr[fields->number]);
+			break;
+		case X86_FIELD_CACHE_K5:
+			x86_descriptor_cache_decode_k5(&image[offset], &emu->sr[fields->number]);
+			break;
+		case X86_FIELD_CACHE_K5_NO_ACCESS:
+			x86_descriptor_cache_decode_k5_no_access(&image[offset], &emu->sr[fields->number]);
+			break;
+		case X86_FIELD_CACHE_AMD64:
+			x86_descriptor_cache_decode_amd64(&image[offset], &emu->sr[fields->number]);
+			break;
+		default:
+			assert(false);
+		}
+	}
+}
+
 //// ICE (STOREALL/LOADALL) for 286/386/486
 
+// physical addresses 0x800 to 0x865, MSW and FLAGS are handled separately
+#define X86_ICE_IMAGE_286_START 0x800
+#define X86_ICE_IMAGE_286_SIZE  0x66
+
+static const x86_image_field_t x86_ice_fields_286[] =
+{
+	{ 0x816, X86_FIELD_SELECTOR16, X86_R_TR },
+	{ 0x81A, X86_FIELD_IP16, 0 },
+	{ 0x81C, X86_FIELD_SELECTOR16, X86_R_LDTR },
+	{ 0x81E, X86_FIELD_SELECTOR16, X86_R_DS },
+	{ 0x820, X86_FIELD_SELECTOR16, X86_R_SS },
+	{ 0x822, X86_FIELD_SELECTOR16, X86_R_CS },
+	{ 0x824, X86_FIELD_SELECTOR16, X86_R_ES },
+	{ 0x826, X86_FIELD_GPR16, X86_R_DI },
+	{ 0x828, X86_FIELD_GPR16, X86_R_SI },
+	{ 0x82A, X86_FIELD_GPR16, X86_R_BP },
+	{ 0x82C, X86_FIELD_GPR16, X86_R_SP },
+	{ 0x82E, X86_FIELD_GPR16, X86_R_BX },
+	{ 0x830, X86_FIELD_GPR16, X86_R_DX },
+	{ 0x832, X86_FIELD_GPR16, X86_R_CX },
+	{ 0x834, X86_FIELD_GPR16, X86_R_AX },
+	{ 0x836, X86_FIELD_CACHE_286, X86_R_ES },
+	{ 0x83C, X86_FIELD_CACHE_286, X86_R_CS },
+	{ 0x842, X86_FIELD_CACHE_286, X86_R_SS },
+	{ 0x848, X86_FIELD_CACHE_286, X86_R_DS },
+	{ 0x84E, X86_FIELD_CACHE_286, X86_R_GDTR }, // TODO: access byte should be 0xFF
+	{ 0x854, X86_FIELD_CACHE_286, X86_R_LDTR }, // TODO: access byte should be ORed with 0x7F
+	{ 0x85A, X86_FIELD_CACHE_286, X86_R_IDTR }, // TODO: access byte should be 0xFF
+	{ 0x860, X86_FIELD_CACHE_286, X86_R_TR }, // TODO: access byte should be 0xFF
+	{ 0 },
+};
+
+// relative to ES:EDI for LOADALL
+#define X86_ICE_IMAGE_386_SIZE 0xCC
+
+static const x86_image_field_t x86_ice_fields_386[] =
+{
+	{ 0x00, X86_FIELD_CR32, 0 },
+	{ 0x04, X86_FIELD_FLAGS32, 0 },
+	{ 0x08, X86_FIELD_IP32, 0 },
+	{ 0x0C, X86_FIELD_GPR32, X86_R_DI },
+	{ 0x10, X86_FIELD_GPR32, X86_R_SI },
+	{ 0x14, X86_FIELD_GPR32, X86_R_BP },
+	{ 0x18, X86_FIELD_GPR32, X86_R_SP },
+	{ 0x1C, X86_FIELD_GPR32, X86_R_BX },
+	{ 0x20, X86_FIELD_GPR32, X86_R_DX },
+	{ 0x24, X86_FIELD_GPR32, X86_R_CX },
+	{ 0x28, X86_FIELD_GPR32, X86_R_AX },
+	{ 0x2C, X86_FIELD_DR32, 6 },
+	{ 0x30, X86_FIELD_DR32, 7 },
+	{ 0x34, X86_FIELD_SELECTOR32, X86_R_TR },
+	{ 0x38, X86_FIELD_SELECTOR32, X86_R_LDTR },
+	{ 0x3C, X86_FIELD_SELECTOR32, X86_R_GS },
+	{ 0x40, X86_FIELD_SELECTOR32, X86_R_FS },
+	{ 0x44, X86_FIELD_SELECTOR32, X86_R_DS },
+	{ 0x48, X86_FIELD_SELECTOR32, X86_R_SS },
+	{ 0x4C, X86_FIELD_SELECTOR32, X86_R_CS },
+	{ 0x50, X86_FIELD_SELECTOR32, X86_R_ES },
+	{ 0x54, X86_FIELD_CACHE_386, X86_R_TR },
+	{ 0x60, X86_FIELD_CACHE_386, X86_R_IDTR },
+	{ 0x6C, X86_FIELD_CACHE_386, X86_R_GDTR },
+	{ 0x78, X86_FIELD_CACHE_386, X86_R_LDTR },
+	{ 0x84, X86_FIELD_CACHE_386, X86_R_GS },
+	{ 0x90, X86_FIELD_CACHE_386, X86_R_FS },
+	{ 0x9C, X86_FIELD_CACHE_386, X86_R_DS },
+	{ 0xA8, X86_FIELD_CACHE_386, X86_R_SS },
+	{ 0xB4, X86_FIELD_CACHE_386, X86_R_CS },
+	{ 0xC0, X86_FIELD_CACHE_386, X86_R_ES },
+	{ 0 },
+};
+
 static inline void x86_ice_storeall_286(x86_state_t * emu)
 {
+	uint8_t image[X86_ICE_IMAGE_286_SIZE];
+	memset(image, 0, sizeof image);
+	x86_image_set16(image, 0x806 - X86_ICE_IMAGE_286_START, emu->cr[0] & 0xFFF0); // MSW
+	x86_image_set16(image, 0x818 - X86_ICE_IMAGE_286_START, (x86_flags_get16(emu) & 0x7FD5) | 0x0002);
+	x86_image_store_fields(emu, image, X86_ICE_IMAGE_286_START, x86_ice_fields_286);
+
 	emu->cpu_level = X86_LEVEL_ICE;
 	// the F1 prefix can override the level for the following writes
-	x86_memory_write16(emu, 0x00806, emu->cr[0] & 0xFFF0); // MSW
-	x86_memory_write16(emu, 0x00818, (x86_flags_get16(emu) & 0x7FD5) | 0x0002);
-	x86_memory_write16(emu, 0x0081A, emu->xip);
-	x86_memory_write16(emu, 0x0081C, emu->sr[X86_R_LDTR].selector);
-	x86_memory_write16(emu, 0x0081E, emu->sr[X86_R_DS].selector);
-	x86_memory_write16(emu, 0x00820, emu->sr[X86_R_SS].selector);
-	x86_memory_write16(emu, 0x00822, emu->sr[X86_R_CS].selector);
-	x86_memory_write16(emu, 0x00824, emu->sr[X86_R_ES].selector);
-	x86_memory_write16(emu, 0x00826, emu->gpr[X86_R_DI]);
-	x86_memory_write16(emu, 0x00828, emu->gpr[X86_R_SI]);
-	x86_memory_write16(emu, 0x0082A, emu->gpr[X86_R_BP]);
-	x86_memory_write16(emu, 0x0082C, emu->gpr[X86_R_SP]);
-	x86_memory_write16(emu, 0x0082E, emu->gpr[X86_R_BX]);
-	x86_memory_write16(emu, 0x00830, emu->gpr[X86_R_DX]);
-	x86_memory_write16(emu, 0x00832, emu->gpr[X86_R_CX]);
-	x86_memory_write16(emu, 0x00834, emu->gpr[X86_R_AX]);
-	x86_descriptor_cache_write_286(emu, 0x00836, &emu->sr[X86_R_ES]);
-	x86_descriptor_cache_write_286(emu, 0x0083C, &emu->sr[X86_R_CS]);
-	x86_descriptor_cache_write_286(emu, 0x00842, &emu->sr[X86_R_SS]);
-	x86_descriptor_cache_write_286(emu, 0x00848, &emu->sr[X86_R_DS]);
-	x86_descriptor_cache_write_286(emu, 0x0084E, &emu->sr[X86_R_GDTR]); // TODO: access byte should be 0xFF
-	x86_descriptor_cache_write_286(emu, 0x00854, &emu->sr[X86_R_LDTR]); // TODO: access byte should be ORed with 0x7F
-	x86_descriptor_cache_write_286(emu, 0x0085A, &emu->sr[X86_R_IDTR]); // TODO: access byte should be 0xFF
-	x86_descriptor_cache_write_286(emu, 0x00860, &emu->sr[X86_R_TR]); // TODO: access byte should be 0xFF
+	x86_memory_write(emu, X86_ICE_IMAGE_286_START, sizeof image, image);
 
 	//x86_reset(false);
 	for(int i = 0; i < 4; i++)
@@ -347,67 +642,21 @@ static inline void x86_ice_storeall_286(x86_state_t * emu)
 
 static inline void x86_ice_loadall_286(x86_state_t * emu)
 {
-	emu->cr[0] = (emu->cr[0] & ~0xFFFE) | x86_memory_read16(emu, 0x00804); // MSW
-	emu->sr[X86_R_TR].selector = x86_memory_read16(emu, 0x00816);
-	x86_flags_set16(emu, (x86_memory_read16(emu, 0x00818) & 0x7FD5) | 0x0002);
-	x86_set_xip(emu, x86_memory_read16(emu, 0x0081A));
-	emu->sr[X86_R_LDTR].selector = x86_memory_read16(emu, 0x0081C);
-	emu->sr[X86_R_DS].selector = x86_memory_read16(emu, 0x0081E);
-	emu->sr[X86_R_SS].selector = x86_memory_read16(emu, 0x00820);
-	emu->sr[X86_R_CS].selector = x86_memory_read16(emu, 0x00822);
-	emu->sr[X86_R_ES].selector = x86_memory_read16(emu, 0x00824);
-	emu->gpr[X86_R_DI] = x86_memory_read16(emu, 0x00826);
-	emu->gpr[X86_R_SI] = x86_memory_read16(emu, 0x00828);
-	emu->gpr[X86_R_BP] = x86_memory_read16(emu, 0x0082A);
-	emu->gpr[X86_R_SP] = x86_memory_read16(emu, 0x0082C);
-	emu->gpr[X86_R_BX] = x86_memory_read16(emu, 0x0082E);
-	emu->gpr[X86_R_DX] = x86_memory_read16(emu, 0x00830);
-	emu->gpr[X86_R_CX] = x86_memory_read16(emu, 0x00832);
-	emu->gpr[X86_R_AX] = x86_memory_read16(emu, 0x00834);
-	x86_descriptor_cache_read_286(emu, 0x00836, &emu->sr[X86_R_ES]);
-	x86_descriptor_cache_read_286(emu, 0x0083C, &emu->sr[X86_R_CS]);
-	x86_descriptor_cache_read_286(emu, 0x00842, &emu->sr[X86_R_SS]);
-	x86_descriptor_cache_read_286(emu, 0x00848, &emu->sr[X86_R_DS]);
-	x86_descriptor_cache_read_286(emu, 0x0084E, &emu->sr[X86_R_GDTR]);
-	x86_descriptor_cache_read_286(emu, 0x00854, &emu->sr[X86_R_LDTR]);
-	x86_descriptor_cache_read_286(emu, 0x0085A, &emu->sr[X86_R_IDTR]);
-	x86_descriptor_cache_read_286(emu, 0x00860, &emu->sr[X86_R_TR]);
+	uint8_t image[X86_ICE_IMAGE_286_SIZE];
+	x86_memory_read(emu, X86_ICE_IMAGE_286_START, sizeof image, image);
+	emu->cr[0] = (emu->cr[0] & ~0xFFFE) | x86_image_get16(image, 0x806 - X86_ICE_IMAGE_286_START); // MSW
+	x86_flags_set16(emu, (x86_image_get16(image, 0x818 - X86_ICE_IMAGE_286_START) & 0x7FD5) | 0x0002);
+	x86_image_load_fields(emu, image, X86_ICE_IMAGE_286_START, x86_ice_fields_286, false);
 	x86_set_cpl(emu, (emu->sr[X86_R_SS].access >> X86_DESC_DPL_SHIFT) & 3);
 	emu->cpu_level = X86_LEVEL_USER;
 }
 
 static inline void x86_ice_storeall_386(x86_state_t * emu, uaddr_t offset)
 {
-	x86_memory_write32(emu, offset + 0x04, x86_flags_get32(emu));
-	x86_memory_write32(emu, offset + 0x08, emu->xip);
-	x86_memory_write32(emu, offset + 0x0C, emu->gpr[X86_R_DI]);
-	x86_memory_write32(emu, offset + 0x10, emu->gpr[X86_R_SI]);
-	x86_memory_write32(emu, offset + 0x14, emu->gpr[X86_R_BP]);
-	x86_memory_write32(emu, offset + 0x18, emu->gpr[X86_R_SP]);
-	x86_memory_write32(emu, offset + 0x1C, emu->gpr[X86_R_BX]);
-	x86_memory_write32(emu, offset + 0x20, emu->gpr[X86_R_DX]);
-	x86_memory_write32(emu, offset + 0x24, emu->gpr[X86_R_CX]);
-	x86_memory_write32(emu, offset + 0x28, emu->gpr[X86_R_AX]);
-	x86_memory_write32(emu, offset + 0x2C, emu->dr[6]);
-	x86_memory_write32(emu, offset + 0x30, emu->dr[7]);
-	x86_memory_write32(emu, offset + 0x34, emu->sr[X86_R_TR].selector);
-	x86_memory_write32(emu, offset + 0x38, emu->sr[X86_R_LDTR].selector);
-	x86_memory_write32(emu, offset + 0x3C, emu->sr[X86_R_GS].selector);
-	x86_memory_write32(emu, offset + 0x40, emu->sr[X86_R_FS].selector);
-	x86_memory_write32(emu, offset + 0x44, emu->sr[X86_R_DS].selector);
-	x86_memory_write32(emu, offset + 0x48, emu->sr[X86_R_SS].selector);
-	x86_memory_write32(emu, offset + 0x4C, emu->sr[X86_R_CS].selector);
-	x86_memory_write32(emu, offset + 0x50, emu->sr[X86_R_ES].selector);
-	x86_descriptor_cache_write_386(emu, offset + 0x54, &emu->sr[X86_R_TR]);
-	x86_descriptor_cache_write_386(emu, offset + 0x60, &emu->sr[X86_R_IDTR]);
-	x86_descriptor_cache_write_386(emu, offset + 0x6C, &emu->sr[X86_R_GDTR]);
-	x86_descriptor_cache_write_386(emu, offset + 0x78, &emu->sr[X86_R_LDTR]);
-	x86_descriptor_cache_write_386(emu, offset + 0x84, &emu->sr[X86_R_GS]);
-	x86_descriptor_cache_write_386(emu, offset + 0x90, &emu->sr[X86_R_FS]);
-	x86_descriptor_cache_write_386(emu, offset + 0x9C, &emu->sr[X86_R_DS]);
-	x86_descriptor_cache_write_386(emu, offset + 0xA8, &emu->sr[X86_R_SS]);
-	x86_descriptor_cache_write_386(emu, offset + 0xB4, &emu->sr[X86_R_CS]);
-	x86_descriptor_cache_write_386(emu, offset + 0xC0, &emu->sr[X86_R_ES]);
+	uint8_t image[X86_ICE_IMAGE_386_SIZE];
+	memset(image, 0, sizeof image);
+	x86_image_store_fields(emu, image, 0, x86_ice_fields_386);
+	x86_memory_write(emu, offset, sizeof image, image);
 
 	//x86_reset(false);
 	for(int i = 0; i < 8; i++)
@@ -481,37 +730,9 @@ static inline void x86_ice_storeall_386(x86_state_t * emu, uaddr_t offset)
 
 static inline void x86_ice_loadall_386(x86_state_t * emu, uaddr_t offset)
 {
-	emu->cr[0] = x86_memory_read32(emu, offset + 0x00);
-	x86_flags_set32(emu, x86_memory_read32(emu, offset + 0x04));
-	x86_set_xip(emu, x86_memory_read32(emu, offset + 0x08));
-	emu->gpr[X86_R_DI] = x86_memory_read32(emu, offset + 0x0C);
-	emu->gpr[X86_R_SI] = x86_memory_read32(emu, offset + 0x10);
-	emu->gpr[X86_R_BP] = x86_memory_read32(emu, offset + 0x14);
-	emu->gpr[X86_R_SP] = x86_memory_read32(emu, offset + 0x18);
-	emu->gpr[X86_R_BX] = x86_memory_read32(emu, offset + 0x1C);
-	emu->gpr[X86_R_DX] = x86_memory_read32(emu, offset + 0x20);
-	emu->gpr[X86_R_CX] = x86_memory_read32(emu, offset + 0x24);
-	emu->gpr[X86_R_AX] = x86_memory_read32(emu, offset + 0x28);
-	emu->dr[6] = x86_memory_read32(emu, offset + 0x2C);
-	emu->dr[7] = x86_memory_read32(emu, offset + 0x30);
-	emu->sr[X86_R_TR].selector = x86_memory_read16(emu, offset + 0x34);
-	emu->sr[X86_R_LDTR].selector = x86_memory_read16(emu, offset + 0x38);
-	emu->sr[X86_R_GS].selector = x86_memory_read16(emu, offset + 0x3C);
-	emu->sr[X86_R_FS].selector = x86_memory_read16(emu, offset + 0x40);
-	emu->sr[X86_R_DS].selector = x86_memory_read16(emu, offset + 0x44);
-	emu->sr[X86_R_SS].selector = x86_memory_read16(emu, offset + 0x48);
-	emu->sr[X86_R_CS].selector = x86_memory_read16(emu, offset + 0x4C);
-	emu->sr[X86_R_ES].selector = x86_memory_read16(emu, offset + 0x50);
-	x86_descriptor_cache_read_386(emu, offset + 0x54, &emu->sr[X86_R_TR]);
-	x86_descriptor_cache_read_386(emu, offset + 0x60, &emu->sr[X86_R_IDTR]);
-	x86_descriptor_cache_read_386(emu, offset + 0x6C, &emu->sr[X86_R_GDTR]);
-	x86_descriptor_cache_read_386(emu, offset + 0x78, &emu->sr[X86_R_LDTR]);
-	x86_descriptor_cache_read_386(emu, offset + 0x84, &emu->sr[X86_R_GS]);
-	x86_descriptor_cache_read_386(emu, offset + 0x90, &emu->sr[X86_R_FS]);
-	x86_descriptor_cache_read_386(emu, offset + 0x9C, &emu->sr[X86_R_DS]);
-	x86_descriptor_cache_read_386(emu, offset + 0xA8, &emu->sr[X86_R_SS]);
-	x86_descriptor_cache_read_386(emu, offset + 0xB4, &emu->sr[X86_R_CS]);
-	x86_descriptor_cache_read_386(emu, offset + 0xC0, &emu->sr[X86_R_ES]);
+	uint8_t image[X86_ICE_IMAGE_386_SIZE];
+	x86_memory_read(emu, offset, sizeof image, image);
+	x86_image_load_fields(emu, image, 0, x86_ice_fields_386, false);
 	x86_set_cpl(emu,  (emu->sr[X86_R_SS].access >> X86_DESC_DPL_SHIFT) & 3);
 	emu->cpu_level = X86_LEVEL_USER;
 }
@@ -544,6 +765,239 @@ static inline bool x86_io_instruction_is_string(x86_io_type_t io_type)
 	}
 }
 
+// State save maps
+
+// the 32-bit and AMD64 maps occupy SMBASE + 0xFE00 to SMBASE + 0xFFFF, the offsets are given relative to SMBASE + 0x8000
+#define X86_SMM_IMAGE_START 0x7E00
+#define X86_SMM_IMAGE_SIZE  0x200
+
+// the Intel 64-bit map extends below SMBASE + 0xFE00
+#define X86_SMM_INTEL64_IMAGE_START 0x7C00
+#define X86_SMM_INTEL64_IMAGE_SIZE  0x400
+
+// the Cyrix header is placed below the header address, the offsets are given as distances below it
+#define X86_SMM_CYRIX_IMAGE_SIZE 0x34
+#define X86_SMM_CYRIX_HEADER(offset) (X86_SMM_CYRIX_IMAGE_SIZE - (offset))
+
+static const x86_image_field_t x86_smm_fields_32[] =
+{
+	{ 0x7FFC, X86_FIELD_CR32, 0 },
+	{ 0x7FF8, X86_FIELD_CR32, 3 },
+	{ 0x7FF4, X86_FIELD_FLAGS32, 0 },
+	{ 0x7FF0, X86_FIELD_IP32 | X86_FIELD_IO_RESTART, 0 },
+	{ 0x7FEC, X86_FIELD_GPR32 | X86_FIELD_IO_RESTART, X86_R_DI },
+	{ 0x7FE8, X86_FIELD_GPR32 | X86_FIELD_IO_RESTART, X86_R_SI },
+	{ 0x7FE4, X86_FIELD_GPR32, X86_R_BP },
+	{ 0x7FE0, X86_FIELD_GPR32, X86_R_SP },
+	{ 0x7FDC, X86_FIELD_GPR32, X86_R_BX },
+	{ 0x7FD8, X86_FIELD_GPR32, X86_R_DX },
+	{ 0x7FD4, X86_FIELD_GPR32 | X86_FIELD_IO_RESTART, X86_R_CX },
+	{ 0x7FD0, X86_FIELD_GPR32, X86_R_AX },
+	{ 0x7FCC, X86_FIELD_DR32, 6 },
+	{ 0x7FC8, X86_FIELD_DR32, 7 },
+	{ 0x7FC4, X86_FIELD_SELECTOR32, X86_R_TR },
+	{ 0x7FC0, X86_FIELD_SELECTOR32, X86_R_LDTR },
+	{ 0x7FBC, X86_FIELD_SELECTOR32, X86_R_GS },
+	{ 0x7FB8, X86_FIELD_SELECTOR32, X86_R_FS },
+	{ 0x7FB4, X86_FIELD_SELECTOR32, X86_R_DS },
+	{ 0x7FB0, X86_FIELD_SELECTOR32, X86_R_SS },
+	{ 0x7FAC, X86_FIELD_SELECTOR32, X86_R_CS },
+	{ 0x7FA8, X86_FIELD_SELECTOR32, X86_R_ES },
+	{ 0 },
+};
+
+// Robert R. Collins: The Secrets of System Management Mode
+static const x86_image_field_t x86_smm_fields_80386sl[] =
+{
+	{ 0x7F9C, X86_FIELD_CACHE_386, X86_R_TR },
+	{ 0x7F90, X86_FIELD_CACHE_386, X86_R_IDTR },
+	{ 0x7F84, X86_FIELD_CACHE_386, X86_R_GDTR },
+	{ 0x7F78, X86_FIELD_CACHE_386, X86_R_LDTR },
+	{ 0x7F6C, X86_FIELD_CACHE_386, X86_R_GS },
+	{ 0x7F60, X86_FIELD_CACHE_386, X86_R_FS },
+	{ 0x7F54, X86_FIELD_CACHE_386, X86_R_DS },
+	{ 0x7F48, X86_FIELD_CACHE_386, X86_R_SS },
+	{ 0x7F3C, X86_FIELD_CACHE_386, X86_R_CS },
+	{ 0x7F30, X86_FIELD_CACHE_386, X86_R_ES },
+	{ 0x7F28, X86_FIELD_CR32, 4 },
+	//{ 0x7F26, /* RSM control */ }, // TODO
+	//{ 0x7F24, X86_FIELD_DR32, 6 }, // TODO: alternate DR6
+	{ 0 },
+};
+
+// Robert R. Collins: The Secrets of System Management Mode, sandpile.org
+static const x86_image_field_t x86_smm_fields_p5[] =
+{
+	{ 0x7F9C, X86_FIELD_CACHE_P5, X86_R_TR },
+	{ 0x7F90, X86_FIELD_CACHE_P5, X86_R_IDTR },
+	{ 0x7F84, X86_FIELD_CACHE_P5, X86_R_GDTR },
+	{ 0x7F78, X86_FIELD_CACHE_P5, X86_R_LDTR },
+	{ 0x7F6C, X86_FIELD_CACHE_P5, X86_R_GS },
+	{ 0x7F60, X86_FIELD_CACHE_P5, X86_R_FS },
+	{ 0x7F54, X86_FIELD_CACHE_P5, X86_R_DS },
+	{ 0x7F48, X86_FIELD_CACHE_P5, X86_R_SS },
+	{ 0x7F3C, X86_FIELD_CACHE_P5, X86_R_CS },
+	{ 0x7F30, X86_FIELD_CACHE_P5, X86_R_ES },
+	{ 0x7F28, X86_FIELD_CR32, 4 },
+	//{ 0x7F26, /* RSM control */ }, // TODO
+	//{ 0x7F24, X86_FIELD_DR32, 6 }, // TODO: alternate DR6
+	{ 0 },
+};
+
+// sandpile.org
+static const x86_image_field_t x86_smm_fields_p6[] =
+{
+	{ 0x7F9C, X86_FIELD_CACHE_P6, X86_R_SS },
+	{ 0x7F90, X86_FIELD_CACHE_P6, X86_R_CS },
+	{ 0x7F84, X86_FIELD_CACHE_P6, X86_R_ES },
+	{ 0x7F78, X86_FIELD_CACHE_P6, X86_R_LDTR },
+	{ 0x7F6C, X86_FIELD_CACHE_P6, X86_R_GDTR },
+	// TODO: undocumented field inbetween
+	{ 0x7F5C, X86_FIELD_CACHE_P6, X86_R_TR },
+	{ 0x7F50, X86_FIELD_CACHE_P6, X86_R_IDTR },
+	{ 0x7F44, X86_FIELD_CACHE_P6, X86_R_GS },
+	{ 0x7F38, X86_FIELD_CACHE_P6, X86_R_FS },
+	{ 0x7F2C, X86_FIELD_CACHE_P6, X86_R_DS },
+	//{ 0x7F26, /* RSM control */ }, // TODO
+	//{ 0x7F24, X86_FIELD_DR32, 6 }, // TODO: alternate DR6
+	// TODO: a couple of undocumented fields
+	{ 0x7F14, X86_FIELD_CR32, 4 },
+	{ 0 },
+};
+
+// sandpile.org
+static const x86_image_field_t x86_smm_fields_p4[] =
+{
+	{ 0x7F6C, X86_FIELD_CACHE_P4, X86_R_TR },
+	{ 0x7F5C, X86_FIELD_CACHE_P4, X86_R_LDTR },
+	{ 0x7F58, X86_FIELD_LIMIT32, X86_R_IDTR },
+	{ 0x7F54, X86_FIELD_BASE32, X86_R_IDTR },
+	{ 0x7F50, X86_FIELD_LIMIT32, X86_R_GDTR },
+	{ 0x7F4C, X86_FIELD_BASE32, X86_R_GDTR },
+	{ 0x7F40, X86_FIELD_CACHE_P4, X86_R_GS },
+	{ 0x7F34, X86_FIELD_CACHE_P4, X86_R_FS },
+	{ 0x7F28, X86_FIELD_CACHE_P4, X86_R_DS },
+	{ 0x7F1C, X86_FIELD_CACHE_P4, X86_R_SS },
+	{ 0x7F10, X86_FIELD_CACHE_P4, X86_R_CS },
+	{ 0 },
+};
+
+static const x86_image_field_t x86_smm_fields_k5[] =
+{
+	{ 0x7F8C, X86_FIELD_CACHE_K5_NO_ACCESS, X86_R_IDTR },
+	{ 0x7F84, X86_FIELD_CACHE_K5_NO_ACCESS, X86_R_GDTR },
+	{ 0x7F78, X86_FIELD_CACHE_K5, X86_R_TR },
+	{ 0x7F6C, X86_FIELD_CACHE_K5, X86_R_LDTR },
+	{ 0x7F60, X86_FIELD_CACHE_K5, X86_R_GS },
+	{ 0x7F54, X86_FIELD_CACHE_K5, X86_R_FS },
+	{ 0x7F48, X86_FIELD_CACHE_K5, X86_R_DS },
+	{ 0x7F3C, X86_FIELD_CACHE_K5, X86_R_SS },
+	{ 0x7F30, X86_FIELD_CACHE_K5, X86_R_CS },
+	{ 0x7F24, X86_FIELD_CACHE_K5, X86_R_ES },
+	{ 0x7F14, X86_FIELD_CR32, 2 },
+	{ 0x7F10, X86_FIELD_CR32, 4 },
+	{ 0 },
+};
+
+static const x86_image_field_t x86_smm_fields_amd64[] =
+{
+	{ 0x7FF8, X86_FIELD_GPR64, X86_R_AX },
+	{ 0x7FF0, X86_FIELD_GPR64 | X86_FIELD_IO_RESTART, X86_R_CX },
+	{ 0x7FE8, X86_FIELD_GPR64, X86_R_DX },
+	{ 0x7FE0, X86_FIELD_GPR64, X86_R_BX },
+	{ 0x7FD8, X86_FIELD_GPR64, X86_R_SP },
+	{ 0x7FD0, X86_FIELD_GPR64, X86_R_BP },
+	{ 0x7FC8, X86_FIELD_GPR64 | X86_FIELD_IO_RESTART, X86_R_SI },
+	{ 0x7FC0, X86_FIELD_GPR64 | X86_FIELD_IO_RESTART, X86_R_DI },
+	{ 0x7FB8, X86_FIELD_GPR64, 8 },
+	{ 0x7FB0, X86_FIELD_GPR64, 9 },
+	{ 0x7FA8, X86_FIELD_GPR64, 10 },
+	{ 0x7FA0, X86_FIELD_GPR64, 11 },
+	{ 0x7F98, X86_FIELD_GPR64, 12 },
+	{ 0x7F90, X86_FIELD_GPR64, 13 },
+	{ 0x7F88, X86_FIELD_GPR64, 14 },
+	{ 0x7F80, X86_FIELD_GPR64, 15 },
+	{ 0x7F78, X86_FIELD_IP64 | X86_FIELD_IO_RESTART, 0 },
+	{ 0x7F70, X86_FIELD_FLAGS64, 0 },
+	{ 0x7F68, X86_FIELD_DR64, 6 },
+	{ 0x7F60, X86_FIELD_DR64, 7 },
+	{ 0x7F58, X86_FIELD_CR64, 0 },
+	{ 0x7F50, X86_FIELD_CR64, 3 },
+	{ 0x7F48, X86_FIELD_CR64, 4 },
+	{ 0x7ED0, X86_FIELD_EFER, 0 },
+	{ 0 },
+};
+
+// loaded after the CPL, since x86_set_cpl updates the access rights of CS and SS
+static const x86_image_field_t x86_smm_caches_amd64[] =
+{
+	{ 0x7E90, X86_FIELD_CACHE_AMD64, X86_R_TR },
+	{ 0x7E80, X86_FIELD_CACHE_AMD64, X86_R_IDTR },
+	{ 0x7E70, X86_FIELD_CACHE_AMD64, X86_R_LDTR },
+	{ 0x7E60, X86_FIELD_CACHE_AMD64, X86_R_GDTR },
+	{ 0x7E50, X86_FIELD_CACHE_AMD64, X86_R_GS },
+	{ 0x7E40, X86_FIELD_CACHE_AMD64, X86_R_FS },
+	{ 0x7E30, X86_FIELD_CACHE_AMD64, X86_R_DS },
+	{ 0x7E20, X86_FIELD_CACHE_AMD64, X86_R_SS },
+	{ 0x7E10, X86_FIELD_CACHE_AMD64, X86_R_CS },
+	{ 0x7E00, X86_FIELD_CACHE_AMD64, X86_R_ES },
+	{ 0 },
+};
+
+// TODO: much of this is undocumented and unknown
+static const x86_image_field_t x86_smm_fields_intel64[] =
+{
+	{ 0x7FF8, X86_FIELD_CR64, 0 },
+	{ 0x7FF0, X86_FIELD_CR64, 3 },
+	{ 0x7FE8, X86_FIELD_FLAGS64, 0 },
+	{ 0x7FE0, X86_FIELD_EFER, 0 },
+	{ 0x7FD8, X86_FIELD_IP64 | X86_FIELD_IO_RESTART, 0 },
+	{ 0x7FD0, X86_FIELD_DR64, 6 },
+	{ 0x7FC8, X86_FIELD_DR64, 7 },
+	{ 0x7FC4, X86_FIELD_SELECTOR16, X86_R_TR },
+	{ 0x7FC0, X86_FIELD_SELECTOR16, X86_R_LDTR },
+	{ 0x7FBC, X86_FIELD_SELECTOR16, X86_R_GS },
+	{ 0x7FB8, X86_FIELD_SELECTOR16, X86_R_FS },
+	{ 0x7FB4, X86_FIELD_SELECTOR16, X86_R_DS },
+	{ 0x7FB0, X86_FIELD_SELECTOR16, X86_R_SS },
+	{ 0x7FAC, X86_FIELD_SELECTOR16, X86_R_CS },
+	{ 0x7FA8, X86_FIELD_SELECTOR16, X86_R_ES },
+	{ 0x7F94, X86_FIELD_GPR64, X86_R_DI },
+	{ 0x7F8C, X86_FIELD_GPR64, X86_R_SI },
+	{ 0x7F84, X86_FIELD_GPR64, X86_R_BP },
+	{ 0x7F7C, X86_FIELD_GPR64, X86_R_SP },
+	{ 0x7F74, X86_FIELD_GPR64, X86_R_BX },
+	{ 0x7F6C, X86_FIELD_GPR64, X86_R_DX },
+	{ 0x7F64, X86_FIELD_GPR64, X86_R_CX },
+	{ 0x7F5C, X86_FIELD_GPR64, X86_R_AX },
+	{ 0x7F54, X86_FIELD_GPR64, 8 },
+	{ 0x7F4C, X86_FIELD_GPR64, 9 },
+	{ 0x7F44, X86_FIELD_GPR64, 10 },
+	{ 0x7F3C, X86_FIELD_GPR64, 11 },
+	{ 0x7F34, X86_FIELD_GPR64, 12 },
+	{ 0x7F2C, X86_FIELD_GPR64, 13 },
+	{ 0x7F24, X86_FIELD_GPR64, 14 },
+	{ 0x7F1C, X86_FIELD_GPR64, 15 },
+	{ 0x7E9C, X86_FIELD_BASE32, X86_R_LDTR },
+	{ 0x7E94, X86_FIELD_BASE32, X86_R_IDTR },
+	{ 0x7E8C, X86_FIELD_BASE32, X86_R_GDTR },
+	{ 0x7E40, X86_FIELD_CR64, 4 },
+	{ 0x7DD8, X86_FIELD_BASE_HIGH32, X86_R_IDTR },
+	{ 0x7DD4, X86_FIELD_BASE_HIGH32, X86_R_LDTR },
+	{ 0x7DD0, X86_FIELD_BASE_HIGH32, X86_R_GDTR },
+	{ 0 },
+};
+
+static const x86_image_field_t x86_smm_fields_cyrix[] =
+{
+	{ X86_SMM_CYRIX_HEADER(0x04), X86_FIELD_DR32, 7 },
+	{ X86_SMM_CYRIX_HEADER(0x08), X86_FIELD_FLAGS32, 0 },
+	{ X86_SMM_CYRIX_HEADER(0x0C), X86_FIELD_CR32, 0 },
+	{ X86_SMM_CYRIX_HEADER(0x14), X86_FIELD_IP32, 0 },
+	{ X86_SMM_CYRIX_HEADER(0x18), X86_FIELD_SELECTOR16, X86_R_CS },
+	{ 0 },
+};
+
 static inline void x86_smm_store_state32(x86_state_t * emu, uaddr_t offset, x86_smi_attributes_t attributes)
 {
 	bool is_ins_io = attributes.source == X86_SMISRC_IO;
@@ -572,97 +1026,33 @@ static inline void x86_smm_store_state32(x86_state_t * emu, uaddr_t offset, x86_
 	}
 	uint32_t io_misc_info;
 
+	uint8_t image[X86_SMM_IMAGE_SIZE];
+	memset(image, 0, sizeof image);
+
 	switch(emu->cpu_traits.smm_format)
 	{
 	default:
 		assert(false);
 
 	case X86_SMM_80386SL:
-		// Robert R. Collins: The Secrets of System Management Mode
-		x86_descriptor_cache_write_386(emu, offset - 0x8000 + 0x7F9C, &emu->sr[X86_R_TR]);
-		x86_descriptor_cache_write_386(emu, offset - 0x8000 + 0x7F90, &emu->sr[X86_R_IDTR]);
-		x86_descriptor_cache_write_386(emu, offset - 0x8000 + 0x7F85, &emu->sr[X86_R_GDTR]);
-		x86_descriptor_cache_write_386(emu, offset - 0x8000 + 0x7F78, &emu->sr[X86_R_LDTR]);
-		x86_descriptor_cache_write_386(emu, offset - 0x8000 + 0x7F6C, &emu->sr[X86_R_GS]);
-		x86_descriptor_cache_write_386(emu, offset - 0x8000 + 0x7F60, &emu->sr[X86_R_FS]);
-		x86_descriptor_cache_write_386(emu, offset - 0x8000 + 0x7F54, &emu->sr[X86_R_DS]);
-		x86_descriptor_cache_write_386(emu, offset - 0x8000 + 0x7F48, &emu->sr[X86_R_SS]);
-		x86_descriptor_cache_write_386(emu, offset - 0x8000 + 0x7F3C, &emu->sr[X86_R_CS]);
-		x86_descriptor_cache_write_386(emu, offset - 0x8000 + 0x7F30, &emu->sr[X86_R_ES]);
-		x86_memory_write32(emu, offset - 0x8000 + 0x7F28, emu->cr[4]);
-		//x86_memory_write16(emu, offset - 0x8000 + 0x7F26, /* RSM control */); // TODO
-		//x86_memory_write16(emu, offset - 0x8000 + 0x7F24, emu->dr[6]); // TODO: alternate DR6
-		if(is_ins_io)
-		{
-			x86_memory_write32(emu, offset - 0x8000 + 0x7F10, emu->old_xip);
-			x86_memory_write32(emu, offset - 0x8000 + 0x7F0C, emu->io_restart_xsi);
-			x86_memory_write32(emu, offset - 0x8000 + 0x7F08, emu->io_restart_xcx);
-			x86_memory_write32(emu, offset - 0x8000 + 0x7F04, emu->io_restart_xdi); // TODO: or CR0
-		}
-		break;
 	case X86_SMM_P5:
-		// Robert R. Collins: The Secrets of System Management Mode, sandpile.org
-		x86_descriptor_cache_write_p5(emu, offset - 0x8000 + 0x7F9C, &emu->sr[X86_R_TR]);
-		x86_descriptor_cache_write_p5(emu, offset - 0x8000 + 0x7F90, &emu->sr[X86_R_IDTR]);
-		x86_descriptor_cache_write_p5(emu, offset - 0x8000 + 0x7F85, &emu->sr[X86_R_GDTR]);
-		x86_descriptor_cache_write_p5(emu, offset - 0x8000 + 0x7F78, &emu->sr[X86_R_LDTR]);
-		x86_descriptor_cache_write_p5(emu, offset - 0x8000 + 0x7F6C, &emu->sr[X86_R_GS]);
-		x86_descriptor_cache_write_p5(emu, offset - 0x8000 + 0x7F60, &emu->sr[X86_R_FS]);
-		x86_descriptor_cache_write_p5(emu, offset - 0x8000 + 0x7F54, &emu->sr[X86_R_DS]);
-		x86_descriptor_cache_write_p5(emu, offset - 0x8000 + 0x7F48, &emu->sr[X86_R_SS]);
-		x86_descriptor_cache_write_p5(emu, offset - 0x8000 + 0x7F3C, &emu->sr[X86_R_CS]);
-		x86_descriptor_cache_write_p5(emu, offset - 0x8000 + 0x7F30, &emu->sr[X86_R_ES]);
-		x86_memory_write32(emu, offset - 0x8000 + 0x7F28, emu->cr[4]);
-		//x86_memory_write16(emu, offset - 0x8000 + 0x7F26, /* RSM control */); // TODO
-		//x86_memory_write16(emu, offset - 0x8000 + 0x7F24, emu->dr[6]); // TODO: alternate DR6
-		if(is_ins_io)
-		{
-			x86_memory_write32(emu, offset - 0x8000 + 0x7F10, emu->old_xip);
-			x86_memory_write32(emu, offset - 0x8000 + 0x7F0C, emu->io_restart_xsi);
-			x86_memory_write32(emu, offset - 0x8000 + 0x7F08, emu->io_restart_xcx);
-			x86_memory_write32(emu, offset - 0x8000 + 0x7F04, emu->io_restart_xdi); // TODO: or CR0
-		}
-		break;
 	case X86_SMM_P6:
-		// sandpile.org
-		x86_descriptor_cache_write_p6(emu, offset - 0x8000 + 0x7F9C, &emu->sr[X86_R_SS]);
-		x86_descriptor_cache_write_p6(emu, offset - 0x8000 + 0x7F90, &emu->sr[X86_R_CS]);
-		x86_descriptor_cache_write_p6(emu, offset - 0x8000 + 0x7F84, &emu->sr[X86_R_ES]);
-		x86_descriptor_cache_write_p6(emu, offset - 0x8000 + 0x7F78, &emu->sr[X86_R_LDTR]);
-		x86_descriptor_cache_write_p6(emu, offset - 0x8000 + 0x7F6C, &emu->sr[X86_R_GDTR]);
-		// TODO: undocumented field inbetween
-		x86_descriptor_cache_write_p6(emu, offset - 0x8000 + 0x7F5C, &emu->sr[X86_R_TR]);
-		x86_descriptor_cache_write_p6(emu, offset - 0x8000 + 0x7F50, &emu->sr[X86_R_IDTR]);
-		x86_descriptor_cache_write_p6(emu, offset - 0x8000 + 0x7F44, &emu->sr[X86_R_GS]);
-		x86_descriptor_cache_write_p6(emu, offset - 0x8000 + 0x7F38, &emu->sr[X86_R_FS]);
-		x86_descriptor_cache_write_p6(emu, offset - 0x8000 + 0x7F2C, &emu->sr[X86_R_DS]);
-		//x86_memory_write16(emu, offset - 0x8000 + 0x7F26, /* RSM control */); // TODO
-		//x86_memory_write16(emu, offset - 0x8000 + 0x7F24, emu->dr[6]); // TODO: alternate DR6
-		// TODO: a couple of undocumented fields
-		x86_memory_write32(emu, offset - 0x8000 + 0x7F14, emu->cr[4]);
+		x86_image_store_fields(emu, image, X86_SMM_IMAGE_START,
+			emu->cpu_traits.smm_format == X86_SMM_80386SL ? x86_smm_fields_80386sl
+			: emu->cpu_traits.smm_format == X86_SMM_P5 ? x86_smm_fields_p5
+			: x86_smm_fields_p6);
 		if(is_ins_io)
 		{
-			x86_memory_write32(emu, offset - 0x8000 + 0x7F10, emu->old_xip);
-			x86_memory_write32(emu, offset - 0x8000 + 0x7F0C, emu->io_restart_xsi);
-			x86_memory_write32(emu, offset - 0x8000 + 0x7F08, emu->io_restart_xcx);
-			x86_memory_write32(emu, offset - 0x8000 + 0x7F04, emu->io_restart_xdi); // TODO: or CR0
+			x86_image_set32(image, 0x7F10 - X86_SMM_IMAGE_START, emu->old_xip);
+			x86_image_set32(image, 0x7F0C - X86_SMM_IMAGE_START, emu->io_restart_xsi);
+			x86_image_set32(image, 0x7F08 - X86_SMM_IMAGE_START, emu->io_restart_xcx);
+			x86_image_set32(image, 0x7F04 - X86_SMM_IMAGE_START, emu->io_restart_xdi); // TODO: or CR0
 		}
 		break;
 	case X86_SMM_P4:
-		// sandpile.org
-		x86_descriptor_cache_write_p4(emu, offset - 0x8000 + 0x7F6C, &emu->sr[X86_R_TR]);
-		x86_memory_write32(emu, offset - 0x8000 + 0x7F68, x86_flags_get32(emu));
-		x86_descriptor_cache_write_p4(emu, offset - 0x8000 + 0x7F5C, &emu->sr[X86_R_LDTR]);
-		x86_memory_write32(emu, offset - 0x8000 + 0x7F58, emu->sr[X86_R_IDTR].limit);
-		x86_memory_write32(emu, offset - 0x8000 + 0x7F54, emu->sr[X86_R_IDTR].base);
-		x86_memory_write32(emu, offset - 0x8000 + 0x7F50, emu->sr[X86_R_GDTR].limit);
-		x86_memory_write32(emu, offset - 0x8000 + 0x7F4C, emu->sr[X86_R_GDTR].base);
-		x86_descriptor_cache_write_p4(emu, offset - 0x8000 + 0x7F40, &emu->sr[X86_R_GS]);
-		x86_descriptor_cache_write_p4(emu, offset - 0x8000 + 0x7F34, &emu->sr[X86_R_FS]);
-		x86_descriptor_cache_write_p4(emu, offset - 0x8000 + 0x7F28, &emu->sr[X86_R_DS]);
-		x86_descriptor_cache_write_p4(emu, offset - 0x8000 + 0x7F1C, &emu->sr[X86_R_SS]);
-		x86_descriptor_cache_write_p4(emu, offset - 0x8000 + 0x7F10, &emu->sr[X86_R_CS]);
-		x86_memory_write32(emu, offset - 0x8000 + 0x7F8C, a20_line ? 0x0000 : 0x3000);
+		x86_image_store_fields(emu, image, X86_SMM_IMAGE_START, x86_smm_fields_p4);
+		x86_image_set32(image, 0x7F68 - X86_SMM_IMAGE_START, x86_flags_get32(emu));
+		x86_image_set32(image, 0x7F8C - X86_SMM_IMAGE_START, a20_line ? 0x0000 : 0x3000);
 
 		if(is_ins_io)
 		{
@@ -671,17 +1061,13 @@ static inline void x86_smm_store_state32(x86_state_t * emu, uaddr_t offset, x86_
 				+ (ins_size << 1)
 				+ (io_type << 4)
 				+ ((uint32_t)io_port << 16);
-			x86_memory_write32(emu, offset - 0x8000 + 0x7FA4, io_misc_info);
-			x86_memory_write32(emu, offset - 0x8000 + 0x7FA0, io_address);
+			x86_image_set32(image, 0x7FA4 - X86_SMM_IMAGE_START, io_misc_info);
+			x86_image_set32(image, 0x7FA0 - X86_SMM_IMAGE_START, io_address);
 
-			x86_memory_write32(emu, offset - 0x8000 + 0x7F84, emu->io_restart_xsi);
-			x86_memory_write32(emu, offset - 0x8000 + 0x7F80, emu->io_restart_xcx);
-			x86_memory_write32(emu, offset - 0x8000 + 0x7F7C, emu->old_xip);
-			x86_memory_write32(emu, offset - 0x8000 + 0x7F78, emu->io_restart_xdi);
-		}
-		else
-		{
-			x86_memory_write32(emu, offset - 0x8000 + 0x7FA0, 0);
+			x86_image_set32(image, 0x7F84 - X86_SMM_IMAGE_START, emu->io_restart_xsi);
+			x86_image_set32(image, 0x7F80 - X86_SMM_IMAGE_START, emu->io_restart_xcx);
+			x86_image_set32(image, 0x7F7C - X86_SMM_IMAGE_START, emu->old_xip);
+			x86_image_set32(image, 0x7F78 - X86_SMM_IMAGE_START, emu->io_restart_xdi);
 		}
 		break;
 	case X86_SMM_K5:
@@ -692,60 +1078,27 @@ static inline void x86_smm_store_state32(x86_state_t * emu, uaddr_t offset, x86_
 			| (is_io_string ? 0x00000004 : 0)
 			| (ins_had_rep ? 0x00000008 : 0)
 			| ((uint32_t)io_port << 16);
-		x86_memory_write32(emu, offset - 0x8000 + 0x7FA4, io_misc_info);
+		x86_image_set32(image, 0x7FA4 - X86_SMM_IMAGE_START, io_misc_info);
+		x86_image_store_fields(emu, image, X86_SMM_IMAGE_START, x86_smm_fields_k5);
 		if(is_ins_io)
 		{
-			x86_memory_write32(emu, offset - 0x8000 + 0x7F9E, emu->old_xip);
-		}
-		x86_descriptor_cache_write_k5_no_access(emu, offset - 0x8000 + 0x7F8C, &emu->sr[X86_R_IDTR]);
-		x86_descriptor_cache_write_k5_no_access(emu, offset - 0x8000 + 0x7F84, &emu->sr[X86_R_GDTR]);
-		x86_descriptor_cache_write_k5(emu, offset - 0x8000 + 0x7F78, &emu->sr[X86_R_TR]);
-		x86_descriptor_cache_write_k5(emu, offset - 0x8000 + 0x7F6C, &emu->sr[X86_R_LDTR]);
-		x86_descriptor_cache_write_k5(emu, offset - 0x8000 + 0x7F60, &emu->sr[X86_R_GS]);
-		x86_descriptor_cache_write_k5(emu, offset - 0x8000 + 0x7F54, &emu->sr[X86_R_FS]);
-		x86_descriptor_cache_write_k5(emu, offset - 0x8000 + 0x7F60, &emu->sr[X86_R_DS]);
-		x86_descriptor_cache_write_k5(emu, offset - 0x8000 + 0x7F3C, &emu->sr[X86_R_SS]);
-		x86_descriptor_cache_write_k5(emu, offset - 0x8000 + 0x7F30, &emu->sr[X86_R_CS]);
-		x86_descriptor_cache_write_k5(emu, offset - 0x8000 + 0x7F24, &emu->sr[X86_R_ES]);
-		x86_memory_write32(emu, offset - 0x8000 + 0x7F14, emu->cr[2]);
-		x86_memory_write32(emu, offset - 0x8000 + 0x7F10, emu->cr[4]);
-		if(is_ins_io)
-		{
-			x86_memory_write32(emu, offset - 0x8000 + 0x7F0C, emu->io_restart_xsi);
-			x86_memory_write32(emu, offset - 0x8000 + 0x7F08, emu->io_restart_xcx);
-			x86_memory_write32(emu, offset - 0x8000 + 0x7F04, emu->io_restart_xdi);
+			x86_image_set32(image, 0x7F9E - X86_SMM_IMAGE_START, emu->old_xip);
+			x86_image_set32(image, 0x7F0C - X86_SMM_IMAGE_START, emu->io_restart_xsi);
+			x86_image_set32(image, 0x7F08 - X86_SMM_IMAGE_START, emu->io_restart_xcx);
+			x86_image_set32(image, 0x7F04 - X86_SMM_IMAGE_START, emu->io_restart_xdi);
 		}
 		break;
 	}
 
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FFC, emu->cr[0]);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FF8, emu->cr[3]);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FF4, x86_flags_get32(emu));
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FF0, emu->xip);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FEC, emu->gpr[X86_R_DI]);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FE8, emu->gpr[X86_R_SI]);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FE4, emu->gpr[X86_R_BP]);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FE0, emu->gpr[X86_R_SP]);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FDC, emu->gpr[X86_R_BX]);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FD8, emu->gpr[X86_R_DX]);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FD4, emu->gpr[X86_R_CX]);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FD0, emu->gpr[X86_R_AX]);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FCC, emu->dr[6]);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FC8, emu->dr[7]);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FC4, emu->sr[X86_R_TR].selector);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FC0, emu->sr[X86_R_LDTR].selector);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FBC, emu->sr[X86_R_GS].selector);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FB8, emu->sr[X86_R_FS].selector);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FB4, emu->sr[X86_R_DS].selector);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FB0, emu->sr[X86_R_SS].selector);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FAC, emu->sr[X86_R_CS].selector);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7FA8, emu->sr[X86_R_ES].selector);
-
-	x86_memory_write16(emu, offset - 0x8000 + 0x7F02, emu->state == X86_STATE_HALTED ? 1 : 0);
-	x86_memory_write16(emu, offset - 0x8000 + 0x7F00, 0); // I/O trap slot
-	x86_memory_write32(emu, offset - 0x8000 + 0x7EFC, emu->smm_revision_identifier);
+	x86_image_store_fields(emu, image, X86_SMM_IMAGE_START, x86_smm_fields_32);
+
+	x86_image_set16(image, 0x7F02 - X86_SMM_IMAGE_START, emu->state == X86_STATE_HALTED ? 1 : 0);
+	x86_image_set16(image, 0x7F00 - X86_SMM_IMAGE_START, 0); // I/O trap slot
+	x86_image_set32(image, 0x7EFC - X86_SMM_IMAGE_START, emu->smm_revision_identifier);
 	if((emu->smm_revision_identifier & SMM_REVID_SMBASE_RELOC) != 0)
-		x86_memory_write32(emu, offset - 0x8000 + 0x7EF8, emu->smbase);
+		x86_image_set32(image, 0x7EF8 - X86_SMM_IMAGE_START, emu->smbase);
+
+	x86_memory_write(emu, offset - 0x8000 + X86_SMM_IMAGE_START, sizeof image, image);
 }
 
 static inline void x86_smm_store_state_amd64(x86_state_t * emu, uaddr_t offset, x86_smi_attributes_t attributes)
@@ -770,69 +1123,36 @@ static inline void x86_smm_store_state_amd64(x86_state_t * emu, uaddr_t offset,
 		break;
 	}
 
-	x86_memory_write64(emu, offset - 0x8000 + 0x7FF8, emu->gpr[X86_R_AX]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7FF0, emu->gpr[X86_R_CX]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7FE8, emu->gpr[X86_R_DX]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7FE0, emu->gpr[X86_R_BX]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7FD8, emu->gpr[X86_R_SP]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7FD0, emu->gpr[X86_R_BP]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7FC8, emu->gpr[X86_R_SI]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7FC0, emu->gpr[X86_R_DI]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7FB8, emu->gpr[8]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7FB0, emu->gpr[9]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7FA8, emu->gpr[10]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7FA0, emu->gpr[11]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F98, emu->gpr[12]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F90, emu->gpr[13]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F88, emu->gpr[14]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F80, emu->gpr[15]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F78, emu->xip);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F70, x86_flags_get64(emu));
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F68, emu->dr[6]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F60, emu->dr[7]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F58, emu->cr[0]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F50, emu->cr[3]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F48, emu->cr[4]);
-
-	x86_memory_write32(emu, offset - 0x8000 + 0x7F00, emu->smbase);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7EFC, emu->smm_revision_identifier);
-
-	x86_memory_write64(emu, offset - 0x8000 + 0x7ED0, emu->efer);
-
-	x86_memory_write8(emu, offset - 0x8000 + 0x7ECB, emu->cpl);
+	uint8_t image[X86_SMM_IMAGE_SIZE];
+	memset(image, 0, sizeof image);
+
+	x86_image_store_fields(emu, image, X86_SMM_IMAGE_START, x86_smm_fields_amd64);
+	x86_image_store_fields(emu, image, X86_SMM_IMAGE_START, x86_smm_caches_amd64);
+
+	x86_image_set32(image, 0x7F00 - X86_SMM_IMAGE_START, emu->smbase);
+	x86_image_set32(image, 0x7EFC - X86_SMM_IMAGE_START, emu->smm_revision_identifier);
+
+	image[0x7ECB - X86_SMM_IMAGE_START] = emu->cpl;
 	// TODO: block NMI
-	x86_memory_write8(emu, offset - 0x8000 + 0x7EC9, emu->state == X86_STATE_HALTED ? 1 : 0);
-	x86_memory_write8(emu, offset - 0x8000 + 0x7EC8, 0); // I/O trap slot
+	image[0x7EC9 - X86_SMM_IMAGE_START] = emu->state == X86_STATE_HALTED ? 1 : 0;
+	image[0x7EC8 - X86_SMM_IMAGE_START] = 0; // I/O trap slot
 
 	// TODO: guessing
 	if(is_ins_io)
 	{
-		x86_memory_write32(emu, offset - 0x8000 + 0x7EC0,
+		x86_image_set32(image, 0x7EC0 - X86_SMM_IMAGE_START,
 			0x0001
 			+ (ins_size << 1)
 			+ (io_type << 4)
 			+ ((uint32_t)io_port << 16));
 
-		x86_memory_write32(emu, offset - 0x8000 + 0x7EB8, emu->io_restart_xdi);
-		x86_memory_write32(emu, offset - 0x8000 + 0x7EB0, emu->io_restart_xsi);
-		x86_memory_write32(emu, offset - 0x8000 + 0x7EA8, emu->io_restart_xcx);
-		x86_memory_write32(emu, offset - 0x8000 + 0x7EA0, emu->old_xip);
-	}
-	else
-	{
-		x86_memory_write32(emu, offset - 0x8000 + 0x7EC0, 0);
+		x86_image_set32(image, 0x7EB8 - X86_SMM_IMAGE_START, emu->io_restart_xdi);
+		x86_image_set32(image, 0x7EB0 - X86_SMM_IMAGE_START, emu->io_restart_xsi);
+		x86_image_set32(image, 0x7EA8 - X86_SMM_IMAGE_START, emu->io_restart_xcx);
+		x86_image_set32(image, 0x7EA0 - X86_SMM_IMAGE_START, emu->old_xip);
 	}
 
-	x86_descriptor_cache_write_amd64(emu, offset - 0x8000 + 0xFE90, &emu->sr[X86_R_TR]);
-	x86_descriptor_cache_write_amd64(emu, offset - 0x8000 + 0xFE80, &emu->sr[X86_R_IDTR]);
-	x86_descriptor_cache_write_amd64(emu, offset - 0x8000 + 0xFE70, &emu->sr[X86_R_LDTR]);
-	x86_descriptor_cache_write_amd64(emu, offset - 0x8000 + 0xFE60, &emu->sr[X86_R_GDTR]);
-	x86_descriptor_cache_write_amd64(emu, offset - 0x8000 + 0xFE50, &emu->sr[X86_R_GS]);
-	x86_descriptor_cache_write_amd64(emu, offset - 0x8000 + 0xFE40, &emu->sr[X86_R_FS]);
-	x86_descriptor_cache_write_amd64(emu, offset - 0x8000 + 0xFE30, &emu->sr[X86_R_DS]);
-	x86_descriptor_cache_write_amd64(emu, offset - 0x8000 + 0xFE20, &emu->sr[X86_R_SS]);
-	x86_descriptor_cache_write_amd64(emu, offset - 0x8000 + 0xFE10, &emu->sr[X86_R_CS]);
-	x86_descriptor_cache_write_amd64(emu, offset - 0x8000 + 0xFE00, &emu->sr[X86_R_ES]);
+	x86_memory_write(emu, offset - 0x8000 + X86_SMM_IMAGE_START, sizeof image, image);
 }
 
 static inline void x86_smm_store_state_intel64(x86_state_t * emu, uaddr_t offset, x86_smi_attributes_t attributes)
@@ -859,70 +1179,30 @@ static inline void x86_smm_store_state_intel64(x86_state_t * emu, uaddr_t offset
 		break;
 	}
 
-	x86_memory_write64(emu, offset - 0x8000 + 0x7FF8, emu->cr[0]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7FF0, emu->cr[3]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7FE8, x86_flags_get64(emu));
-	x86_memory_write64(emu, offset - 0x8000 + 0x7FE0, emu->efer);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7FD8, emu->xip);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7FD0, emu->dr[6]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7FC8, emu->dr[7]);
-	x86_memory_write16(emu, offset - 0x8000 + 0x7FC4, emu->sr[X86_R_TR].selector);
-	x86_memory_write16(emu, offset - 0x8000 + 0x7FC0, emu->sr[X86_R_LDTR].selector);
-	x86_memory_write16(emu, offset - 0x8000 + 0x7FBC, emu->sr[X86_R_GS].selector);
-	x86_memory_write16(emu, offset - 0x8000 + 0x7FB8, emu->sr[X86_R_FS].selector);
-	x86_memory_write16(emu, offset - 0x8000 + 0x7FB4, emu->sr[X86_R_DS].selector);
-	x86_memory_write16(emu, offset - 0x8000 + 0x7FB0, emu->sr[X86_R_SS].selector);
-	x86_memory_write16(emu, offset - 0x8000 + 0x7FAC, emu->sr[X86_R_CS].selector);
-	x86_memory_write16(emu, offset - 0x8000 + 0x7FA8, emu->sr[X86_R_ES].selector);
-
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F94, emu->gpr[X86_R_DI]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F8C, emu->gpr[X86_R_SI]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F84, emu->gpr[X86_R_BP]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F7C, emu->gpr[X86_R_SP]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F74, emu->gpr[X86_R_BX]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F6C, emu->gpr[X86_R_DX]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F64, emu->gpr[X86_R_CX]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F5C, emu->gpr[X86_R_AX]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F54, emu->gpr[8]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F4C, emu->gpr[9]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F44, emu->gpr[10]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F3C, emu->gpr[11]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F34, emu->gpr[12]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F2C, emu->gpr[13]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F24, emu->gpr[14]);
-	x86_memory_write64(emu, offset - 0x8000 + 0x7F1C, emu->gpr[15]);
-
-	x86_memory_write16(emu, offset - 0x8000 + 0x7F02, emu->state == X86_STATE_HALTED ? 1 : 0);
-	x86_memory_write16(emu, offset - 0x8000 + 0x7F00, 0); // I/O trap slot
-	x86_memory_write32(emu, offset - 0x8000 + 0x7EFC, emu->smm_revision_identifier);
-	if((emu->smm_revision_identifier & SMM_REVID_SMBASE_RELOC) != 0)
-		x86_memory_write32(emu, offset - 0x8000 + 0x7EF8, emu->smbase);
-
-	x86_memory_write32(emu, offset - 0x8000 + 0x7E9C, emu->sr[X86_R_LDTR].base);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7E94, emu->sr[X86_R_IDTR].base);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7E8C, emu->sr[X86_R_GDTR].base);
+	uint8_t image[X86_SMM_INTEL64_IMAGE_SIZE];
+	memset(image, 0, sizeof image);
 
-	x86_memory_write64(emu, offset - 0x8000 + 0x7E40, emu->cr[4]);
+	x86_image_store_fields(emu, image, X86_SMM_INTEL64_IMAGE_START, x86_smm_fields_intel64);
 
-	x86_memory_write32(emu, offset - 0x8000 + 0x7DD8, emu->sr[X86_R_IDTR].base >> 32);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7DD4, emu->sr[X86_R_LDTR].base >> 32);
-	x86_memory_write32(emu, offset - 0x8000 + 0x7DD0, emu->sr[X86_R_GDTR].base >> 32);
+	x86_image_set16(image, 0x7F02 - X86_SMM_INTEL64_IMAGE_START, emu->state == X86_STATE_HALTED ? 1 : 0);
+	x86_image_set16(image, 0x7F00 - X86_SMM_INTEL64_IMAGE_START, 0); // I/O trap slot
+	x86_image_set32(image, 0x7EFC - X86_SMM_INTEL64_IMAGE_START, emu->smm_revision_identifier);
+	if((emu->smm_revision_identifier & SMM_REVID_SMBASE_RELOC) != 0)
+		x86_image_set32(image, 0x7EF8 - X86_SMM_INTEL64_IMAGE_START, emu->smbase);
 
 	if(is_ins_io)
 	{
-		x86_memory_write32(emu, offset - 0x8000 + 0x7FA4,
+		x86_image_set32(image, 0x7FA4 - X86_SMM_INTEL64_IMAGE_START,
 			0x0001
 			+ (ins_size << 1)
 			+ (io_type << 4)
 			+ ((uint32_t)io_port << 16));
-		x86_memory_write32(emu, offset - 0x8000 + 0x7FA0, io_address);
+		x86_image_set32(image, 0x7FA0 - X86_SMM_INTEL64_IMAGE_START, io_address);
 
-		x86_memory_write32(emu, offset - 0x8000 + 0x7DE8, emu->old_xip);
-	}
-	else
-	{
-		x86_memory_write32(emu, offset - 0x8000 + 0x7FA0, 0);
+		x86_image_set32(image, 0x7DE8 - X86_SMM_INTEL64_IMAGE_START, emu->old_xip);
 	}
+
+	x86_memory_write(emu, offset - 0x8000 + X86_SMM_INTEL64_IMAGE_START, sizeof image, image);
 }
 
 static inline void x86_smm_store_state_cyrix(x86_state_t * emu, uaddr_t offset, x86_smi_attributes_t attributes)
@@ -955,7 +1235,8 @@ static inline void x86_smm_store_state_cyrix(x86_state_t * emu, uaddr_t offset,
 		break;
 	}
 
-	uint8_t code_descriptor[8];
+	uint8_t image[X86_SMM_CYRIX_IMAGE_SIZE];
+	memset(image, 0, sizeof image);
 
 	switch(emu->cpu_traits.smm_format)
 	{
@@ -963,45 +1244,42 @@ static inline void x86_smm_store_state_cyrix(x86_state_t * emu, uaddr_t offset,
 		assert(false);
 
 	case X86_SMM_CX486SLCE:
-		x86_segment_store_protected_mode_386(emu, X86_R_CS, code_descriptor);
-		x86_memory_write(emu, offset - 0x20, 8, code_descriptor);
+		x86_segment_store_protected_mode_386(emu, X86_R_CS, &image[X86_SMM_CYRIX_HEADER(0x20)]);
 
-		x86_memory_write16(emu, offset - 0x24,
+		x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x24),
 			(ins_is_write ? 0x0002 : 0)
 			+ (ins_had_rep ? 0x0004 : 0));
 
 		if(!memory_access && ins_had_rep)
-			x86_memory_write32(emu, offset - 0x30, ins_is_write ? emu->io_restart_xsi : emu->io_restart_xdi);
+			x86_image_set32(image, X86_SMM_CYRIX_HEADER(0x30), ins_is_write ? emu->io_restart_xsi : emu->io_restart_xdi);
 		break;
 
 	case X86_SMM_M1:
-		x86_segment_store_protected_mode_386(emu, X86_R_CS, code_descriptor);
-		x86_memory_write(emu, offset - 0x20, 8, code_descriptor);
+		x86_segment_store_protected_mode_386(emu, X86_R_CS, &image[X86_SMM_CYRIX_HEADER(0x20)]);
 
-		x86_memory_write16(emu, offset - 0x16, emu->cpl << 5);
+		x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x16), emu->cpl << 5);
 
-		x86_memory_write16(emu, offset - 0x24,
+		x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x24),
 			(ins_is_write ? 0x0002 : 0)
 			+ (ins_had_rep ? 0x0004 : 0)
 			+ (ins_smint ? 0x0008 : 0)
 			+ (cpu_in_halt ? 0x0010 : 0));
 
-		x86_memory_write16(emu, offset - 0x26, write_size);
-		x86_memory_write16(emu, offset - 0x28, write_address);
-		x86_memory_write16(emu, offset - 0x2C, write_data);
+		x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x26), write_size);
+		x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x28), write_address);
+		x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x2C), write_data);
 
 		if(!memory_access && ins_had_rep)
-			x86_memory_write32(emu, offset - 0x30, ins_is_write ? emu->io_restart_xsi : emu->io_restart_xdi);
+			x86_image_set32(image, X86_SMM_CYRIX_HEADER(0x30), ins_is_write ? emu->io_restart_xsi : emu->io_restart_xdi);
 
 		break;
 
 	case X86_SMM_M2:
-		x86_segment_store_protected_mode_386(emu, X86_R_CS, code_descriptor);
-		x86_memory_write(emu, offset - 0x20, 8, code_descriptor);
+		x86_segment_store_protected_mode_386(emu, X86_R_CS, &image[X86_SMM_CYRIX_HEADER(0x20)]);
 
-		x86_memory_write16(emu, offset - 0x22, emu->cpl << 5);
+		x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x22), emu->cpl << 5);
 
-		x86_memory_write16(emu, offset - 0x24,
+		x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x24),
 			(code_writable ? 0x0001 : 0)
 			+ (ins_is_write ? 0x0002 : 0)
 			+ (ins_had_rep ? 0x0004 : 0)
@@ -1010,20 +1288,19 @@ static inline void x86_smm_store_state_cyrix(x86_state_t * emu, uaddr_t offset,
 			+ (internal_smi ? 0x2000 : 0)
 			+ (nested_smi ? 0x8000 : 0));
 
-		x86_memory_write16(emu, offset - 0x26, write_size);
-		x86_memory_write16(emu, offset - 0x28, write_address);
-		x86_memory_write16(emu, offset - 0x2C, write_data);
+		x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x26), write_size);
+		x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x28), write_address);
+		x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x2C), write_data);
 
 		if(!memory_access && ins_had_rep)
-			x86_memory_write32(emu, offset - 0x30, ins_is_write ? emu->io_restart_xsi : emu->io_restart_xdi);
+			x86_image_set32(image, X86_SMM_CYRIX_HEADER(0x30), ins_is_write ? emu->io_restart_xsi : emu->io_restart_xdi);
 
 		break;
 
 	case X86_SMM_MEDIAGX:
-		x86_segment_store_protected_mode_386(emu, X86_R_CS, code_descriptor);
-		x86_memory_write(emu, offset - 0x20, 8, code_descriptor);
+		x86_segment_store_protected_mode_386(emu, X86_R_CS, &image[X86_SMM_CYRIX_HEADER(0x20)]);
 
-		x86_memory_write16(emu, offset - 0x24,
+		x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x24),
 			(code_writable ? 0x0001 : 0)
 			+ (ins_is_write ? 0x0002 : 0)
 			+ (ins_had_rep ? 0x0004 : 0)
@@ -1036,26 +1313,26 @@ static inline void x86_smm_store_state_cyrix(x86_state_t * emu, uaddr_t offset,
 
 		if(!memory_access)
 		{
-			x86_memory_write16(emu, offset - 0x26, write_size);
-			x86_memory_write16(emu, offset - 0x28, write_address);
+			x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x26), write_size);
+			x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x28), write_address);
 		}
-		x86_memory_write16(emu, offset - 0x2C, write_data);
+		x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x2C), write_data);
 		if(!memory_access && ins_had_rep)
-			x86_memory_write32(emu, offset - 0x30, ins_is_write ? emu->io_restart_xsi : emu->io_restart_xdi);
+			x86_image_set32(image, X86_SMM_CYRIX_HEADER(0x30), ins_is_write ? emu->io_restart_xsi : emu->io_restart_xdi);
 		if(memory_access)
 		{
-			x86_memory_write32(emu, offset - 0x34, write_address);
+			x86_image_set32(image, X86_SMM_CYRIX_HEADER(0x34), write_address);
 		}
 
 		break;
 
 	case X86_SMM_GX2:
-		x86_memory_write16(emu, offset - 0x16, emu->sr[X86_R_CS].access >> 8);
-		x86_memory_write32(emu, offset - 0x1C, emu->sr[X86_R_CS].base);
-		x86_memory_write32(emu, offset - 0x1D, emu->sr[X86_R_CS].limit);
-		x86_memory_write16(emu, offset - 0x22, emu->sr[X86_R_SS].access >> 8); // note: this is where LX reads the CPL back afterwards
+		x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x16), emu->sr[X86_R_CS].access >> 8);
+		x86_image_set32(image, X86_SMM_CYRIX_HEADER(0x1C), emu->sr[X86_R_CS].base);
+		x86_image_set32(image, X86_SMM_CYRIX_HEADER(0x20), emu->sr[X86_R_CS].limit);
+		x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x22), emu->sr[X86_R_SS].access >> 8); // note: this is where LX reads the CPL back afterwards
 
-		x86_memory_write16(emu, offset - 0x24,
+		x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x24),
 			(code_writable ? 0x0001 : 0)
 			+ (ins_is_write ? 0x0002 : 0)
 			+ (ins_had_rep ? 0x0004 : 0)
@@ -1069,21 +1346,21 @@ static inline void x86_smm_store_state_cyrix(x86_state_t * emu, uaddr_t offset,
 
 		if(!memory_access)
 		{
-			x86_memory_write16(emu, offset - 0x26, write_size);
-			x86_memory_write16(emu, offset - 0x28, write_address);
+			x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x26), write_size);
+			x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x28), write_address);
 		}
-		x86_memory_write16(emu, offset - 0x2C, write_data);
-		x86_memory_write32(emu, offset - 0x30, emu->smm_ctl);
+		x86_image_set16(image, X86_SMM_CYRIX_HEADER(0x2C), write_data);
+		x86_image_set32(image, X86_SMM_CYRIX_HEADER(0x30), emu->smm_ctl);
 
 		break;
 	}
 
-	x86_memory_write32(emu, offset - 0x04, emu->dr[7]);
-	x86_memory_write32(emu, offset - 0x08, x86_flags_get32(emu));
-	x86_memory_write32(emu, offset - 0x0C, emu->cr[0]);
-	x86_memory_write32(emu, offset - 0x10, emu->old_xip);
-	x86_memory_write32(emu, offset - 0x14, emu->xip);
-	x86_memory_write16(emu, offset - 0x18, emu->sr[X86_R_CS].selector);
+	x86_image_store_fields(emu, image, 0, x86_smm_fields_cyrix);
+	x86_image_set32(image, X86_SMM_CYRIX_HEADER(0x10), emu->old_xip);
+
+	// only the MediaGX header extends to 0x34 bytes
+	size_t header_size = emu->cpu_traits.smm_format == X86_SMM_MEDIAGX ? 0x34 : 0x30;
+	x86_memory_write(emu, offset - header_size, header_size, &image[X86_SMM_CYRIX_HEADER(header_size)]);
 }
 
 static inline void x86_smm_enter(x86_state_t * emu, x86_smi_attributes_t attributes)
@@ -1338,7 +1615,10 @@ static inline void x86_smint(x86_state_t * emu)
 
 static inline void x86_smm_restore_state32(x86_state_t * emu, uaddr_t offset)
 {
-	bool restart_io = (emu->smm_revision_identifier & SMM_REVID_IO_RESTART) != 0 && x86_memory_read8(emu, offset - 0x8000 + 0x7F00) == 0xFF;
+	uint8_t image[X86_SMM_IMAGE_SIZE];
+	x86_memory_read(emu, offset - 0x8000 + X86_SMM_IMAGE_START, sizeof image, image);
+
+	bool restart_io = (emu->smm_revision_identifier & SMM_REVID_IO_RESTART) != 0 && image[0x7F00 - X86_SMM_IMAGE_START] == 0xFF;
 
 	switch(emu->cpu_traits.smm_format)
 	{
@@ -1346,269 +1626,97 @@ static inline void x86_smm_restore_state32(x86_state_t * emu, uaddr_t offset)
 		assert(false);
 
 	case X86_SMM_80386SL:
-		// Robert R. Collins: The Secrets of System Management Mode
-		x86_descriptor_cache_read_386(emu, offset - 0x8000 + 0x7F9C, &emu->sr[X86_R_TR]);
-		x86_descriptor_cache_read_386(emu, offset - 0x8000 + 0x7F90, &emu->sr[X86_R_IDTR]);
-		x86_descriptor_cache_read_386(emu, offset - 0x8000 + 0x7F85, &emu->sr[X86_R_GDTR]);
-		x86_descriptor_cache_read_386(emu, offset - 0x8000 + 0x7F78, &emu->sr[X86_R_LDTR]);
-		x86_descriptor_cache_read_386(emu, offset - 0x8000 + 0x7F6C, &emu->sr[X86_R_GS]);
-		x86_descriptor_cache_read_386(emu, offset - 0x8000 + 0x7F60, &emu->sr[X86_R_FS]);
-		x86_descriptor_cache_read_386(emu, offset - 0x8000 + 0x7F54, &emu->sr[X86_R_DS]);
-		x86_descriptor_cache_read_386(emu, offset - 0x8000 + 0x7F48, &emu->sr[X86_R_SS]);
-		x86_descriptor_cache_read_386(emu, offset - 0x8000 + 0x7F3C, &emu->sr[X86_R_CS]);
-		x86_descriptor_cache_read_386(emu, offset - 0x8000 + 0x7F30, &emu->sr[X86_R_ES]);
-		emu->cr[4] = x86_memory_read32(emu, offset - 0x8000 + 0x7F28);
-		if(restart_io)
-		{
-			x86_set_xip(emu, x86_memory_read32(emu, offset - 0x8000 + 0x7F10));
-			emu->gpr[X86_R_SI] = x86_memory_read32(emu, offset - 0x8000 + 0x7F1C);
-			emu->gpr[X86_R_CX] = x86_memory_read32(emu, offset - 0x8000 + 0x7F18);
-			emu->gpr[X86_R_DI] = x86_memory_read32(emu, offset - 0x8000 + 0x7F14);
-		}
-		break;
 	case X86_SMM_P5:
-		// Robert R. Collins: The Secrets of System Management Mode, sandpile.org
-		x86_descriptor_cache_read_p5(emu, offset - 0x8000 + 0x7F9C, &emu->sr[X86_R_TR]);
-		x86_descriptor_cache_read_p5(emu, offset - 0x8000 + 0x7F90, &emu->sr[X86_R_IDTR]);
-		x86_descriptor_cache_read_p5(emu, offset - 0x8000 + 0x7F85, &emu->sr[X86_R_GDTR]);
-		x86_descriptor_cache_read_p5(emu, offset - 0x8000 + 0x7F78, &emu->sr[X86_R_LDTR]);
-		x86_descriptor_cache_read_p5(emu, offset - 0x8000 + 0x7F6C, &emu->sr[X86_R_GS]);
-		x86_descriptor_cache_read_p5(emu, offset - 0x8000 + 0x7F60, &emu->sr[X86_R_FS]);
-		x86_descriptor_cache_read_p5(emu, offset - 0x8000 + 0x7F54, &emu->sr[X86_R_DS]);
-		x86_descriptor_cache_read_p5(emu, offset - 0x8000 + 0x7F48, &emu->sr[X86_R_SS]);
-		x86_descriptor_cache_read_p5(emu, offset - 0x8000 + 0x7F3C, &emu->sr[X86_R_CS]);
-		x86_descriptor_cache_read_p5(emu, offset - 0x8000 + 0x7F30, &emu->sr[X86_R_ES]);
-		emu->cr[4] = x86_memory_read32(emu, offset - 0x8000 + 0x7F28);
-		if(restart_io)
-		{
-			x86_set_xip(emu, x86_memory_read32(emu, offset - 0x8000 + 0x7F10));
-			emu->gpr[X86_R_SI] = x86_memory_read32(emu, offset - 0x8000 + 0x7F0C);
-			emu->gpr[X86_R_CX] = x86_memory_read32(emu, offset - 0x8000 + 0x7F08);
-			emu->gpr[X86_R_DI] = x86_memory_read32(emu, offset - 0x8000 + 0x7F04);
-		}
-		break;
 	case X86_SMM_P6:
-		// sandpile.org
-		x86_descriptor_cache_read_p6(emu, offset - 0x8000 + 0x7F9C, &emu->sr[X86_R_SS]);
-		x86_descriptor_cache_read_p6(emu, offset - 0x8000 + 0x7F90, &emu->sr[X86_R_CS]);
-		x86_descriptor_cache_read_p6(emu, offset - 0x8000 + 0x7F84, &emu->sr[X86_R_ES]);
-		x86_descriptor_cache_read_p6(emu, offset - 0x8000 + 0x7F78, &emu->sr[X86_R_LDTR]);
-		x86_descriptor_cache_read_p6(emu, offset - 0x8000 + 0x7F6C, &emu->sr[X86_R_GDTR]);
-		x86_descriptor_cache_read_p6(emu, offset - 0x8000 + 0x7F5C, &emu->sr[X86_R_TR]);
-		x86_descriptor_cache_read_p6(emu, offset - 0x8000 + 0x7F50, &emu->sr[X86_R_IDTR]);
-		x86_descriptor_cache_read_p6(emu, offset - 0x8000 + 0x7F44, &emu->sr[X86_R_GS]);
-		x86_descriptor_cache_read_p6(emu, offset - 0x8000 + 0x7F38, &emu->sr[X86_R_FS]);
-		x86_descriptor_cache_read_p6(emu, offset - 0x8000 + 0x7F2C, &emu->sr[X86_R_DS]);
-		emu->cr[4] = x86_memory_read32(emu, offset - 0x8000 + 0x7F14);
+		x86_image_load_fields(emu, image, X86_SMM_IMAGE_START,
+			emu->cpu_traits.smm_format == X86_SMM_80386SL ? x86_smm_fields_80386sl
+			: emu->cpu_traits.smm_format == X86_SMM_P5 ? x86_smm_fields_p5
+			: x86_smm_fields_p6,
+			false);
 		if(restart_io)
 		{
-			x86_set_xip(emu, x86_memory_read32(emu, offset - 0x8000 + 0x7F10));
-			emu->gpr[X86_R_SI] = x86_memory_read32(emu, offset - 0x8000 + 0x7F0C);
-			emu->gpr[X86_R_CX] = x86_memory_read32(emu, offset - 0x8000 + 0x7F08);
-			emu->gpr[X86_R_DI] = x86_memory_read32(emu, offset - 0x8000 + 0x7F04);
+			x86_set_xip(emu, x86_image_get32(image, 0x7F10 - X86_SMM_IMAGE_START));
+			emu->gpr[X86_R_SI] = x86_image_get32(image, 0x7F0C - X86_SMM_IMAGE_START);
+			emu->gpr[X86_R_CX] = x86_image_get32(image, 0x7F08 - X86_SMM_IMAGE_START);
+			emu->gpr[X86_R_DI] = x86_image_get32(image, 0x7F04 - X86_SMM_IMAGE_START);
 		}
 		break;
 	case X86_SMM_P4:
-		// sandpile.org
-		x86_descriptor_cache_read_p4(emu, offset - 0x8000 + 0x7F6C, &emu->sr[X86_R_TR]);
-		x86_descriptor_cache_read_p4(emu, offset - 0x8000 + 0x7F5C, &emu->sr[X86_R_LDTR]);
-		emu->sr[X86_R_IDTR].limit = x86_memory_read32(emu, offset - 0x8000 + 0x7F58);
-		emu->sr[X86_R_IDTR].base = x86_memory_read32(emu, offset - 0x8000 + 0x7F54);
-		emu->sr[X86_R_GDTR].limit = x86_memory_read32(emu, offset - 0x8000 + 0x7F50);
-		emu->sr[X86_R_GDTR].base = x86_memory_read32(emu, offset - 0x8000 + 0x7F4C);
-		x86_descriptor_cache_read_p4(emu, offset - 0x8000 + 0x7F40, &emu->sr[X86_R_GS]);
-		x86_descriptor_cache_read_p4(emu, offset - 0x8000 + 0x7F34, &emu->sr[X86_R_FS]);
-		x86_descriptor_cache_read_p4(emu, offset - 0x8000 + 0x7F28, &emu->sr[X86_R_DS]);
-		x86_descriptor_cache_read_p4(emu, offset - 0x8000 + 0x7F1C, &emu->sr[X86_R_SS]);
-		x86_descriptor_cache_read_p4(emu, offset - 0x8000 + 0x7F10, &emu->sr[X86_R_CS]);
-		//x86_memory_read32(emu, offset - 0x8000 + 0x7F8C, a20_line ? 0x0000 : 0x3000); // TODO
+		x86_image_load_fields(emu, image, X86_SMM_IMAGE_START, x86_smm_fields_p4, false);
+		//a20_line = x86_image_get32(image, 0x7F8C - X86_SMM_IMAGE_START) == 0x0000; // TODO
 
 		if(restart_io)
 		{
-			emu->gpr[X86_R_SI] = x86_memory_read32(emu, offset - 0x8000 + 0x7F84);
-			emu->gpr[X86_R_CX] = x86_memory_read32(emu, offset - 0x8000 + 0x7F80);
-			x86_set_xip(emu, x86_memory_read32(emu, offset - 0x8000 + 0x7F7C));
-			emu->gpr[X86_R_DI] = x86_memory_read32(emu, offset - 0x8000 + 0x7F78);
+			emu->gpr[X86_R_SI] = x86_image_get32(image, 0x7F84 - X86_SMM_IMAGE_START);
+			emu->gpr[X86_R_CX] = x86_image_get32(image, 0x7F80 - X86_SMM_IMAGE_START);
+			x86_set_xip(emu, x86_image_get32(image, 0x7F7C - X86_SMM_IMAGE_START));
+			emu->gpr[X86_R_DI] = x86_image_get32(image, 0x7F78 - X86_SMM_IMAGE_START);
 		}
 		break;
 	case X86_SMM_K5:
 	case X86_SMM_K6: // TODO
-		x86_descriptor_cache_read_k5_no_access(emu, offset - 0x8000 + 0x7F8C, &emu->sr[X86_R_IDTR]);
-		x86_descriptor_cache_read_k5_no_access(emu, offset - 0x8000 + 0x7F84, &emu->sr[X86_R_GDTR]);
-		x86_descriptor_cache_read_k5(emu, offset - 0x8000 + 0x7F78, &emu->sr[X86_R_TR]);
-		x86_descriptor_cache_read_k5(emu, offset - 0x8000 + 0x7F6C, &emu->sr[X86_R_LDTR]);
-		x86_descriptor_cache_read_k5(emu, offset - 0x8000 + 0x7F60, &emu->sr[X86_R_GS]);
-		x86_descriptor_cache_read_k5(emu, offset - 0x8000 + 0x7F54, &emu->sr[X86_R_FS]);
-		x86_descriptor_cache_read_k5(emu, offset - 0x8000 + 0x7F60, &emu->sr[X86_R_DS]);
-		x86_descriptor_cache_read_k5(emu, offset - 0x8000 + 0x7F3C, &emu->sr[X86_R_SS]);
-		x86_descriptor_cache_read_k5(emu, offset - 0x8000 + 0x7F30, &emu->sr[X86_R_CS]);
-		x86_descriptor_cache_read_k5(emu, offset - 0x8000 + 0x7F24, &emu->sr[X86_R_ES]);
-		emu->cr[2] = x86_memory_read32(emu, offset - 0x8000 + 0x7F14);
-		emu->cr[4] = x86_memory_read32(emu, offset - 0x8000 + 0x7F10);
+		x86_image_load_fields(emu, image, X86_SMM_IMAGE_START, x86_smm_fields_k5, false);
 		if(restart_io)
 		{
-			x86_set_xip(emu, x86_memory_read32(emu, offset - 0x8000 + 0x7F9E));
-			emu->gpr[X86_R_SI] = x86_memory_read32(emu, offset - 0x8000 + 0x7F0C);
-			emu->gpr[X86_R_CX] = x86_memory_read32(emu, offset - 0x8000 + 0x7F08);
-			emu->gpr[X86_R_DI] = x86_memory_read32(emu, offset - 0x8000 + 0x7F04);
+			x86_set_xip(emu, x86_image_get32(image, 0x7F9E - X86_SMM_IMAGE_START));
+			emu->gpr[X86_R_SI] = x86_image_get32(image, 0x7F0C - X86_SMM_IMAGE_START);
+			emu->gpr[X86_R_CX] = x86_image_get32(image, 0x7F08 - X86_SMM_IMAGE_START);
+			emu->gpr[X86_R_DI] = x86_image_get32(image, 0x7F04 - X86_SMM_IMAGE_START);
 		}
 		break;
 	}
 
-	emu->cr[0] = x86_memory_read32(emu, offset - 0x8000 + 0x7FFC);
-	emu->cr[3] = x86_memory_read32(emu, offset - 0x8000 + 0x7FF8);
-	x86_flags_set32(emu, x86_memory_read32(emu, offset - 0x8000 + 0x7FF4));
-	if(!restart_io)
-	{
-		x86_set_xip(emu, x86_memory_read32(emu, offset - 0x8000 + 0x7FF0));
-		emu->gpr[X86_R_DI] = x86_memory_read32(emu, offset - 0x8000 + 0x7FEC);
-		emu->gpr[X86_R_SI] = x86_memory_read32(emu, offset - 0x8000 + 0x7FE8);
-	}
-	emu->gpr[X86_R_BP] = x86_memory_read32(emu, offset - 0x8000 + 0x7FE4);
-	emu->gpr[X86_R_SP] = x86_memory_read32(emu, offset - 0x8000 + 0x7FE0);
-	emu->gpr[X86_R_BX] = x86_memory_read32(emu, offset - 0x8000 + 0x7FDC);
-	emu->gpr[X86_R_DX] = x86_memory_read32(emu, offset - 0x8000 + 0x7FD8);
-	if(!restart_io)
-		emu->gpr[X86_R_CX] = x86_memory_read32(emu, offset - 0x8000 + 0x7FD4);
-	emu->gpr[X86_R_AX] = x86_memory_read32(emu, offset - 0x8000 + 0x7FD0);
-	emu->dr[6] = x86_memory_read32(emu, offset - 0x8000 + 0x7FCC);
-	emu->dr[7] = x86_memory_read32(emu, offset - 0x8000 + 0x7FC8);
-	emu->sr[X86_R_TR].selector = x86_memory_read32(emu, offset - 0x8000 + 0x7FC4);
-	emu->sr[X86_R_LDTR].selector = x86_memory_read32(emu, offset - 0x8000 + 0x7FC0);
-	emu->sr[X86_R_GS].selector = x86_memory_read32(emu, offset - 0x8000 + 0x7FBC);
-	emu->sr[X86_R_FS].selector = x86_memory_read32(emu, offset - 0x8000 + 0x7FB8);
-	emu->sr[X86_R_DS].selector = x86_memory_read32(emu, offset - 0x8000 + 0x7FB4);
-	emu->sr[X86_R_SS].selector = x86_memory_read32(emu, offset - 0x8000 + 0x7FB0);
-	emu->sr[X86_R_CS].selector = x86_memory_read32(emu, offset - 0x8000 + 0x7FAC);
-	emu->sr[X86_R_ES].selector = x86_memory_read32(emu, offset - 0x8000 + 0x7FA8);
+	x86_image_load_fields(emu, image, X86_SMM_IMAGE_START, x86_smm_fields_32, restart_io);
 
 	if((emu->smm_revision_identifier & SMM_REVID_SMBASE_RELOC) != 0)
-		emu->smbase = x86_memory_read32(emu, offset - 0x8000 + 0x7EF8);
+		emu->smbase = x86_image_get32(image, 0x7EF8 - X86_SMM_IMAGE_START);
 
 	emu->cpu_level = X86_LEVEL_USER;
 }
 
 static inline void x86_smm_restore_state_amd64(x86_state_t * emu, uaddr_t offset)
 {
-	bool restart_io = (emu->smm_revision_identifier & SMM_REVID_IO_RESTART) != 0 && x86_memory_read8(emu, offset - 0x8000 + 0x7EC8) == 0xFF;
-
-	emu->gpr[X86_R_AX] = x86_memory_read64(emu, offset - 0x8000 + 0x7FF8);
-	if(!restart_io)
-		emu->gpr[X86_R_CX] = x86_memory_read64(emu, offset - 0x8000 + 0x7FF0);
-	emu->gpr[X86_R_DX] = x86_memory_read64(emu, offset - 0x8000 + 0x7FE8);
-	emu->gpr[X86_R_BX] = x86_memory_read64(emu, offset - 0x8000 + 0x7FE0);
-	emu->gpr[X86_R_SP] = x86_memory_read64(emu, offset - 0x8000 + 0x7FD8);
-	emu->gpr[X86_R_BP] = x86_memory_read64(emu, offset - 0x8000 + 0x7FD0);
-	if(!restart_io)
-	{
-		emu->gpr[X86_R_SI] = x86_memory_read64(emu, offset - 0x8000 + 0x7FC8);
-		emu->gpr[X86_R_DI] = x86_memory_read64(emu, offset - 0x8000 + 0x7FC0);
-	}
-	emu->gpr[8] = x86_memory_read64(emu, offset - 0x8000 + 0x7FB8);
-	emu->gpr[9] = x86_memory_read64(emu, offset - 0x8000 + 0x7FB0);
-	emu->gpr[10] = x86_memory_read64(emu, offset - 0x8000 + 0x7FA8);
-	emu->gpr[11] = x86_memory_read64(emu, offset - 0x8000 + 0x7FA0);
-	emu->gpr[12] = x86_memory_read64(emu, offset - 0x8000 + 0x7F98);
-	emu->gpr[13] = x86_memory_read64(emu, offset - 0x8000 + 0x7F90);
-	emu->gpr[14] = x86_memory_read64(emu, offset - 0x8000 + 0x7F88);
-	emu->gpr[15] = x86_memory_read64(emu, offset - 0x8000 + 0x7F80);
-	if(!restart_io)
-		x86_set_xip(emu, x86_memory_read64(emu, offset - 0x8000 + 0x7F78));
-	x86_flags_set64(emu, x86_memory_read64(emu, offset - 0x8000 + 0x7F70));
-	emu->dr[6] = x86_memory_read64(emu, offset - 0x8000 + 0x7F68);
-	emu->dr[7] = x86_memory_read64(emu, offset - 0x8000 + 0x7F60);
-	emu->cr[0] = x86_memory_read64(emu, offset - 0x8000 + 0x7F58);
-	emu->cr[3] = x86_memory_read64(emu, offset - 0x8000 + 0x7F50);
-	emu->cr[4] = x86_memory_read64(emu, offset - 0x8000 + 0x7F48);
-
-	emu->smbase = x86_memory_read32(emu, offset - 0x8000 + 0x7F00);
-
-	emu->efer = x86_memory_read64(emu, offset - 0x8000 + 0x7ED0);
-
-	x86_set_cpl(emu, x86_memory_read8(emu, offset - 0x8000 + 0x7ECB));
+	uint8_t image[X86_SMM_IMAGE_SIZE];
+	x86_memory_read(emu, offset - 0x8000 + X86_SMM_IMAGE_START, sizeof image, image);
+
+	bool restart_io = (emu->smm_revision_identifier & SMM_REVID_IO_RESTART) != 0 && image[0x7EC8 - X86_SMM_IMAGE_START] == 0xFF;
+
+	x86_image_load_fields(emu, image, X86_SMM_IMAGE_START, x86_smm_fields_amd64, restart_io);
+
+	emu->smbase = x86_image_get32(image, 0x7F00 - X86_SMM_IMAGE_START);
+
+	x86_set_cpl(emu, image[0x7ECB - X86_SMM_IMAGE_START]);
 
 	// TODO: guessing
 	if(restart_io)
 	{
-		emu->gpr[X86_R_DI] = x86_memory_read32(emu, offset - 0x8000 + 0x7EB8);
-		emu->gpr[X86_R_SI] = x86_memory_read32(emu, offset - 0x8000 + 0x7EB0);
-		emu->gpr[X86_R_CX] = x86_memory_read32(emu, offset - 0x8000 + 0x7EA8);
-		x86_set_xip(emu, x86_memory_read32(emu, offset - 0x8000 + 0x7EA0));
+		emu->gpr[X86_R_DI] = x86_image_get32(image, 0x7EB8 - X86_SMM_IMAGE_START);
+		emu->gpr[X86_R_SI] = x86_image_get32(image, 0x7EB0 - X86_SMM_IMAGE_START);
+		emu->gpr[X86_R_CX] = x86_image_get32(image, 0x7EA8 - X86_SMM_IMAGE_START);
+		x86_set_xip(emu, x86_image_get32(image, 0x7EA0 - X86_SMM_IMAGE_START));
 	}
 
-	x86_descriptor_cache_read_amd64(emu, offset - 0x8000 + 0xFE90, &emu->sr[X86_R_TR]);
-	x86_descriptor_cache_read_amd64(emu, offset - 0x8000 + 0xFE80, &emu->sr[X86_R_IDTR]);
-	x86_descriptor_cache_read_amd64(emu, offset - 0x8000 + 0xFE70, &emu->sr[X86_R_LDTR]);
-	x86_descriptor_cache_read_amd64(emu, offset - 0x8000 + 0xFE60, &emu->sr[X86_R_GDTR]);
-	x86_descriptor_cache_read_amd64(emu, offset - 0x8000 + 0xFE50, &emu->sr[X86_R_GS]);
-	x86_descriptor_cache_read_amd64(emu, offset - 0x8000 + 0xFE40, &emu->sr[X86_R_FS]);
-	x86_descriptor_cache_read_amd64(emu, offset - 0x8000 + 0xFE30, &emu->sr[X86_R_DS]);
-	x86_descriptor_cache_read_amd64(emu, offset - 0x8000 + 0xFE20, &emu->sr[X86_R_SS]);
-	x86_descriptor_cache_read_amd64(emu, offset - 0x8000 + 0xFE10, &emu->sr[X86_R_CS]);
-	x86_descriptor_cache_read_amd64(emu, offset - 0x8000 + 0xFE00, &emu->sr[X86_R_ES]);
+	x86_image_load_fields(emu, image, X86_SMM_IMAGE_START, x86_smm_caches_amd64, false);
 
 	emu->cpu_level = X86_LEVEL_USER;
 }
 
 static inline void x86_smm_restore_state_intel64(x86_state_t * emu, uaddr_t offset)
 {
-	bool restart_io = (emu->smm_revision_identifier & SMM_REVID_IO_RESTART) != 0 && x86_memory_read8(emu, offset - 0x8000 + 0x7F00) == 0xFF;
-
-	emu->cr[0] = x86_memory_read64(emu, offset - 0x8000 + 0x7FF8);
-	emu->cr[3] = x86_memory_read64(emu, offset - 0x8000 + 0x7FF0);
-	x86_flags_set64(emu, x86_memory_read64(emu, offset - 0x8000 + 0x7FE8));
-	emu->efer = x86_memory_read64(emu, offset - 0x8000 + 0x7FE0);
-	if(!restart_io)
-		x86_set_xip(emu, x86_memory_read64(emu, offset - 0x8000 + 0x7FD8));
-	emu->dr[6] = x86_memory_read64(emu, offset - 0x8000 + 0x7FD0);
-	emu->dr[7] = x86_memory_read64(emu, offset - 0x8000 + 0x7FC8);
-	emu->sr[X86_R_TR].selector = x86_memory_read16(emu, offset - 0x8000 + 0x7FC4);
-	emu->sr[X86_R_LDTR].selector = x86_memory_read16(emu, offset - 0x8000 + 0x7FC0);
-	emu->sr[X86_R_GS].selector = x86_memory_read16(emu, offset - 0x8000 + 0x7FBC);
-	emu->sr[X86_R_FS].selector = x86_memory_read16(emu, offset - 0x8000 + 0x7FB8);
-	emu->sr[X86_R_DS].selector = x86_memory_read16(emu, offset - 0x8000 + 0x7FB4);
-	emu->sr[X86_R_SS].selector = x86_memory_read16(emu, offset - 0x8000 + 0x7FB0);
-	emu->sr[X86_R_CS].selector = x86_memory_read16(emu, offset - 0x8000 + 0x7FAC);
-	emu->sr[X86_R_ES].selector = x86_memory_read16(emu, offset - 0x8000 + 0x7FA8);
-
-	//if(!restart_io)
-	emu->gpr[X86_R_DI] = x86_memory_read64(emu, offset - 0x8000 + 0x7F94);
-	//if(!restart_io)
-	emu->gpr[X86_R_SI] = x86_memory_read64(emu, offset - 0x8000 + 0x7F8C);
-	emu->gpr[X86_R_BP] = x86_memory_read64(emu, offset - 0x8000 + 0x7F84);
-	emu->gpr[X86_R_SP] = x86_memory_read64(emu, offset - 0x8000 + 0x7F7C);
-	emu->gpr[X86_R_BX] = x86_memory_read64(emu, offset - 0x8000 + 0x7F74);
-	emu->gpr[X86_R_DX] = x86_memory_read64(emu, offset - 0x8000 + 0x7F6C);
-	//if(!restart_io)
-	emu->gpr[X86_R_CX] = x86_memory_read64(emu, offset - 0x8000 + 0x7F64);
-	emu->gpr[X86_R_AX] = x86_memory_read64(emu, offset - 0x8000 + 0x7F5C);
-	emu->gpr[8] = x86_memory_read64(emu, offset - 0x8000 + 0x7F54);
-	emu->gpr[9] = x86_memory_read64(emu, offset - 0x8000 + 0x7F4C);
-	emu->gpr[10] = x86_memory_read64(emu, offset - 0x8000 + 0x7F44);
-	emu->gpr[11] = x86_memory_read64(emu, offset - 0x8000 + 0x7F3C);
-	emu->gpr[12] = x86_memory_read64(emu, offset - 0x8000 + 0x7F34);
-	emu->gpr[13] = x86_memory_read64(emu, offset - 0x8000 + 0x7F2C);
-	emu->gpr[14] = x86_memory_read64(emu, offset - 0x8000 + 0x7F24);
-	emu->gpr[15] = x86_memory_read64(emu, offset - 0x8000 + 0x7F1C);
+	uint8_t image[X86_SMM_INTEL64_IMAGE_SIZE];
+	x86_memory_read(emu, offset - 0x8000 + X86_SMM_INTEL64_IMAGE_START, sizeof image, image);
 
-	if((emu->smm_revision_identifier & SMM_REVID_SMBASE_RELOC) != 0)
-		emu->smbase = x86_memory_read32(emu, offset - 0x8000 + 0x7EF8);
+	bool restart_io = (emu->smm_revision_identifier & SMM_REVID_IO_RESTART) != 0 && image[0x7F00 - X86_SMM_INTEL64_IMAGE_START] == 0xFF;
 
-	emu->sr[X86_R_LDTR].base =
-		x86_memory_read32(emu, offset - 0x8000 + 0x7E9C)
-		| ((uint64_t)x86_memory_read32(emu, offset - 0x8000 + 0x7DD4) << 32);
-	emu->sr[X86_R_IDTR].base =
-		x86_memory_read32(emu, offset - 0x8000 + 0x7E94)
-		| ((uint64_t)x86_memory_read32(emu, offset - 0x8000 + 0x7DD8) << 32);
-	emu->sr[X86_R_GDTR].base =
-		x86_memory_read32(emu, offset - 0x8000 + 0x7E8C)
-		| ((uint64_t)x86_memory_read32(emu, offset - 0x8000 + 0x7DD0) << 32);
+	// TODO: check whether RDI, RSI and RCX should also be taken from the I/O restart fields
+	x86_image_load_fields(emu, image, X86_SMM_INTEL64_IMAGE_START, x86_smm_fields_intel64, restart_io);
 
-	emu->cr[4] = x86_memory_read64(emu, offset - 0x8000 + 0x7E40);
+	if((emu->smm_revision_identifier & SMM_REVID_SMBASE_RELOC) != 0)
+		emu->smbase = x86_image_get32(image, 0x7EF8 - X86_SMM_INTEL64_IMAGE_START);
 
 	if(restart_io)
 	{
-		x86_set_xip(emu, x86_memory_read32(emu, offset - 0x8000 + 0x7DE8));
+		x86_set_xip(emu, x86_image_get32(image, 0x7DE8 - X86_SMM_INTEL64_IMAGE_START));
 	}
 
 	emu->cpu_level = X86_LEVEL_USER;
@@ -1616,19 +1724,18 @@ static inline void x86_smm_restore_state_intel64(x86_state_t * emu, uaddr_t offs
 
 static inline void x86_smm_restore_state_cyrix(x86_state_t * emu, uaddr_t offset)
 {
-	uint8_t code_descriptor[8];
+	uint8_t image[X86_SMM_CYRIX_IMAGE_SIZE];
+	uint8_t * code_descriptor = &image[X86_SMM_CYRIX_HEADER(0x20)];
 
 	bool is_nested = false;
 	bool is_halted = false;
 	uint16_t flags;
 
-	emu->dr[7] = x86_memory_read32(emu, offset - 0x04); // TODO: check DMM_CTL.DBG_AS_DMI == 0
-	x86_flags_set32(emu, x86_memory_read32(emu, offset - 0x08));
-	emu->cr[0] = x86_memory_read32(emu, offset - 0x0C);
-	x86_set_xip(emu, x86_memory_read32(emu, offset - 0x14));
-	emu->sr[X86_R_CS].selector = x86_memory_read16(emu, offset - 0x18);
+	x86_memory_read(emu, offset - X86_SMM_CYRIX_IMAGE_SIZE, sizeof image, image);
+
+	x86_image_load_fields(emu, image, 0, x86_smm_fields_cyrix, false); // TODO: check DMM_CTL.DBG_AS_DMI == 0 for DR7
 
-	flags = x86_memory_read16(emu, offset - 0x24);
+	flags = x86_image_get16(image, X86_SMM_CYRIX_HEADER(0x24));
 
 	switch(emu->cpu_traits.smm_format)
 	{
@@ -1636,32 +1743,28 @@ static inline void x86_smm_restore_state_cyrix(x86_state_t * emu, uaddr_t offset
 		assert(false);
 
 	case X86_SMM_CX486SLCE:
-		x86_memory_read(emu, offset - 0x20, 8, code_descriptor);
 		x86_descriptor_cache_read_cyrix(emu, X86_R_CS, code_descriptor);
 		x86_set_cpl(emu, code_descriptor[5] >> 5);
 		break;
 
 	case X86_SMM_M1:
-		x86_memory_read(emu, offset - 0x20, 8, code_descriptor);
 		x86_descriptor_cache_read_cyrix(emu, X86_R_CS, code_descriptor);
 
-		x86_set_cpl(emu, x86_memory_read16(emu, offset - 0x16) >> 5);
+		x86_set_cpl(emu, x86_image_get16(image, X86_SMM_CYRIX_HEADER(0x16)) >> 5);
 
 		is_halted = (flags & 0x0010) != 0;
 		break;
 
 	case X86_SMM_M2:
-		x86_memory_read(emu, offset - 0x20, 8, code_descriptor);
 		x86_descriptor_cache_read_cyrix(emu, X86_R_CS, code_descriptor);
 
-		x86_set_cpl(emu, x86_memory_read16(emu, offset - 0x22) >> 5);
+		x86_set_cpl(emu, x86_image_get16(image, X86_SMM_CYRIX_HEADER(0x22)) >> 5);
 
 		is_halted = (flags & 0x0010) != 0;
 		is_nested = (flags & 0x8000) != 0;
 		break;
 
 	case X86_SMM_MEDIAGX:
-		x86_memory_read(emu, offset - 0x20, 8, code_descriptor);
 		x86_descriptor_cache_read_cyrix(emu, X86_R_CS, code_descriptor);
 		x86_set_cpl(emu, code_descriptor[5] >> 5);
 
@@ -1670,11 +1773,11 @@ static inline void x86_smm_restore_state_cyrix(x86_state_t * emu, uaddr_t offset
 		break;
 
 	case X86_SMM_GX2:
-		emu->sr[X86_R_CS].access = (uint32_t)x86_memory_read16(emu, offset - 0x16) << 8;
-		emu->sr[X86_R_CS].base = x86_memory_read32(emu, offset - 0x1C);
-		emu->sr[X86_R_CS].limit = x86_memory_read32(emu, offset - 0x1D);
-		emu->sr[X86_R_SS].access = (uint32_t)x86_memory_read16(emu, offset - 0x22) << 8;
-		emu->smm_ctl = x86_memory_read32(emu, offset - 0x30);
+		emu->sr[X86_R_CS].access = (uint32_t)x86_image_get16(image, X86_SMM_CYRIX_HEADER(0x16)) << 8;
+		emu->sr[X86_R_CS].base = x86_image_get32(image, X86_SMM_CYRIX_HEADER(0x1C));
+		emu->sr[X86_R_CS].limit = x86_image_get32(image, X86_SMM_CYRIX_HEADER(0x20));
+		emu->sr[X86_R_SS].access = (uint32_t)x86_image_get16(image, X86_SMM_CYRIX_HEADER(0x22)) << 8;
+		emu->smm_ctl = x86_image_get32(image, X86_SMM_CYRIX_HEADER(0x30));
 		x86_set_cpl(emu, emu->sr[X86_R_SS].access >> 13);
 
 		is_halted = (flags & 0x0010) != 0;
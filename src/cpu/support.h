@@ -121,6 +121,36 @@ static inline void _imul128(int128_t * _z, int64_t x, int64_t y)
 # define _high128(x) ((x).h)
 #endif
 
+// number of trailing and leading zero bits, the argument must not be zero
+#ifdef __GNUC__
+# define _ctz64(x) __builtin_ctzll(x)
+# define _clz64(x) __builtin_clzll(x)
+#else
+static inline int _ctz64(uint64_t x)
+{
+	int count = 0;
+	if((x & 0xFFFFFFFF) == 0) { count += 32; x >>= 32; }
+	if((x & 0xFFFF) == 0) { count += 16; x >>= 16; }
+	if((x & 0xFF) == 0) { count += 8; x >>= 8; }
+	if((x & 0xF) == 0) { count += 4; x >>= 4; }
+	if((x & 0x3) == 0) { count += 2; x >>= 2; }
+	if((x & 0x1) == 0) { count += 1; }
+	return count;
+}
+
+static inline int _clz64(uint64_t x)
+{
+	int count = 0;
+	if((x >> 32) == 0) { count += 32; x <<= 32; }
+	if((x >> 48) == 0) { count += 16; x <<= 16; }
+	if((x >> 56) == 0) { count += 8; x <<= 8; }
+	if((x >> 60) == 0) { count += 4; x <<= 4; }
+	if((x >> 62) == 0) { count += 2; x <<= 2; }
+	if((x >> 63) == 0) { count += 1; }
+	return count;
+}
+#endif
+
 #if FLT_RADIX == 2
 # if LDBL_MANT_DIG >= 63 && LDBL_MIN_EXP <= -13681 && LDBL_MAX_EXP >= 16384
 #  define _SUPPORT_FLOAT80 1
@@ -21,8 +21,20 @@ static inline void x86_set_high(uint16_t * reference, uint8_t value)
 	*reference = (*reference & ~0xFF00) | (value << 8);
 }
 
-static inline uint8_t x80_register_get8(x80_state_t * emu, x80_regnum_t prefix, int number, int8_t offset)
+// Accesses the register selected by the low 3 bits of a CB prefixed opcode
+// With a DD (IX) or FD (IY) prefix, the operand is always (IX+d) or (IY+d), and a result is also copied to the register unless it selects (HL)
+// The prefix is a constant for each opcode page, so the checks are resolved when the accessors are inlined
+
+static inline uint16_t x80_register_index_address(x80_state_t * emu, int prefix, int8_t offset)
+{
+	return (prefix == X80_R_IX ? emu->ix : emu->iy) + offset;
+}
+
+static inline uint8_t x80_register_get8(x80_state_t * emu, int prefix, int number, int8_t offset)
 {
+	if(prefix != NONE)
+		return x80_memory_read8(emu, x80_register_index_address(emu, prefix, offset));
+
 	switch(number)
 	{
 	case 0:
@@ -34,37 +46,13 @@ static inline uint8_t x80_register_get8(x80_state_t * emu, x80_regnum_t prefix,
 	case 3:
 		return x86_get_low(emu->bank[emu->main_bank].de);
 	case 4:
-		switch(prefix)
-		{
-		case X80_R_IX:
-			return x86_get_high(emu->ix);
-		case X80_R_IY:
-			return x86_get_high(emu->iy);
-		default:
-			return x86_get_high(emu->bank[emu->main_bank].hl);
-		}
+		return x86_get_high(emu->bank[emu->main_bank].hl);
 	case 5:
-		switch(prefix)
-		{
-		case X80_R_IX:
-			return x86_get_low(emu->ix);
-		case X80_R_IY:
-			return x86_get_low(emu->iy);
-		default:
-			return x86_get_low(emu->bank[emu->main_bank].hl);
-		}
+		return x86_get_low(emu->bank[emu->main_bank].hl);
 	case 6:
-		switch(prefix)
-		{
-		case X80_R_IX:
-			return x80_memory_read8(emu, emu->ix + offset);
-		case X80_R_IY:
-			return x80_memory_read8(emu, emu->iy + offset);
-		default:
-			return x80_memory_read8(emu, emu->bank[emu->main_bank].hl);
-		}
+		return x80_memory_read8(emu, emu->bank[emu->main_bank].hl);
 	case 7:
-		return x86_get_high(emu->bank[emu->main_bank].af);
+		return x86_get_high(emu->bank[emu->af_bank].af);
 	default:
 		assert(false);
 	}
@@ -72,6 +60,13 @@ static inline uint8_t x80_register_get8(x80_state_t * emu, x80_regnum_t prefix,
 
 static inline void x80_register_set8(x80_state_t * emu, int prefix, int number, int8_t offset, uint8_t value)
 {
+	if(prefix != NONE)
+	{
+		x80_memory_write8(emu, x80_register_index_address(emu, prefix, offset), value);
+		if(number == 6)
+			return;
+	}
+
 	switch(number)
 	{
 	case 0:
@@ -87,49 +82,16 @@ static inline void x80_register_set8(x80_state_t * emu, int prefix, int number,
 		x86_set_low(&emu->bank[emu->main_bank].de, value);
 		break;
 	case 4:
-		switch(prefix)
-		{
-		case X80_R_IX:
-			x86_set_high(&emu->ix, value);
-			break;
-		case X80_R_IY:
-			x86_set_high(&emu->iy, value);
-			break;
-		default:
-			x86_set_high(&emu->bank[emu->main_bank].hl, value);
-			break;
-		}
+		x86_set_high(&emu->bank[emu->main_bank].hl, value);
 		break;
 	case 5:
-		switch(prefix)
-		{
-		case X80_R_IX:
-			x86_set_low(&emu->ix, value);
-			break;
-		case X80_R_IY:
-			x86_set_low(&emu->iy, value);
-			break;
-		default:
-			x86_set_low(&emu->bank[emu->main_bank].hl, value);
-			break;
-		}
+		x86_set_low(&emu->bank[emu->main_bank].hl, value);
 		break;
 	case 6:
-		switch(prefix)
-		{
-		case X80_R_IX:
-			x80_memory_write8(emu, emu->ix + offset, value);
-			break;
-		case X80_R_IY:
-			x80_memory_write8(emu, emu->iy + offset, value);
-			break;
-		default:
-			x80_memory_write8(emu, emu->bank[emu->main_bank].hl, value);
-			break;
-		}
+		x80_memory_write8(emu, emu->bank[emu->main_bank].hl, value);
 		break;
 	case 7:
-		x86_set_high(&emu->bank[emu->main_bank].af, value);
+		x86_set_high(&emu->bank[emu->af_bank].af, value);
 		break;
 	default:
 		assert(false);
@@ -195,3 +157,304 @@ static inline uint16_t x80_pop16(x80_state_t * emu)
 	return x80_memory_read16(emu, sp);
 }
 
+// Precomputed flags for 8-bit arithmetic, the first index is 0 for the 8080/8085 and 1 for the Z80
+// The 8080/8085 tables only contain the S, Z, A, P and C bits, the remaining bits of the flags register are preserved
+
+#define X80_FLAGS_MASK_8080 0xD5
+#define X80_FLAGS_MASK_8080_INC_DEC 0xD4
+#define X80_FLAGS_MASK_Z80_INC_DEC 0xFE
+
+static uint8_t x80_flags_add[2][0x20000]; // indexed by carry << 16 | x << 8 | y
+static uint8_t x80_flags_sub[2][0x20000]; // indexed by carry << 16 | x << 8 | y
+static uint8_t x80_flags_inc[2][0x100]; // indexed by the result
+static uint8_t x80_flags_dec[2][0x100]; // indexed by the result
+static uint8_t x80_flags_szp[2][0x100]; // indexed by the result of a logical operation
+static bool x80_flags_initialized;
+
+static inline uint8_t x80_flags_get_szp(uint8_t z, bool z80)
+{
+	uint8_t parity = z ^ (z >> 4);
+	parity ^= parity >> 2;
+	parity ^= parity >> 1;
+	return (z & (z80 ? 0xA8 : 0x80)) | (z == 0 ? X86_FL_ZF : 0) | ((parity & 1) == 0 ? X86_FL_PF : 0);
+}
+
+static void x80_flags_initialize(void)
+{
+	if(x80_flags_initialized)
+		return;
+
+	for(int z80 = 0; z80 < 2; z80++)
+	{
+		for(unsigned index = 0; index < 0x20000; index++)
+		{
+			uint8_t x = index >> 8, y = index, carry = index >> 16;
+			uint8_t z;
+			uint8_t flags;
+
+			z = x + y + carry;
+			flags = x80_flags_get_szp(z, z80) & ~X86_FL_PF;
+			flags |= (((x & y) | ((x | y) & ~z)) & 0x80) != 0 ? X86_FL_CF : 0;
+			flags |= ((x ^ y ^ z) & 0x10) != 0 ? X86_FL_AF : 0;
+			if(z80)
+				flags |= (((x ^ z) & (y ^ z)) & 0x80) != 0 ? X86_FL_PF : 0;
+			else
+				flags |= x80_flags_get_szp(z, false) & X86_FL_PF;
+			x80_flags_add[z80][index] = flags;
+
+			z = x - y - carry;
+			flags = x80_flags_get_szp(z, z80) & ~X86_FL_PF;
+			flags |= (((~x & y) | ((~x | y) & z)) & 0x80) != 0 ? X86_FL_CF : 0;
+			if(z80)
+			{
+				// the 8080 sets A when there is no borrow, the Z80 sets H when there is one
+				flags |= ((x ^ y ^ z) & 0x10) != 0 ? X86_FL_AF : 0;
+				flags |= (((x ^ y) & (x ^ z)) & 0x80) != 0 ? X86_FL_PF : 0;
+				flags |= X86_FL_NF;
+			}
+			else
+			{
+				flags |= ((x ^ y ^ z) & 0x10) == 0 ? X86_FL_AF : 0;
+				flags |= x80_flags_get_szp(z, false) & X86_FL_PF;
+			}
+			x80_flags_sub[z80][index] = flags;
+		}
+
+		for(unsigned z = 0; z < 0x100; z++)
+		{
+			uint8_t flags;
+
+			x80_flags_szp[z80][z] = x80_flags_get_szp(z, z80);
+
+			flags = x80_flags_get_szp(z, z80);
+			if(z80)
+				flags = (flags & ~X86_FL_PF) | (z == 0x80 ? X86_FL_PF : 0);
+			flags |= (z & 0x0F) == 0x00 ? X86_FL_AF : 0;
+			x80_flags_inc[z80][z] = flags;
+
+			flags = x80_flags_get_szp(z, z80);
+			if(z80)
+			{
+				flags = (flags & ~X86_FL_PF) | (z == 0x7F ? X86_FL_PF : 0) | X86_FL_NF;
+				flags |= (z & 0x0F) == 0x0F ? X86_FL_AF : 0;
+			}
+			else
+			{
+				flags |= (z & 0x0F) != 0x0F ? X86_FL_AF : 0;
+			}
+			x80_flags_dec[z80][z] = flags;
+		}
+	}
+
+	x80_flags_initialized = true;
+}
+
+static inline void x80_flags_set(x80_state_t * emu, uint8_t mask, uint8_t flags)
+{
+	x86_set_low(&emu->bank[emu->af_bank].af, (x86_get_low(emu->bank[emu->af_bank].af) & ~mask) | flags);
+}
+
+static inline uint8_t x80_add8(x80_state_t * emu, uint8_t x, uint8_t y, unsigned carry)
+{
+	bool z80 = emu->cpu_type == X80_CPU_Z80;
+	x80_flags_set(emu, z80 ? 0xFF : X80_FLAGS_MASK_8080, x80_flags_add[z80][(carry << 16) | (x << 8) | y]);
+	return x + y + carry;
+}
+
+static inline uint8_t x80_sub8(x80_state_t * emu, uint8_t x, uint8_t y, unsigned carry)
+{
+	bool z80 = emu->cpu_type == X80_CPU_Z80;
+	x80_flags_set(emu, z80 ? 0xFF : X80_FLAGS_MASK_8080, x80_flags_sub[z80][(carry << 16) | (x << 8) | y]);
+	return x - y - carry;
+}
+
+static inline void x80_compare8(x80_state_t * emu, uint8_t x, uint8_t y)
+{
+	if(emu->cpu_type == X80_CPU_Z80)
+		// the undocumented bits are copied from the operand
+		x80_flags_set(emu, 0xFF, (x80_flags_sub[1][(x << 8) | y] & ~0x28) | (y & 0x28));
+	else
+		x80_flags_set(emu, X80_FLAGS_MASK_8080, x80_flags_sub[0][(x << 8) | y]);
+}
+
+static inline uint8_t x80_negate8(x80_state_t * emu, uint8_t x)
+{
+	// only present on the Z80
+	x80_flags_set(emu, 0xFF, x80_flags_sub[1][x]);
+	return -x;
+}
+
+static inline uint8_t x80_inc8(x80_state_t * emu, uint8_t x)
+{
+	bool z80 = emu->cpu_type == X80_CPU_Z80;
+	uint8_t z = x + 1;
+	x80_flags_set(emu, z80 ? X80_FLAGS_MASK_Z80_INC_DEC : X80_FLAGS_MASK_8080_INC_DEC, x80_flags_inc[z80][z]);
+	return z;
+}
+
+static inline uint8_t x80_dec8(x80_state_t * emu, uint8_t x)
+{
+	bool z80 = emu->cpu_type == X80_CPU_Z80;
+	uint8_t z = x - 1;
+	x80_flags_set(emu, z80 ? X80_FLAGS_MASK_Z80_INC_DEC : X80_FLAGS_MASK_8080_INC_DEC, x80_flags_dec[z80][z]);
+	return z;
+}
+
+static inline uint8_t x80_and8(x80_state_t * emu, uint8_t x, uint8_t y)
+{
+	uint8_t z = x & y;
+	if(emu->cpu_type == X80_CPU_Z80)
+		x80_flags_set(emu, 0xFF, x80_flags_szp[1][z] | X86_FL_AF);
+	else
+		// the 8080 sets A from bit 3 of the operands
+		x80_flags_set(emu, X80_FLAGS_MASK_8080, x80_flags_szp[0][z] | (((x | y) & 0x08) != 0 ? X86_FL_AF : 0));
+	return z;
+}
+
+static inline uint8_t x80_logic8(x80_state_t * emu, uint8_t z)
+{
+	bool z80 = emu->cpu_type == X80_CPU_Z80;
+	x80_flags_set(emu, z80 ? 0xFF : X80_FLAGS_MASK_8080, x80_flags_szp[z80][z]);
+	return z;
+}
+
+// Repeated block instructions transfer up to X80_BLOCK_SIZE bytes in a single step, then restart like the x86 REP prefix
+// Bytes are only grouped while neither HL nor DE wraps around, the final registers and flags are those of the last iteration
+
+#define X80_BLOCK_SIZE 0x1000
+
+static inline size_t x80_block_count(uint16_t counter, uint16_t address, bool decrement)
+{
+	size_t count = counter == 0 ? 0x10000 : counter;
+	count = min(count, decrement ? (size_t)address + 1 : 0x10000 - (size_t)address);
+	return min(count, X80_BLOCK_SIZE);
+}
+
+// LDIR/LDDR, returns the last byte moved
+static inline uint8_t x80_block_move(x80_state_t * emu, bool decrement)
+{
+	uint16_t bc = emu->bank[emu->main_bank].bc;
+	uint16_t de = emu->bank[emu->main_bank].de;
+	uint16_t hl = emu->bank[emu->main_bank].hl;
+	size_t count = min(x80_block_count(bc, hl, decrement), x80_block_count(bc, de, decrement));
+	// bytes further than this from the start of the source were already overwritten by the time they are read
+	size_t distance = (uint16_t)(decrement ? hl - de : de - hl);
+	uint16_t source = decrement ? hl - (count - 1) : hl;
+	uint16_t target = decrement ? de - (count - 1) : de;
+	uint8_t buffer[X80_BLOCK_SIZE];
+
+	if(distance != 0 && distance < count)
+	{
+		// the first distance bytes repeat over the destination, this is how a buffer is filled with LD (DE),(HL) and DE = HL + 1
+		if(!decrement)
+		{
+			x80_memory_read_block(emu, source, distance, buffer);
+			for(size_t i = distance; i < count; i++)
+				buffer[i] = buffer[i - distance];
+		}
+		else
+		{
+			x80_memory_read_block(emu, hl - (distance - 1), distance, &buffer[count - distance]);
+			for(size_t i = count - distance; i-- > 0; )
+				buffer[i] = buffer[i + distance];
+		}
+	}
+	else
+	{
+		x80_memory_read_block(emu, source, count, buffer);
+	}
+	x80_memory_write_block(emu, target, count, buffer);
+
+	emu->bank[emu->main_bank].bc = bc - count;
+	emu->bank[emu->main_bank].de = decrement ? de - count : de + count;
+	emu->bank[emu->main_bank].hl = decrement ? hl - count : hl + count;
+	return decrement ? buffer[0] : buffer[count - 1];
+}
+
+// CPIR/CPDR, stops after the first byte equal to A, returns the last byte compared
+static inline uint8_t x80_block_compare(x80_state_t * emu, bool decrement)
+{
+	uint16_t bc = emu->bank[emu->main_bank].bc;
+	uint16_t hl = emu->bank[emu->main_bank].hl;
+	uint8_t a = x86_get_high(emu->bank[emu->af_bank].af);
+	size_t count = x80_block_count(bc, hl, decrement);
+	uint8_t buffer[X80_BLOCK_SIZE];
+	uint8_t value;
+
+	x80_memory_read_block(emu, decrement ? hl - (count - 1) : hl, count, buffer);
+	if(!decrement)
+	{
+		uint8_t * match = memchr(buffer, a, count);
+		if(match != NULL)
+			count = match - buffer + 1;
+		value = buffer[count - 1];
+	}
+	else
+	{
+		size_t index = count;
+		while(index > 1 && buffer[index - 1] != a)
+			index--;
+		count -= index - 1;
+		value = buffer[index - 1];
+	}
+
+	emu->bank[emu->main_bank].bc = bc - count;
+	emu->bank[emu->main_bank].hl = decrement ? hl - count : hl + count;
+	return value;
+}
+
+// INDR/OTDR access memory downwards, the first byte is at the highest address
+static inline void x80_block_reverse(uint8_t * buffer, size_t count)
+{
+	for(size_t i = 0; i < count / 2; i++)
+	{
+		uint8_t value = buffer[i];
+		buffer[i] = buffer[count - 1 - i];
+		buffer[count - 1 - i] = value;
+	}
+}
+
+// INIR/INDR, moves a single byte unless the device can transfer a block
+static inline void x80_block_input(x80_state_t * emu, bool decrement)
+{
+	uint16_t bc = emu->bank[emu->main_bank].bc;
+	uint16_t hl = emu->bank[emu->main_bank].hl;
+	size_t count = x80_block_count(x86_get_high(bc) != 0 ? x86_get_high(bc) : 0x100, hl, decrement);
+	uint8_t buffer[0x100];
+
+	if(count < 2 || x80_input_block(emu, bc, count, buffer) == 0)
+	{
+		count = 1;
+		buffer[0] = x80_input8(emu, bc);
+	}
+	else if(decrement)
+	{
+		x80_block_reverse(buffer, count);
+	}
+	x80_memory_write_block(emu, decrement ? hl - (count - 1) : hl, count, buffer);
+
+	emu->bank[emu->main_bank].bc = bc - (count << 8);
+	emu->bank[emu->main_bank].hl = decrement ? hl - count : hl + count;
+}
+
+// OTIR/OTDR, moves a single byte unless the device can transfer a block
+static inline void x80_block_output(x80_state_t * emu, bool decrement)
+{
+	uint16_t bc = emu->bank[emu->main_bank].bc;
+	uint16_t hl = emu->bank[emu->main_bank].hl;
+	size_t count = x80_block_count(x86_get_high(bc) != 0 ? x86_get_high(bc) : 0x100, hl, decrement);
+	uint8_t buffer[0x100];
+
+	x80_memory_read_block(emu, decrement ? hl - (count - 1) : hl, count, buffer);
+	if(decrement)
+		x80_block_reverse(buffer, count);
+
+	if(count < 2 || x80_output_block(emu, bc, count, buffer) == 0)
+	{
+		count = 1;
+		x80_output8(emu, bc, buffer[0]);
+	}
+
+	emu->bank[emu->main_bank].bc = bc - (count << 8);
+	emu->bank[emu->main_bank].hl = decrement ? hl - count : hl + count;
+}
@@ -423,6 +423,86 @@ static inline void x86_push64(x86_state_t * emu, uint64_t value)
 	}
 }
 
+// Pushes several values with a single stack access, buffer holds them in memory order (the last value pushed first)
+// Returns false without accessing the stack if the stack pointer would wrap around inside the block
+static inline bool x86_push_block(x86_state_t * emu, const void * buffer, uoff_t count)
+{
+	switch(x86_get_stack_size(emu))
+	{
+	case SIZE_16BIT:
+		{
+			uint16_t sp = x86_register_get16(emu, X86_R_SP);
+			if(sp != 0 && sp < count)
+				return false;
+			sp -= count;
+			x86_memory_segmented_write(emu, X86_R_SS, sp, count, buffer);
+			x86_register_set16(emu, X86_R_SP, sp);
+		}
+		break;
+	case SIZE_32BIT:
+		{
+			uint32_t esp = x86_register_get32(emu, X86_R_SP);
+			if(esp != 0 && esp < count)
+				return false;
+			esp -= count;
+			x86_memory_segmented_write(emu, X86_R_SS, esp, count, buffer);
+			x86_register_set32(emu, X86_R_SP, esp);
+		}
+		break;
+	case SIZE_64BIT:
+		{
+			uint64_t rsp = x86_register_get64(emu, X86_R_SP);
+			rsp -= count;
+			x86_memory_segmented_write(emu, X86_R_SS, rsp, count, buffer);
+			x86_register_set64(emu, X86_R_SP, rsp);
+		}
+		break;
+	default:
+		assert(false);
+	}
+	return true;
+}
+
+// Pops several values with a single stack access, buffer receives them in memory order (the first value popped first)
+// Returns false without accessing the stack if the stack pointer would wrap around inside the block
+static inline bool x86_pop_block(x86_state_t * emu, void * buffer, uoff_t count)
+{
+	switch(x86_get_stack_size(emu))
+	{
+	case SIZE_16BIT:
+		{
+			uint16_t sp = x86_register_get16(emu, X86_R_SP);
+			if(sp > 0x10000 - count)
+				return false;
+			x86_memory_segmented_read(emu, X86_R_SS, sp, count, buffer);
+			sp += count;
+			x86_register_set16(emu, X86_R_SP, sp);
+		}
+		break;
+	case SIZE_32BIT:
+		{
+			uint32_t esp = x86_register_get32(emu, X86_R_SP);
+			if(esp > 0x100000000 - count)
+				return false;
+			x86_memory_segmented_read(emu, X86_R_SS, esp, count, buffer);
+			esp += count;
+			x86_register_set32(emu, X86_R_SP, esp);
+		}
+		break;
+	case SIZE_64BIT:
+		{
+			uint64_t rsp = x86_register_get64(emu, X86_R_SP);
+			x86_memory_segmented_read(emu, X86_R_SS, rsp, count, buffer);
+			rsp += count;
+			x86_register_set64(emu, X86_R_SP, rsp);
+		}
+		break;
+	default:
+		assert(false);
+	}
+	return true;
+}
+
 static inline uint64_t x86_pop64(x86_state_t * emu)
 {
 	uint64_t value;
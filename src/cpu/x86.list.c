@@ -0,0 +1,3253 @@
+typedef enum x86_cpu_version_t
+{
+	X86_CPU_TYPE_8086,
+	X86_CPU_TYPE_8088,
+	X86_CPU_TYPE_80186,
+	X86_CPU_TYPE_80188,
+	X86_CPU_TYPE_80286,
+	X86_CPU_TYPE_80386,
+	X86_CPU_TYPE_80386SX,
+	X86_CPU_TYPE_80386B0,
+	X86_CPU_TYPE_80386SL,
+	X86_CPU_TYPE_80376,
+	X86_CPU_TYPE_80486,
+	X86_CPU_TYPE_80486A,
+	X86_CPU_TYPE_80486SX,
+	X86_CPU_TYPE_80486SL,
+	X86_CPU_TYPE_P5,
+	X86_CPU_TYPE_P6,
+	X86_CPU_TYPE_P5MMX,
+	X86_CPU_TYPE_P6_2,
+	X86_CPU_TYPE_P6_3,
+	X86_CPU_TYPE_IA64,
+	X86_CPU_TYPE_ITANIUM2,
+	X86_CPU_TYPE_P4,
+	X86_CPU_TYPE_PRESCOTT,
+	X86_CPU_TYPE_MEROM,
+	X86_CPU_TYPE_PENRYN,
+	X86_CPU_TYPE_NEHALEM,
+	X86_CPU_TYPE_WESTMERE,
+	X86_CPU_TYPE_SANDYBRIDGE,
+	X86_CPU_TYPE_IVYBRIDGE,
+	X86_CPU_TYPE_HASWELL,
+	X86_CPU_TYPE_BROADWELL,
+	X86_CPU_TYPE_SKYLAKE,
+	X86_CPU_TYPE_BONNELL,
+	X86_CPU_TYPE_SILVERMONT,
+	X86_CPU_TYPE_GOLDMONT,
+	X86_CPU_TYPE_GRACEMONT,
+	X86_CPU_TYPE_KNF,
+	X86_CPU_TYPE_KNC,
+	X86_CPU_TYPE_KNL,
+	X86_CPU_TYPE_X86S,
+	X86_CPU_TYPE_AM386,
+	X86_CPU_TYPE_AM486,
+	X86_CPU_TYPE_AM5X86,
+	X86_CPU_TYPE_NX586,
+	X86_CPU_TYPE_NX586FP,
+	X86_CPU_TYPE_NX686,
+	X86_CPU_TYPE_K5,
+	X86_CPU_TYPE_K6,
+	X86_CPU_TYPE_K6_2,
+	X86_CPU_TYPE_K6_3,
+	X86_CPU_TYPE_K6_2PLUS,
+	X86_CPU_TYPE_K6_3PLUS,
+	X86_CPU_TYPE_K7,
+	X86_CPU_TYPE_ATHLONXP,
+	X86_CPU_TYPE_K8,
+	X86_CPU_TYPE_K10,
+	X86_CPU_TYPE_BOBCAT,
+	X86_CPU_TYPE_JAGUAR,
+	X86_CPU_TYPE_PUMA,
+	X86_CPU_TYPE_DREX,
+	X86_CPU_TYPE_BULLDOZER,
+	X86_CPU_TYPE_PILEDRIVER,
+	X86_CPU_TYPE_EXCAVATOR,
+	X86_CPU_TYPE_ZEN,
+	X86_CPU_TYPE_ZEN2,
+	X86_CPU_TYPE_ZEN3,
+	X86_CPU_TYPE_ZEN4,
+	X86_CPU_TYPE_ZEN5,
+	X86_CPU_TYPE_CX486,
+	X86_CPU_TYPE_CX486FP,
+	X86_CPU_TYPE_CX486SLCE,
+	X86_CPU_TYPE_CX486S,
+	X86_CPU_TYPE_CX5X86,
+	X86_CPU_TYPE_MEDIAGX,
+	X86_CPU_TYPE_GXM,
+	X86_CPU_TYPE_GX1,
+	X86_CPU_TYPE_GX2,
+	X86_CPU_TYPE_LX,
+	X86_CPU_TYPE_NX,
+	X86_CPU_TYPE_CX6X86,
+	X86_CPU_TYPE_CX6X86L,
+	X86_CPU_TYPE_M2,
+	X86_CPU_TYPE_CYRIX3,
+	X86_CPU_TYPE_WC6,
+	X86_CPU_TYPE_WC2,
+	X86_CPU_TYPE_WC3,
+	X86_CPU_TYPE_SAMUEL,
+	X86_CPU_TYPE_C3,
+	X86_CPU_TYPE_NEHEMIAH,
+	X86_CPU_TYPE_C5,
+	X86_CPU_TYPE_C7,
+	X86_CPU_TYPE_NANO,
+	X86_CPU_TYPE_NANO3000,
+	X86_CPU_TYPE_NANOX2,
+	X86_CPU_TYPE_NANOC4000,
+	X86_CPU_TYPE_CNS,
+	X86_CPU_TYPE_ZXCPLUS,
+	X86_CPU_TYPE_ZXD,
+	X86_CPU_TYPE_ZXE,
+	X86_CPU_TYPE_KH40000,
+	X86_CPU_TYPE_ZXF,
+	X86_CPU_TYPE_V20,
+	X86_CPU_TYPE_V30,
+	X86_CPU_TYPE_V40,
+	X86_CPU_TYPE_V50,
+	X86_CPU_TYPE_UPD9002,
+	X86_CPU_TYPE_V33,
+	X86_CPU_TYPE_V25,
+	X86_CPU_TYPE_V25S,
+	X86_CPU_TYPE_V55,
+	X86_CPU_TYPE_V60,
+	X86_CPU_TYPE_EXTENDED,
+} x86_cpu_version_t;
+x86_cpu_traits_t x86_cpu_traits[] =
+{
+	[X86_CPU_TYPE_8086] =
+		{
+			.description = "Intel 8086",
+			.cpu_type = X86_CPU_8086,
+			.default_fpu = X87_FPU_8087,
+			.supported_fpu_types = (1 << X87_FPU_8087),
+			.prefetch_queue_size = 6,
+		},
+
+	[X86_CPU_TYPE_8088] =
+		{
+			.description = "Intel 8088",
+			.cpu_type = X86_CPU_8086,
+			.default_fpu = X87_FPU_8087,
+			.supported_fpu_types = (1 << X87_FPU_8087),
+			.prefetch_queue_size = 4,
+		},
+
+	[X86_CPU_TYPE_80186] =
+		{
+			.description = "Intel 80186",
+			.cpu_type = X86_CPU_186,
+			.default_fpu = X87_FPU_387,
+			.supported_fpu_types = (1 << X87_FPU_387),
+			.prefetch_queue_size = 6,
+		},
+
+	[X86_CPU_TYPE_80188] =
+		{
+			.description = "Intel 80188",
+			.cpu_type = X86_CPU_186,
+			.default_fpu = X87_FPU_387,
+			.supported_fpu_types = (1 << X87_FPU_387),
+			.prefetch_queue_size = 4,
+		},
+
+	[X86_CPU_TYPE_80286] =
+		{
+			.description = "Intel 80286",
+			.cpu_type = X86_CPU_286,
+			.default_fpu = X87_FPU_287,
+			.supported_fpu_types = (1 << X87_FPU_287),
+			.prefetch_queue_size = 6,
+		},
+
+	[X86_CPU_TYPE_80386] =
+		{
+			.description = "Intel 80386",
+			.cpu_type = X86_CPU_386,
+			.default_fpu = X87_FPU_387,
+			.supported_fpu_types = (1 << X87_FPU_387) | (1 << X87_FPU_287),
+			.prefetch_queue_size = 12,
+			.cpuid1 =
+			{
+				.eax = 0x00000300,
+			},
+		},
+
+	[X86_CPU_TYPE_80386SX] =
+		{
+			.description = "Intel 80386SX",
+			.cpu_type = X86_CPU_386,
+			.default_fpu = X87_FPU_387,
+			.supported_fpu_types = (1 << X87_FPU_387) | (1 << X87_FPU_287),
+			.prefetch_queue_size = 16,
+			.cpuid1 =
+			{
+				.eax = 0x00000300,
+			},
+		},
+
+	[X86_CPU_TYPE_80386B0] =
+		{
+			.description = "Intel 80386 stepping B0",
+			.cpu_type = X86_CPU_386,
+			.cpu_subtype = X86_CPU_386_386B0,
+			.default_fpu = X87_FPU_387,
+			.supported_fpu_types = (1 << X87_FPU_387) | (1 << X87_FPU_287),
+			.prefetch_queue_size = 12,
+			.cpuid1 =
+			{
+				.eax = 0x00000300,
+			},
+		},
+
+	[X86_CPU_TYPE_80386SL] =
+		{
+			.description = "Intel 80386SL",
+			.cpu_type = X86_CPU_386,
+			.default_fpu = X87_FPU_387,
+			.supported_fpu_types = (1 << X87_FPU_387) | (1 << X87_FPU_287),
+			.prefetch_queue_size = 16,
+			.smm_format = X86_SMM_80386SL,
+			.cpuid1 =
+			{
+				.eax = 0x00000300,
+			},
+		},
+
+	[X86_CPU_TYPE_80376] =
+		{
+			.description = "Intel 80376",
+			.cpu_type = X86_CPU_386,
+			.cpu_subtype = X86_CPU_386_376,
+			.default_fpu = X87_FPU_387,
+			.supported_fpu_types = (1 << X87_FPU_387) | (1 << X87_FPU_287),
+			.prefetch_queue_size = 16,
+			.cpuid1 =
+			{
+				.eax = 0x00000300,
+			},
+		},
+
+	[X86_CPU_TYPE_80486] =
+		{
+			.description = "Intel 80486",
+			.cpu_type = X86_CPU_486,
+			.prefetch_queue_size = 16,
+			.cpuid1 =
+			{
+				.eax = 0x00000480,
+				.edx = X86_CPUID1_EDX_FPU,
+			},
+		},
+
+	[X86_CPU_TYPE_80486A] =
+		{
+			.description = "Intel 80486 stepping A",
+			.cpu_type = X86_CPU_486,
+			.cpu_subtype = X86_CPU_486_486A,
+			.prefetch_queue_size = 16,
+			.cpuid1 =
+			{
+				.eax = 0x00000400,
+				.edx = X86_CPUID1_EDX_FPU,
+			},
+		},
+
+	[X86_CPU_TYPE_80486SX] =
+		{
+			.description = "Intel 80486SX (no x87 unit)",
+			.cpu_type = X86_CPU_486,
+			.prefetch_queue_size = 16,
+			.cpuid1 =
+			{
+				.eax = 0x00000400,
+			},
+		},
+
+	[X86_CPU_TYPE_80486SL] =
+		{
+			.description = "Intel 80486SL",
+			.cpu_type = X86_CPU_486,
+			.prefetch_queue_size = 16,
+			.smm_format = X86_SMM_80386SL,
+			.cpuid1 =
+			{
+				.eax = 0x00000400,
+				.edx = X86_CPUID1_EDX_FPU,
+			},
+		},
+
+	[X86_CPU_TYPE_P5] =
+		{
+			.description = "Intel Pentium (P5)",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_P5,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000570,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8,
+			},
+			.cpuid = true,
+		},
+
+	[X86_CPU_TYPE_P6] =
+		{
+			.description = "Intel Pentium Pro (P6)",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_P6,
+			.cpuid0 =
+			{
+				.eax = 0x00000002,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000610,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_CMOV,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+		},
+
+	[X86_CPU_TYPE_P5MMX] =
+		{
+			.description = "Intel Pentium MMX",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_P5,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000580,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_MMX,
+			},
+			.cpuid = true,
+			.rdpmc = true,
+		},
+
+	[X86_CPU_TYPE_P6_2] =
+		{
+			.description = "Intel Pentium II (P6-2)",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_P6,
+			.cpuid0 =
+			{
+				.eax = 0x00000002,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000660,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+		},
+
+	[X86_CPU_TYPE_P6_3] =
+		{
+			.description = "Intel Pentium III (P6-3)",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_P6,
+			.cpuid0 =
+			{
+				.eax = 0x00000003,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000006A0,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_IA64] =
+		{
+			.description = "Intel Itanium, IA-32 emulation",
+			.cpu_type = X86_CPU_INTEL,
+			.cpuid0 =
+			{
+				.eax = 0x00000001, // TODO
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000700,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_NX | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_IA64,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_ITANIUM2] =
+		{
+			.description = "Intel Itanium 2, IA-32 emulation",
+			.cpu_type = X86_CPU_INTEL,
+			.cpuid0 =
+			{
+				.eax = 0x00000001, // TODO
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00200F00,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_NX | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_IA64,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_P4] =
+		{
+			.description = "Intel Pentium 4 (P4)",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_P4,
+			.cpuid0 =
+			{
+				.eax = 0x00000002,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000F20,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000004,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_PRESCOTT] =
+		{
+			.description = "Intel Pentium 4 \"Prescott\"",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_AMD64,
+			.cpuid0 =
+			{
+				.eax = 0x00000002,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000F40,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000004,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_MEROM] =
+		{
+			.description = "Intel Core 2 \"Merom\"",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000A,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000006F0,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_PENRYN] =
+		{
+			.description = "Intel Core 2 \"Penryn\"",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000A,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00040670,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_XSAVE,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_NEHALEM] =
+		{
+			.description = "Intel \"Nehalem\"",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000B,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000406A0,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_POPCNT | X86_CPUID1_ECX_XSAVE,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_WESTMERE] =
+		{
+			.description = "Intel \"Westmere\"",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000B,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000406A0,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_POPCNT | X86_CPUID1_ECX_XSAVE,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_SANDYBRIDGE] =
+		{
+			.description = "Intel \"Sandy Bridge\"",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000D,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000806A0,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_POPCNT | X86_CPUID1_ECX_XSAVE | X86_CPUID1_ECX_AVX,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_IVYBRIDGE] =
+		{
+			.description = "Intel \"Ivy Bridge\"",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000D,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000C06A0,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_POPCNT | X86_CPUID1_ECX_XSAVE | X86_CPUID1_ECX_AVX | X86_CPUID1_ECX_RDRAND,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_HASWELL] =
+		{
+			.description = "Intel \"Haswell\"",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000D,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000C06C0,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_POPCNT | X86_CPUID1_ECX_XSAVE | X86_CPUID1_ECX_AVX | X86_CPUID1_ECX_RDRAND,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_BMI1,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_BROADWELL] =
+		{
+			.description = "Intel \"Broadwell\"",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000D,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000C06D0,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_POPCNT | X86_CPUID1_ECX_XSAVE | X86_CPUID1_ECX_AVX | X86_CPUID1_ECX_RDRAND,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_BMI1 | X86_CPUID7_0_EBX_RDSEED | X86_CPUID7_0_EBX_SMAP,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64 | X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_SKYLAKE] =
+		{
+			.description = "Intel \"Skylake\"",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x00000016,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x001006E0,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_POPCNT | X86_CPUID1_ECX_XSAVE | X86_CPUID1_ECX_AVX | X86_CPUID1_ECX_RDRAND,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_BMI1 | X86_CPUID7_0_EBX_AVX512_F | X86_CPUID7_0_EBX_RDSEED | X86_CPUID7_0_EBX_SMAP,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64 | X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_BONNELL] =
+		{
+			.description = "Intel Atom \"Bonnell\"",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000A,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000600,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_SILVERMONT] =
+		{
+			.description = "Intel Atom \"silvermont\"",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000B,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000C0670,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_POPCNT | X86_CPUID1_ECX_RDRAND,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_GOLDMONT] =
+		{
+			.description = "Intel Atom \"Goldmont\"",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x00000015,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x001406C0,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_POPCNT | X86_CPUID1_ECX_XSAVE | X86_CPUID1_ECX_RDRAND,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_RDSEED,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_GRACEMONT] =
+		{
+			.description = "Intel Atom \"Gracemont\"",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000A,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000600,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_POPCNT | X86_CPUID1_ECX_XSAVE | X86_CPUID1_ECX_AVX | X86_CPUID1_ECX_RDRAND,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_RDSEED,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_KNF] =
+		{
+			.description = "Intel \"Knights Ferry\"",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x00000001, // TODO
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000600,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8,
+			},
+			.cpuid = true,
+			.l10m = true,
+		},
+
+	[X86_CPU_TYPE_KNC] =
+		{
+			.description = "Intel Xeon Phi x100 \"Knights Corner\"",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x00000001, // TODO
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000B00,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8,
+			},
+			.cpuid = true,
+			.mvex = true,
+		},
+
+	[X86_CPU_TYPE_KNL] =
+		{
+			.description = "Intel Xeon Phi x200 \"Knights Landing\"",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000D,
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00140670,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_AVX512_F,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+		},
+
+	[X86_CPU_TYPE_X86S] =
+		{
+			.description = "hypothetical x86s Intel CPU",
+			.cpu_type = X86_CPU_INTEL,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x00000001, // TODO
+				X86_CPUID_VENDOR_INTEL,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00400F00,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_POPCNT | X86_CPUID1_ECX_XSAVE | X86_CPUID1_ECX_AVX | X86_CPUID1_ECX_RDRAND,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_BMI1 | X86_CPUID7_0_EBX_AVX512_F | X86_CPUID7_0_EBX_RDSEED | X86_CPUID7_0_EBX_SMAP,
+			},
+			.cpuid7_1 =
+			{
+				.ecx = X86_CPUID7_1_ECX_X86S,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64 | X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_AM386] =
+		{
+			.description = "AMD Am386",
+			.cpu_type = X86_CPU_386,
+			.default_fpu = X87_FPU_387,
+			.supported_fpu_types = (1 << X87_FPU_387) | (1 << X87_FPU_287),
+			.cpuid1 =
+			{
+				.eax = 0x00000300,
+			},
+		},
+
+	[X86_CPU_TYPE_AM486] =
+		{
+			.description = "AMD Am486",
+			.cpu_type = X86_CPU_486,
+			.cpuid1 =
+			{
+				.eax = 0x00000400,
+				.edx = X86_CPUID1_EDX_FPU,
+			},
+		},
+
+	[X86_CPU_TYPE_AM5X86] =
+		{
+			.description = "AMD Am5x86",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_P5,
+			.cpuid0 =
+			{
+				.eax = 0x00000001, // TODO
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000400,
+				.edx = X86_CPUID1_EDX_FPU,
+			},
+			.cpuid = true,
+		},
+
+	[X86_CPU_TYPE_NX586] =
+		{
+			.description = "NexGen Nx586",
+			.cpu_type = X86_CPU_AMD,
+			.cpuid0 =
+			{
+				.eax = 0x00000001, // TODO
+				X86_CPUID_VENDOR_NEXGEN,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000500,
+			},
+			.cpuid = true,
+		},
+
+	[X86_CPU_TYPE_NX586FP] =
+		{
+			.description = "NexGen Nx586 with FPU",
+			.cpu_type = X86_CPU_AMD,
+			.cpuid0 =
+			{
+				.eax = 0x00000001, // TODO
+				X86_CPUID_VENDOR_NEXGEN,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000500,
+				.edx = X86_CPUID1_EDX_FPU,
+			},
+			.cpuid = true,
+		},
+
+	[X86_CPU_TYPE_NX686] =
+		{
+			.description = "NexGen Nx686",
+			.cpu_type = X86_CPU_AMD,
+			.cpuid0 =
+			{
+				.eax = 0x00000001, // TODO
+				X86_CPUID_VENDOR_NEXGEN,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000500,
+				.edx = X86_CPUID1_EDX_FPU,
+			},
+			.cpuid = true,
+		},
+
+	[X86_CPU_TYPE_K5] =
+		{
+			.description = "AMD K5",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_K5,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000530,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000005,
+			},
+			.cpuid = true,
+		},
+
+	[X86_CPU_TYPE_K6] =
+		{
+			.description = "AMD K6",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_K6,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000570,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_MMX,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL_K6,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000005,
+			},
+			.cpuid = true,
+		},
+
+	[X86_CPU_TYPE_K6_2] =
+		{
+			.description = "AMD K6-2",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_K6,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000580,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_MMX,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL_K6 | X86_CPUID_EXT1_EDX_3DNOW,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000005,
+			},
+			.cpuid = true,
+		},
+
+	[X86_CPU_TYPE_K6_3] =
+		{
+			.description = "AMD K6-III",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_K6,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000590,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_MMX,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL_K6 | X86_CPUID_EXT1_EDX_3DNOW,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000006,
+			},
+			.cpuid = true,
+		},
+
+	[X86_CPU_TYPE_K6_2PLUS] =
+		{
+			.description = "AMD K6-2+",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_K6,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000005D0,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_MMX,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL_K6 | X86_CPUID_EXT1_EDX_3DNOWEXT | X86_CPUID_EXT1_EDX_3DNOW,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000007,
+			},
+			.cpuid = true,
+		},
+
+	[X86_CPU_TYPE_K6_3PLUS] =
+		{
+			.description = "AMD K6-III+",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_K6,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000005D0,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_MMX,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL_K6 | X86_CPUID_EXT1_EDX_3DNOWEXT | X86_CPUID_EXT1_EDX_3DNOW,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000007,
+			},
+			.cpuid = true,
+		},
+
+	[X86_CPU_TYPE_K7] =
+		{
+			.description = "AMD Athlon (K7)",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_K6,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000640,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_3DNOWEXT | X86_CPUID_EXT1_EDX_3DNOW,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000006,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+		},
+
+	[X86_CPU_TYPE_ATHLONXP] =
+		{
+			.description = "AMD Athlon XP",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_K6,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000006A0,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_3DNOWEXT | X86_CPUID_EXT1_EDX_3DNOW,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_K8] =
+		{
+			.description = "AMD Athlon 64 (K8)",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_AMD64,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x001C0FF0,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_CR8D | X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM | X86_CPUID_EXT1_EDX_3DNOWEXT | X86_CPUID_EXT1_EDX_3DNOW,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000018,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_K10] =
+		{
+			.description = "AMD K10",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_AMD64,
+			.cpuid0 =
+			{
+				.eax = 0x00000006,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00100FA0,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64 | X86_CPUID_EXT1_ECX_CR8D | X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM | X86_CPUID_EXT1_EDX_3DNOWEXT | X86_CPUID_EXT1_EDX_3DNOW,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x8000001B,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_BOBCAT] =
+		{
+			.description = "AMD \"Bobcat\"",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_AMD64,
+			.cpuid0 =
+			{
+				.eax = 0x00000006,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00500F20,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64 | X86_CPUID_EXT1_ECX_CR8D | X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x8000001B,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_JAGUAR] =
+		{
+			.description = "AMD \"Jaguar\"",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_AMD64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000D,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00700F00,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_MOVBE | X86_CPUID1_ECX_XSAVE | X86_CPUID1_ECX_AVX,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_BMI1,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64 | X86_CPUID_EXT1_ECX_CR8D | X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x8000001E,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_PUMA] =
+		{
+			.description = "AMD \"Puma\"",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_AMD64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000D,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x007C0F00,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_MOVBE | X86_CPUID1_ECX_XSAVE | X86_CPUID1_ECX_AVX,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_BMI1,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64 | X86_CPUID_EXT1_ECX_CR8D | X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x8000001E,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_DREX] =
+		{
+			.description = "hypothetical AMD CPU with DREX support",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_AMD64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000D,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00600F00,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_AVX,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64 | X86_CPUID_EXT1_ECX_CR8D | X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x8000001E,
+			},
+			.cpuid = true,
+			.drex = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_BULLDOZER] =
+		{
+			.description = "AMD \"Bulldozer\"",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_AMD64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000D,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00600F20,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_XSAVE | X86_CPUID1_ECX_AVX,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64 | X86_CPUID_EXT1_ECX_CR8D | X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x8000001E,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_PILEDRIVER] =
+		{
+			.description = "AMD \"Piledriver\"",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_AMD64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000D,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00640F30,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_XSAVE | X86_CPUID1_ECX_AVX,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_BMI1,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64 | X86_CPUID_EXT1_ECX_CR8D | X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x8000001E,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_EXCAVATOR] =
+		{
+			.description = "AMD \"Excavator\"",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_AMD64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000D,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x007C0F00,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_MOVBE | X86_CPUID1_ECX_XSAVE | X86_CPUID1_ECX_AVX | X86_CPUID1_ECX_RDRAND,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_BMI1,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64 | X86_CPUID_EXT1_ECX_CR8D | X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x8000001E,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_ZEN] =
+		{
+			.description = "AMD Zen",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_AMD64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000D,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00880F00,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_MOVBE | X86_CPUID1_ECX_XSAVE | X86_CPUID1_ECX_AVX | X86_CPUID1_ECX_RDRAND,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_BMI1 | X86_CPUID7_0_EBX_RDSEED | X86_CPUID7_0_EBX_SMAP,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64 | X86_CPUID_EXT1_ECX_CR8D | X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x8000001F,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_ZEN2] =
+		{
+			.description = "AMD Zen 2",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_AMD64,
+			.cpuid0 =
+			{
+				.eax = 0x00000010,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00A80F00,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_MOVBE | X86_CPUID1_ECX_XSAVE | X86_CPUID1_ECX_AVX | X86_CPUID1_ECX_RDRAND,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_BMI1 | X86_CPUID7_0_EBX_RDSEED | X86_CPUID7_0_EBX_SMAP,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64 | X86_CPUID_EXT1_ECX_CR8D | X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000020,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_ZEN3] =
+		{
+			.description = "AMD Zen 3",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_AMD64,
+			.cpuid0 =
+			{
+				.eax = 0x00000010,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00B40F00,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_MOVBE | X86_CPUID1_ECX_XSAVE | X86_CPUID1_ECX_AVX | X86_CPUID1_ECX_RDRAND,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_BMI1 | X86_CPUID7_0_EBX_RDSEED | X86_CPUID7_0_EBX_SMAP,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64 | X86_CPUID_EXT1_ECX_CR8D | X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000023,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_ZEN4] =
+		{
+			.description = "AMD Zen 4",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_AMD64,
+			.cpuid0 =
+			{
+				.eax = 0x00000010,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00A00F00,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_MOVBE | X86_CPUID1_ECX_XSAVE | X86_CPUID1_ECX_AVX | X86_CPUID1_ECX_RDRAND,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_BMI1 | X86_CPUID7_0_EBX_AVX512_F | X86_CPUID7_0_EBX_RDSEED | X86_CPUID7_0_EBX_SMAP,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64 | X86_CPUID_EXT1_ECX_CR8D | X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000028,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_ZEN5] =
+		{
+			.description = "AMD Zen 5",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_AMD64,
+			.cpuid0 =
+			{
+				.eax = 0x00000010,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00B00F40,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_MOVBE | X86_CPUID1_ECX_XSAVE | X86_CPUID1_ECX_AVX | X86_CPUID1_ECX_RDRAND,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_BMI1 | X86_CPUID7_0_EBX_AVX512_F | X86_CPUID7_0_EBX_RDSEED | X86_CPUID7_0_EBX_SMAP,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64 | X86_CPUID_EXT1_ECX_CR8D | X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000028,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_CX486] =
+		{
+			.description = "Cyrix Cx486SLC",
+			.cpu_type = X86_CPU_CYRIX,
+			.cpu_subtype = X86_CPU_CYRIX_CX486SLC,
+		},
+
+	[X86_CPU_TYPE_CX486FP] =
+		{
+			.description = "Cyrix Cx486SLC with FPU",
+			.cpu_type = X86_CPU_CYRIX,
+			.cpuid1 =
+			{
+				.edx = X86_CPUID1_EDX_FPU,
+			},
+		},
+
+	[X86_CPU_TYPE_CX486SLCE] =
+		{
+			.description = "Cyrix Cx486SLC/e",
+			.cpu_type = X86_CPU_CYRIX,
+			.cpu_subtype = X86_CPU_CYRIX_CX486SLCE,
+			.smm_format = X86_SMM_CX486SLCE,
+		},
+
+	[X86_CPU_TYPE_CX486S] =
+		{
+			.description = "Cyrix Cx486SLC/e",
+			.cpu_type = X86_CPU_CYRIX,
+			.cpu_subtype = X86_CPU_CYRIX_CX486SLCE,
+			.smm_format = X86_SMM_CX486SLCE,
+			.smint = true,
+		},
+
+	[X86_CPU_TYPE_CX5X86] =
+		{
+			.description = "Cyrix 5x86",
+			.cpu_type = X86_CPU_CYRIX,
+			.cpu_subtype = X86_CPU_CYRIX_5X86,
+			.smm_format = X86_SMM_M1,
+			.cpuid0 =
+			{
+				.eax = 0x00000001, // TODO
+				X86_CPUID_VENDOR_CYRIX,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000400,
+			},
+			.cpuid = true,
+			.smint = true,
+		},
+
+	[X86_CPU_TYPE_MEDIAGX] =
+		{
+			.description = "Cyrix MediaGX",
+			.cpu_type = X86_CPU_CYRIX,
+			.cpu_subtype = X86_CPU_CYRIX_MEDIAGX,
+			.smm_format = X86_SMM_MEDIAGX,
+			.cpuid0 =
+			{
+				.eax = 0x00000001, // TODO
+				X86_CPUID_VENDOR_CYRIX,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000400,
+			},
+			.cpuid = true,
+			.media_gx = true,
+			.smint = true,
+		},
+
+	[X86_CPU_TYPE_GXM] =
+		{
+			.description = "Cyrix MediaGXm, National Semiconductor Geode GXm",
+			.cpu_type = X86_CPU_CYRIX,
+			.cpu_subtype = X86_CPU_CYRIX_GXM,
+			.smm_format = X86_SMM_MEDIAGX,
+			.cpuid0 =
+			{
+				.eax = 0x00000002,
+				X86_CPUID_VENDOR_CYRIX,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000530,
+				.edx = X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_MMX,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_EMMI,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000005,
+			},
+			.cpuid = true,
+			.emmi = true,
+			.media_gx = true,
+			.smint = true,
+		},
+
+	[X86_CPU_TYPE_GX1] =
+		{
+			.description = "National Semiconductor Geode GX1",
+			.cpu_type = X86_CPU_CYRIX,
+			.cpu_subtype = X86_CPU_CYRIX_GX1,
+			.smm_format = X86_SMM_MEDIAGX,
+			.cpuid0 =
+			{
+				.eax = 0x00000002,
+				X86_CPUID_VENDOR_NSC,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000540,
+				.edx = X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_MMX,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_EMMI,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000005,
+			},
+			.cpuid = true,
+			.emmi = true,
+			.media_gx = true,
+			.smint = true,
+		},
+
+	[X86_CPU_TYPE_GX2] =
+		{
+			.description = "National Semiconductor Geode GX2, AMD Geode GX",
+			.cpu_type = X86_CPU_CYRIX,
+			.cpu_subtype = X86_CPU_CYRIX_GX2,
+			.smm_format = X86_SMM_GX2,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_NSC,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000550,
+				.edx = X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_SSE,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_3DNOWEXT | X86_CPUID_EXT1_EDX_3DNOW,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000006,
+			},
+			._3dnow_gx = true,
+			.cpuid = true,
+			.dmm = true,
+			.smint = true,
+			.sse_non_simd = true,
+		},
+
+	[X86_CPU_TYPE_LX] =
+		{
+			.description = "AMD Geode LX",
+			.cpu_type = X86_CPU_CYRIX,
+			.cpu_subtype = X86_CPU_CYRIX_LX,
+			.smm_format = X86_SMM_GX2,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000005A0,
+				.edx = X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_SSE,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_3DNOWEXT | X86_CPUID_EXT1_EDX_3DNOW,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000006,
+			},
+			._3dnow_gx = true,
+			.cpuid = true,
+			.dmm = true,
+			.rdpmc = true,
+			.smint = true,
+			.sse_non_simd = true,
+		},
+
+	[X86_CPU_TYPE_NX] =
+		{
+			.description = "AMD Geode NX",
+			.cpu_type = X86_CPU_AMD,
+			.smm_format = X86_SMM_K6,
+			.cpuid0 =
+			{
+				.eax = 0x00000001, // TODO
+				X86_CPUID_VENDOR_AMD,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000600,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_3DNOWEXT | X86_CPUID_EXT1_EDX_3DNOW,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_CX6X86] =
+		{
+			.description = "Cyrix 6x86",
+			.cpu_type = X86_CPU_CYRIX,
+			.cpu_subtype = X86_CPU_CYRIX_6X86,
+			.smm_format = X86_SMM_M1,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_CYRIX,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000520,
+			},
+			.cpuid = true,
+			.smint = true,
+		},
+
+	[X86_CPU_TYPE_CX6X86L] =
+		{
+			.description = "Cyrix 6x86L",
+			.cpu_type = X86_CPU_CYRIX,
+			.cpu_subtype = X86_CPU_CYRIX_6X86,
+			.smm_format = X86_SMM_M1,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_CYRIX,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000520,
+				.edx = X86_CPUID1_EDX_CX8,
+			},
+			.cpuid = true,
+			.rdshr = true,
+			.smint = true,
+		},
+
+	[X86_CPU_TYPE_M2] =
+		{
+			.description = "Cyrix 6x86MX, Cyrix MII",
+			.cpu_type = X86_CPU_CYRIX,
+			.cpu_subtype = X86_CPU_CYRIX_M2,
+			.smm_format = X86_SMM_M2,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_CYRIX,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000600,
+				.edx = X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_MMX,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_EMMI,
+			},
+			.cpuid = true,
+			.emmi = true,
+			.rdpmc = true,
+			.rdshr = true,
+			.smint = true,
+		},
+
+	[X86_CPU_TYPE_CYRIX3] =
+		{
+			.description = "VIA Cyrix III \"Joshua\"",
+			.cpu_type = X86_CPU_CYRIX,
+			.cpu_subtype = X86_CPU_CYRIX_III,
+			.smm_format = X86_SMM_M2,
+			.cpuid0 =
+			{
+				.eax = 0x00000001, // TODO
+				X86_CPUID_VENDOR_CYRIX,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000600,
+				.edx = X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_MMX,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_3DNOW,
+			},
+			.cpuid = true,
+			.rdpmc = true,
+			.rdshr = true,
+			.smint = true,
+		},
+
+	[X86_CPU_TYPE_WC6] =
+		{
+			.description = "Centaur/IDT WinChip C6",
+			.cpu_type = X86_CPU_WINCHIP,
+			.smm_format = X86_SMM_P5,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_CENTAUR,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000540,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_MMX,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000000,
+			},
+			.cpuid = true,
+			.rdpmc = true,
+		},
+
+	[X86_CPU_TYPE_WC2] =
+		{
+			.description = "Centaur/IDT WinChip 2",
+			.cpu_type = X86_CPU_WINCHIP,
+			.smm_format = X86_SMM_P5,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_CENTAUR,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000580,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_MMX,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_3DNOW,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000005,
+			},
+			.cpuid = true,
+			.rdpmc = true,
+		},
+
+	[X86_CPU_TYPE_WC3] =
+		{
+			.description = "Centaur/IDT WinChip 3",
+			.cpu_type = X86_CPU_WINCHIP,
+			.smm_format = X86_SMM_P5,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_CENTAUR,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000580,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_MMX,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_3DNOW,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000005,
+			},
+			.cpuid = true,
+			.rdpmc = true,
+		},
+
+	[X86_CPU_TYPE_SAMUEL] =
+		{
+			.description = "VIA Cyrix III \"Samuel\"",
+			.cpu_type = X86_CPU_VIA,
+			.smm_format = X86_SMM_P5,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_CENTAUR,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000660,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_MMX,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_3DNOW,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000005,
+			},
+			.cpuid = true,
+			.rdpmc = true,
+		},
+
+	[X86_CPU_TYPE_C3] =
+		{
+			.description = "VIA C3",
+			.cpu_type = X86_CPU_VIA,
+			.smm_format = X86_SMM_P5,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_CENTAUR,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000680,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_MMX,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_3DNOW,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000006,
+			},
+			.altinst = true,
+			.cpuid = true,
+			.rdpmc = true,
+		},
+
+	[X86_CPU_TYPE_NEHEMIAH] =
+		{
+			.description = "VIA C3 \"Nehemiah\"",
+			.cpu_type = X86_CPU_VIA,
+			.smm_format = X86_SMM_P5,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_CENTAUR,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000690,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000006,
+			},
+			.cpuid = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_C5] =
+		{
+			.description = "VIA C5 (C5P) \"Nehemiah+\"",
+			.cpu_type = X86_CPU_VIA,
+			.smm_format = X86_SMM_P5,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_CENTAUR,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000695,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000006,
+			},
+			.cpuid = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_C7] =
+		{
+			.description = "VIA C7",
+			.cpu_type = X86_CPU_VIA,
+			.smm_format = X86_SMM_P5,
+			.cpuid0 =
+			{
+				.eax = 0x00000001,
+				X86_CPUID_VENDOR_CENTAUR,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000006D0,
+				.ecx = X86_CPUID1_ECX_SSE3,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_NX,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000006,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_NANO] =
+		{
+			.description = "VIA Nano",
+			.cpu_type = X86_CPU_VIA,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000D,
+				X86_CPUID_VENDOR_CENTAUR,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000006F0,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_NANO3000] =
+		{
+			.description = "VIA Nano \"3000\"",
+			.cpu_type = X86_CPU_VIA,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000D,
+				X86_CPUID_VENDOR_CENTAUR,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000006F0,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_NANOX2] =
+		{
+			.description = "VIA Nano \"X2\"",
+			.cpu_type = X86_CPU_VIA,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000D,
+				X86_CPUID_VENDOR_CENTAUR,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000006F0,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_NANOC4000] =
+		{
+			.description = "VIA Nano \"QuadCore C4000\"",
+			.cpu_type = X86_CPU_VIA,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000D,
+				X86_CPUID_VENDOR_CENTAUR,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000006F0,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_AVX,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_CNS] =
+		{
+			.description = "Centaur Technology CNS",
+			.cpu_type = X86_CPU_VIA,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000D,
+				X86_CPUID_VENDOR_CENTAUR,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00100670,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_AVX,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_AVX512_F,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_ZXCPLUS] =
+		{
+			.description = "Zhaoxin ZX-C+",
+			.cpu_type = X86_CPU_VIA,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000D,
+				X86_CPUID_VENDOR_CENTAUR,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000006F0,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_AVX,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_ZXD] =
+		{
+			.description = "Zhaoxin ZX-D/KX-5000/KH-20000 \"Wudaoku\"",
+			.cpu_type = X86_CPU_VIA,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000D,
+				X86_CPUID_VENDOR_CENTAUR,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000007F0,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_AVX,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_ZXE] =
+		{
+			.description = "Zhaoxin ZX-E/KX-6000/KH-30000 \"Lujiazui\"",
+			.cpu_type = X86_CPU_VIA,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000000D,
+				X86_CPUID_VENDOR_CENTAUR,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000007B0,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_AVX | X86_CPUID1_ECX_RDRAND,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_RDSEED,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_KH40000] =
+		{
+			.description = "Zhaoxin KH-40000 \"Yongfeng\"",
+			.cpu_type = X86_CPU_VIA,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000001F,
+				X86_CPUID_VENDOR_CENTAUR,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000007B0,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_AVX | X86_CPUID1_ECX_RDRAND,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_RDSEED,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_ZXF] =
+		{
+			.description = "Zhaoxin ZX-F \"Shijidadao\"",
+			.cpu_type = X86_CPU_VIA,
+			.smm_format = X86_SMM_INTEL64,
+			.cpuid0 =
+			{
+				.eax = 0x0000001F,
+				X86_CPUID_VENDOR_CENTAUR,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x000007B0,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_AVX | X86_CPUID1_ECX_RDRAND,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_RDSEED,
+			},
+			.cpuid_ext1 =
+			{
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_TSCP | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid_ext0 =
+			{
+				.eax = 0x80000008,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+	[X86_CPU_TYPE_V20] =
+		{
+			.description = "NEC V20",
+			.cpu_type = X86_CPU_V20,
+			.default_fpu = X87_FPU_8087,
+			.supported_fpu_types = (1 << X87_FPU_8087) | (1 << X87_FPU_8087) | (1 << X87_FPU_387),
+			.prefetch_queue_size = 4,
+		},
+
+	[X86_CPU_TYPE_V30] =
+		{
+			.description = "NEC V30",
+			.cpu_type = X86_CPU_V20,
+			.default_fpu = X87_FPU_8087,
+			.supported_fpu_types = (1 << X87_FPU_8087) | (1 << X87_FPU_8087) | (1 << X87_FPU_387),
+			.prefetch_queue_size = 8,
+		},
+
+	[X86_CPU_TYPE_V40] =
+		{
+			.description = "NEC V40",
+			.cpu_type = X86_CPU_V20,
+			.default_fpu = X87_FPU_8087,
+			.supported_fpu_types = (1 << X87_FPU_8087) | (1 << X87_FPU_8087) | (1 << X87_FPU_387),
+			.prefetch_queue_size = 4,
+		},
+
+	[X86_CPU_TYPE_V50] =
+		{
+			.description = "NEC V50",
+			.cpu_type = X86_CPU_V20,
+			.default_fpu = X87_FPU_8087,
+			.supported_fpu_types = (1 << X87_FPU_8087) | (1 << X87_FPU_8087) | (1 << X87_FPU_387),
+			.prefetch_queue_size = 6,
+		},
+
+	[X86_CPU_TYPE_UPD9002] =
+		{
+			.description = "NEC µPD9002",
+			.cpu_type = X86_CPU_UPD9002,
+			.prefetch_queue_size = 6,
+		},
+
+	[X86_CPU_TYPE_V33] =
+		{
+			.description = "NEC V33/V53",
+			.cpu_type = X86_CPU_V33,
+			.prefetch_queue_size = 8,
+		},
+
+	[X86_CPU_TYPE_V25] =
+		{
+			.description = "NEC V25",
+			.cpu_type = X86_CPU_V25,
+			.prefetch_queue_size = 6,
+		},
+
+	[X86_CPU_TYPE_V25S] =
+		{
+			.description = "NEC V25 Software Guard",
+			.cpu_type = X86_CPU_V25,
+			.cpu_subtype = X86_CPU_V25_V25S,
+			.prefetch_queue_size = 6,
+		},
+
+	[X86_CPU_TYPE_V55] =
+		{
+			.description = "NEC V55PI/V55SC",
+			.cpu_type = X86_CPU_V55,
+			.prefetch_queue_size = 6,
+		},
+
+	[X86_CPU_TYPE_V60] =
+		{
+			.description = "NEC V60, V30 emulation",
+			.cpu_type = X86_CPU_V60,
+		},
+
+	[X86_CPU_TYPE_EXTENDED] =
+		{
+			.description = "Extended",
+			.cpu_type = X86_CPU_EXTENDED,
+			.smm_format = X86_SMM_AMD64,
+			.cpuid0 =
+			{
+				.eax = 0x00000001, // TODO
+				X86_CPUID_VENDOR_CUSTOM,
+			},
+			.cpuid1 =
+			{
+				.eax = 0x00000F00,
+				.ecx = X86_CPUID1_ECX_SSE3 | X86_CPUID1_ECX_CX16 | X86_CPUID1_ECX_POPCNT | X86_CPUID1_ECX_XSAVE | X86_CPUID1_ECX_AVX | X86_CPUID1_ECX_RDRAND,
+				.edx = X86_CPUID1_EDX_FPU | X86_CPUID1_EDX_VME | X86_CPUID1_EDX_TSC | X86_CPUID1_EDX_MSR | X86_CPUID1_EDX_PAE | X86_CPUID1_EDX_CX8 | X86_CPUID1_EDX_SEP | X86_CPUID1_EDX_CMOV | X86_CPUID1_EDX_CLFL | X86_CPUID1_EDX_MMX | X86_CPUID1_EDX_FXSR | X86_CPUID1_EDX_SSE | X86_CPUID1_EDX_SSE2,
+			},
+			.cpuid7_0 =
+			{
+				.ebx = X86_CPUID7_0_EBX_BMI1 | X86_CPUID7_0_EBX_AVX512_F | X86_CPUID7_0_EBX_RDSEED | X86_CPUID7_0_EBX_SMAP,
+			},
+			.cpuid_ext1 =
+			{
+				.ecx = X86_CPUID_EXT1_ECX_AHF64 | X86_CPUID_EXT1_ECX_3DNOWP,
+				.edx = X86_CPUID_EXT1_EDX_SYSCALL | X86_CPUID_EXT1_EDX_NX | X86_CPUID_EXT1_EDX_LM,
+			},
+			.cpuid = true,
+			.multibyte_nop = true,
+			.rdpmc = true,
+			.sse_non_simd = true,
+			.sse_simd = true,
+		},
+
+};
+	static const struct
+{
+	const char * name;
+	x86_cpu_version_t type;
+} supported_cpu_table[] =
+{
+	{ "8086", X86_CPU_TYPE_8086 },
+	{ "i8086", X86_CPU_TYPE_8086 },
+	{ "86", X86_CPU_TYPE_8086 },
+	{ "i86", X86_CPU_TYPE_8086 },
+	{ "intel8086", X86_CPU_TYPE_8086 },
+	{ "intel86", X86_CPU_TYPE_8086 },
+	{ "iapx86", X86_CPU_TYPE_8086 },
+	{ "mcs86", X86_CPU_TYPE_8086 },
+	{ "mcs-86", X86_CPU_TYPE_8086 },
+	{ "8088", X86_CPU_TYPE_8088 },
+	{ "i8088", X86_CPU_TYPE_8088 },
+	{ "88", X86_CPU_TYPE_8088 },
+	{ "i88", X86_CPU_TYPE_8088 },
+	{ "intel8088", X86_CPU_TYPE_8088 },
+	{ "intel88", X86_CPU_TYPE_8088 },
+	{ "iapx88", X86_CPU_TYPE_8088 },
+	{ "80186", X86_CPU_TYPE_80186 },
+	{ "i80186", X86_CPU_TYPE_80186 },
+	{ "186", X86_CPU_TYPE_80186 },
+	{ "i186", X86_CPU_TYPE_80186 },
+	{ "intel80186", X86_CPU_TYPE_80186 },
+	{ "intel186", X86_CPU_TYPE_80186 },
+	{ "iapx186", X86_CPU_TYPE_80186 },
+	{ "80188", X86_CPU_TYPE_80188 },
+	{ "i80188", X86_CPU_TYPE_80188 },
+	{ "188", X86_CPU_TYPE_80188 },
+	{ "i188", X86_CPU_TYPE_80188 },
+	{ "intel80188", X86_CPU_TYPE_80188 },
+	{ "intel188", X86_CPU_TYPE_80188 },
+	{ "iapx188", X86_CPU_TYPE_80188 },
+	{ "80286", X86_CPU_TYPE_80286 },
+	{ "i80286", X86_CPU_TYPE_80286 },
+	{ "286", X86_CPU_TYPE_80286 },
+	{ "i286", X86_CPU_TYPE_80286 },
+	{ "intel80286", X86_CPU_TYPE_80286 },
+	{ "intel286", X86_CPU_TYPE_80286 },
+	{ "iapx286", X86_CPU_TYPE_80286 },
+	{ "80386", X86_CPU_TYPE_80386 },
+	{ "i80386", X86_CPU_TYPE_80386 },
+	{ "386", X86_CPU_TYPE_80386 },
+	{ "i386", X86_CPU_TYPE_80386 },
+	{ "intel80386", X86_CPU_TYPE_80386 },
+	{ "intel386", X86_CPU_TYPE_80386 },
+	{ "iapx386", X86_CPU_TYPE_80386 },
+	{ "80386dx", X86_CPU_TYPE_80386 },
+	{ "i80386dx", X86_CPU_TYPE_80386 },
+	{ "386dx", X86_CPU_TYPE_80386 },
+	{ "i386dx", X86_CPU_TYPE_80386 },
+	{ "intel80386dx", X86_CPU_TYPE_80386 },
+	{ "intel386dx", X86_CPU_TYPE_80386 },
+	{ "iapx386dx", X86_CPU_TYPE_80386 },
+	{ "80386sx", X86_CPU_TYPE_80386SX },
+	{ "i80386sx", X86_CPU_TYPE_80386SX },
+	{ "386sx", X86_CPU_TYPE_80386SX },
+	{ "i386sx", X86_CPU_TYPE_80386SX },
+	{ "intel80386sx", X86_CPU_TYPE_80386SX },
+	{ "intel386sx", X86_CPU_TYPE_80386SX },
+	{ "iapx386sx", X86_CPU_TYPE_80386SX },
+	{ "80386b0", X86_CPU_TYPE_80386B0 },
+	{ "i80386b0", X86_CPU_TYPE_80386B0 },
+	{ "386b0", X86_CPU_TYPE_80386B0 },
+	{ "i386b0", X86_CPU_TYPE_80386B0 },
+	{ "intel80386b0", X86_CPU_TYPE_80386B0 },
+	{ "intel386b0", X86_CPU_TYPE_80386B0 },
+	{ "iapx386b0", X86_CPU_TYPE_80386B0 },
+	{ "80386sl", X86_CPU_TYPE_80386SL },
+	{ "i80386sl", X86_CPU_TYPE_80386SL },
+	{ "386sl", X86_CPU_TYPE_80386SL },
+	{ "i386sl", X86_CPU_TYPE_80386SL },
+	{ "intel80386sl", X86_CPU_TYPE_80386SL },
+	{ "intel386sl", X86_CPU_TYPE_80386SL },
+	{ "iapx386sl", X86_CPU_TYPE_80386SL },
+	{ "80376", X86_CPU_TYPE_80376 },
+	{ "i80376", X86_CPU_TYPE_80376 },
+	{ "376", X86_CPU_TYPE_80376 },
+	{ "i376", X86_CPU_TYPE_80376 },
+	{ "intel80376", X86_CPU_TYPE_80376 },
+	{ "intel376", X86_CPU_TYPE_80376 },
+	{ "80486", X86_CPU_TYPE_80486 },
+	{ "i80486", X86_CPU_TYPE_80486 },
+	{ "486", X86_CPU_TYPE_80486 },
+	{ "i486", X86_CPU_TYPE_80486 },
+	{ "intel80486", X86_CPU_TYPE_80486 },
+	{ "intel486", X86_CPU_TYPE_80486 },
+	{ "80486a", X86_CPU_TYPE_80486A },
+	{ "i80486a", X86_CPU_TYPE_80486A },
+	{ "486a", X86_CPU_TYPE_80486A },
+	{ "i486a", X86_CPU_TYPE_80486A },
+	{ "intel80486a", X86_CPU_TYPE_80486A },
+	{ "intel486a", X86_CPU_TYPE_80486A },
+	{ "80486sx", X86_CPU_TYPE_80486SX },
+	{ "i80486sx", X86_CPU_TYPE_80486SX },
+	{ "486sx", X86_CPU_TYPE_80486SX },
+	{ "i486sx", X86_CPU_TYPE_80486SX },
+	{ "intel80486sx", X86_CPU_TYPE_80486SX },
+	{ "intel486sx", X86_CPU_TYPE_80486SX },
+	{ "80486sl", X86_CPU_TYPE_80486SL },
+	{ "i80486sl", X86_CPU_TYPE_80486SL },
+	{ "486sl", X86_CPU_TYPE_80486SL },
+	{ "i486sl", X86_CPU_TYPE_80486SL },
+	{ "intel80486sl", X86_CPU_TYPE_80486SL },
+	{ "intel486sl", X86_CPU_TYPE_80486SL },
+	{ "80586", X86_CPU_TYPE_P5 },
+	{ "i80586", X86_CPU_TYPE_P5 },
+	{ "586", X86_CPU_TYPE_P5 },
+	{ "i586", X86_CPU_TYPE_P5 },
+	{ "intel80586", X86_CPU_TYPE_P5 },
+	{ "intel586", X86_CPU_TYPE_P5 },
+	{ "pentium", X86_CPU_TYPE_P5 },
+	{ "p5", X86_CPU_TYPE_P5 },
+	{ "80686", X86_CPU_TYPE_P6 },
+	{ "i80686", X86_CPU_TYPE_P6 },
+	{ "686", X86_CPU_TYPE_P6 },
+	{ "i686", X86_CPU_TYPE_P6 },
+	{ "intel80686", X86_CPU_TYPE_P6 },
+	{ "intel686", X86_CPU_TYPE_P6 },
+	{ "pentiumpro", X86_CPU_TYPE_P6 },
+	{ "ppro", X86_CPU_TYPE_P6 },
+	{ "p6", X86_CPU_TYPE_P6 },
+	{ "80586mmx", X86_CPU_TYPE_P5MMX },
+	{ "i80586mmx", X86_CPU_TYPE_P5MMX },
+	{ "586mmx", X86_CPU_TYPE_P5MMX },
+	{ "i586mmx", X86_CPU_TYPE_P5MMX },
+	{ "intel80586mmx", X86_CPU_TYPE_P5MMX },
+	{ "intel586mmx", X86_CPU_TYPE_P5MMX },
+	{ "pentiummmx", X86_CPU_TYPE_P5MMX },
+	{ "pentium_mmx", X86_CPU_TYPE_P5MMX },
+	{ "pentium-mmx", X86_CPU_TYPE_P5MMX },
+	{ "p5mmx", X86_CPU_TYPE_P5MMX },
+	{ "mmx", X86_CPU_TYPE_P5MMX },
+	{ "pentiumii", X86_CPU_TYPE_P6_2 },
+	{ "pentium2", X86_CPU_TYPE_P6_2 },
+	{ "pentium-2", X86_CPU_TYPE_P6_2 },
+	{ "pentium_2", X86_CPU_TYPE_P6_2 },
+	{ "p6-2", X86_CPU_TYPE_P6_2 },
+	{ "p6_2", X86_CPU_TYPE_P6_2 },
+	{ "p2", X86_CPU_TYPE_P6_2 },
+	{ "pentiumiii", X86_CPU_TYPE_P6_3 },
+	{ "pentium3", X86_CPU_TYPE_P6_3 },
+	{ "pentium-3", X86_CPU_TYPE_P6_3 },
+	{ "pentium_3", X86_CPU_TYPE_P6_3 },
+	{ "p6-3", X86_CPU_TYPE_P6_3 },
+	{ "p6_3", X86_CPU_TYPE_P6_3 },
+	{ "p3", X86_CPU_TYPE_P6_3 },
+	{ "itanium", X86_CPU_TYPE_IA64 },
+	{ "ia64", X86_CPU_TYPE_IA64 },
+	{ "ia-64", X86_CPU_TYPE_IA64 },
+	{ "ia_64", X86_CPU_TYPE_IA64 },
+	{ "itanium2", X86_CPU_TYPE_ITANIUM2 },
+	{ "pentiumiv", X86_CPU_TYPE_P4 },
+	{ "pentium4", X86_CPU_TYPE_P4 },
+	{ "pentium-4", X86_CPU_TYPE_P4 },
+	{ "pentium_4", X86_CPU_TYPE_P4 },
+	{ "p4", X86_CPU_TYPE_P4 },
+	{ "p7", X86_CPU_TYPE_P4 },
+	{ "netburst", X86_CPU_TYPE_P4 },
+	{ "ia32", X86_CPU_TYPE_P4 },
+	{ "ia-32", X86_CPU_TYPE_P4 },
+	{ "ia_32", X86_CPU_TYPE_P4 },
+	{ "prescott", X86_CPU_TYPE_PRESCOTT },
+	{ "nocona", X86_CPU_TYPE_PRESCOTT },
+	{ "ia32e", X86_CPU_TYPE_PRESCOTT },
+	{ "ia-32e", X86_CPU_TYPE_PRESCOTT },
+	{ "ia_32e", X86_CPU_TYPE_PRESCOTT },
+	{ "em64t", X86_CPU_TYPE_PRESCOTT },
+	{ "intel64", X86_CPU_TYPE_PRESCOTT },
+	{ "core", X86_CPU_TYPE_MEROM },
+	{ "merom", X86_CPU_TYPE_MEROM },
+	{ "penryn", X86_CPU_TYPE_PENRYN },
+	{ "nehalem", X86_CPU_TYPE_NEHALEM },
+	{ "westmere", X86_CPU_TYPE_WESTMERE },
+	{ "sandybridge", X86_CPU_TYPE_SANDYBRIDGE },
+	{ "ivybridge", X86_CPU_TYPE_IVYBRIDGE },
+	{ "haswell", X86_CPU_TYPE_HASWELL },
+	{ "broadwell", X86_CPU_TYPE_BROADWELL },
+	{ "intel", X86_CPU_TYPE_SKYLAKE },
+	{ "skylake", X86_CPU_TYPE_SKYLAKE },
+	{ "bonnell", X86_CPU_TYPE_BONNELL },
+	{ "silvermont", X86_CPU_TYPE_SILVERMONT },
+	{ "goldmont", X86_CPU_TYPE_GOLDMONT },
+	{ "gracemont", X86_CPU_TYPE_GRACEMONT },
+	{ "knf", X86_CPU_TYPE_KNF },
+	{ "knc", X86_CPU_TYPE_KNC },
+	{ "knl", X86_CPU_TYPE_KNL },
+	{ "x86s", X86_CPU_TYPE_X86S },
+	{ "am386", X86_CPU_TYPE_AM386 },
+	{ "am486", X86_CPU_TYPE_AM486 },
+	{ "am5x86", X86_CPU_TYPE_AM5X86 },
+	{ "nx586", X86_CPU_TYPE_NX586 },
+	{ "nx586fp", X86_CPU_TYPE_NX586FP },
+	{ "nx686", X86_CPU_TYPE_NX686 },
+	{ "k5", X86_CPU_TYPE_K5 },
+	{ "k6", X86_CPU_TYPE_K6 },
+	{ "k6-2", X86_CPU_TYPE_K6_2 },
+	{ "k6_2", X86_CPU_TYPE_K6_2 },
+	{ "k6-ii", X86_CPU_TYPE_K6_2 },
+	{ "k6-3", X86_CPU_TYPE_K6_3 },
+	{ "k6_3", X86_CPU_TYPE_K6_3 },
+	{ "k6-iii", X86_CPU_TYPE_K6_3 },
+	{ "k6_iii", X86_CPU_TYPE_K6_3 },
+	{ "k6-2+", X86_CPU_TYPE_K6_2PLUS },
+	{ "k6_2+", X86_CPU_TYPE_K6_2PLUS },
+	{ "k6-2plus", X86_CPU_TYPE_K6_2PLUS },
+	{ "k6_2plus", X86_CPU_TYPE_K6_2PLUS },
+	{ "k6-3+", X86_CPU_TYPE_K6_3PLUS },
+	{ "k6_3+", X86_CPU_TYPE_K6_3PLUS },
+	{ "k6-3plus", X86_CPU_TYPE_K6_3PLUS },
+	{ "k6_3plus", X86_CPU_TYPE_K6_3PLUS },
+	{ "k6-iii", X86_CPU_TYPE_K6_3PLUS },
+	{ "k6_iii", X86_CPU_TYPE_K6_3PLUS },
+	{ "k6iii+", X86_CPU_TYPE_K6_3PLUS },
+	{ "k6-iii+", X86_CPU_TYPE_K6_3PLUS },
+	{ "k6_iii+", X86_CPU_TYPE_K6_3PLUS },
+	{ "k6iii+", X86_CPU_TYPE_K6_3PLUS },
+	{ "k7", X86_CPU_TYPE_K7 },
+	{ "athlon", X86_CPU_TYPE_K7 },
+	{ "athlonxp", X86_CPU_TYPE_ATHLONXP },
+	{ "amd64", X86_CPU_TYPE_K8 },
+	{ "opteron", X86_CPU_TYPE_K8 },
+	{ "athlon64", X86_CPU_TYPE_K8 },
+	{ "k8", X86_CPU_TYPE_K8 },
+	{ "k10", X86_CPU_TYPE_K10 },
+	{ "bobcat", X86_CPU_TYPE_BOBCAT },
+	{ "jaguar", X86_CPU_TYPE_JAGUAR },
+	{ "puma", X86_CPU_TYPE_PUMA },
+	{ "drex", X86_CPU_TYPE_DREX },
+	{ "bulldozer", X86_CPU_TYPE_BULLDOZER },
+	{ "piledriver", X86_CPU_TYPE_PILEDRIVER },
+	{ "excavator", X86_CPU_TYPE_EXCAVATOR },
+	{ "zen", X86_CPU_TYPE_ZEN },
+	{ "zen2", X86_CPU_TYPE_ZEN2 },
+	{ "zen3", X86_CPU_TYPE_ZEN3 },
+	{ "zen4", X86_CPU_TYPE_ZEN4 },
+	{ "amd", X86_CPU_TYPE_ZEN5 },
+	{ "zen5", X86_CPU_TYPE_ZEN5 },
+	{ "cx486slc", X86_CPU_TYPE_CX486 },
+	{ "cx486dlc", X86_CPU_TYPE_CX486 },
+	{ "cx486", X86_CPU_TYPE_CX486 },
+	{ "cx486slc", X86_CPU_TYPE_CX486FP },
+	{ "cx486dlc", X86_CPU_TYPE_CX486FP },
+	{ "cx486", X86_CPU_TYPE_CX486FP },
+	{ "cx486fp", X86_CPU_TYPE_CX486FP },
+	{ "cx486slce", X86_CPU_TYPE_CX486SLCE },
+	{ "cx486s", X86_CPU_TYPE_CX486S },
+	{ "5x86", X86_CPU_TYPE_CX5X86 },
+	{ "cx5x86", X86_CPU_TYPE_CX5X86 },
+	{ "mediagx", X86_CPU_TYPE_MEDIAGX },
+	{ "gx", X86_CPU_TYPE_MEDIAGX },
+	{ "cxgx", X86_CPU_TYPE_MEDIAGX },
+	{ "mediagxi", X86_CPU_TYPE_MEDIAGX },
+	{ "gxi", X86_CPU_TYPE_MEDIAGX },
+	{ "mediagxm", X86_CPU_TYPE_GXM },
+	{ "geode", X86_CPU_TYPE_GXM },
+	{ "gxm", X86_CPU_TYPE_GXM },
+	{ "gx1", X86_CPU_TYPE_GX1 },
+	{ "gx2", X86_CPU_TYPE_GX2 },
+	{ "amdgx", X86_CPU_TYPE_GX2 },
+	{ "lx", X86_CPU_TYPE_LX },
+	{ "amdlx", X86_CPU_TYPE_LX },
+	{ "nx", X86_CPU_TYPE_NX },
+	{ "amdnx", X86_CPU_TYPE_NX },
+	{ "6x86", X86_CPU_TYPE_CX6X86 },
+	{ "cx6x86", X86_CPU_TYPE_CX6X86 },
+	{ "cx6x86l", X86_CPU_TYPE_CX6X86L },
+	{ "6x86mx", X86_CPU_TYPE_M2 },
+	{ "cx6x86mx", X86_CPU_TYPE_M2 },
+	{ "mii", X86_CPU_TYPE_M2 },
+	{ "m2", X86_CPU_TYPE_M2 },
+	{ "m-2", X86_CPU_TYPE_M2 },
+	{ "m_2", X86_CPU_TYPE_M2 },
+	{ "cyrixiii", X86_CPU_TYPE_CYRIX3 },
+	{ "cyrix3", X86_CPU_TYPE_CYRIX3 },
+	{ "viacyrixiii", X86_CPU_TYPE_CYRIX3 },
+	{ "viacyrix3", X86_CPU_TYPE_CYRIX3 },
+	{ "viacyrix", X86_CPU_TYPE_CYRIX3 },
+	{ "joshua", X86_CPU_TYPE_CYRIX3 },
+	{ "wc6", X86_CPU_TYPE_WC6 },
+	{ "wc2", X86_CPU_TYPE_WC2 },
+	{ "wc3", X86_CPU_TYPE_WC3 },
+	{ "samuel", X86_CPU_TYPE_SAMUEL },
+	{ "viac3", X86_CPU_TYPE_C3 },
+	{ "c3", X86_CPU_TYPE_C3 },
+	{ "viac3", X86_CPU_TYPE_C3 },
+	{ "samuel2", X86_CPU_TYPE_C3 },
+	{ "c5b", X86_CPU_TYPE_C3 },
+	{ "ezra", X86_CPU_TYPE_C3 },
+	{ "c5c", X86_CPU_TYPE_C3 },
+	{ "c5n", X86_CPU_TYPE_C3 },
+	{ "nehemiah", X86_CPU_TYPE_NEHEMIAH },
+	{ "c5xl", X86_CPU_TYPE_NEHEMIAH },
+	{ "viac5", X86_CPU_TYPE_C5 },
+	{ "nehemiah+", X86_CPU_TYPE_C5 },
+	{ "c5p", X86_CPU_TYPE_C5 },
+	{ "c5", X86_CPU_TYPE_C5 },
+	{ "viac7", X86_CPU_TYPE_C7 },
+	{ "esther", X86_CPU_TYPE_C7 },
+	{ "eden", X86_CPU_TYPE_C7 },
+	{ "c5j", X86_CPU_TYPE_C7 },
+	{ "c7", X86_CPU_TYPE_C7 },
+	{ "vianano", X86_CPU_TYPE_NANO },
+	{ "isaiah", X86_CPU_TYPE_NANO },
+	{ "via64", X86_CPU_TYPE_NANO },
+	{ "nano", X86_CPU_TYPE_NANO },
+	{ "nano3000", X86_CPU_TYPE_NANO3000 },
+	{ "zxa", X86_CPU_TYPE_NANOX2 },
+	{ "zx-a", X86_CPU_TYPE_NANOX2 },
+	{ "zx_a", X86_CPU_TYPE_NANOX2 },
+	{ "zxb", X86_CPU_TYPE_NANOX2 },
+	{ "zx-b", X86_CPU_TYPE_NANOX2 },
+	{ "zx_b", X86_CPU_TYPE_NANOX2 },
+	{ "nanox2", X86_CPU_TYPE_NANOX2 },
+	{ "quadcore", X86_CPU_TYPE_NANOC4000 },
+	{ "c4000", X86_CPU_TYPE_NANOC4000 },
+	{ "zxc", X86_CPU_TYPE_NANOC4000 },
+	{ "zx-c", X86_CPU_TYPE_NANOC4000 },
+	{ "zx_c", X86_CPU_TYPE_NANOC4000 },
+	{ "zhangjiang", X86_CPU_TYPE_NANOC4000 },
+	{ "张江高", X86_CPU_TYPE_NANOC4000 },
+	{ "張江高", X86_CPU_TYPE_NANOC4000 },
+	{ "nanoc4000", X86_CPU_TYPE_NANOC4000 },
+	{ "cns", X86_CPU_TYPE_CNS },
+	{ "zxc+", X86_CPU_TYPE_ZXCPLUS },
+	{ "zx-c+", X86_CPU_TYPE_ZXCPLUS },
+	{ "zx_c+", X86_CPU_TYPE_ZXCPLUS },
+	{ "zxcplus", X86_CPU_TYPE_ZXCPLUS },
+	{ "zx-cplus", X86_CPU_TYPE_ZXCPLUS },
+	{ "zx_cplus", X86_CPU_TYPE_ZXCPLUS },
+	{ "zxd", X86_CPU_TYPE_ZXD },
+	{ "zx-d", X86_CPU_TYPE_ZXD },
+	{ "zx_d", X86_CPU_TYPE_ZXD },
+	{ "kx5000", X86_CPU_TYPE_ZXD },
+	{ "kx-5000", X86_CPU_TYPE_ZXD },
+	{ "kx_5000", X86_CPU_TYPE_ZXD },
+	{ "kx5k", X86_CPU_TYPE_ZXD },
+	{ "kx-5k", X86_CPU_TYPE_ZXD },
+	{ "kx_5k", X86_CPU_TYPE_ZXD },
+	{ "kh20000", X86_CPU_TYPE_ZXD },
+	{ "kh-20000", X86_CPU_TYPE_ZXD },
+	{ "kh_20000", X86_CPU_TYPE_ZXD },
+	{ "kh20k", X86_CPU_TYPE_ZXD },
+	{ "kh-20k", X86_CPU_TYPE_ZXD },
+	{ "kh_20k", X86_CPU_TYPE_ZXD },
+	{ "wudaokou", X86_CPU_TYPE_ZXD },
+	{ "五道口", X86_CPU_TYPE_ZXD },
+	{ "zxe", X86_CPU_TYPE_ZXE },
+	{ "zx-e", X86_CPU_TYPE_ZXE },
+	{ "zx_e", X86_CPU_TYPE_ZXE },
+	{ "kx6000", X86_CPU_TYPE_ZXE },
+	{ "kx-6000", X86_CPU_TYPE_ZXE },
+	{ "kx_6000", X86_CPU_TYPE_ZXE },
+	{ "kx6k", X86_CPU_TYPE_ZXE },
+	{ "kx-6k", X86_CPU_TYPE_ZXE },
+	{ "kx_6k", X86_CPU_TYPE_ZXE },
+	{ "kh30000", X86_CPU_TYPE_ZXE },
+	{ "kh-23000", X86_CPU_TYPE_ZXE },
+	{ "kh_30000", X86_CPU_TYPE_ZXE },
+	{ "kh30k", X86_CPU_TYPE_ZXE },
+	{ "kh-30k", X86_CPU_TYPE_ZXE },
+	{ "kh_30k", X86_CPU_TYPE_ZXE },
+	{ "lujiazui", X86_CPU_TYPE_ZXE },
+	{ "陆家嘴", X86_CPU_TYPE_ZXE },
+	{ "kh40000", X86_CPU_TYPE_KH40000 },
+	{ "kh-40000", X86_CPU_TYPE_KH40000 },
+	{ "kh_40000", X86_CPU_TYPE_KH40000 },
+	{ "kh40k", X86_CPU_TYPE_KH40000 },
+	{ "kh-40k", X86_CPU_TYPE_KH40000 },
+	{ "kh_40k", X86_CPU_TYPE_KH40000 },
+	{ "yongfeng", X86_CPU_TYPE_KH40000 },
+	{ "永豐", X86_CPU_TYPE_KH40000 },
+	{ "永丰", X86_CPU_TYPE_KH40000 },
+	{ "zx", X86_CPU_TYPE_ZXF },
+	{ "via", X86_CPU_TYPE_ZXF },
+	{ "kx7000", X86_CPU_TYPE_ZXF },
+	{ "kx-7000", X86_CPU_TYPE_ZXF },
+	{ "kx_7000", X86_CPU_TYPE_ZXF },
+	{ "kx7k", X86_CPU_TYPE_ZXF },
+	{ "kx-7k", X86_CPU_TYPE_ZXF },
+	{ "kx_7k", X86_CPU_TYPE_ZXF },
+	{ "shijidadao", X86_CPU_TYPE_ZXF },
+	{ "世纪大道", X86_CPU_TYPE_ZXF },
+	{ "zxf", X86_CPU_TYPE_ZXF },
+	{ "v20", X86_CPU_TYPE_V20 },
+	{ "upd70108", X86_CPU_TYPE_V20 },
+	{ "70108", X86_CPU_TYPE_V20 },
+	{ "v30", X86_CPU_TYPE_V30 },
+	{ "upd70116", X86_CPU_TYPE_V30 },
+	{ "70116", X86_CPU_TYPE_V30 },
+	{ "v40", X86_CPU_TYPE_V40 },
+	{ "upd70208", X86_CPU_TYPE_V40 },
+	{ "70208", X86_CPU_TYPE_V40 },
+	{ "v50", X86_CPU_TYPE_V50 },
+	{ "upd70216", X86_CPU_TYPE_V50 },
+	{ "70216", X86_CPU_TYPE_V50 },
+	{ "upd9002", X86_CPU_TYPE_UPD9002 },
+	{ "9002", X86_CPU_TYPE_UPD9002 },
+	{ "pc-88va", X86_CPU_TYPE_UPD9002 },
+	{ "pc88va", X86_CPU_TYPE_UPD9002 },
+	{ "88va", X86_CPU_TYPE_UPD9002 },
+	{ "pc-88-va", X86_CPU_TYPE_UPD9002 },
+	{ "pc88-va", X86_CPU_TYPE_UPD9002 },
+	{ "88-va", X86_CPU_TYPE_UPD9002 },
+	{ "v33", X86_CPU_TYPE_V33 },
+	{ "upd70136", X86_CPU_TYPE_V33 },
+	{ "70108", X86_CPU_TYPE_V33 },
+	{ "v53", X86_CPU_TYPE_V33 },
+	{ "upd70236", X86_CPU_TYPE_V33 },
+	{ "70116", X86_CPU_TYPE_V33 },
+	{ "v25", X86_CPU_TYPE_V25 },
+	{ "upd70320", X86_CPU_TYPE_V25 },
+	{ "70320", X86_CPU_TYPE_V25 },
+	{ "v35", X86_CPU_TYPE_V25 },
+	{ "upd70330", X86_CPU_TYPE_V25 },
+	{ "70330", X86_CPU_TYPE_V25 },
+	{ "v25s", X86_CPU_TYPE_V25S },
+	{ "upd70327", X86_CPU_TYPE_V25S },
+	{ "70327", X86_CPU_TYPE_V25S },
+	{ "v35s", X86_CPU_TYPE_V25S },
+	{ "upd70337", X86_CPU_TYPE_V25S },
+	{ "70337", X86_CPU_TYPE_V25S },
+	{ "v55", X86_CPU_TYPE_V55 },
+	{ "upd70433", X86_CPU_TYPE_V55 },
+	{ "70433", X86_CPU_TYPE_V55 },
+	{ "upd70423", X86_CPU_TYPE_V55 },
+	{ "70423", X86_CPU_TYPE_V55 },
+	{ "v55pi", X86_CPU_TYPE_V55 },
+	{ "v55sc", X86_CPU_TYPE_V55 },
+	{ "v60", X86_CPU_TYPE_V60 },
+	{ "upd70616", X86_CPU_TYPE_V60 },
+	{ "70616", X86_CPU_TYPE_V60 },
+	{ "v70", X86_CPU_TYPE_V60 },
+	{ "upd70632", X86_CPU_TYPE_V60 },
+	{ "70632", X86_CPU_TYPE_V60 },
+	{ "v80", X86_CPU_TYPE_V60 },
+	{ "upd70832", X86_CPU_TYPE_V60 },
+	{ "70832", X86_CPU_TYPE_V60 },
+	{ "extended", X86_CPU_TYPE_EXTENDED },
+};
+	static const struct
+{
+	const char * name;
+	const char * description;
+	x87_fpu_type_t type;
+	x87_fpu_subtype_t subtype;
+} supported_fpu_table[] =
+{
+	{ "8087", "Intel 8087", X87_FPU_8087, 0 },
+	{ "i8087", "Intel 8087", X87_FPU_8087, 0 },
+	{ "87", "Intel 8087", X87_FPU_8087, 0 },
+	{ "i87", "Intel 8087", X87_FPU_8087, 0 },
+	{ "72091", "NEC µPD72091", X87_FPU_8087, 0 },
+	{ "80287", "Intel 80287", X87_FPU_287, 0 },
+	{ "i80287", "Intel 80287", X87_FPU_287, 0 },
+	{ "287", "Intel 80287", X87_FPU_287, 0 },
+	{ "i287", "Intel 80287", X87_FPU_287, 0 },
+	{ "80287xl", "Intel 80287XL", X87_FPU_287, X87_FPU_287_287XL },
+	{ "i80287xl", "Intel 80287XL", X87_FPU_287, X87_FPU_287_287XL },
+	{ "287xl", "Intel 80287XL", X87_FPU_287, X87_FPU_287_287XL },
+	{ "i287xl", "Intel 80287XL", X87_FPU_287, X87_FPU_287_287XL },
+	{ "80387", "Intel 80387", X87_FPU_387, 0 },
+	{ "i80387", "Intel 80387", X87_FPU_387, 0 },
+	{ "387", "Intel 80387", X87_FPU_387, 0 },
+	{ "i387", "Intel 80387", X87_FPU_387, 0 },
+	{ "80387sl", "Intel 80387SL", X87_FPU_387, X87_FPU_387_387SL },
+	{ "i80387sl", "Intel 80387SL", X87_FPU_387, X87_FPU_387_387SL },
+	{ "387sl", "Intel 80387SL", X87_FPU_387, X87_FPU_387_387SL },
+	{ "i387sl", "Intel 80387SL", X87_FPU_387, X87_FPU_387_387SL },
+	{ "80187", "Intel 80C187", X87_FPU_387, 0 },
+	{ "i80187", "Intel 80C187", X87_FPU_387, 0 },
+	{ "187", "Intel 80C187", X87_FPU_387, 0 },
+	{ "i187", "Intel 80C187", X87_FPU_387, 0 },
+	{ "80c187", "Intel 80C187", X87_FPU_387, 0 },
+	{ "i80c187", "Intel 80C187", X87_FPU_387, 0 },
+	{ "72191", "NEC µPD72191", X87_FPU_387, 0 },
+	{ "emc87", "Cyrix EMC87", X87_FPU_EMC87, 0 },
+	{ "fasmath", "Cyrix EMC87", X87_FPU_EMC87, 0 },
+	{ "cyrix", "Cyrix EMC87", X87_FPU_EMC87, 0 },
+	{ "iit", "IIT 3c87", X87_FPU_IIT, 0 },
+};
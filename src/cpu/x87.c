@@ -71,11 +71,6 @@ static inline x87_float80_t x87_float80_make_zero(bool sign)
 
 const x87_float80_t FLOAT80_ZERO = FLOAT80_MAKE(0.0, 0, 0);
 const x87_float80_t FLOAT80_ONE = FLOAT80_MAKE(1.0, 0x8000000000000000U, 0x3FFF);
-const x87_float80_t FLOAT80_PI = FLOAT80_MAKE(M_PI, 0xC90FDAA22168C000U /* TODO: this is the 64-bit expansion */, 0x3FFF + 1);
-const x87_float80_t FLOAT80_LOG2E = FLOAT80_MAKE(M_LOG2E, 0xB17217F7D1CF7800 /* TODO: this is the 64-bit expansion */, 0x3FFF - 1);
-const x87_float80_t FLOAT80_LOG2_10 = FLOAT80_MAKE(M_LOG2E * M_LN10, 0x9A209A84FBCFF000 /* TODO: this is the 64-bit expansion */, 0x3FFF - 2);
-const x87_float80_t FLOAT80_LOG10_2 = FLOAT80_MAKE(M_LOG10E * M_LN2, 0xD49A784BCD1B9000 /* TODO: this is the 64-bit expansion */, 0x3FFF + 1);
-const x87_float80_t FLOAT80_LN2 = FLOAT80_MAKE(M_LN2, 0xB17217F7D1CF7800 /* TODO: this is the 64-bit expansion */, 0x3FFF - 1);
 
 static inline x87_float80_t x87_float80_make_int64(int64_t value)
 {
@@ -135,7 +130,8 @@ static inline x87_float80_t x87_float80_make(float80_t value)
 #if _SUPPORT_FLOAT80
 		result.value = value;
 		frexpl(value, &exp);
-		result.exponent = exp + 0x3FFE + (signbit(value) ? 0x8000 : 0x0000);
+		// the sign is only stored in the value, like in x87_convert_to_float80
+		result.exponent = exp + 0x3FFE;
 #else
 		result.fraction = (uint64_t)ldexpl(frexpl(fabsl(value), &exp), 64);
 		result.exponent = exp + 0x3FFE + (signbit(value) ? 0x8000 : 0x0000);
@@ -196,6 +192,36 @@ static inline x87_float80_t x87_make_unnormal(x87_float80_t x87value, uint16_t e
 	return x87value;
 }
 
+#if _SUPPORT_FLOAT80 && _FLOAT80_EXACT && BYTE_ORDER == LITTLE_ENDIAN
+/* The host long double has the same layout as the x87 format, so normal numbers can be accessed as bits, without going through frexpl and ldexpl
+ * Returns false if the value is not a normal number, or the stored exponent shows that it is an unnormal or pseudo-subnormal
+ */
+# define X87_FLOAT80_BITS 1
+static inline bool x87_float80_get_normal_bits(x87_float80_t x87value, uint64_t * fraction, uint16_t * exponent, bool * sign)
+{
+	// the bytes after the 80 bits are padding
+	uint64_t bits[2] = { 0, 0 };
+	memcpy(bits, &x87value.value, sizeof x87value.value < sizeof bits ? sizeof x87value.value : sizeof bits);
+	uint16_t biased = bits[1] & 0x7FFF;
+	if(biased == 0 || biased == 0x7FFF || biased != x87value.exponent)
+		return false;
+	*fraction = bits[0];
+	*exponent = biased;
+	*sign = (bits[1] & 0x8000) != 0;
+	return true;
+}
+
+// the fraction must have its highest bit set and the exponent must be between 1 and 0x7FFE
+static inline x87_float80_t x87_float80_make_normal_bits(uint64_t fraction, uint16_t exponent, bool sign)
+{
+	x87_float80_t result;
+	uint64_t bits[2] = { fraction, exponent | (sign ? 0x8000 : 0x0000) };
+	memcpy(&result.value, bits, sizeof result.value < sizeof bits ? sizeof result.value : sizeof bits);
+	result.exponent = exponent;
+	return result;
+}
+#endif
+
 static inline bool signbit80(x87_float80_t x87value)
 {
 #if _SUPPORT_FLOAT80
@@ -208,6 +234,13 @@ static inline bool signbit80(x87_float80_t x87value)
 static inline int fp80classify(x87_float80_t x87value)
 {
 #if _SUPPORT_FLOAT80
+# if X87_FLOAT80_BITS
+	uint64_t fraction;
+	uint16_t exponent;
+	bool sign;
+	if(x87_float80_get_normal_bits(x87value, &fraction, &exponent, &sign))
+		return FP80_NORMAL;
+# endif
 	switch(fpclassify(x87value.value))
 	{
 	case FP_NAN:
@@ -384,6 +417,10 @@ static inline unsigned x87_determine_tag_nonfp(x86_state_t * emu, uint64_t fract
 static inline void x87_convert_from_float80(x87_float80_t x87value, uint64_t * fraction, uint16_t * exponent, bool * sign)
 {
 #if _SUPPORT_FLOAT80
+# if X87_FLOAT80_BITS
+	if(x87_float80_get_normal_bits(x87value, fraction, exponent, sign))
+		return;
+# endif
 	int exp;
 	switch(fpclassify(x87value.value))
 	{
@@ -445,6 +482,10 @@ static inline x87_float80_t x87_convert_to_float80(uint64_t fraction, uint16_t e
 	x87_float80_t result;
 #if _SUPPORT_FLOAT80
 	exponent &= 0x7FFF;
+# if X87_FLOAT80_BITS
+	if(exponent != 0 && exponent != 0x7FFF && (fraction & 0x8000000000000000U) != 0)
+		return x87_float80_make_normal_bits(fraction, exponent, sign);
+# endif
 	if(exponent == 0x7FFF)
 	{
 		if((fraction & ~0x8000000000000000U) == 0)
@@ -1272,18 +1313,6 @@ static inline void x86_mmx_set(x86_state_t * emu, x86_regnum_t number, uint64_t
 	emu->x87.fpr[number].mmx.q[0] = value;
 }
 
-static inline x87_float80_t x87_f2xm1(x86_state_t * emu, x87_float80_t value)
-{
-	(void) emu;
-#if _SUPPORT_FLOAT80
-	return x87_float80_make(expm1l(log2l(value.value))); // TODO
-#else
-	// TODO
-	(void) value;
-	return FLOAT80_ZERO;
-#endif
-}
-
 static inline x87_float80_t x87_check_subnormal(x86_state_t * emu, x87_float80_t value)
 {
 	if(issubnormal80(value))
@@ -1317,224 +1346,2497 @@ static inline x87_float80_t x87_check_invalid(x86_state_t * emu, x87_float80_t v
 	return value;
 }
 
-static inline x87_float80_t x87_fabs(x86_state_t * emu, x87_float80_t value)
+// Transcendental functions
+
+/*
+	The transcendental instructions are computed on 128-bit significands using only integer arithmetic and then rounded according to the rounding control.
+	This makes the results independent of the host floating point support.
+	Like the hardware, sine, cosine and tangent reduce their argument by a 66-bit approximation of pi.
+	Each function looks up the nearest entry in a table of values and then evaluates a short series for the small remaining difference.
+	The tables and series coefficients were calculated to 400 bits and rounded to 128 bits.
+*/
+
+typedef struct x87_wide_t
 {
-	(void) emu;
-#if _SUPPORT_FLOAT80
-	value.value = fabsl(value.value);
+	// the value is (high:low) * 2^(exponent - 127), the highest bit of high is set unless the value is zero
+	uint64_t high, low;
+	int32_t exponent;
+	bool sign;
+} x87_wide_t;
+
+#define X87_WIDE_ZERO_EXPONENT (-0x10000)
+
+static inline uint64_t x87_mul64(uint64_t value1, uint64_t value2, uint64_t * low)
+{
+#ifdef __SIZEOF_INT128__
+	uint128_t product = (uint128_t)value1 * value2;
+	*low = (uint64_t)product;
+	return (uint64_t)(product >> 64);
 #else
-	value.exponent &= 0x7FFF;
+	uint64_t ll = (value1 & 0xFFFFFFFF) * (value2 & 0xFFFFFFFF);
+	uint64_t lh = (value1 & 0xFFFFFFFF) * (value2 >> 32);
+	uint64_t hl = (value1 >> 32) * (value2 & 0xFFFFFFFF);
+	uint64_t hh = (value1 >> 32) * (value2 >> 32);
+	uint64_t middle = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+	*low = (middle << 32) | (ll & 0xFFFFFFFF);
+	return hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
 #endif
-	return value;
 }
 
-static inline x87_float80_t x87_fadd(x86_state_t * emu, x87_float80_t value1, x87_float80_t value2)
+static inline uint64_t x87_mulhi64(uint64_t value1, uint64_t value2)
 {
-	x87_float80_t result;
+	uint64_t low;
+	return x87_mul64(value1, value2, &low);
+}
 
-	x87_check_subnormal_8087(emu, value1);
-	x87_check_subnormal_8087(emu, value2);
+// keeps the upper 128 bits of the product of a 128-bit and a 64-bit number, shifted right by 0 to 63 bits
+static inline void x87_mul128_64(uint64_t high1, uint64_t low1, uint64_t value2, int shift, uint64_t * high, uint64_t * low)
+{
+	uint64_t carry = x87_mulhi64(low1, value2);
+	uint64_t product_low, product_high = x87_mul64(high1, value2, &product_low);
+	product_low += carry;
+	product_high += product_low < carry;
+	*high = shift == 0 ? product_high : product_high >> shift;
+	*low = shift == 0 ? product_low : (product_high << (64 - shift)) | (product_low >> shift);
+}
 
-	x87_check_invalid(emu, value1);
-	x87_check_invalid(emu, value2);
+static inline void x87_fixed_add(uint64_t * high, uint64_t * low, uint64_t value_high, uint64_t value_low)
+{
+	*low += value_low;
+	*high += value_high + (*low < value_low);
+}
 
-	x87_check_subnormal(emu, value1);
-	x87_check_subnormal(emu, value2);
+static inline void x87_fixed_sub(uint64_t * high, uint64_t * low, uint64_t value_high, uint64_t value_low)
+{
+	*high -= value_high + (*low < value_low);
+	*low -= value_low;
+}
 
-#if _SUPPORT_FLOAT80
-	if(emu->x87.fpu_type < X87_FPU_387)
+static inline x87_wide_t x87_wide_normalize(x87_wide_t value)
+{
+	if(value.high == 0)
 	{
-		// 8087/287 converts subnormals to unnormal
-		if(fp80classify(value1) == FP80_SUBNORMAL)
-			value1 = x87_float80_make_8087(value1.value);
-		if(fp80classify(value2) == FP80_SUBNORMAL)
-			value2 = x87_float80_make_8087(value2.value);
-
-		if(isinf80(value1) && isinf80(value2) && (emu->x87.cw & X87_CW_IC) == 0)
+		if(value.low == 0)
 		{
-			// infinity control makes inf + inf invalid
-			x87_signal_exception(emu, X87_SW_IE);
-
-			return x87_float80_make_indefinite();
+			value.exponent = X87_WIDE_ZERO_EXPONENT;
+			return value;
 		}
+		value.high = value.low;
+		value.low = 0;
+		value.exponent -= 64;
 	}
 
-	if(isnan80(value1) && isnan80(value2))
+	// the low bits are shifted in two steps, since a shift by 64 is not defined
+	int shift = _clz64(value.high);
+	value.high = (value.high << shift) | ((value.low >> 1) >> (63 - shift));
+	value.low <<= shift;
+	value.exponent -= shift;
+	return value;
+}
+
+// value is fraction * 2^(exponent - 63)
+static inline x87_wide_t x87_wide_make(uint64_t fraction, int32_t exponent, bool sign)
+{
+	x87_wide_t result = { fraction, 0, exponent, sign };
+	return x87_wide_normalize(result);
+}
+
+static inline bool x87_wide_is_zero(x87_wide_t value)
+{
+	return value.high == 0;
+}
+
+static inline x87_wide_t x87_wide_negate(x87_wide_t value)
+{
+	value.sign = !value.sign;
+	return value;
+}
+
+static inline x87_wide_t x87_wide_scale(x87_wide_t value, int32_t exponent)
+{
+	if(!x87_wide_is_zero(value))
+		value.exponent += exponent;
+	return value;
+}
+
+// compares the magnitudes
+static inline int x87_wide_compare(x87_wide_t value1, x87_wide_t value2)
+{
+	if(value1.exponent != value2.exponent)
+		return value1.exponent < value2.exponent ? -1 : 1;
+	else if(value1.high != value2.high)
+		return value1.high < value2.high ? -1 : 1;
+	else if(value1.low != value2.low)
+		return value1.low < value2.low ? -1 : 1;
+	else
+		return 0;
+}
+
+static inline x87_wide_t x87_wide_add(x87_wide_t value1, x87_wide_t value2)
+{
+	if(x87_wide_is_zero(value2))
+		return value1;
+	if(x87_wide_is_zero(value1))
+		return value2;
+
+	if(x87_wide_compare(value1, value2) < 0)
 	{
-		// takes NaN of greater magnitude
-		// on 387 and later, quiet NaNs override signaling NaNs, but since quiet NaNs have greater magnitude, this works out the same way
-		if(value1.fraction > value2.fraction)
-			return x87_make_quiet_nan(emu, value1);
-		else
-			return x87_make_quiet_nan(emu, value2);
+		x87_wide_t tmp = value1;
+		value1 = value2;
+		value2 = tmp;
 	}
-	else if(isnan80(value1))
+
+	// the smaller operand is truncated, the lowest bit is set if any of the shifted out bits were set
+	int32_t shift = value1.exponent - value2.exponent;
+	if(shift >= 128)
 	{
-		return x87_make_quiet_nan(emu, value1);
+		value2.high = 0;
+		value2.low = 1;
 	}
-	else if(isnan80(value2))
+	else if(shift >= 64)
 	{
-		return x87_make_quiet_nan(emu, value2);
+		bool lost = value2.low != 0 || (shift > 64 && (value2.high << (128 - shift)) != 0);
+		value2.low = (shift > 64 ? value2.high >> (shift - 64) : value2.high) | lost;
+		value2.high = 0;
 	}
-
-	fesetround(x87_get_std_rounding_mode(emu));
-	feclearexcept(FE_ALL_EXCEPT);
-
-	if(emu->x87.fpu_type < X87_FPU_387)
+	else if(shift != 0)
 	{
-		result = x87_restrict_precision(emu, x87_float80_make_8087(value1.value + value2.value));
+		bool lost = (value2.low << (64 - shift)) != 0;
+		value2.low = (value2.low >> shift) | (value2.high << (64 - shift)) | lost;
+		value2.high >>= shift;
+	}
 
-		if(fp80classify(value1) == FP80_UNNORMAL || fp80classify(value2) == FP80_UNNORMAL)
+	x87_wide_t result = value1;
+	if(value1.sign == value2.sign)
+	{
+		result.low = value1.low + value2.low;
+		result.high = value1.high + value2.high + (result.low < value1.low);
+		if(result.high < value1.high || (result.high == value1.high && result.low < value1.low))
 		{
-			result = x87_make_unnormal(result, min(value1.exponent, value2.exponent));
+			result.low = (result.low >> 1) | (result.high << 63);
+			result.high = (result.high >> 1) | 0x8000000000000000U;
+			result.exponent ++;
 		}
+		return result;
 	}
 	else
 	{
-		result = x87_restrict_precision(emu, x87_float80_make(value1.value + value2.value));
+		result.low = value1.low - value2.low;
+		result.high = value1.high - value2.high - (value1.low < value2.low);
+		return x87_wide_normalize(result);
 	}
+}
 
-	if(fetestexcept(FE_OVERFLOW))
+static inline x87_wide_t x87_wide_sub(x87_wide_t value1, x87_wide_t value2)
+{
+	return x87_wide_add(value1, x87_wide_negate(value2));
+}
+
+// keeps the upper 128 bits of the product of two 128-bit numbers, the product of the lower halves is dropped
+// the lowest bit is set if any of the dropped bits might be set, so that inexact results are never mistaken for exact ones
+static inline void x87_mul128(uint64_t high1, uint64_t low1, uint64_t high2, uint64_t low2, uint64_t * high, uint64_t * low)
+{
+	uint64_t hh_low, hl_low, lh_low;
+	uint64_t hh_high = x87_mul64(high1, high2, &hh_low);
+	uint64_t hl_high = x87_mul64(high1, low2, &hl_low);
+	uint64_t lh_high = x87_mul64(low1, high2, &lh_low);
+	uint64_t carry = ((hl_low >> 1) + (lh_low >> 1)) >> 63;
+
+	*low = hh_low + hl_high;
+	*high = hh_high + (*low < hl_high);
+	*low += lh_high;
+	*high += *low < lh_high;
+	*low += carry;
+	*high += *low < carry;
+	*low |= (hl_low | lh_low | (low1 & -(uint64_t)(low2 != 0))) != 0;
+}
+
+static inline x87_wide_t x87_wide_mul(x87_wide_t value1, x87_wide_t value2)
+{
+	x87_wide_t result;
+	result.sign = value1.sign != value2.sign;
+
+	if(x87_wide_is_zero(value1) || x87_wide_is_zero(value2))
 	{
-		// TODO: 8087/287 behaves differently to the IEEE standard
-		int exp1, exp2;
-		// unmasked response
-		x87_signal_exception_later(emu, X87_SW_OE);
+		result.high = result.low = 0;
+		result.exponent = X87_WIDE_ZERO_EXPONENT;
+		return result;
+	}
 
-		frexp(value1.value, &exp1);
-		frexp(value2.value, &exp2);
-		if(exp1 >= exp2)
-		{
-			value1.value = ldexp(value1.value, exp1 - 0x6000);
-			value1.exponent -= 0x6000;
-		}
-		else
-		{
-			value2.value = ldexp(value2.value, exp2 - 0x6000);
-			value2.exponent -= 0x6000;
-		}
+	x87_mul128(value1.high, value1.low, value2.high, value2.low, &result.high, &result.low);
 
-		feclearexcept(FE_ALL_EXCEPT);
-		result = x87_restrict_precision(emu, x87_float80_make(value1.value + value2.value));
+	// the product of the significands is at least 1, so it is shifted by at most one place, either way is equally likely
+	unsigned shift = (unsigned)(~result.high >> 63);
+	result.high = (result.high << shift) | ((result.low >> 63) & shift);
+	result.low <<= shift;
+	result.exponent = value1.exponent + value2.exponent + 1 - (int32_t)shift;
+	return result;
+}
+
+/* Calculates the reciprocal of the significand, which is between 1 and 2, as a fixed point number with 128 fraction bits
+ * A double precision estimate is refined by Newton-Raphson iteration, the first step gives about 100 bits, the second one, done if accurate is set, about 125 bits
+ */
+static inline void x87_wide_reciprocal(x87_wide_t value, bool accurate, uint64_t * high, uint64_t * low)
+{
+	// 2^127 / high, the reciprocal of 1 is rounded down
+	double estimate = 170141183460469231731687303715884105728.0 / (double)value.high;
+	uint64_t reciprocal = estimate >= 18446744073709551616.0 ? 0xFFFFFFFFFFFFFFFFU : (uint64_t)estimate;
+
+	// the product of the value with the estimate has 191 fraction bits, its lowest 64 bits are dropped
+	uint64_t product_high, product_low;
+	x87_mul128_64(value.high, value.low, reciprocal, 0, &product_high, &product_low);
+	// the product minus 1, scaled by 2^114, this is below 2^-51 in magnitude
+	int64_t error = (int64_t)((product_high << 51) | (product_low >> 13));
+
+	// r - r (b r - 1)
+	uint64_t correction_high, correction_low;
+	x87_mul128_64(reciprocal, 0, error < 0 ? -(uint64_t)error : (uint64_t)error, 50, &correction_high, &correction_low);
+	*high = reciprocal;
+	*low = 0;
+	if(error < 0)
+	{
+		x87_fixed_add(high, low, correction_high, correction_low);
+		if(*high < reciprocal)
+			*high = *low = 0xFFFFFFFFFFFFFFFFU;
+	}
+	else
+	{
+		x87_fixed_sub(high, low, correction_high, correction_low);
 	}
 
-	if(fetestexcept(FE_UNDERFLOW))
+	if(accurate)
 	{
-		// TODO: 8087/287 behaves differently to the IEEE standard
-		int exp1, exp2;
-		// unmasked response
-		x87_signal_exception_later(emu, X87_SW_UE);
+		// the product minus 1, scaled by 2^127, this is below 2^-100 in magnitude
+		x87_mul128(value.high, value.low, *high, *low, &product_high, &product_low);
+		error = (int64_t)product_low;
 
-		frexp(value1.value, &exp1);
-		frexp(value2.value, &exp2);
-		if(exp1 >= exp2)
+		uint64_t correction = x87_mul64(*high, error < 0 ? -(uint64_t)error : (uint64_t)error, &correction_low);
+		correction = (correction << 1) | (correction_low >> 63);
+		if(error < 0)
 		{
-			value1.value = ldexp(value1.value, exp1 + 0x6000);
-			value1.exponent += 0x6000;
+			uint64_t previous = *high;
+			x87_fixed_add(high, low, 0, correction);
+			if(*high < previous)
+				*high = *low = 0xFFFFFFFFFFFFFFFFU;
 		}
 		else
 		{
-			value2.value = ldexp(value2.value, exp2 + 0x6000);
-			value2.exponent += 0x6000;
+			x87_fixed_sub(high, low, 0, correction);
 		}
-
-		feclearexcept(FE_ALL_EXCEPT);
-		result = x87_restrict_precision(emu, x87_float80_make(value1.value + value2.value));
 	}
+}
 
-	if(fetestexcept(FE_INEXACT))
-		x87_signal_exception_later(emu, X87_SW_PE);
+// the relative error is below 2^-124, or below 2^-98 unless accurate is set
+static inline x87_wide_t x87_wide_div(x87_wide_t value1, x87_wide_t value2, bool accurate)
+{
+	x87_wide_t result;
+	result.sign = value1.sign != value2.sign;
 
-#else
-	// TODO
-	(void) emu;
-	(void) value1;
-	(void) value2;
-	result = FLOAT80_ZERO;
-#endif
-	return result;
+	if(x87_wide_is_zero(value1))
+	{
+		result.high = result.low = 0;
+		result.exponent = X87_WIDE_ZERO_EXPONENT;
+		return result;
+	}
+
+	uint64_t high, low;
+	x87_wide_reciprocal(value2, accurate, &high, &low);
+	x87_mul128(value1.high, value1.low, high, low, &result.high, &result.low);
+	result.exponent = value1.exponent - value2.exponent;
+	return x87_wide_normalize(result);
 }
 
-static inline x87_float80_t x87_fchs(x86_state_t * emu, x87_float80_t value)
+static inline x87_wide_t x87_wide_from_float80(x87_float80_t value)
 {
-	(void) emu;
-	// TODO: precision/rounding
-#if _SUPPORT_FLOAT80
-	return x87_float80_make(-value.value);
-#else
-	// TODO
-	(void) value;
-	return FLOAT80_ZERO;
-#endif
+	uint64_t fraction;
+	uint16_t exponent;
+	bool sign;
+	x87_convert_from_float80(value, &fraction, &exponent, &sign);
+	// subnormals and pseudo-subnormals have the same scale as the smallest normal numbers
+	return x87_wide_make(fraction, exponent == 0 ? 1 - 0x3FFF : exponent - 0x3FFF, sign);
 }
 
-static inline void x87_fcom(x86_state_t * emu, x87_float80_t value1, x87_float80_t value2)
+// rounds to 64 bits according to the rounding control, signals inexact results, underflows and overflows
+static inline x87_float80_t x87_wide_to_float80(x86_state_t * emu, x87_wide_t value)
 {
-	(void) emu;
-	// TODO: precision/rounding
-#if _SUPPORT_FLOAT80
-	if(value1.value > value2.value)
+	if(x87_wide_is_zero(value))
+		return x87_float80_make_zero(value.sign);
+
+	int32_t exponent = value.exponent + 0x3FFF;
+	uint64_t fraction = value.high;
+	uint64_t rest = value.low; // bits below the significand
+	bool sticky = false; // bits below the rest
+	bool tiny = exponent <= 0;
+
+	if(tiny)
 	{
-		emu->x87.sw &= ~(X87_SW_C3 | X87_SW_C0);
+		// subnormal result
+		int32_t shift = 1 - exponent;
+		exponent = 0;
+		if(shift >= 128)
+		{
+			sticky = fraction != 0 || rest != 0;
+			rest = 0;
+			fraction = 0;
+		}
+		else if(shift >= 64)
+		{
+			sticky = rest != 0 || (shift > 64 && (fraction << (128 - shift)) != 0);
+			rest = shift > 64 ? fraction >> (shift - 64) : fraction;
+			fraction = 0;
+		}
+		else
+		{
+			sticky = (rest << (64 - shift)) != 0;
+			rest = (rest >> shift) | (fraction << (64 - shift));
+			fraction >>= shift;
+		}
 	}
-	else if(value1.value > value2.value)
+
+	bool inexact = rest != 0 || sticky;
+	bool round_up;
+	switch((emu->x87.cw & X87_CW_RC_MASK) >> X87_CW_RC_SHIFT)
 	{
-		emu->x87.sw &= ~X87_SW_C3;
-		emu->x87.sw |= X87_SW_C0;
+	case X87_RC_NEAREST:
+		round_up = (rest & 0x8000000000000000U) != 0 && ((rest & 0x7FFFFFFFFFFFFFFFU) != 0 || sticky || (fraction & 1) != 0);
+		break;
+	case X87_RC_DOWN:
+		round_up = inexact && value.sign;
+		break;
+	case X87_RC_UP:
+		round_up = inexact && !value.sign;
+		break;
+	default:
+		round_up = false;
+		break;
 	}
-	else if(value1.value == value2.value)
+
+	if(round_up)
 	{
-		emu->x87.sw |= X87_SW_C3;
-		emu->x87.sw &= ~X87_SW_C0;
+		fraction ++;
+		if(fraction == 0)
+		{
+			fraction = 0x8000000000000000U;
+			exponent ++;
+		}
+		else if(exponent == 0 && (fraction & 0x8000000000000000U) != 0)
+		{
+			// rounded up to the smallest normal number
+			exponent = 1;
+		}
 	}
-	else
+
+	if(emu->x87.fpu_type >= X87_FPU_387)
 	{
-		emu->x87.sw |= X87_SW_C3;
-		emu->x87.sw |= X87_SW_C0;
+		if(round_up)
+			emu->x87.sw |= X87_SW_C1;
+		else
+			emu->x87.sw &= ~X87_SW_C1;
 	}
-#else
-	// TODO
-	(void) value1;
-	(void) value2;
-#endif
-}
 
-static inline x87_float80_t x87_fdiv(x86_state_t * emu, x87_float80_t value1, x87_float80_t value2)
-{
-	(void) emu;
-	// TODO: precision/rounding
-#if _SUPPORT_FLOAT80
-	return x87_float80_make(value1.value / value2.value);
-#else
+	if(exponent >= 0x7FFF)
+	{
+		x87_signal_exception_later(emu, X87_SW_OE | X87_SW_PE);
+		switch((emu->x87.cw & X87_CW_RC_MASK) >> X87_CW_RC_SHIFT)
+		{
+		case X87_RC_NEAREST:
+			return x87_float80_make_infinity(value.sign);
+		case X87_RC_DOWN:
+			if(value.sign)
+				return x87_float80_make_infinity(value.sign);
+			break;
+		case X87_RC_UP:
+			if(!value.sign)
+				return x87_float80_make_infinity(value.sign);
+			break;
+		}
+		// largest finite number
+		return x87_convert_to_float80(0xFFFFFFFFFFFFFFFFU, 0x7FFE, value.sign);
+	}
+
+	if(inexact)
+	{
+		if(tiny)
+			x87_signal_exception_later(emu, X87_SW_UE);
+		x87_signal_exception_later(emu, X87_SW_PE);
+	}
+
+	return x87_convert_to_float80(fraction, exponent, value.sign);
+}
+
+// converts to a fixed point number with 128 fraction bits, the magnitude must be below 1
+// the lowest bit is set if any of the shifted out bits were set
+static inline void x87_wide_to_fixed(x87_wide_t value, uint64_t * high, uint64_t * low)
+{
+	int32_t shift = -1 - value.exponent;
+	if(shift == 0)
+	{
+		*high = value.high;
+		*low = value.low;
+	}
+	else if(shift < 64)
+	{
+		*high = value.high >> shift;
+		*low = (value.low >> shift) | (value.high << (64 - shift)) | ((value.low << (64 - shift)) != 0);
+	}
+	else if(shift < 128)
+	{
+		*high = 0;
+		*low = (value.high >> (shift - 64)) | (value.low != 0 || (shift > 64 && (value.high << (128 - shift)) != 0));
+	}
+	else
+	{
+		*high = 0;
+		*low = !x87_wide_is_zero(value);
+	}
+}
+
+// the value is (high:low) * 2^-fraction_bits
+static inline x87_wide_t x87_wide_from_fixed(uint64_t high, uint64_t low, int fraction_bits, bool sign)
+{
+	x87_wide_t result = { high, low, 127 - fraction_bits, sign };
+	return x87_wide_normalize(result);
+}
+
+// the shifted out bits are dropped
+static inline void x87_fixed_shift_right(uint64_t * high, uint64_t * low, int32_t shift)
+{
+	if(shift >= 128)
+	{
+		*high = *low = 0;
+	}
+	else if(shift >= 64)
+	{
+		*low = *high >> (shift - 64);
+		*high = 0;
+	}
+	else
+	{
+		*low = (*low >> shift) | ((*high << 1) << (63 - shift));
+		*high >>= shift;
+	}
+}
+
+static inline void x87_fixed_negate(uint64_t * high, uint64_t * low)
+{
+	*high = ~*high + (*low == 0);
+	*low = -*low;
+}
+
+// negates the number if the mask is all ones, and leaves it unchanged if the mask is zero, without branching on it
+static inline void x87_fixed_negate_masked(uint64_t * high, uint64_t * low, uint64_t mask)
+{
+	*high ^= mask;
+	*low ^= mask;
+	x87_fixed_add(high, low, 0, mask & 1);
+}
+
+// converts the magnitude to a fixed point number with the given fraction bits, which must be below 2^(128 - fraction_bits), the shifted out bits are dropped
+static inline void x87_wide_to_fixed_truncated(x87_wide_t value, int fraction_bits, uint64_t * high, uint64_t * low)
+{
+	*high = value.high;
+	*low = value.low;
+	x87_fixed_shift_right(high, low, 127 - fraction_bits - value.exponent);
+}
+
+/* Evaluates coefficients[0] + coefficients[1] x + ... + coefficients[count - 1] x^(count - 1) for 0 <= x < 2^-6, with the odd terms subtracted if alternating is set
+ * The argument is a fixed point number with 128 fraction bits, the coefficients and the result have 127 fraction bits
+ * Starting from coefficients[precise], the terms only affect the lower half of the result, so they are summed with 64 bits
+ */
+static inline void x87_fixed_series(uint64_t value_high, uint64_t value_low, const uint64_t (* coefficients)[2], int count, int precise, bool alternating, uint64_t * result_high, uint64_t * result_low)
+{
+	// the terms decrease quickly, so the partial sums never change sign
+	uint64_t high = coefficients[count - 1][0], low = 0;
+	for(int i = count - 2; i >= precise; i--)
+	{
+		uint64_t product = x87_mul64(high, value_high, &low);
+		high = alternating ? coefficients[i][0] - product : coefficients[i][0] + product;
+	}
+
+	if(precise >= count - 1)
+	{
+		precise = count - 1;
+		low = coefficients[count - 1][1];
+	}
+	else
+	{
+		low = 0;
+	}
+
+	for(int i = precise - 1; i >= 0; i--)
+	{
+		uint64_t product_high, product_low;
+		x87_mul128(high, low, value_high, value_low, &product_high, &product_low);
+		if(alternating)
+		{
+			low = coefficients[i][1] - product_low;
+			high = coefficients[i][0] - product_high - (coefficients[i][1] < product_low);
+		}
+		else
+		{
+			low = coefficients[i][1] + product_low;
+			high = coefficients[i][0] + product_high + (low < product_low);
+		}
+	}
+
+	*result_high = high;
+	*result_low = low;
+}
+
+/* Evaluates coefficients[0] + t coefficients[1] + t^2 coefficients[2] + ... for 0 <= t < 1, with the odd terms subtracted if alternating is set
+ * All numbers are fixed point numbers with 64 fraction bits, this is used for the small corrections in the fast paths
+ * The terms are taken in pairs, (c0 + t c1) + t^2 ((c2 + t c3) + t^2 (...)), so that the products within a step do not depend on each other
+ */
+static inline uint64_t x87_fixed_series64(uint64_t value, const uint64_t * coefficients, int count, bool alternating)
+{
+	uint64_t square = x87_mulhi64(value, value);
+	int i = (count - 1) & ~1;
+	uint64_t result = coefficients[i];
+	if(i + 1 < count)
+		result = alternating ? result - x87_mulhi64(value, coefficients[i + 1]) : result + x87_mulhi64(value, coefficients[i + 1]);
+	for(i -= 2; i >= 0; i -= 2)
+	{
+		uint64_t pair = alternating ? coefficients[i] - x87_mulhi64(value, coefficients[i + 1]) : coefficients[i] + x87_mulhi64(value, coefficients[i + 1]);
+		result = pair + x87_mulhi64(square, result);
+	}
+	return result;
+}
+
+// calculates value (1 + w), or value (1 - w) if subtract is set, where w is a fixed point number with 64 + shift fraction bits
+static inline x87_wide_t x87_wide_mul_one_plus(x87_wide_t value, uint64_t term, int shift, bool subtract)
+{
+	// the value is halved first, so that the sum cannot overflow
+	value.low = (value.low >> 1) | (value.high << 63);
+	value.high >>= 1;
+	value.exponent ++;
+
+	uint64_t high, low;
+	x87_mul128_64(value.high, value.low, term, shift, &high, &low);
+	if(subtract)
+		x87_fixed_sub(&value.high, &value.low, high, low);
+	else
+		x87_fixed_add(&value.high, &value.low, high, low);
+	return x87_wide_normalize(value);
+}
+
+/* Checks whether a result with an absolute error below 2^error_exponent rounds to the same 64-bit significand as the exact value, in every rounding mode
+ * This fails if the bits below the significand are too close to zero or to one half, and for subnormal results, which are rounded at a different bit
+ */
+static inline bool x87_wide_rounds_safely(x87_wide_t value, int32_t error_exponent)
+{
+	int32_t shift = error_exponent - (value.exponent - 127);
+	if(x87_wide_is_zero(value) || value.exponent < 1 - 0x3FFF || shift >= 62)
+		return false;
+	uint64_t error = (uint64_t)1 << (shift < 0 ? 0 : shift);
+	uint64_t rest = value.low & 0x7FFFFFFFFFFFFFFFU;
+	return rest > error && rest < 0x8000000000000000U - error;
+}
+
+// evaluates the series for a value below 2^-6 in magnitude, the odd terms are subtracted for negative values if alternating is not set
+static inline x87_wide_t x87_wide_series(x87_wide_t value, const uint64_t (* coefficients)[2], int count, int precise, bool alternating)
+{
+	uint64_t value_high, value_low, high, low;
+	x87_wide_to_fixed(value, &value_high, &value_low);
+	x87_fixed_series(value_high, value_low, coefficients, count, precise, alternating != value.sign, &high, &low);
+	return x87_wide_from_fixed(high, low, 127, false);
+}
+
+// rounds value * 2^scale to the nearest integer, the magnitude of the value must be below 2^(62 - scale)
+static inline int32_t x87_wide_round_scaled(x87_wide_t value, int scale)
+{
+	int32_t shift = 62 - scale - value.exponent;
+	if(shift >= 64)
+		return 0;
+	int32_t result = (int32_t)(((value.high >> shift) + 1) >> 1);
+	return value.sign ? -result : result;
+}
+
+// sin(i/64) and cos(i/64) for i from 1 to 50, as fixed point numbers with 128 fraction bits
+static const uint64_t x87_sincos_table[50][2][2] =
+{
+	{ { 0x03FFF5555DDDDA9D, 0xAA938CAC1F113DCA }, { 0xFFF8000AAAA4FA51, 0x4514074BDE6ACE45 } },
+	{ { 0x07FFAAABBBBA1BA3, 0x2BF904DDB51E4656 }, { 0xFFE000AAA93E9589, 0x576DA4EC94946FB9 } },
+	{ { 0x0BFEE008197DD454, 0xCC841722CD0CC475 }, { 0xFFB8035FEFCCF674, 0xC4A9F9B72A141836 } },
+	{ { 0x0FFD557776A76D5A, 0x5D259B2F692D4ACB }, { 0xFF800AAA4FA69A65, 0x070F73284DE215B9 } },
+	{ { 0x13FACB12D1755A9B, 0x79BAB59AE5D278C9 }, { 0xFF381A094F7B771A, 0x05E641B4834BE063 } },
+	{ { 0x17F701032550E41A, 0xFC2D1800501A1008 }, { 0xFEE035FBF35CDA63, 0x2056A6BF1B6B28E0 } },
+	{ { 0x1BF1B78568391D7A, 0x461077A9331F2958 }, { 0xFE78640074CD88F5, 0x1EBC368C35611B2B } },
+	{ { 0x1FEAAEEE86EE35CA, 0x069A86721F89F85A }, { 0xFE00AA93EADE9B6D, 0x1E6A129DF6F18CE5 } },
+	{ { 0x23E1A7AF5F9D5D48, 0x8357B344B2DA517A }, { 0xFD791131E25E97AB, 0x54C7B317625D2CC1 } },
+	{ { 0x27D66258BACD96A3, 0xEB335B365C87D594 }, { 0xFCE1A053E621438B, 0x6D60C76E8C45BF0B } },
+	{ { 0x2BC89F9F424DE548, 0x5DE7CE03B2514953 }, { 0xFC3A6170F767AC73, 0x5D63D99A9D439E1E } },
+	{ { 0x2FB8205F75E56A2B, 0x56A1C4792F856258 }, { 0xFB835EFCF670DD2C, 0xE6FE7924697EEA14 } },
+	{ { 0x33A4A5A19D862467, 0x10F602C44DF4FA51 }, { 0xFABCA467FB3CB8F1, 0xD069F01D8EA33ADE } },
+	{ { 0x378DF09DB8C332CE, 0x0D2B53D865582E45 }, { 0xF9E63E1D9E8B6F6F, 0x2E296BAE5B5ED9C1 } },
+	{ { 0x3B73C2BF6B4B9F66, 0x8EF9499C81F0D965 }, { 0xF90039843324F9B9, 0x40416C1984B6CBED } },
+	{ { 0x3F55DDA9E62AED75, 0x13BD7B8E6A3D1636 }, { 0xF80AA4FBEF750BA7, 0x83D33CB95F94F8A4 } },
+	{ { 0x4334033BCD90D660, 0x4F5F36C1D4B84452 }, { 0xF7058FDE0788DFC8, 0x05B8FE88789E4F42 } },
+	{ { 0x470DF5931AE1D946, 0x076FE0DCFF47FE32 }, { 0xF5F10A7BB77D3DFA, 0x0C1DA8B578427833 } },
+	{ { 0x4AE37710FAD27C8A, 0xA9C4CF96C03519BA }, { 0xF4CD261D3E6C15BB, 0x369C8758630D2AC0 } },
+	{ { 0x4EB44A5DA74F6002, 0x07AAA090F0734E29 }, { 0xF399F500C9E9FD37, 0xAE9957263DAB8877 } },
+	{ { 0x5280326C3CF48182, 0x3BA6BB08EAC82C21 }, { 0xF2578A595224DD2E, 0x6BFA2EB2F99CC675 } },
+	{ { 0x5646F27E8BD65CBE, 0x3A5D61FF06572291 }, { 0xF105FA4D66B607A6, 0x7D44E04272520443 } },
+	{ { 0x5A084E28E35FDA27, 0x76DFDBBB5531D74D }, { 0xEFA559F5EC3AEC3A, 0x4EB03319278A2D42 } },
+	{ { 0x5DC40955D9084F48, 0xA94675A2498DE5D8 }, { 0xEE35BF5CCAC89052, 0xCD91DDB734D3A47E } },
+	{ { 0x6179E84A09A5258A, 0x40E9B5FACE03E526 }, { 0xECB7417B8D4EE3FE, 0xC37ABA4073AA48F2 } },
+	{ { 0x6529AFA7D51B1296, 0x31EC197C0A840A12 }, { 0xEB29F839F201FD13, 0xB93796827916A78F } },
+	{ { 0x68D3247314332797, 0x3BC712BCC4CCDDC4 }, { 0xE98DFC6C6BE031E6, 0x0DD3089CBDD18A76 } },
+	{ { 0x6C760C14C8585A51, 0xDBD34660AE6C52AC }, { 0xE7E367D2956CFB16, 0xB6AA11E5419CD005 } },
+	{ { 0x70122C5EC5028C8C, 0xFF33ABF4FD340CCC }, { 0xE62A551594B970A7, 0x70B15D41D4C0E484 } },
+	{ { 0x73A74B8F52947B68, 0x1BAF6928EB3FB021 }, { 0xE462DFC670D421AB, 0x3D1A15901228F147 } },
+	{ { 0x77353054CA72690D, 0x4C6E171FD99E6B3A }, { 0xE28D245C58BAEF72, 0x225E232ABC003C43 } },
+	{ { 0x7ABBA1D12C17BFA1, 0xD92F0D93F60DED9A }, { 0xE0A94032DBEA7CED, 0xBDDD9DA2FAFAD985 } },
+	{ { 0x7E3A679DAAF25C67, 0x6542BCB4028D0964 }, { 0xDEB7518814A7A931, 0xBBCC88C109CD41C5 } },
+	{ { 0x81B149CE34CAA5A4, 0xE650F8D09FD4D6AA }, { 0xDCB7777AC4207051, 0x68F31E3EB780CE9D } },
+	{ { 0x852010F4F0800521, 0x378BD8DD614753D1 }, { 0xDAA9D20860827063, 0xFDE51C09E855E993 } },
+	{ { 0x88868625B4E1DBB2, 0x3133101330225272 }, { 0xD88E820B1526311D, 0xD561EFBC0C1A9A53 } },
+	{ { 0x8BE472F9776D809A, 0xF2B88171243D63D6 }, { 0xD665A937B4EF2B1F, 0x6D51BAD6D988A442 } },
+	{ { 0x8F39A191B2BA6122, 0xA3FA4F41D5A3FFD4 }, { 0xD42F6A1B9F0168CD, 0xF031C2F63C8D9305 } },
+	{ { 0x9285DC9BC45DD9EA, 0x3D02457BCCE59C41 }, { 0xD1EBE81A95EE752E, 0x48A26BCD32D6E923 } },
+	{ { 0x95C8EF544210EC0B, 0x91C49BD2AA09E851 }, { 0xCF9B476C897C25C5, 0xBFE750DD3F308EAF } },
+	{ { 0x9902A58A45E27BED, 0x68412B426B675ED5 }, { 0xCD3DAD1B5328A2E4, 0x59F993F4F510881A } },
+	{ { 0x9C32CBA2B14156EF, 0x05256C4F857991CA }, { 0xCAD33F00658FE5E8, 0x204BBC0F3A66A0E7 } },
+	{ { 0x9F592E9B66A9CF90, 0x6A3C7AA3C1019985 }, { 0xC85C23C26ED7B6F0, 0x14EF546C47929682 } },
+	{ { 0xA2759C0E79C35582, 0x527C32B55F5405C2 }, { 0xC5D882D2EE48030C, 0x7C07D28E981E3480 } },
+	{ { 0xA587E23555BB0808, 0x6D02B9C662CDD293 }, { 0xC348846BBD363133, 0x8FFE2BFE9DD1381A } },
+	{ { 0xA88FCFEBD9A8DD47, 0xE2F3C76EF9E24399 }, { 0xC0AC518C8B6AE710, 0xBA37A3EEB90CB15B } },
+	{ { 0xAB8D34B36ACD9872, 0x10ED343EC65D7E3B }, { 0xBE0413F84F2A771C, 0x614946A88CBF4DA2 } },
+	{ { 0xAE7FE0B5FC786B2D, 0x966E1D6AF140A488 }, { 0xBB4FF632A908F73E, 0xC151839CB9D993B5 } },
+	{ { 0xB167A4C90D63C424, 0x4CF5493B7CC23BD4 }, { 0xB890237D3BB3C284, 0xB614A0539016BFA1 } },
+	{ { 0xB44452709A597529, 0x05913765434A59D1 }, { 0xB5C4C7D4F7DAE915, 0xAC786CCF4B1A498D } },
+};
+
+// atan(i/64)
+static const x87_wide_t x87_atan_table[65] =
+{
+	{ 0x0000000000000000, 0x0000000000000000, -65536, false },
+	{ 0xFFFAAADDDB94D5BB, 0xE78C564015F76048, -7, false },
+	{ 0xFFEAADDD4BB12542, 0x779D776DDA8C6214, -6, false },
+	{ 0xBFDC0C2186D14FCF, 0x220E10D61DF56EC7, -5, false },
+	{ 0xFFAADDB967EF4E36, 0xCB2792DC0E2E0D51, -5, false },
+	{ 0x9FACF873E2ACEB58, 0x99C50BBF08E6CDF6, -4, false },
+	{ 0xBF70C13017887460, 0x93567E784CF83676, -4, false },
+	{ 0xDF1CF5F3783E1BEF, 0x71E5340B30E5D9EF, -4, false },
+	{ 0xFEADD4D5617B6E32, 0xC897989F3E888EF8, -4, false },
+	{ 0x8F0FD7D821B93725, 0xBD37592983A0AF9A, -3, false },
+	{ 0x9EB77746331362C3, 0x47619D250360FE85, -3, false },
+	{ 0xAE4C08F1F6134EFA, 0xB54D3FEF0C2DE994, -3, false },
+	{ 0xBDCBDA5E72D81134, 0x7B0B4F881C9C7488, -3, false },
+	{ 0xCD35474B643130E7, 0xB00F3DA1A46EEB3B, -3, false },
+	{ 0xDC86BA9493051022, 0xF621A5C1CB552F03, -3, false },
+	{ 0xEBBEAEF902B9B38C, 0x91A2A68B2FBD78E8, -3, false },
+	{ 0xFADBAFC96406EB15, 0x6DC79EF5F7A217E6, -3, false },
+	{ 0x84EE2CBEC31B12C5, 0xC8E721970CABD3A3, -2, false },
+	{ 0x8C5FAD185F8BC130, 0xCA4748B1BF88298D, -2, false },
+	{ 0x93C1B902BF7A2DF1, 0x064592406FE1447A, -2, false },
+	{ 0x9B13B9B83F5E5E69, 0xC5ABB498D27AF328, -2, false },
+	{ 0xA25521B615784D45, 0x4378754988B8D9E3, -2, false },
+	{ 0xA9856CCA8E6A4EDA, 0x99B7F77BF7D9E8C1, -2, false },
+	{ 0xB0A420184E7F0CB1, 0xB51D51DC200A0FC3, -2, false },
+	{ 0xB7B0CA0F26F78473, 0x8AA32122DCFE4483, -2, false },
+	{ 0xBEAB025B1D9FBAD3, 0x910B856493411026, -2, false },
+	{ 0xC59269CA50D92B6D, 0xA1746E91F50A28DE, -2, false },
+	{ 0xCC66AA2A6B58C33C, 0xD9311FA14ED9B7C4, -2, false },
+	{ 0xD327761E611FE5B6, 0x427C95E9001E7136, -2, false },
+	{ 0xD9D488ED32E3635C, 0x30F6394A0806345D, -2, false },
+	{ 0xE06DA64A764F7C67, 0xC631ED96798CB804, -2, false },
+	{ 0xE6F29A19609A84BA, 0x60B77CE1CA6DC2C8, -2, false },
+	{ 0xED63382B0DDA7B45, 0x6FE445ECBC3A8D03, -2, false },
+	{ 0xF3BF5BF8BAD1A21C, 0xA7B837E686ADF3FA, -2, false },
+	{ 0xFA06E85AA0A0BE5C, 0x66D23C7D5DC8ECC2, -2, false },
+	{ 0x801CE39E0D205C99, 0xA6D6C6C54D938596, -1, false },
+	{ 0x832BF4A6D9867E2A, 0x4B6A09CB61A515C1, -1, false },
+	{ 0x8630A2DADA1ED065, 0xD3E84ED5013CA37E, -1, false },
+	{ 0x892AECDFDE9547B5, 0x094478FC472B4AFC, -1, false },
+	{ 0x8C1AD445F3E09B8C, 0x439D801860205921, -1, false },
+	{ 0x8F005D5EF7F59F9B, 0x5C835E1665C43748, -1, false },
+	{ 0x91DB8F1664F350E2, 0x10E4F9C1126E0220, -1, false },
+	{ 0x94AC72C9847186F6, 0x18C4F393F78A32F9, -1, false },
+	{ 0x97731420365E538B, 0xABD3FE19F1AEB6B3, -1, false },
+	{ 0x9A2F80E671BDDA20, 0x4226F8E2204FF3BD, -1, false },
+	{ 0x9CE1C8E6A0B8CDB9, 0xF799C4E8174CF11C, -1, false },
+	{ 0x9F89FDC4F4B7A1EC, 0xF8B492644F0701E0, -1, false },
+	{ 0xA22832DBCADAAE08, 0x92FE9C08637AF0E6, -1, false },
+	{ 0xA4BC7D1934F70924, 0x19A87F2A457DAC9F, -1, false },
+	{ 0xA746F2DDB7602294, 0x67B7D66F2D74E019, -1, false },
+	{ 0xA9C7ABDC4830F5C8, 0x916A84B5BE7933F6, -1, false },
+	{ 0xAC3EC0FB997DD6A1, 0xA36273A56AFA8EF4, -1, false },
+	{ 0xAEAC4C38B4D8C080, 0x14725E2F3E52070A, -1, false },
+	{ 0xB110688AEBDC6F6A, 0x43D65788B9F6A7B5, -1, false },
+	{ 0xB36B31C91F043691, 0x590141744462F93A, -1, false },
+	{ 0xB5BCC49059ECC4AF, 0xF8F3CEE75E3907D5, -1, false },
+	{ 0xB8053E2BC2319E73, 0xCB2DA55210A4443D, -1, false },
+	{ 0xBA44BC7DD470782F, 0x654C2CB10942E386, -1, false },
+	{ 0xBC7B5DEAE98AF280, 0xD4113006E80FB290, -1, false },
+	{ 0xBEA94144FD049AAC, 0x1043C5E755282E7D, -1, false },
+	{ 0xC0CE85B8AC526640, 0x89DD62C46E92FA25, -1, false },
+	{ 0xC2EB4ABB661628B5, 0xB373FE45C61BB9FB, -1, false },
+	{ 0xC4FFAFFABF8FBD54, 0x8CB43D10BC9E0221, -1, false },
+	{ 0xC70BD54CE602EE13, 0xE7D54FBD09F2BE38, -1, false },
+	{ 0xC90FDAA22168C234, 0xC4C6628B80DC1CD1, -1, false },
+};
+
+// 2^(i/64)-1 for i from -64 to 64
+static const x87_wide_t x87_exp2m1_table[129] =
+{
+	{ 0x8000000000000000, 0x0000000000000000, -1, true },
+	{ 0xFD365C1887F9F119, 0x083535B085D64217, -2, true },
+	{ 0xFA64F2CEA7A8BC51, 0x83AB7149735BE802, -2, true },
+	{ 0xF78BAE78A6437F73, 0xCA0DA26BD805D4FC, -2, true },
+	{ 0xF4AA7930676F09D6, 0x746D48E7BD567C9C, -2, true },
+	{ 0xF1C13CD2C2E5DFDF, 0x8BD1B075095AAD54, -2, true },
+	{ 0xEECFE2FEDA4AF5B1, 0x440E5126CE73153A, -2, true },
+	{ 0xEBD655156D2204CB, 0xEFE6BC4DA792FE7C, -2, true },
+	{ 0xE8D47C382AE85232, 0x08373AF14EB586E0, -2, true },
+	{ 0xE5CA41490348AC34, 0x967096D2E37CA594, -2, true },
+	{ 0xE2B78CE97465587F, 0xA47FD766F0F85675, -2, true },
+	{ 0xDF9C4779D7329C47, 0x114FD6AF6D62F03B, -2, true },
+	{ 0xDC785918A9DC7993, 0xE0524E3EA34A6C50, -2, true },
+	{ 0xD94BA9A1D8322DA8, 0x598CD7E2C4DB6232, -2, true },
+	{ 0xD61620AE0211ED3D, 0xA2EA0A5DB55C4357, -2, true },
+	{ 0xD2D7A591BFCF4BFF, 0x6E2AC92F8AC7BA76, -2, true },
+	{ 0xCF901F5CE48EAD21, 0x72A5B9CFA37A1213, -2, true },
+	{ 0xCC3F74D9BE900B36, 0x379EF269969406A3, -2, true },
+	{ 0xC8E58C8C5563558E, 0xBAAFD0BAB86781C2, -2, true },
+	{ 0xC5824CB1A600915E, 0x436D661F5E2CC9EA, -2, true },
+	{ 0xC2159B3EDCBDDCA4, 0xBEDDC1EC288C045D, -2, true },
+	{ 0xBE9F5DE08D1D607B, 0xCDA470C249E04CAD, -2, true },
+	{ 0xBB1F79F9E76D2FCE, 0xC90BF620FE6042B1, -2, true },
+	{ 0xB795D4A3EC32FEC3, 0xE5C496F9D0FC3C23, -2, true },
+	{ 0xB40252AC9D5D8E2B, 0xC685013BD1DF1FCA, -2, true },
+	{ 0xB064D8962D35952C, 0xC2749655F8C11AA2, -2, true },
+	{ 0xACBD4A962B07E20F, 0x57C3B627959C0B1A, -2, true },
+	{ 0xA90B8C94AD825991, 0x34FFB89B14C3FF0D, -2, true },
+	{ 0xA54F822B7ABD6A73, 0x6CFEAE6E14CBA277, -2, true },
+	{ 0xA1890EA52DEB7916, 0x41B3DFC668995F9B, -2, true },
+	{ 0x9DB814FC5AA7B4E0, 0xF05F902D25BD44E3, -2, true },
+	{ 0x99DC77DAADDDB6ED, 0x8261D6470CEB5CC8, -2, true },
+	{ 0x95F619980C4336F7, 0x4D04EC99156A82C2, -2, true },
+	{ 0x9204DC39AE5D10DD, 0xF1D341E44557CB4C, -2, true },
+	{ 0x8E08A1713A08C22D, 0xC8F0D10F532934BD, -2, true },
+	{ 0x8A014A9BD9837409, 0x1655CC5B74D8F8E8, -2, true },
+	{ 0x85EEB8C14FE79282, 0xAEFDC09325E0A10C, -2, true },
+	{ 0x81D0CC930B19DEFA, 0x2FD45EA8681E8F5F, -2, true },
+	{ 0xFB4ECCD6663DAEA6, 0x0EEA0A996BFDE12A, -3, true },
+	{ 0xF2E4CC976DA26FE3, 0x7C4DEA7B5D1F16F6, -3, true },
+	{ 0xEA6357BAABE4948B, 0x0754BCDA6C898322, -3, true },
+	{ 0xE1CA2CDD51193A8C, 0xFB17471A24FF6207, -3, true },
+	{ 0xD91909E647436175, 0xFC781B57EBBA5A07, -3, true },
+	{ 0xD04FAC0436360E8C, 0x2DBE0DC2E850248C, -3, true },
+	{ 0xC76DCFAB81EDFC70, 0x7729F1C1A834E44A, -3, true },
+	{ 0xBE733094435369AC, 0xA4AE8E6A996CABF8, -3, true },
+	{ 0xB55F89B83B546E97, 0xB76DC6A0F086FF5F, -3, true },
+	{ 0xAC329550C0481782, 0x9B78840167674E95, -3, true },
+	{ 0xA2EC0CD4A58A542F, 0x1965D119BF4B0088, -3, true },
+	{ 0x998BA8F61D40A128, 0x05E3084D707B5151, -3, true },
+	{ 0x901121A0943722AB, 0x09EFCA958759566F, -3, true },
+	{ 0x867C2DF687C5BB70, 0x8BE174985EE65E9C, -3, true },
+	{ 0xF999089EAB58F777, 0xCD3B57DB916661AF, -4, true },
+	{ 0xE603B46A0BAD2D77, 0xB200B7C3533F8898, -4, true },
+	{ 0xD237C8C41BE5BABF, 0x0D0B85AD8922789B, -4, true },
+	{ 0xBE34AD7E1DA11CBC, 0x3743797A9C79C110, -4, true },
+	{ 0xA9F9C8C116DE3689, 0x7E9452647C8D582A, -4, true },
+	{ 0x95867F09335EA3DC, 0xFF96924ACDA0276E, -4, true },
+	{ 0x80DA3321192851A5, 0xCD4F184B5B923769, -4, true },
+	{ 0xD7E88C3A6004EC61, 0x767F563370B85B4D, -5, true },
+	{ 0xADA82EADB7933D38, 0x462F3851267F03C9, -5, true },
+	{ 0x82F208CF52EC4470, 0x16F2B6929F049151, -5, true },
+	{ 0xAF89A491BABF98B0, 0x7B489D79D4500670, -6, true },
+	{ 0xB07CFCC2DE4FA2DE, 0xB03169B387C47F3E, -7, true },
+	{ 0x0000000000000000, 0x0000000000000000, -65536, false },
+	{ 0xB268F9DE0183B9BD, 0xF2B293DE8A6F7A4F, -7, false },
+	{ 0xB361A62B0AE875CF, 0x8A91D6D19482FFCA, -6, false },
+	{ 0x874518759BC808C3, 0x5F25D9427FA2B042, -5, false },
+	{ 0xB5586CF9890F6298, 0xB92B71842A983643, -5, false },
+	{ 0xE3EC32D3D1A20207, 0x42E4F8AF6A552AC5, -5, false },
+	{ 0x8980E8092DA85275, 0xDF8D76C98C67562E, -4, false },
+	{ 0xA14D575496EFD9A0, 0x80CA1D92C3680C22, -4, false },
+	{ 0xB95C1E3EA8BD6E6F, 0xBE4628758A53C902, -4, false },
+	{ 0xD1ADF5B7E5BA9E5B, 0x4C7B4968E41AD362, -4, false },
+	{ 0xEA4398B45CD53C02, 0xDC0144C8783D4C5A, -4, false },
+	{ 0x818EE218A3358EE3, 0xBAC0A5424A743F12, -3, false },
+	{ 0x8E1E9B9D588E19B0, 0x7EB6C70572D64EC1, -3, false },
+	{ 0x9AD159789F37495E, 0x99CCA074EC927739, -3, false },
+	{ 0xA7A77D47F7B84B09, 0x7457D6892A8EF2A2, -3, false },
+	{ 0xB4A169B900C2D002, 0x4754DB41D4E11627, -3, false },
+	{ 0xC1BF828C6DC54B7A, 0x356918C17217B7B3, -3, false },
+	{ 0xCF022C9905BFD327, 0x21843659A5AFE574, -3, false },
+	{ 0xDC69CDCEAA72A9C5, 0x1540BD151E61F8F8, -3, false },
+	{ 0xE9F6CD3967FDBA86, 0xF24A6782874CD859, -3, false },
+	{ 0xF7A993048D088D6D, 0x0488F84F5DCFEE8B, -3, false },
+	{ 0x82C1443EE5C53F08, 0x64B71E7B6C3F66A6, -2, false },
+	{ 0x89C10C0C3125A062, 0x6DE813BE033F7A9E, -2, false },
+	{ 0x90D456B8279A0278, 0x3476D20C5E0787BB, -2, false },
+	{ 0x97FB5AA6C544E3A8, 0x72F5FD885C41C06C, -2, false },
+	{ 0x9F364ED3A594D5A6, 0x7B16D3540E7DCABC, -2, false },
+	{ 0xA6856AD3A9F03BE1, 0x507893B0D4C7E9CD, -2, false },
+	{ 0xADE8E6D6A4FB4CDD, 0x96008EC9D67801E6, -2, false },
+	{ 0xB560FBA90A852B19, 0x2602A323D668BB12, -2, false },
+	{ 0xBCEDE2B5A4290DD3, 0x7C9840732ECD40CB, -2, false },
+	{ 0xC48FD6074AB0963E, 0x1F40DFA5B485763A, -2, false },
+	{ 0xCC47104AA4449224, 0xFB3C5371E6294670, -2, false },
+	{ 0xD413CCCFE7799211, 0x65F626CDD52AFA7C, -2, false },
+	{ 0xDBF6478CA345DE44, 0x1C597C3775506968, -2, false },
+	{ 0xE3EEBD1D8BEE7BA4, 0x6E1E5DE159AD9687, -2, false },
+	{ 0xEBFD6AC84CF917ED, 0xD3546749164E0E30, -2, false },
+	{ 0xF4228E7D6030DAFA, 0xA2047ED9B43EBDE8, -2, false },
+	{ 0xFC5E66D9E9CC420B, 0xA05742AF2FC2E143, -2, false },
+	{ 0x82589994CCE128AC, 0xF88AFAB34A010F6B, -1, false },
+	{ 0x868D99B4492EC80E, 0x41D90AC251707485, -1, false },
+	{ 0x8ACE5422AA0DB5BA, 0x7C55A192C9BB3E6F, -1, false },
+	{ 0x8F1AE991577362B9, 0x82745C72ED804EFD, -1, false },
+	{ 0x93737B0CDC5E4F45, 0x01C3F2540A22D2FC, -1, false },
+	{ 0x97D829FDE4E4F8B9, 0xE920F91E8BD7EDBA, -1, false },
+	{ 0x9C49182A3F0901C7, 0xC46B071F2BE58DDB, -1, false },
+	{ 0xA0C667B5DE564B29, 0xADA8B8CAB349AA04, -1, false },
+	{ 0xA5503B23E255C8B4, 0x24491CAF87BC8051, -1, false },
+	{ 0xA9E6B5579FDBF43E, 0xB243BDFF4C4C58B5, -1, false },
+	{ 0xAE89F995AD3AD5E8, 0x734D1773205A7FBC, -1, false },
+	{ 0xB33A2B84F15FAF6B, 0xFD0E7BD947C25758, -1, false },
+	{ 0xB7F76F2FB5E46EAA, 0x7B081AB53C5354C9, -1, false },
+	{ 0xBCC1E904BC1D2247, 0xBA0F45B3D08CD0B2, -1, false },
+	{ 0xC199BDD85529C222, 0x0CB12A091BA66794, -1, false },
+	{ 0xC67F12E57D14B4A2, 0x137FD20F2B301DDA, -1, false },
+	{ 0xCB720DCEF9069150, 0x3CBD1E949DB761D9, -1, false },
+	{ 0xD072D4A07897B8D0, 0xF22F21A158E18FBC, -1, false },
+	{ 0xD5818DCFBA48725D, 0xA05AEB66E0DCA9F6, -1, false },
+	{ 0xDA9E603DB3285708, 0xC01A5B6D4C97F624, -1, false },
+	{ 0xDFC97337B9B5EB96, 0x8CAC39ED291B7226, -1, false },
+	{ 0xE502EE78B3FF6273, 0xD130153991E8F496, -1, false },
+	{ 0xEA4AFA2A490D9858, 0xF73A18F5DB301F87, -1, false },
+	{ 0xEFA1BEE615A27771, 0xFD21A92DAC1F6DD6, -1, false },
+	{ 0xF50765B6E4540674, 0xF84B762862BAFF99, -1, false },
+	{ 0xFA7C1819E90D82E9, 0x0A7E74B263C1DC06, -1, false },
+	{ 0x8000000000000000, 0x0000000000000000, 0, false },
+};
+
+// log2(i/64) for i from 48 to 96
+static const x87_wide_t x87_log2_table[49] =
+{
+	{ 0xD47FCB8C0852F0C0, 0xBFE9DBEBF2E8A45E, -2, true },
+	{ 0xC544C055FDE99333, 0x54DBF16FB0695EE3, -2, true },
+	{ 0xB6587B432E47501B, 0x6D40900B25024B32, -2, true },
+	{ 0xA7B7DD96762CC3C7, 0x2742D7296A39EED6, -2, true },
+	{ 0x995FF71B8773432D, 0x124BC6F1ACF95DC4, -2, true },
+	{ 0x8B4E029B1F8AC391, 0xA87C02EAF36E2C29, -2, true },
+	{ 0xFAFEC54831F1A484, 0x7F7B2787B173DA32, -3, true },
+	{ 0xDFE33D3FFFA66037, 0x815EF705CFAEF035, -3, true },
+	{ 0xC544C055FDE99333, 0x54DBF16FB0695EE3, -3, true },
+	{ 0xAB1EE14FFD659064, 0x3906F29BBE579929, -3, true },
+	{ 0x916D6E1559A4B696, 0x91D79938E7226384, -3, true },
+	{ 0xF058D74797EAB325, 0x9D2C6D9213F3F83C, -4, true },
+	{ 0xBEB024B67DDA6339, 0xDA288FC615A727DC, -4, true },
+	{ 0x8DD9953002A4E866, 0x31514AEF39CE6303, -4, true },
+	{ 0xBB9CA64ECAC6AAEF, 0x2E1C07F0438EBAC0, -5, true },
+	{ 0xBA1F7430F9AAB1B2, 0xA41B08FBE05F82D0, -6, true },
+	{ 0x0000000000000000, 0x0000000000000000, -65536, false },
+	{ 0xB73CB42E16914C53, 0x713F108C0857CA30, -6, false },
+	{ 0xB5D69BAC77EC3989, 0xB03784B5BE084906, -5, false },
+	{ 0x8759C4FD14FCD59E, 0x7BA5D5CCC90B8336, -4, false },
+	{ 0xB31FB7D64898B3E6, 0x629C130A22BAD61E, -4, false },
+	{ 0xDE4212056D5DD31D, 0x962D3728CBD5C3CB, -4, false },
+	{ 0x8462C466D3CF1CB1, 0x3DE37E852A9455EA, -3, false },
+	{ 0x99574F13C570D0FA, 0x8F9603AD3A5D326D, -3, false },
+	{ 0xAE00D1CFDEB43CFD, 0x00589050345D6E89, -3, false },
+	{ 0xC2615E81781D97EE, 0x9124773B1D4AB87C, -3, false },
+	{ 0xD67AF16DA7649F7F, 0x08F65E00C1B1A5A9, -3, false },
+	{ 0xEA4F726192CB7E47, 0xA5AB2811D02A20E0, -3, false },
+	{ 0xFDE0B5C81340511D, 0x46CCC53C2779AF92, -3, false },
+	{ 0x88983ED6985BAE58, 0x4B82D3CAD274FE0D, -2, false },
+	{ 0x92203D587039CC12, 0x2DCA5D22601DFDDF, -2, false },
+	{ 0x9B892675266F66CC, 0x899B64B03F7230DD, -2, false },
+	{ 0xA4D3C25E68DC57F2, 0x495FB7FA6D7EDA67, -2, false },
+	{ 0xAE00D1CFDEB43CFD, 0x00589050345D6E89, -2, false },
+	{ 0xB7110E6CE866F2BC, 0x6A905A27B81E2219, -2, false },
+	{ 0xC0052B18B0E2A195, 0x75B04FA6FBD6446C, -2, false },
+	{ 0xC8DDD448F8B845A5, 0x95A82B5C34E2AC31, -2, false },
+	{ 0xD19BB053FB0284EB, 0xE206BCBCF62D8FEE, -2, false },
+	{ 0xDA3F5FB9C4150520, 0xA377C7EC513C756E, -2, false },
+	{ 0xE2C97D694ADAB3F3, 0xF72A5777998629E0, -2, false },
+	{ 0xEB3A9F01975077F1, 0xF5F0CC82AAA9AD7E, -2, false },
+	{ 0xF393550F3AA69062, 0x8CF097A388999ABD, -2, false },
+	{ 0xFBD42B4658367670, 0xC98C002287AD91AB, -2, false },
+	{ 0x81FED45CBCCBF99C, 0xA1A3202B3D68F965, -1, false },
+	{ 0x86082806B1D532C4, 0x12BA94DB12EF0AA8, -1, false },
+	{ 0x8A064FD50F2A1CF0, 0xAD29518B0252C225, -1, false },
+	{ 0x8DF988F4AE806F1D, 0xA89D4EE66C3700E4, -1, false },
+	{ 0x91E20EA1393E4040, 0x76630D4C409DD918, -1, false },
+	{ 0x95C01A39FBD6879F, 0xA00B120A068BADD1, -1, false },
+};
+
+// reciprocals r = R 2^-16 of i/128 for i from 96 to 192, with -log2(r) as fixed point numbers with 112 fraction bits
+static const uint64_t x87_log2_fast_table[97][3] =
+{
+	{ 0x15555, 0xFFFF95C0768F24F5, 0xDB4A9F24892A0DD2 },
+	{ 0x151D0, 0xFFFF99946DD56B3C, 0x32251FF840414A1B },
+	{ 0x14E5E, 0xFFFF9D5DAB5FA4EB, 0xF6B7952D1DD3F8C6 },
+	{ 0x14AFD, 0xFFFFA11DFA41E42E, 0x257D3C8C3B70B1D7 },
+	{ 0x147AE, 0xFFFFA4D3D973B0FA, 0x2DB822961B1FCC49 },
+	{ 0x14470, 0xFFFFA88001B8B2E0, 0xABB12C6F456A2980 },
+	{ 0x14141, 0xFFFFAC245C39F490, 0xF29F2D5772E9C0DE },
+	{ 0x13E23, 0xFFFFAFBE430919DC, 0x5802FA1C26DD9A38 },
+	{ 0x13B14, 0xFFFFB34FA81D2A3C, 0x5223A3FC4DB9C372 },
+	{ 0x13814, 0xFFFFB6D835497F32, 0xC3FB00A534D801F8 },
+	{ 0x13522, 0xFFFFBA58C4FD423F, 0xD8E939967B190D21 },
+	{ 0x1323E, 0xFFFFBDD1074431E1, 0xDFF6FE31DC3C88F8 },
+	{ 0x12F68, 0xFFFFC140AB031CA2, 0xEA89DF3AAD3E1AE9 },
+	{ 0x12CA0, 0xFFFFC4A75E032572, 0x4DBDA2386FFB6F51 },
+	{ 0x129E4, 0xFFFFC80747C54834, 0x3DB7F8DEA563EADF },
+	{ 0x12735, 0xFFFFCB5EE502B297, 0x0D323E2555EEA7F9 },
+	{ 0x12492, 0xFFFFCEAF2C3FA9A4, 0xEEDE29E27AC41B2C },
+	{ 0x121FB, 0xFFFFD1F7D8898968, 0x4F119B694E5787A1 },
+	{ 0x11F70, 0xFFFFD538A40129C5, 0xEF91F0D7BA7917B0 },
+	{ 0x11CF0, 0xFFFFD87293B5AC9A, 0x5A9EFAD2814782C8 },
+	{ 0x11A7C, 0xFFFFDBA419FB172F, 0xB71C3DAFA2C2DC6E },
+	{ 0x11812, 0xFFFFDECF918C1440, 0x5A848E54DCB3D0BD },
+	{ 0x115B2, 0xFFFFE1F4C277238A, 0x6741F457F60FB37B },
+	{ 0x1135D, 0xFFFFE5121CA8824A, 0x8FB54B90058E3180 },
+	{ 0x11111, 0xFFFFE82A127E7862, 0x895E9DF1512C9C16 },
+	{ 0x10ECF, 0xFFFFEB3B154EB829, 0x5236F76E7D9DFA14 },
+	{ 0x10C97, 0xFFFFEE44EA349A0A, 0x63626F43C3C3AD32 },
+	{ 0x10A68, 0xFFFFF148B885B827, 0xD6C3AE89A2434165 },
+	{ 0x10842, 0xFFFFF4464CB05B71, 0x6B16E654A2A65A92 },
+	{ 0x10625, 0xFFFFF73D728068D5, 0x67DE63AE64C473F8 },
+	{ 0x10410, 0xFFFFFA2F60B3A151, 0xFE1D69F89ED82843 },
+	{ 0x10204, 0xFFFFFD1A7C1661F2, 0x5B65D3F80D4644CF },
+	{ 0x10000, 0x0000000000000000, 0x0000000000000000 },
+	{ 0x0FE04, 0x000002DFBE8C3A5C, 0x9EFC46D9F6F75FC1 },
+	{ 0x0FC10, 0x000005B9894C5EAA, 0x7E1CC8AC29B6FA31 },
+	{ 0x0FA23, 0x0000088EAB47BCD3, 0x465735D489499296 },
+	{ 0x0F83E, 0x00000B5D80D00F9C, 0x995E7439DB70BAAB },
+	{ 0x0F660, 0x00000E2759B1AE75, 0x03257B95AC13250A },
+	{ 0x0F48A, 0x000010EA8B8033BC, 0x2F2F285E37CB7F78 },
+	{ 0x0F2BA, 0x000013A9F062A910, 0x11EF2E155A447E8C },
+	{ 0x0F0F1, 0x00001663DFE58266, 0x952D45D607C79833 },
+	{ 0x0EF2F, 0x0000191830E69B4A, 0xD0BA6BF68734E71C },
+	{ 0x0ED73, 0x00001BC84805FF90, 0x8FE843A85090F450 },
+	{ 0x0EBBE, 0x00001E7272E1DCB4, 0x5D52466744B8FF92 },
+	{ 0x0EA0F, 0x000021181B0F835C, 0x3C5B609A22CDFB6C },
+	{ 0x0E866, 0x000023B91E7467AA, 0xB31956DAE8998A42 },
+	{ 0x0E6C3, 0x000026555A954E6A, 0xDF742C96EBC82438 },
+	{ 0x0E526, 0x000028ECAC98E83B, 0x873E49371EE118FB },
+	{ 0x0E38E, 0x00002B8090C920CC, 0x62EA3F2F9B34145E },
+	{ 0x0E1FC, 0x00002E0F49DEF0FF, 0x0DD4B23BCDF055CD },
+	{ 0x0E070, 0x00003098B3F58726, 0xB9A6A36294EECE99 },
+	{ 0x0DEE9, 0x0000331E52FC1589, 0x1693C49D92990155 },
+	{ 0x0DD68, 0x0000359E600657CF, 0x1B99EF5FC8B2CA5B },
+	{ 0x0DBEB, 0x0000381C121373EB, 0x5F49929A9A77ACFD },
+	{ 0x0DA74, 0x00003A93F3ADACD0, 0xB557C2A12D29D2D5 },
+	{ 0x0D902, 0x00003D0793145A28, 0x55EBA21A31E4F707 },
+	{ 0x0D794, 0x00003F7889C72DEF, 0x67F250CCA86F1125 },
+	{ 0x0D62C, 0x000041E35024DB98, 0xF1F608125902CDF2 },
+	{ 0x0D4C7, 0x0000444CF4F05E4E, 0x26D79DACB7D2BD7F },
+	{ 0x0D368, 0x000046B02DDF8FDF, 0x97100B047EA39151 },
+	{ 0x0D20D, 0x0000491058616F1B, 0xFB3A8E2C0ABD7B05 },
+	{ 0x0D0B7, 0x00004B6B99B46F1C, 0x9BC1A25C75BA9636 },
+	{ 0x0CF64, 0x00004DC562FA5034, 0x2DA285C7E9BDDD5A },
+	{ 0x0CE17, 0x00005018464A7CA6, 0x205B79C4E85FA636 },
+	{ 0x0CCCD, 0x0000526984DA2264, 0x1FB351D20D2FD0AE },
+	{ 0x0CB87, 0x000054B74013B882, 0x554527E1C891AFB8 },
+	{ 0x0CA46, 0x000056FF8D9E0A32, 0xEAB87BD4FAB596B2 },
+	{ 0x0C908, 0x00005945FA51CE3D, 0x14504474CF8873CD },
+	{ 0x0C7CE, 0x00005B889E4BBC51, 0x4F240E7E90393ADA },
+	{ 0x0C698, 0x00005DC761FF440A, 0xC55798E9B76DF16A },
+	{ 0x0C566, 0x000060022DACA5C5, 0x816E2332B65D988A },
+	{ 0x0C437, 0x0000623ACB3E0245, 0x7D0E7F143B74E421 },
+	{ 0x0C30C, 0x0000646F4679A57B, 0x767DC9ED8CCE21B8 },
+	{ 0x0C1E5, 0x0000669F870CDDC6, 0x8CF0939A1664A132 },
+	{ 0x0C0C1, 0x000068CD5EFA5A8F, 0xEDAB79B4C93B50B7 },
+	{ 0x0BFA0, 0x00006AF8BE3B259C, 0x773190E2CC831E3C },
+	{ 0x0BE83, 0x00006D1FA4523E86, 0x175CA6CEE4ED5935 },
+	{ 0x0BD69, 0x00006F43EB64E1C9, 0x006D08E2410D1185 },
+	{ 0x0BC52, 0x0000716582E9B867, 0x697B2D9703FD2599 },
+	{ 0x0BB3F, 0x00007382613BB4EC, 0xD71869C78C6B511E },
+	{ 0x0BA2F, 0x0000759C68AC49D6, 0xE9E8E47CB740ECCA },
+	{ 0x0B921, 0x000077B586EE2531, 0x6A96C4E4BA9AD435 },
+	{ 0x0B817, 0x000079C9B04CEF38, 0x1DB5D75AF57D9F22 },
+	{ 0x0B710, 0x00007BDACF4D1121, 0x66B65A2C29F52680 },
+	{ 0x0B60B, 0x00007DEAD9D83F15, 0x4AB996C7D8529CAD },
+	{ 0x0B50A, 0x00007FF5B27A3301, 0xA67452E86699D06E },
+	{ 0x0B40B, 0x000081FF59172F2B, 0x35C8A56ECE2D2DFB },
+	{ 0x0B30F, 0x00008405B4710DF5, 0x221C0DDFF375796E },
+	{ 0x0B216, 0x00008608B286782C, 0x2EA5D622A54A4C09 },
+	{ 0x0B120, 0x0000880841358C3D, 0x4793140FA4B0011A },
+	{ 0x0B02C, 0x00008A0666EA5747, 0xF2B6865FB4B0611D },
+	{ 0x0AF3B, 0x00008C00FE591CAA, 0x87FB5D01372BE462 },
+	{ 0x0AE4C, 0x00008DFA137474D7, 0x6AFF6C055F55A550 },
+	{ 0x0AD60, 0x00008FEF7AED9D28, 0x85BD0A03B0E22ECF },
+	{ 0x0AC77, 0x000091E12207693A, 0x7ECB832D9B4B07E2 },
+	{ 0x0AB8F, 0x000093D3441E95BE, 0xA2FBF75C03181EE2 },
+	{ 0x0AAAB, 0x000095BF618FEED7, 0xAAEE872C823956F0 },
+};
+
+// reciprocals r = R 2^-32 of 1 + j 2^-13 for j from -43 to 43, with -log2(r) as fixed point numbers with 112 fraction bits
+static const uint64_t x87_log2p1_fast_table[87][3] =
+{
+	{ 0x10159D0B0, 0xFFFFFE0E67E4582B, 0x7A7EF70E67032B2F },
+	{ 0x10151BB46, 0xFFFFFE1A01EFBB97, 0xA0EF432A98ED0163 },
+	{ 0x10149A65D, 0xFFFFFE259B9F4112, 0xC9827EDED37C5822 },
+	{ 0x1014191F6, 0xFFFFFE3134F16D7F, 0x924BD099C7B6791D },
+	{ 0x101397E12, 0xFFFFFE3CCDE4C591, 0xE180BDB2A7CA4E02 },
+	{ 0x101316AAF, 0xFFFFFE48667C1CA8, 0x8B9E7D15AB2246D1 },
+	{ 0x1012957CE, 0xFFFFFE53FEB5F781, 0xE71700FB1737A0B3 },
+	{ 0x10121456E, 0xFFFFFE5F9693BA17, 0x814EFABA08DF272C },
+	{ 0x101193390, 0xFFFFFE6B2E13E90F, 0x8150A061F1290242 },
+	{ 0x101112234, 0xFFFFFE76C53678AD, 0x6335A36E1399B4B4 },
+	{ 0x10109115A, 0xFFFFFE825BFB5D34, 0x16340E6CC9819E85 },
+	{ 0x101010101, 0xFFFFFE8DF263FAC9, 0x1E8BE3C758F43449 },
+	{ 0x100F8F12A, 0xFFFFFE99886ED5E2, 0x454AE51C48EBAFAC },
+	{ 0x100F0E1D4, 0xFFFFFEA51E1D52BB, 0x0A88356E24961727 },
+	{ 0x100E8D2FF, 0xFFFFFEB0B36F65B6, 0xCA85335AAC436A70 },
+	{ 0x100E0C4AC, 0xFFFFFEBC48639327, 0x088C0B6076AD6594 },
+	{ 0x100D8B6DA, 0xFFFFFEC7DCFB3F68, 0x3EFBC886E019BA06 },
+	{ 0x100D0A98A, 0xFFFFFED37134EEB3, 0xC2F4457E0673CE31 },
+	{ 0x100C89CBA, 0xFFFFFEDF051375AF, 0xF7B2BD95254261A6 },
+	{ 0x100C0906C, 0xFFFFFEEA9893E861, 0x2D644221E2E80A9C },
+	{ 0x100B8849F, 0xFFFFFEF62BB7AB4F, 0xD7BE0A7783C23323 },
+	{ 0x100B07953, 0xFFFFFF01BE7EB2DB, 0x7CA039F06B6B5E73 },
+	{ 0x100A86E89, 0xFFFFFF0D50E78300, 0xFEF52E2971C4C44C },
+	{ 0x100A0643F, 0xFFFFFF18E2F4F0D7, 0x6FB3A3864EDBDCFA },
+	{ 0x100985A76, 0xFFFFFF2474A58066, 0x247D2BB2270173F7 },
+	{ 0x10090512E, 0xFFFFFF3005F9260A, 0x735889FA10E53213 },
+	{ 0x100884866, 0xFFFFFF3B96F146B1, 0x67F5D645A0993B26 },
+	{ 0x100804020, 0xFFFFFF47278AF5A2, 0x4893FB4DC9C57C6D },
+	{ 0x10078385A, 0xFFFFFF52B7C90864, 0xD59A94F75537B64F },
+	{ 0x100703115, 0xFFFFFF5E47AA02C3, 0xF4DB1625A699C783 },
+	{ 0x100682A51, 0xFFFFFF69D72DD91A, 0x421684A4B49BFFD4 },
+	{ 0x10060240E, 0xFFFFFF7566547FC1, 0xCD9B596B6D71BB9A },
+	{ 0x100581E4A, 0xFFFFFF80F520CCBF, 0x1EE99B85819C4DA6 },
+	{ 0x100501908, 0xFFFFFF8C838E620D, 0x4BAA9503B94BF03E },
+	{ 0x100481446, 0xFFFFFF9811A015BB, 0x4F73B705AAFB0FA1 },
+	{ 0x100401004, 0xFFFFFFA39F55DC43, 0xAD5FFADAA0580A4E },
+	{ 0x100380C43, 0xFFFFFFAF2CAE391C, 0xB196168E647A647E },
+	{ 0x100300902, 0xFFFFFFBAB9AA91AC, 0x5F9C0F7584911FC6 },
+	{ 0x100280641, 0xFFFFFFC6464ADA6B, 0x996D93F2653827B2 },
+	{ 0x100200401, 0xFFFFFFD1D28D96AC, 0x6A5AF5857252D313 },
+	{ 0x100180240, 0xFFFFFFDD5E759D27, 0xAB8559D71D59D58D },
+	{ 0x100100100, 0xFFFFFFE8E9FFFFFC, 0x7C3A32A4C88F2275 },
+	{ 0x100080040, 0xFFFFFFF4752E24C7, 0xDF023B21F14F2170 },
+	{ 0x100000000, 0x0000000000000000, 0x0000000000000000 },
+	{ 0x0FFF80040, 0x0000000B8A75861A, 0x80C51536F3F156B0 },
+	{ 0x0FFF00100, 0x00000017148EAB8C, 0x786363469C2A624D },
+	{ 0x0FFE80240, 0x000000229E4B64CA, 0x737E79E0CCECD987 },
+	{ 0x0FFE00400, 0x0000002E27ABA648, 0x745CE7FD13B5D709 },
+	{ 0x0FFD8063F, 0x00000039B0B0D608, 0x1E7E1E7232BAF049 },
+	{ 0x0FFD008FE, 0x0000004539597705, 0x49650D0F864E4CBE },
+	{ 0x0FFC80C3D, 0x00000050C1A57DB2, 0x58A84F6B2DFA626F },
+	{ 0x0FFC00FFC, 0x0000005C4994DE81, 0x25C6D160CD99FC34 },
+	{ 0x0FFB8143A, 0x00000067D128FF9F, 0x564CFBAA5438E899 },
+	{ 0x0FFB018F8, 0x00000073586063D8, 0x6EF09E9027484857 },
+	{ 0x0FFA81E36, 0x0000007EDF3AFF9C, 0xAB50575CE0276C4B },
+	{ 0x0FFA023F3, 0x0000008A65BA393A, 0xB336672EA51434FF },
+	{ 0x0FF982A2F, 0x00000095EBDE0544, 0x4E972131FF87544A },
+	{ 0x0FF9030EB, 0x000000A171A4E654, 0xB0705697BBDC45DF },
+	{ 0x0FF883826, 0x000000ACF71042DB, 0x83650BFED5015217 },
+	{ 0x0FF803FE0, 0x000000B87C200F68, 0xF28B5E100FBFBEB6 },
+	{ 0x0FF78481A, 0x000000C400D2CE73, 0xF44AB45A05CFBF71 },
+	{ 0x0FF7050D3, 0x000000CF8529E68D, 0x36B9ED43FE8AB5D0 },
+	{ 0x0FF685A0B, 0x000000DB09254C43, 0x48AAD4A0F1042489 },
+	{ 0x0FF6063C2, 0x000000E68CC4F424, 0x2FA59723DC0053F9 },
+	{ 0x0FF586DF8, 0x000000F21008D2BD, 0x67F9C9173AF0E256 },
+	{ 0x0FF5078AD, 0x000000FD92F0DC9B, 0xE4CF7266B14A9723 },
+	{ 0x0FF4883E1, 0x00000109157D064C, 0x10381FFB6BE7774C },
+	{ 0x0FF408F94, 0x0000011497AD4459, 0xCB3FFA6BB80C5AB6 },
+	{ 0x0FF389BC6, 0x0000012019818B50, 0x6DFEE1FE4F8D7984 },
+	{ 0x0FF30A877, 0x0000012B9AF9CFBA, 0xC7A99001D9718EF4 },
+	{ 0x0FF28B5A7, 0x000001371C160623, 0x1EA2BD791E57498E },
+	{ 0x0FF20C355, 0x000001429CD795AA, 0xD0C5F50D9797A34C },
+	{ 0x0FF18D182, 0x0000014E1D3D005A, 0x8811E81692413CFC },
+	{ 0x0FF10E02E, 0x000001599D463ABA, 0xF0D8E56791AAF388 },
+	{ 0x0FF08EF58, 0x000001651CF4AC0E, 0x6F0496FDDB2285C5 },
+	{ 0x0FF00FF01, 0x000001709C46D639, 0x72FE5AE45B11F331 },
+	{ 0x0FEF90F28, 0x0000017C1B3E2094, 0x650E53BDB47C4401 },
+	{ 0x0FEF11FCE, 0x0000018799D90CEB, 0x8F8F1C6A2FF7262D },
+	{ 0x0FEE930F2, 0x00000193181902AD, 0x5F6B5AF81CB07A28 },
+	{ 0x0FEE14295, 0x0000019E95FC838D, 0xF932E43A72F0E5EE },
+	{ 0x0FED954B6, 0x000001AA1384F711, 0xCEB68D49D5BC3C7A },
+	{ 0x0FED16755, 0x000001B590B251DF, 0xE99F02A7941657D5 },
+	{ 0x0FEC97A73, 0x000001C10D831588, 0x364BA9B65FCA9F4D },
+	{ 0x0FEC18E0E, 0x000001CC89FA1CD2, 0x4E4BF74E9D2CA913 },
+	{ 0x0FEB9A228, 0x000001D80614762A, 0xEE3EB7146EEFDE6B },
+	{ 0x0FEB1B6C0, 0x000001E381D3894D, 0x955C304ECF3F7288 },
+	{ 0x0FEA9CBD6, 0x000001EEFD374ADE, 0xA5D6C5CAC327C80B },
+};
+
+// series of sin(x)/x and cos(x) in x^2, with alternating signs
+static const uint64_t x87_sin_series[8][2] =
+{
+	{ 0x8000000000000000, 0x0000000000000000 },
+	{ 0x1555555555555555, 0x5555555555555555 },
+	{ 0x0111111111111111, 0x1111111111111111 },
+	{ 0x0006806806806806, 0x8068068068068068 },
+	{ 0x0000171DE3A556C7, 0x338FAAC1C88E5001 },
+	{ 0x00000035CC8ACFEA, 0x89C71FCE8FC97070 },
+	{ 0x000000005849184E, 0xA1B425F28E0CC749 },
+	{ 0x00000000006B9FCF, 0x9CCEE07C476195AC },
+};
+
+static const uint64_t x87_cos_series[8][2] =
+{
+	{ 0x8000000000000000, 0x0000000000000000 },
+	{ 0x4000000000000000, 0x0000000000000000 },
+	{ 0x0555555555555555, 0x5555555555555555 },
+	{ 0x002D82D82D82D82D, 0x82D82D82D82D82D8 },
+	{ 0x0000D00D00D00D00, 0xD00D00D00D00D00D },
+	{ 0x0000024FC9F6EF13, 0xEB8E5DE02DA7D4CD },
+	{ 0x000000047BB63BFE, 0x3625ED5136A61EB4 },
+	{ 0x00000000064E5D2A, 0x301F27482EB7C517 },
+};
+
+// (x - sin x)/x^3 and (1 - cos x)/x^2 as series in x^2 2^14, with alternating signs and 64 fraction bits, for the fast paths
+static const uint64_t x87_sin_fast_series[4] = { 0x2AAAAAAAAAAAAAABU, 0x0000088888888889U, 0x0000000000D00D01U, 0x000000000000000CU };
+static const uint64_t x87_cos_fast_series[4] = { 0x8000000000000000U, 0x00002AAAAAAAAAABU, 0x0000000005B05B06U, 0x0000000000000068U };
+// 4 (e^x - 1 - x - x^2/2)/x^3 as a series in x 2^7, and (x - atan x)/x^3 as a series in x^2 2^14 with alternating signs, for the fast paths
+static const uint64_t x87_expm1_fast_series[7] = { 0xAAAAAAAAAAAAAAABU, 0x0055555555555555U, 0x0000222222222222U, 0x0000000B60B60B61U, 0x0000000003403403U, 0x000000000000D00DU, 0x000000000000002EU };
+static const uint64_t x87_atan_fast_series[5] = { 0x5555555555555555U, 0x0000CCCCCCCCCCCDU, 0x0000000249249249U, 0x0000000000071C72U, 0x0000000000000017U };
+// (v - log(1 + v))/v^2 as a series in v 2^13 with alternating signs, for the fast paths
+static const uint64_t x87_log1p_fast_series[5] = { 0x8000000000000000U, 0x0002AAAAAAAAAAABU, 0x0000001000000000U, 0x0000000000666666U, 0x00000000000002ABU };
+
+// series of (e^x-1)/x
+static const uint64_t x87_expm1_series[13][2] =
+{
+	{ 0x8000000000000000, 0x0000000000000000 },
+	{ 0x4000000000000000, 0x0000000000000000 },
+	{ 0x1555555555555555, 0x5555555555555555 },
+	{ 0x0555555555555555, 0x5555555555555555 },
+	{ 0x0111111111111111, 0x1111111111111111 },
+	{ 0x002D82D82D82D82D, 0x82D82D82D82D82D8 },
+	{ 0x0006806806806806, 0x8068068068068068 },
+	{ 0x0000D00D00D00D00, 0xD00D00D00D00D00D },
+	{ 0x0000171DE3A556C7, 0x338FAAC1C88E5001 },
+	{ 0x0000024FC9F6EF13, 0xEB8E5DE02DA7D4CD },
+	{ 0x00000035CC8ACFEA, 0x89C71FCE8FC97070 },
+	{ 0x000000047BB63BFE, 0x3625ED5136A61EB4 },
+	{ 0x000000005849184E, 0xA1B425F28E0CC749 },
+};
+
+// series of atanh(x)/x in x^2, and of atan(x)/x with alternating signs
+static const uint64_t x87_atan_series[9][2] =
+{
+	{ 0x8000000000000000, 0x0000000000000000 },
+	{ 0x2AAAAAAAAAAAAAAA, 0xAAAAAAAAAAAAAAAB },
+	{ 0x1999999999999999, 0x999999999999999A },
+	{ 0x1249249249249249, 0x2492492492492492 },
+	{ 0x0E38E38E38E38E38, 0xE38E38E38E38E38E },
+	{ 0x0BA2E8BA2E8BA2E8, 0xBA2E8BA2E8BA2E8C },
+	{ 0x09D89D89D89D89D8, 0x9D89D89D89D89D8A },
+	{ 0x0888888888888888, 0x8888888888888889 },
+	{ 0x0787878787878787, 0x8787878787878788 },
+};
+
+static const x87_wide_t X87_WIDE_PI = { 0xC90FDAA22168C234, 0xC4C6628B80DC1CD1, 1, false };
+static const x87_wide_t X87_WIDE_LN2 = { 0xB17217F7D1CF79AB, 0xC9E3B39803F2F6AF, -1, false };
+static const x87_wide_t X87_WIDE_LOG2E = { 0xB8AA3B295C17F0BB, 0xBE87FED0691D3E89, 0, false };
+
+static const x87_wide_t X87_WIDE_ONE = { 0x8000000000000000U, 0, 0, false };
+static const x87_wide_t X87_WIDE_TWO = { 0x8000000000000000U, 0, 1, false };
+
+/* Reduces the argument to at most pi/4 in magnitude and converts it to a fixed point number with 128 fraction bits
+ * Returns the number of quarter turns subtracted, modulo 4
+ * The argument must be at least 2^-7 and below 2^63 in magnitude and have at most 64 significant bits
+ */
+static inline unsigned x87_wide_reduce(x87_wide_t value, uint64_t * high, uint64_t * low, bool * sign)
+{
+	// 66-bit approximation of pi/2 used by the hardware, in units of 2^-65
+	const uint64_t pi_2_high = 0x0000000000000003U;
+	const uint64_t pi_2_low = 0x243F6A8885A308D3U;
+	// 2^129 / (pi/2), rounded down
+	const uint64_t reciprocal = 0xA2F9836E4E44152AU;
+
+	*sign = value.sign;
+	// arguments up to pi/4 are not reduced
+	if(value.exponent < -1 || (value.exponent == -1 && value.high <= 0xC90FDAA22168C234U))
+	{
+		int32_t shift = -1 - value.exponent;
+		*high = value.high >> shift;
+		*low = (value.high << 1) << (63 - shift);
+		return 0;
+	}
+
+	// the argument is an integer of at most 128 bits in units of 2^-65
+	int32_t shift = value.exponent + 2;
+	uint64_t dividend_high = shift == 64 ? value.high : value.high >> (64 - shift);
+	uint64_t dividend_low = shift == 64 ? 0 : value.high << shift;
+
+	// the quotient is estimated from the reciprocal, this is at most 2 below the actual quotient
+	uint64_t product_low, product_high = x87_mul64(value.high, reciprocal, &product_low);
+	shift = 129 - shift;
+	uint64_t quotient = shift >= 128 ? 0 : shift >= 64 ? product_high >> (shift - 64) : (product_high << (64 - shift)) | (product_low >> shift);
+
+	// the remainder is below 2^68, so it can be calculated modulo 2^128
+	uint64_t remainder_low, remainder_high = x87_mul64(quotient, pi_2_low, &remainder_low) + quotient * pi_2_high;
+	remainder_high = dividend_high - remainder_high - (dividend_low < remainder_low);
+	remainder_low = dividend_low - remainder_low;
+	while(remainder_high > pi_2_high || (remainder_high == pi_2_high && remainder_low >= pi_2_low))
+	{
+		remainder_high -= pi_2_high + (remainder_low < pi_2_low);
+		remainder_low -= pi_2_low;
+		quotient ++;
+	}
+
+	if(remainder_high > (pi_2_high >> 1) || (remainder_high == (pi_2_high >> 1) && remainder_low > ((pi_2_high << 63) | (pi_2_low >> 1))))
+	{
+		// the remainder is above pi/4, take the difference to the next multiple of pi/2
+		remainder_high = pi_2_high - remainder_high - (pi_2_low < remainder_low);
+		remainder_low = pi_2_low - remainder_low;
+		*sign = !*sign;
+		quotient ++;
+	}
+
+	*high = (remainder_high << 63) | (remainder_low >> 1);
+	*low = remainder_low << 63;
+	// for negative arguments, the quarter turns are subtracted in the opposite direction
+	return (value.sign ? -(unsigned)quotient : (unsigned)quotient) & 3;
+}
+
+// calculates the sine and cosine of an argument below 2^-7 in magnitude, the sine keeps the relative precision of the argument
+static inline void x87_wide_sincos_small(x87_wide_t value, x87_wide_t * sine, x87_wide_t * cosine)
+{
+	uint64_t value_high, value_low, square_high, square_low, high, low;
+	x87_wide_to_fixed(value, &value_high, &value_low);
+	x87_mul128(value_high, value_low, value_high, value_low, &square_high, &square_low);
+
+	x87_fixed_series(square_high, square_low, x87_sin_series, 8, 4, true, &high, &low);
+	*sine = x87_wide_mul(value, x87_wide_from_fixed(high, low, 127, false));
+	x87_fixed_series(square_high, square_low, x87_cos_series, 8, 4, true, &high, &low);
+	*cosine = x87_wide_from_fixed(high, low, 127, false);
+}
+
+// calculates the sine and cosine of a fixed point number with 128 fraction bits, at most pi/4 in magnitude
+static inline void x87_wide_sincos_reduced(uint64_t value_high, uint64_t value_low, bool sign, x87_wide_t * sine, x87_wide_t * cosine)
+{
+	// sin(a + b) = sin(a) cos(b) + cos(a) sin(b), cos(a + b) = cos(a) cos(b) - sin(a) sin(b), where a = i/64 is the nearest table entry
+	unsigned index = (unsigned)((value_high >> 57) + 1) >> 1;
+	if(index == 0)
+	{
+		x87_wide_sincos_small(x87_wide_from_fixed(value_high, value_low, 128, sign), sine, cosine);
+		return;
+	}
+
+	uint64_t offset = (uint64_t)index << 58;
+	bool negative = value_high < offset;
+	uint64_t delta_high, delta_low;
+	if(negative)
+	{
+		delta_high = offset - value_high - (value_low != 0);
+		delta_low = -value_low;
+	}
+	else
+	{
+		delta_high = value_high - offset;
+		delta_low = value_low;
+	}
+
+	uint64_t square_high, square_low, series_high, series_low;
+	uint64_t delta_sine_high, delta_sine_low, delta_cosine_high, delta_cosine_low;
+	x87_mul128(delta_high, delta_low, delta_high, delta_low, &square_high, &square_low);
+	x87_fixed_series(square_high, square_low, x87_sin_series, 8, 4, true, &series_high, &series_low);
+	x87_mul128(delta_high, delta_low, series_high, series_low, &delta_sine_high, &delta_sine_low);
+	x87_fixed_series(square_high, square_low, x87_cos_series, 8, 4, true, &delta_cosine_high, &delta_cosine_low);
+
+	// all products have 127 fraction bits
+	uint64_t sine_high, sine_low, cosine_high, cosine_low, high, low;
+	x87_mul128(x87_sincos_table[index - 1][0][0], x87_sincos_table[index - 1][0][1], delta_cosine_high, delta_cosine_low, &sine_high, &sine_low);
+	x87_mul128(x87_sincos_table[index - 1][1][0], x87_sincos_table[index - 1][1][1], delta_sine_high, delta_sine_low, &high, &low);
+	if(negative)
+	{
+		sine_high = sine_high - high - (sine_low < low);
+		sine_low -= low;
+	}
+	else
+	{
+		sine_low += low;
+		sine_high += high + (sine_low < low);
+	}
+
+	x87_mul128(x87_sincos_table[index - 1][1][0], x87_sincos_table[index - 1][1][1], delta_cosine_high, delta_cosine_low, &cosine_high, &cosine_low);
+	x87_mul128(x87_sincos_table[index - 1][0][0], x87_sincos_table[index - 1][0][1], delta_sine_high, delta_sine_low, &high, &low);
+	if(negative)
+	{
+		cosine_low += low;
+		cosine_high += high + (cosine_low < low);
+	}
+	else
+	{
+		cosine_high = cosine_high - high - (cosine_low < low);
+		cosine_low -= low;
+	}
+
+	*sine = x87_wide_from_fixed(sine_high, sine_low, 127, sign);
+	*cosine = x87_wide_from_fixed(cosine_high, cosine_low, 127, false);
+}
+
+/* Fast version of x87_wide_sincos_small with a relative error below 2^-74, either result may be skipped by passing NULL
+ * sin x = x - x w and cos x = 1 - z, where w and z are below 2^-14 and only need 64 bits
+ */
+static inline void x87_wide_sincos_small_fast(x87_wide_t value, x87_wide_t * sine, x87_wide_t * cosine)
+{
+	// the square scaled by 2^78
+	int32_t shift = -16 - 2 * value.exponent;
+	uint64_t square = shift >= 64 ? 0 : x87_mulhi64(value.high, value.high) >> shift;
+
+	if(sine != NULL)
+		*sine = x87_wide_mul_one_plus(value, x87_mulhi64(square, x87_fixed_series64(square, x87_sin_fast_series, 4, true)), 14, true);
+
+	if(cosine != NULL)
+	{
+		// z scaled by 2^78, and 1 - z with 127 fraction bits
+		uint64_t term = x87_mulhi64(square, x87_fixed_series64(square, x87_cos_fast_series, 4, true));
+		uint64_t high = 0x8000000000000000U, low = 0;
+		x87_fixed_sub(&high, &low, term >> 15, term << 49);
+		*cosine = x87_wide_from_fixed(high, low, 127, false);
+	}
+}
+
+/* Calculates first cos d + second sin d, with the second product subtracted if subtract is all ones, as a fixed point number with 128 fraction bits
+ * The table entries have 128 fraction bits, the difference d is scaled by 2^70 and sin d = d - d w and cos d = 1 - z are given by the terms d w scaled by 2^84 and z scaled by 2^78
+ */
+static inline void x87_sincos_combine_fast(const uint64_t * first, const uint64_t * second, uint64_t delta, uint64_t sine_term, uint64_t cosine_term, uint64_t subtract, uint64_t * high, uint64_t * low)
+{
+	// the first table entry is needed in full when it is small
+	uint64_t term_high, term_low;
+	x87_mul128_64(second[0], second[1], delta, 6, high, low);
+	x87_mul128_64(second[0], 0, sine_term, 20, &term_high, &term_low);
+	x87_fixed_sub(high, low, term_high, term_low);
+	x87_fixed_negate_masked(high, low, subtract);
+	x87_fixed_add(high, low, first[0], first[1]);
+	x87_mul128_64(first[0], first[1], cosine_term, 14, &term_high, &term_low);
+	x87_fixed_sub(high, low, term_high, term_low);
+}
+
+/* Fast version of x87_wide_sincos_reduced with a relative error below 2^-74, either result may be skipped by passing NULL
+ * The argument must be a multiple of 2^-70, this holds for the reduced arguments since the 64-bit arguments above 2^-7 and the multiples of the 66-bit pi/2 are multiples of 2^-70
+ * The difference to the table entry then fits into 64 bits, only its product with the table entry needs 128 bits and the terms of the series after the first one are calculated with 64 bits
+ */
+static inline void x87_wide_sincos_reduced_fast(uint64_t value_high, uint64_t value_low, bool sign, x87_wide_t * sine, x87_wide_t * cosine)
+{
+	unsigned index = (unsigned)((value_high >> 57) + 1) >> 1;
+	if(index == 0)
+	{
+		x87_wide_sincos_small_fast(x87_wide_from_fixed(value_high, value_low, 128, sign), sine, cosine);
+		return;
+	}
+
+	// the magnitude of the difference scaled by 2^70, at most 2^63
+	uint64_t offset = (uint64_t)index << 58;
+	uint64_t negative = -(uint64_t)(value_high < offset);
+	uint64_t delta = ((value_high - offset) << 6) | (value_low >> 58);
+	delta = (delta ^ negative) - negative;
+
+	// the square scaled by 2^78, the largest one is rounded down
+	uint64_t square_low, square = x87_mul64(delta, delta, &square_low);
+	square = (square >> 62) != 0 ? 0xFFFFFFFFFFFFFFFFU : (square << 2) | (square_low >> 62);
+	// the last term of the sine series is too small to matter after multiplying with d
+	uint64_t sine_term = x87_mulhi64(delta, x87_mulhi64(square, x87_fixed_series64(square, x87_sin_fast_series, 3, true)));
+	uint64_t cosine_term = x87_mulhi64(square, x87_fixed_series64(square, x87_cos_fast_series, 4, true));
+
+	// sin(a + d) = sin(a) cos d + cos(a) sin d, cos(a + d) = cos(a) cos d - sin(a) sin d, where a = i/64 is the nearest table entry
+	uint64_t high, low;
+	if(sine != NULL)
+	{
+		x87_sincos_combine_fast(x87_sincos_table[index - 1][0], x87_sincos_table[index - 1][1], delta, sine_term, cosine_term, negative, &high, &low);
+		*sine = x87_wide_from_fixed(high, low, 128, sign);
+	}
+	if(cosine != NULL)
+	{
+		x87_sincos_combine_fast(x87_sincos_table[index - 1][1], x87_sincos_table[index - 1][0], delta, sine_term, cosine_term, ~negative, &high, &low);
+		*cosine = x87_wide_from_fixed(high, low, 128, false);
+	}
+}
+
+// the fast results are below 2^(exponent + 1), so their error is below 2^(exponent - X87_SINCOS_FAST_ERROR)
+#define X87_SINCOS_FAST_ERROR 73
+
+/* Calculates the sine and cosine with a relative error below 2^-74, either result may be skipped by passing NULL
+ * The argument must be below 2^63 in magnitude and have at most 64 significant bits
+ */
+static inline void x87_wide_sincos_fast(x87_wide_t value, x87_wide_t * sine, x87_wide_t * cosine)
+{
+	if(value.exponent < -7)
+	{
+		x87_wide_sincos_small_fast(value, sine, cosine);
+		return;
+	}
+
+	uint64_t high, low;
+	bool sign;
+	unsigned quadrant = x87_wide_reduce(value, &high, &low, &sign);
+
+	// each quarter turn turns the sine into the cosine and the cosine into the negated sine
+	x87_wide_t reduced_sine, reduced_cosine;
+	bool odd = (quadrant & 1) != 0;
+	x87_wide_sincos_reduced_fast(high, low, sign, (odd ? cosine : sine) != NULL ? &reduced_sine : NULL, (odd ? sine : cosine) != NULL ? &reduced_cosine : NULL);
+
+	if(sine != NULL)
+	{
+		*sine = odd ? reduced_cosine : reduced_sine;
+		if((quadrant & 2) != 0)
+			sine->sign = !sine->sign;
+	}
+	if(cosine != NULL)
+	{
+		*cosine = odd ? reduced_sine : reduced_cosine;
+		if(((quadrant + 1) & 2) != 0)
+			cosine->sign = !cosine->sign;
+	}
+}
+
+// the argument must be below 2^63 in magnitude
+static inline void x87_wide_sincos(x87_wide_t value, x87_wide_t * sine, x87_wide_t * cosine)
+{
+	x87_wide_t reduced_sine, reduced_cosine;
+	unsigned quadrant = 0;
+	if(value.exponent < -7)
+	{
+		x87_wide_sincos_small(value, &reduced_sine, &reduced_cosine);
+	}
+	else
+	{
+		uint64_t high, low;
+		bool sign;
+		quadrant = x87_wide_reduce(value, &high, &low, &sign);
+		x87_wide_sincos_reduced(high, low, sign, &reduced_sine, &reduced_cosine);
+	}
+
+	switch(quadrant)
+	{
+	case 0:
+		*sine = reduced_sine;
+		*cosine = reduced_cosine;
+		break;
+	case 1:
+		*sine = reduced_cosine;
+		*cosine = x87_wide_negate(reduced_sine);
+		break;
+	case 2:
+		*sine = x87_wide_negate(reduced_sine);
+		*cosine = x87_wide_negate(reduced_cosine);
+		break;
+	case 3:
+		*sine = x87_wide_negate(reduced_cosine);
+		*cosine = reduced_sine;
+		break;
+	}
+}
+
+// calculates the angle of the point (x, y) from the positive x axis, between 0 and pi, the coordinates must be nonzero
+static inline x87_wide_t x87_wide_atan2(x87_wide_t y, x87_wide_t x)
+{
+	bool negative = x.sign;
+	x.sign = y.sign = false;
+
+	// atan(y/x) = pi/2 - atan(x/y)
+	bool swap = x87_wide_compare(y, x) > 0;
+	if(swap)
+	{
+		x87_wide_t tmp = x;
+		x = y;
+		y = tmp;
+	}
+
+	// the table entry only needs to be close to the ratio, so it is selected using an estimate
+	int32_t index = 0;
+	if(y.exponent - x.exponent >= -7)
+		index = (int32_t)((double)y.high / (double)x.high / (double)(1 << (x.exponent - y.exponent)) * 64.0 + 0.5);
+
+	x87_wide_t result;
+	if(index == 0)
+	{
+		x87_wide_t ratio = x87_wide_div(y, x, true);
+		result = x87_wide_mul(ratio, x87_wide_series(x87_wide_mul(ratio, ratio), x87_atan_series, 9, 9, true));
+	}
+	else
+	{
+		// atan(y/x) = atan(c) + atan((y - c x) / (x + c y))
+		x87_wide_t offset = x87_wide_make(index, 57, false);
+		x87_wide_t delta = x87_wide_div(x87_wide_sub(y, x87_wide_mul(offset, x)), x87_wide_add(x, x87_wide_mul(offset, y)), true);
+		result = x87_wide_add(x87_atan_table[index], x87_wide_mul(delta, x87_wide_series(x87_wide_mul(delta, delta), x87_atan_series, 9, 9, true)));
+	}
+
+	if(swap)
+		result = x87_wide_sub(x87_wide_scale(X87_WIDE_PI, -1), result);
+	if(negative)
+		result = x87_wide_sub(X87_WIDE_PI, result);
+	return result;
+}
+
+/* Fast version of x87_wide_atan2 for coordinates with 64-bit significands, stores the exponent of a bound for the absolute error
+ * The differences y - c x and x + c y are calculated exactly, so that only the quotient and the series are approximate
+ * Away from zero, the quotient and the series only need absolute precision, so they are calculated in fixed point
+ */
+static inline x87_wide_t x87_wide_atan2_fast(x87_wide_t y, x87_wide_t x, int32_t * error)
+{
+	bool negative = x.sign;
+	x.sign = y.sign = false;
+
+	bool swap = x87_wide_compare(y, x) > 0;
+	if(swap)
+	{
+		x87_wide_t tmp = x;
+		x = y;
+		y = tmp;
+	}
+
+	// the series needs a ratio below 2^-7, so the estimate is only trusted above that
+	int32_t index = 0;
+	int32_t shift = x.exponent - y.exponent;
+	if(shift <= 7)
+	{
+		// the shifts scale the quotient by 64, within the 63 bits of a signed integer
+		index = (int32_t)((double)(int64_t)(y.high >> (shift + 1)) / (double)(int64_t)(x.high >> 7) + 0.5);
+		if(index == 0 && x87_wide_compare(x87_wide_scale(y, 7), x) >= 0)
+			index = 1;
+	}
+
+	// the sum is calculated with 126 fraction bits
+	uint64_t high, low;
+	if(index == 0)
+	{
+		// atan(r) = r - r w, the square is scaled by 2^78
+		x87_wide_t ratio = x87_wide_div(y, x, false);
+		shift = -16 - 2 * ratio.exponent;
+		uint64_t square = shift >= 64 ? 0 : x87_mulhi64(ratio.high, ratio.high) >> shift;
+		x87_wide_t result = x87_wide_mul_one_plus(ratio, x87_mulhi64(square, x87_fixed_series64(square, x87_atan_fast_series, 5, true)), 14, true);
+
+		if(!swap && !negative)
+		{
+			// the relative error is below 2^-75
+			*error = result.exponent - 74;
+			return result;
+		}
+		x87_wide_to_fixed_truncated(result, 126, &high, &low);
+	}
+	else
+	{
+		// y and x in units of 2^(exponent of x - 126), where y is at most 7 places lower, the sum is below 2^128
+		uint64_t x_high = x.high >> 1, x_low = x.high << 63;
+		uint64_t y_high = y.high >> (shift + 1), y_low = y.high << (63 - shift);
+		uint64_t product_low, product_high;
+
+		// y - c x
+		uint64_t numerator_high = y_high, numerator_low = y_low;
+		product_high = x87_mul64(x.high, (uint64_t)index, &product_low);
+		x87_fixed_sub(&numerator_high, &numerator_low, (product_high << 57) | (product_low >> 7), product_low << 57);
+		uint64_t sign = -(numerator_high >> 63);
+		x87_fixed_negate_masked(&numerator_high, &numerator_low, sign);
+
+		// x + c y, between x and 2 x, it is normalized together with the numerator
+		uint64_t denominator_high = x_high, denominator_low = x_low;
+		product_high = x87_mul64(y.high, (uint64_t)index, &product_low);
+		x87_fixed_add(&denominator_high, &denominator_low, (product_high << (57 - shift)) | (product_low >> (7 + shift)), product_low << (57 - shift));
+		if((denominator_high & 0x8000000000000000U) == 0)
+		{
+			denominator_high = (denominator_high << 1) | (denominator_low >> 63);
+			denominator_low <<= 1;
+			numerator_high = (numerator_high << 1) | (numerator_low >> 63);
+			numerator_low <<= 1;
+		}
+
+		// the ratio r with 127 fraction bits, below 2^-7, its absolute error is below 2^-104
+		x87_wide_t denominator = { denominator_high, denominator_low, 0, false };
+		uint64_t reciprocal_high, reciprocal_low;
+		x87_wide_reciprocal(denominator, false, &reciprocal_high, &reciprocal_low);
+		x87_mul128(numerator_high, numerator_low, reciprocal_high, reciprocal_low, &high, &low);
+
+		// atan(r) = r - r w, the square is scaled by 2^14
+		uint64_t scaled = (high << 8) | (low >> 56);
+		uint64_t square = x87_mulhi64(scaled, scaled);
+		uint64_t term_high, term_low;
+		x87_mul128_64(high, low, x87_mulhi64(square, x87_fixed_series64(square, x87_atan_fast_series, 5, true)), 14, &term_high, &term_low);
+		x87_fixed_sub(&high, &low, term_high, term_low);
+		x87_fixed_shift_right(&high, &low, 1);
+		x87_fixed_negate_masked(&high, &low, sign);
+
+		uint64_t table_high, table_low;
+		x87_wide_to_fixed_truncated(x87_atan_table[index], 126, &table_high, &table_low);
+		x87_fixed_add(&high, &low, table_high, table_low);
+	}
+
+	// the absolute error is below 2^-81, the quadrant is applied with masks since it is random for random arguments
+	uint64_t mask = -(uint64_t)swap;
+	x87_fixed_negate_masked(&high, &low, mask);
+	x87_fixed_add(&high, &low, (X87_WIDE_PI.high >> 1) & mask, ((X87_WIDE_PI.high << 63) | (X87_WIDE_PI.low >> 1)) & mask);
+	mask = -(uint64_t)negative;
+	x87_fixed_negate_masked(&high, &low, mask);
+	x87_fixed_add(&high, &low, X87_WIDE_PI.high & mask, X87_WIDE_PI.low & mask);
+	*error = -81;
+	return x87_wide_from_fixed(high, low, 126, false);
+}
+
+static inline x87_wide_t x87_wide_exp2m1(x87_wide_t value)
+{
+	if(value.exponent >= 15)
+	{
+		if(!value.sign)
+		{
+			// certain to overflow
+			x87_wide_t result = { 0x8000000000000000U, 0, 0x8000, false };
+			return result;
+		}
+		else
+		{
+			// -1 plus a value too small to be represented
+			x87_wide_t result = { 0xFFFFFFFFFFFFFFFFU, 0xFFFFFFFFFFFFFFFFU, -1, true };
+			return result;
+		}
+	}
+
+	// 2^x - 1 = 2^(i/64) - 1 + 2^(i/64) (e^(d ln 2) - 1), where x = i/64 + d
+	int32_t index = x87_wide_round_scaled(value, 6);
+	x87_wide_t delta = x87_wide_sub(value, x87_wide_make(index < 0 ? -index : index, 57, index < 0));
+	x87_wide_t exponent = x87_wide_mul(delta, X87_WIDE_LN2);
+	x87_wide_t delta_power = x87_wide_mul(exponent, x87_wide_series(exponent, x87_expm1_series, 13, 13, false));
+
+	if(index == 0)
+	{
+		return delta_power;
+	}
+	else if(-64 <= index && index <= 64)
+	{
+		x87_wide_t table_power = x87_exp2m1_table[index + 64];
+		return x87_wide_add(table_power, x87_wide_mul(x87_wide_add(table_power, X87_WIDE_ONE), delta_power));
+	}
+	else
+	{
+		int32_t whole = index >= 0 ? index / 64 : -((63 - index) / 64);
+		x87_wide_t table_power = x87_wide_add(x87_exp2m1_table[index - whole * 64 + 64], X87_WIDE_ONE);
+		x87_wide_t power = x87_wide_add(table_power, x87_wide_mul(table_power, delta_power));
+		return x87_wide_sub(x87_wide_scale(power, whole), X87_WIDE_ONE);
+	}
+}
+
+/* Calculates 2^x - 1 for x = value 2^(exponent - 63) below 2^-7 in magnitude with a relative error below 2^-77
+ * 2^x - 1 = y + y^2/2 + y^3 h(y), where y = x ln 2, only the first two terms need 128 bits
+ */
+static inline x87_wide_t x87_wide_exp2m1_small_fast(uint64_t value, int32_t exponent, bool sign)
+{
+	// all terms are in units of 2^(exponent - 127), y is below 2^128
+	uint64_t high, low;
+	x87_mul128_64(X87_WIDE_LN2.high, X87_WIDE_LN2.low, value, 0, &high, &low);
+
+	uint64_t square_high, square_low;
+	x87_mul128(high, low, high, low, &square_high, &square_low);
+	x87_fixed_shift_right(&square_high, &square_low, -exponent);
+
+	// y scaled by 2^71, below 1, and y^2 h(y) scaled by 2^80
+	int32_t shift = -8 - exponent;
+	uint64_t scaled = shift < 0 ? (high << 1) | (low >> 63) : shift >= 64 ? 0 : high >> shift;
+	uint64_t term = x87_mulhi64(x87_mulhi64(scaled, scaled), x87_fixed_series64(scaled, x87_expm1_fast_series, 7, sign));
+	uint64_t term_high, term_low;
+	x87_mul128_64(high, low, term, 16, &term_high, &term_low);
+
+	// for negative arguments, the magnitude is |y| - y^2/2 + |y|^3 h(y)
+	if(sign)
+		x87_fixed_sub(&high, &low, square_high, square_low);
+	else
+		x87_fixed_add(&high, &low, square_high, square_low);
+	x87_fixed_add(&high, &low, term_high, term_low);
+
+	x87_wide_t result = { high, low, exponent, sign };
+	return x87_wide_normalize(result);
+}
+
+/* Fast version of x87_wide_exp2m1 for arguments below 1 in magnitude with 64-bit significands, stores the exponent of a bound for the absolute error
+ * The difference to the table entry is a multiple of 2^-70, so it fits into 64 bits
+ */
+static inline x87_wide_t x87_wide_exp2m1_fast(x87_wide_t value, int32_t * error)
+{
+	int32_t index = x87_wide_round_scaled(value, 6);
+	if(index == 0)
+	{
+		x87_wide_t result = x87_wide_exp2m1_small_fast(value.high, value.exponent, value.sign);
+		*error = result.exponent - 76;
+		return result;
+	}
+
+	// the difference to i/64 scaled by 2^70, the multiple of 2^64 is dropped since the difference is at most 2^63 in magnitude
+	int64_t delta = (int64_t)(value.high << (value.exponent + 7));
+	bool sign = (delta < 0) != value.sign;
+	x87_wide_t delta_power = x87_wide_exp2m1_small_fast(delta < 0 ? -(uint64_t)delta : (uint64_t)delta, -7, sign);
+
+	// 2^x - 1 = 2^(i/64) - 1 + 2^(i/64) (2^d - 1), with 126 fraction bits, its absolute error is below 2^-82
+	uint64_t high, low, power_high, power_low, term_high, term_low;
+	x87_wide_t table_power = x87_exp2m1_table[index + 64];
+	x87_wide_to_fixed_truncated(table_power, 126, &high, &low);
+	if(table_power.sign)
+		x87_fixed_negate(&high, &low);
+	power_high = high + 0x4000000000000000U;
+	power_low = low;
+	x87_wide_to_fixed_truncated(delta_power, 128, &term_high, &term_low);
+	x87_mul128(power_high, power_low, term_high, term_low, &term_high, &term_low);
+	if(sign)
+		x87_fixed_sub(&high, &low, term_high, term_low);
+	else
+		x87_fixed_add(&high, &low, term_high, term_low);
+
+	bool negative = (int64_t)high < 0;
+	if(negative)
+		x87_fixed_negate(&high, &low);
+	*error = -82;
+	return x87_wide_from_fixed(high, low, 126, negative);
+}
+
+// calculates log2((1 + s) / (1 - s)) = 2 log2(e) atanh(s)
+static inline x87_wide_t x87_wide_log2_ratio(x87_wide_t value)
+{
+	x87_wide_t result = x87_wide_mul(value, x87_wide_series(x87_wide_mul(value, value), x87_atan_series, 9, 9, false));
+	return x87_wide_scale(x87_wide_mul(result, X87_WIDE_LOG2E), 1);
+}
+
+// the argument must be positive
+static inline x87_wide_t x87_wide_log2(x87_wide_t value)
+{
+	// log2(x) = e + log2(c) + log2(m / c), where x = m 2^e, 0.75 <= m < 1.5 and c = i/64 is near m
+	int32_t exponent = value.exponent;
+	value.exponent = 0;
+	if(value.high >= 0xC000000000000000U)
+	{
+		value.exponent = -1;
+		exponent ++;
+	}
+
+	int32_t index = x87_wide_round_scaled(value, 6);
+	x87_wide_t offset = x87_wide_make(index, 57, false);
+	x87_wide_t result = x87_wide_log2_ratio(x87_wide_div(x87_wide_sub(value, offset), x87_wide_add(value, offset), true));
+	result = x87_wide_add(result, x87_log2_table[index - 48]);
+	return x87_wide_add(result, x87_wide_make(exponent < 0 ? -exponent : exponent, 63, exponent < 0));
+}
+
+// the argument must be above -1
+static inline x87_wide_t x87_wide_log2p1(x87_wide_t value)
+{
+	if(value.exponent < -7)
+		// log2(1 + x) = log2((1 + s) / (1 - s)), where s = x / (2 + x)
+		return x87_wide_log2_ratio(x87_wide_div(value, x87_wide_add(X87_WIDE_TWO, value), true));
+	else
+		return x87_wide_log2(x87_wide_add(X87_WIDE_ONE, value));
+}
+
+/* Calculates log2(1 + v) for v below 2^-13 in magnitude with a relative error below 2^-75
+ * log(1 + v) = v - v^2 w(v), where w is evaluated with 64 bits
+ */
+static inline x87_wide_t x87_wide_log2p1_small_fast(x87_wide_t value)
+{
+	// |v| scaled by 2^77, below 1
+	int32_t shift = -14 - value.exponent;
+	uint64_t scaled = shift >= 64 ? 0 : value.high >> shift;
+	uint64_t term = x87_mulhi64(scaled, x87_fixed_series64(scaled, x87_log1p_fast_series, 5, !value.sign));
+	return x87_wide_mul(x87_wide_mul_one_plus(value, term, 13, !value.sign), X87_WIDE_LOG2E);
+}
+
+/* Fast version of x87_wide_log2 for x = m 2^exponent, where m is a fixed point number with 127 fraction bits from 0.75 to 1.5, stores the exponent of a bound for the absolute error
+ * log2(x) = e - log2(r1) - log2(r2) + log2(1 + v), where 1 + v = m r1 r2, the reciprocals r1 of i/128 and r2 of 1 + j 2^-13 only have a few bits, so the products need no division and lose almost nothing
+ */
+static inline x87_wide_t x87_wide_log2_fixed_fast(uint64_t high, uint64_t low, int32_t exponent, int32_t * error)
+{
+	int index = (int)((high + ((uint64_t)1 << 55)) >> 56);
+	const uint64_t * entry = x87_log2_fast_table[index - 96];
+	// m r1 with 126 fraction bits, within 2^-7.5 of 1
+	x87_mul128_64(high, low, entry[0] << 47, 0, &high, &low);
+
+	int delta_index = (int)(((int64_t)(high - ((uint64_t)1 << 62)) + ((int64_t)1 << 48)) >> 49);
+	const uint64_t * delta_entry = x87_log2p1_fast_table[delta_index + 43];
+	// v with 124 fraction bits, below 2^-13.99 in magnitude
+	x87_mul128_64(high, low, delta_entry[0] << 30, 0, &high, &low);
+	high -= (uint64_t)1 << 60;
+	// the signs are random for random arguments, so they are applied with masks instead of branches
+	uint64_t negative = -(high >> 63);
+	x87_fixed_negate_masked(&high, &low, negative);
+
+	if(exponent == 0 && index == 128 && delta_index == 0)
+	{
+		// there are no table entries to cancel, v is exact for arguments with at most 124 fraction bits
+		x87_wide_t result = x87_wide_log2p1_small_fast(x87_wide_from_fixed(high, low, 124, negative != 0));
+		*error = result.exponent - 74;
+		return result;
+	}
+
+	// log(1 + v) = v - v^2 w(v), the magnitude is |v| - v^2 w for positive v and |v| + v^2 w for negative v
+	uint64_t scaled = (high << 17) | (low >> 47);
+	uint64_t term = x87_mulhi64(x87_mulhi64(scaled, scaled), x87_fixed_series64(scaled, x87_log1p_fast_series, 5, negative == 0));
+	uint64_t term_high = term >> 30, term_low = term << 34;
+	x87_fixed_negate_masked(&term_high, &term_low, negative);
+	x87_fixed_sub(&high, &low, term_high, term_low);
+
+	// the sum is calculated with 112 fraction bits, its absolute error is below 2^-86
+	x87_mul128(high, low, X87_WIDE_LOG2E.high, X87_WIDE_LOG2E.low, &high, &low);
+	x87_fixed_shift_right(&high, &low, 11);
+	x87_fixed_negate_masked(&high, &low, negative);
+	x87_fixed_add(&high, &low, entry[1], entry[2]);
+	x87_fixed_add(&high, &low, delta_entry[1], delta_entry[2]);
+	high += (uint64_t)(int64_t)exponent << 48;
+
+	negative = -(high >> 63);
+	x87_fixed_negate_masked(&high, &low, negative);
+	*error = -86;
+	return x87_wide_from_fixed(high, low, 112, negative != 0);
+}
+
+// fast version of x87_wide_log2, the argument must be positive
+static inline x87_wide_t x87_wide_log2_fast(x87_wide_t value, int32_t * error)
+{
+	// significands from 1.5 are halved, without a branch since either case is equally likely
+	unsigned shift = value.high >= 0xC000000000000000U;
+	return x87_wide_log2_fixed_fast(value.high >> shift, (value.low >> shift) | ((value.high << 63) & -(uint64_t)shift), value.exponent + (int32_t)shift, error);
+}
+
+// fast version of x87_wide_log2p1, the argument must be above -1 and have a 64-bit significand
+static inline x87_wide_t x87_wide_log2p1_fast(x87_wide_t value, int32_t * error)
+{
+	if(value.exponent < -15)
+	{
+		x87_wide_t result = x87_wide_log2p1_small_fast(value);
+		*error = result.exponent - 74;
+		return result;
+	}
+	else if(value.exponent <= 0)
+	{
+		// 1 + x is exact with 126 fraction bits
+		uint64_t high = value.high >> (1 - value.exponent), low = value.high << (63 + value.exponent);
+		x87_fixed_negate_masked(&high, &low, -(uint64_t)value.sign);
+		return x87_wide_log2_fast(x87_wide_from_fixed(high + 0x4000000000000000U, low, 126, false), error);
+	}
+	else
+	{
+		return x87_wide_log2_fast(x87_wide_add(X87_WIDE_ONE, value), error);
+	}
+}
+
+enum
+{
+	X87_CONSTANT_LOG2_10,
+	X87_CONSTANT_LOG2E,
+	X87_CONSTANT_PI,
+	X87_CONSTANT_LOG10_2,
+	X87_CONSTANT_LN2,
+};
+
+// the FPU stores its constants with 66-bit significands, the two extra bits follow the 64-bit fraction
+static const struct
+{
+	uint64_t fraction;
+	uint8_t extra;
+	uint16_t exponent;
+} x87_constants[] =
+{
+	[X87_CONSTANT_LOG2_10] = { 0xD49A784BCD1B8AFEU, 1, 0x4000 },
+	[X87_CONSTANT_LOG2E] = { 0xB8AA3B295C17F0BBU, 2, 0x3FFF },
+	[X87_CONSTANT_PI] = { 0xC90FDAA22168C234U, 3, 0x4000 },
+	[X87_CONSTANT_LOG10_2] = { 0x9A209A84FBCFF798U, 2, 0x3FFD },
+	[X87_CONSTANT_LN2] = { 0xB17217F7D1CF79ABU, 3, 0x3FFE },
+};
+
+static inline x87_float80_t x87_load_constant(x86_state_t * emu, int number)
+{
+	uint64_t fraction = x87_constants[number].fraction;
+	// the 8087 and 287 always round to nearest, the constants are irrational so the bits beyond the 66-bit value are never all zero
+	int rounding = emu->x87.fpu_type < X87_FPU_387 ? X87_RC_NEAREST : (emu->x87.cw & X87_CW_RC_MASK) >> X87_CW_RC_SHIFT;
+	if(rounding == X87_RC_UP || (rounding == X87_RC_NEAREST && (x87_constants[number].extra & 2) != 0))
+		fraction ++;
+	return x87_convert_to_float80(fraction, x87_constants[number].exponent, false);
+}
+
+static inline bool x87_is_unsupported(x86_state_t * emu, int type)
+{
+	if(emu->x87.fpu_type < X87_FPU_387)
+		return false;
+
+	switch(type)
+	{
+	case FP80_PSEUDO_NAN:
+	case FP80_PSEUDO_INFINITE:
+	case FP80_PSEUDO_ZERO:
+	case FP80_UNNORMAL:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static inline bool x87_type_is_nan(int type)
+{
+	return type == FP80_NAN_QUIET || type == FP80_NAN_SIGNALING || type == FP80_PSEUDO_NAN;
+}
+
+static inline bool x87_type_is_infinite(int type)
+{
+	return type == FP80_INFINITE || type == FP80_PSEUDO_INFINITE;
+}
+
+/* Checks the operands of a transcendental instruction and converts them, the second operand is optional
+ * Each operand is only classified once, since this is expensive when using native floats
+ * Returns true if the result is already determined by a NaN or unsupported operand
+ */
+static inline bool x87_check_transcendental_operands(x86_state_t * emu, x87_float80_t value1, int * type1, x87_wide_t * wide1, x87_float80_t value2, int * type2, x87_wide_t * wide2, x87_float80_t * result)
+{
+	bool binary = type2 != NULL;
+
+#if X87_FLOAT80_BITS
+	// normal operands need no further checks
+	uint64_t fraction1, fraction2 = 0;
+	uint16_t exponent1, exponent2 = 0;
+	bool sign1, sign2 = false;
+	if(x87_float80_get_normal_bits(value1, &fraction1, &exponent1, &sign1) && (!binary || x87_float80_get_normal_bits(value2, &fraction2, &exponent2, &sign2)))
+	{
+		x87_wide_t normal1 = { fraction1, 0, exponent1 - 0x3FFF, sign1 };
+		*type1 = FP80_NORMAL;
+		*wide1 = normal1;
+		if(binary)
+		{
+			x87_wide_t normal2 = { fraction2, 0, exponent2 - 0x3FFF, sign2 };
+			*type2 = FP80_NORMAL;
+			*wide2 = normal2;
+		}
+		return false;
+	}
+#endif
+
+	*type1 = fp80classify(value1);
+	if(binary)
+		*type2 = fp80classify(value2);
+
+	if(emu->x87.fpu_type < X87_FPU_387 ? x87_type_is_nan(*type1) || (binary && x87_type_is_nan(*type2))
+		: *type1 == FP80_NAN_SIGNALING || (binary && *type2 == FP80_NAN_SIGNALING))
+	{
+		x87_signal_exception(emu, X87_SW_IE);
+	}
+
+	if(x87_is_unsupported(emu, *type1) || (binary && x87_is_unsupported(emu, *type2)))
+	{
+		x87_signal_exception(emu, X87_SW_IE);
+		*result = x87_float80_make_indefinite();
+		return true;
+	}
+
+	if(x87_type_is_nan(*type1) && binary && x87_type_is_nan(*type2))
+	{
+		// takes NaN of greater magnitude
+		*result = x87_make_quiet_nan(emu, value1.fraction > value2.fraction ? value1 : value2);
+		return true;
+	}
+	else if(x87_type_is_nan(*type1))
+	{
+		*result = x87_make_quiet_nan(emu, value1);
+		return true;
+	}
+	else if(binary && x87_type_is_nan(*type2))
+	{
+		*result = x87_make_quiet_nan(emu, value2);
+		return true;
+	}
+
+	if(*type1 == FP80_SUBNORMAL || (binary && *type2 == FP80_SUBNORMAL))
+		x87_signal_exception(emu, X87_SW_DE);
+
+	*wide1 = x87_wide_from_float80(value1);
+	if(binary)
+		*wide2 = x87_wide_from_float80(value2);
+	return false;
+}
+
+// returns true if the result is already determined, operands that are too large are left unchanged and set C2
+static inline bool x87_check_trigonometric_operand(x86_state_t * emu, x87_float80_t value, x87_wide_t * argument, x87_float80_t * result)
+{
+	int type;
+
+	emu->x87.sw &= ~X87_SW_C2;
+
+#if X87_FLOAT80_BITS
+	// normal operands in range need no further checks
+	uint64_t fraction;
+	uint16_t exponent;
+	bool sign;
+	if(x87_float80_get_normal_bits(value, &fraction, &exponent, &sign) && exponent < 0x3FFF + 63)
+	{
+		x87_wide_t normal = { fraction, 0, exponent - 0x3FFF, sign };
+		*argument = normal;
+		return false;
+	}
+#endif
+
+	if(x87_check_transcendental_operands(emu, value, &type, argument, value, NULL, NULL, result))
+		return true;
+
+	if(x87_type_is_infinite(type))
+	{
+		x87_signal_exception(emu, X87_SW_IE);
+		*result = x87_float80_make_indefinite();
+		return true;
+	}
+
+	if(argument->exponent >= 63)
+	{
+		emu->x87.sw |= X87_SW_C2;
+		*result = value;
+		return true;
+	}
+
+	return false;
+}
+
+static inline x87_float80_t x87_f2xm1(x86_state_t * emu, x87_float80_t value)
+{
+	x87_float80_t result;
+	x87_wide_t argument;
+	int type;
+	if(x87_check_transcendental_operands(emu, value, &type, &argument, value, NULL, NULL, &result))
+		return result;
+
+	if(x87_type_is_infinite(type))
+		return argument.sign ? x87_convert_to_float80(0x8000000000000000U, 0x3FFF, true) : value;
+
+	if(x87_wide_is_zero(argument))
+		return value;
+
+	// the accurate calculation is only needed if the fast result is too close to a rounding boundary
+	if(argument.exponent < 0)
+	{
+		int32_t error;
+		x87_wide_t power = x87_wide_exp2m1_fast(argument, &error);
+		if(x87_wide_rounds_safely(power, error))
+			return x87_wide_to_float80(emu, power);
+	}
+	return x87_wide_to_float80(emu, x87_wide_exp2m1(argument));
+}
+
+static inline x87_float80_t x87_fsin(x86_state_t * emu, x87_float80_t value)
+{
+	x87_float80_t result;
+	x87_wide_t argument;
+	if(x87_check_trigonometric_operand(emu, value, &argument, &result))
+		return result;
+
+	if(x87_wide_is_zero(argument))
+		return value;
+
+	// the accurate calculation is only needed if the fast result is too close to a rounding boundary
+	x87_wide_t sine;
+	x87_wide_sincos_fast(argument, &sine, NULL);
+	if(!x87_wide_rounds_safely(sine, sine.exponent - X87_SINCOS_FAST_ERROR))
+	{
+		x87_wide_t cosine;
+		x87_wide_sincos(argument, &sine, &cosine);
+	}
+	return x87_wide_to_float80(emu, sine);
+}
+
+static inline x87_float80_t x87_fcos(x86_state_t * emu, x87_float80_t value)
+{
+	x87_float80_t result;
+	x87_wide_t argument;
+	if(x87_check_trigonometric_operand(emu, value, &argument, &result))
+		return result;
+
+	if(x87_wide_is_zero(argument))
+		return FLOAT80_ONE;
+
+	x87_wide_t cosine;
+	x87_wide_sincos_fast(argument, NULL, &cosine);
+	if(!x87_wide_rounds_safely(cosine, cosine.exponent - X87_SINCOS_FAST_ERROR))
+	{
+		x87_wide_t sine;
+		x87_wide_sincos(argument, &sine, &cosine);
+	}
+	return x87_wide_to_float80(emu, cosine);
+}
+
+// returns false if the operand is out of range and the stack must not be changed
+static inline bool x87_fsincos(x86_state_t * emu, x87_float80_t value, x87_float80_t * sine, x87_float80_t * cosine)
+{
+	x87_wide_t argument;
+	if(x87_check_trigonometric_operand(emu, value, &argument, sine))
+	{
+		*cosine = *sine;
+		return (emu->x87.sw & X87_SW_C2) == 0;
+	}
+
+	if(x87_wide_is_zero(argument))
+	{
+		*sine = value;
+		*cosine = FLOAT80_ONE;
+		return true;
+	}
+
+	x87_wide_t wide_sine, wide_cosine;
+	x87_wide_sincos_fast(argument, &wide_sine, &wide_cosine);
+	if(!x87_wide_rounds_safely(wide_sine, wide_sine.exponent - X87_SINCOS_FAST_ERROR) || !x87_wide_rounds_safely(wide_cosine, wide_cosine.exponent - X87_SINCOS_FAST_ERROR))
+		x87_wide_sincos(argument, &wide_sine, &wide_cosine);
+	*sine = x87_wide_to_float80(emu, wide_sine);
+	*cosine = x87_wide_to_float80(emu, wide_cosine);
+	return true;
+}
+
+// returns false if the operand is out of range and the stack must not be changed
+static inline bool x87_fptan(x86_state_t * emu, x87_float80_t value, x87_float80_t * tangent)
+{
+	x87_wide_t argument;
+	if(x87_check_trigonometric_operand(emu, value, &argument, tangent))
+		return (emu->x87.sw & X87_SW_C2) == 0;
+
+	if(x87_wide_is_zero(argument))
+	{
+		*tangent = value;
+		return true;
+	}
+
+	// the errors of the fast sine and cosine add up in the quotient
+	x87_wide_t sine, cosine;
+	x87_wide_sincos_fast(argument, &sine, &cosine);
+	x87_wide_t wide_tangent = x87_wide_div(sine, cosine, false);
+	if(!x87_wide_rounds_safely(wide_tangent, wide_tangent.exponent - X87_SINCOS_FAST_ERROR + 1))
+	{
+		x87_wide_sincos(argument, &sine, &cosine);
+		wide_tangent = x87_wide_div(sine, cosine, true);
+	}
+	*tangent = x87_wide_to_float80(emu, wide_tangent);
+	return true;
+}
+
+// calculates atan(value2 / value1), with the quadrant determined by the signs of both operands
+static inline x87_float80_t x87_fpatan(x86_state_t * emu, x87_float80_t value1, x87_float80_t value2)
+{
+	x87_float80_t result;
+	x87_wide_t x, y, angle;
+	int x_type, y_type;
+	if(x87_check_transcendental_operands(emu, value1, &x_type, &x, value2, &y_type, &y, &result))
+		return result;
+
+	if(x87_type_is_infinite(y_type))
+	{
+		if(!x87_type_is_infinite(x_type))
+			angle = x87_wide_scale(X87_WIDE_PI, -1);
+		else if(!x.sign)
+			angle = x87_wide_scale(X87_WIDE_PI, -2);
+		else
+			angle = x87_wide_sub(X87_WIDE_PI, x87_wide_scale(X87_WIDE_PI, -2));
+	}
+	else if(x87_type_is_infinite(x_type) || x87_wide_is_zero(y))
+	{
+		if(!x.sign)
+			return x87_float80_make_zero(y.sign);
+		angle = X87_WIDE_PI;
+	}
+	else if(x87_wide_is_zero(x))
+	{
+		angle = x87_wide_scale(X87_WIDE_PI, -1);
+	}
+	else
+	{
+		int32_t error;
+		angle = x87_wide_atan2_fast(y, x, &error);
+		if(!x87_wide_rounds_safely(angle, error))
+			angle = x87_wide_atan2(y, x);
+	}
+
+	angle.sign = y.sign;
+	return x87_wide_to_float80(emu, angle);
+}
+
+enum
+{
+	X87_LOGARITHM_FINITE,
+	X87_LOGARITHM_INFINITE,
+	X87_LOGARITHM_POLE, // logarithm of zero
+};
+
+// multiplies the second operand of FYL2X or FYL2XP1 with the logarithm
+static inline x87_float80_t x87_multiply_logarithm(x86_state_t * emu, x87_wide_t logarithm, int kind, x87_wide_t factor, int factor_type)
+{
+	bool sign = factor.sign != logarithm.sign;
+
+	if(kind != X87_LOGARITHM_FINITE)
+	{
+		if(x87_type_is_infinite(factor_type))
+			return x87_float80_make_infinity(sign);
+
+		if(x87_wide_is_zero(factor))
+		{
+			x87_signal_exception(emu, X87_SW_IE);
+			return x87_float80_make_indefinite();
+		}
+
+		if(kind == X87_LOGARITHM_POLE)
+			x87_signal_exception(emu, X87_SW_ZE);
+		return x87_float80_make_infinity(sign);
+	}
+	else if(x87_wide_is_zero(logarithm))
+	{
+		if(x87_type_is_infinite(factor_type))
+		{
+			x87_signal_exception(emu, X87_SW_IE);
+			return x87_float80_make_indefinite();
+		}
+		return x87_float80_make_zero(sign);
+	}
+	else if(x87_type_is_infinite(factor_type))
+	{
+		return x87_float80_make_infinity(sign);
+	}
+	else if(x87_wide_is_zero(factor))
+	{
+		return x87_float80_make_zero(sign);
+	}
+	else
+	{
+		return x87_wide_to_float80(emu, x87_wide_mul(factor, logarithm));
+	}
+}
+
+static inline x87_float80_t x87_fyl2x(x86_state_t * emu, x87_float80_t value1, x87_float80_t value2)
+{
+	x87_float80_t result;
+	x87_wide_t x, y;
+	int x_type, y_type;
+	if(x87_check_transcendental_operands(emu, value1, &x_type, &x, value2, &y_type, &y, &result))
+		return result;
+
+	if(x87_type_is_infinite(x_type))
+	{
+		if(!x.sign)
+			return x87_multiply_logarithm(emu, x, X87_LOGARITHM_INFINITE, y, y_type);
+	}
+	else if(x87_wide_is_zero(x))
+	{
+		x.sign = true;
+		return x87_multiply_logarithm(emu, x, X87_LOGARITHM_POLE, y, y_type);
+	}
+	else if(!x.sign)
+	{
+		// the error of the fast logarithm is multiplied by the factor, which is below 2^(exponent + 1)
+		int32_t error;
+		x87_wide_t product = x87_wide_mul(y, x87_wide_log2_fast(x, &error));
+		if(!x87_type_is_infinite(y_type) && x87_wide_rounds_safely(product, error + y.exponent + 2))
+			return x87_wide_to_float80(emu, product);
+		return x87_multiply_logarithm(emu, x87_wide_log2(x), X87_LOGARITHM_FINITE, y, y_type);
+	}
+
+	x87_signal_exception(emu, X87_SW_IE);
+	return x87_float80_make_indefinite();
+}
+
+static inline x87_float80_t x87_fyl2xp1(x86_state_t * emu, x87_float80_t value1, x87_float80_t value2)
+{
+	x87_float80_t result;
+	x87_wide_t x, y;
+	int x_type, y_type;
+	if(x87_check_transcendental_operands(emu, value1, &x_type, &x, value2, &y_type, &y, &result))
+		return result;
+
+	if(x87_type_is_infinite(x_type))
+	{
+		if(!x.sign)
+			return x87_multiply_logarithm(emu, x, X87_LOGARITHM_INFINITE, y, y_type);
+	}
+	else if(x87_wide_is_zero(x))
+	{
+		// log2(1 + x) has the same sign as x
+		return x87_multiply_logarithm(emu, x, X87_LOGARITHM_FINITE, y, y_type);
+	}
+	else if(!x.sign || x87_wide_compare(x, X87_WIDE_ONE) < 0)
+	{
+		int32_t error;
+		x87_wide_t product = x87_wide_mul(y, x87_wide_log2p1_fast(x, &error));
+		if(!x87_type_is_infinite(y_type) && x87_wide_rounds_safely(product, error + y.exponent + 2))
+			return x87_wide_to_float80(emu, product);
+		return x87_multiply_logarithm(emu, x87_wide_log2p1(x), X87_LOGARITHM_FINITE, y, y_type);
+	}
+	else if(x87_wide_compare(x, X87_WIDE_ONE) == 0)
+	{
+		return x87_multiply_logarithm(emu, x, X87_LOGARITHM_POLE, y, y_type);
+	}
+
+	x87_signal_exception(emu, X87_SW_IE);
+	return x87_float80_make_indefinite();
+}
+
+static inline x87_float80_t x87_fabs(x86_state_t * emu, x87_float80_t value)
+{
+	(void) emu;
+#if _SUPPORT_FLOAT80
+	value.value = fabsl(value.value);
+#else
+	value.exponent &= 0x7FFF;
+#endif
+	return value;
+}
+
+static inline x87_float80_t x87_fadd(x86_state_t * emu, x87_float80_t value1, x87_float80_t value2)
+{
+	x87_float80_t result;
+
+	x87_check_subnormal_8087(emu, value1);
+	x87_check_subnormal_8087(emu, value2);
+
+	x87_check_invalid(emu, value1);
+	x87_check_invalid(emu, value2);
+
+	x87_check_subnormal(emu, value1);
+	x87_check_subnormal(emu, value2);
+
+#if _SUPPORT_FLOAT80
+	if(emu->x87.fpu_type < X87_FPU_387)
+	{
+		// 8087/287 converts subnormals to unnormal
+		if(fp80classify(value1) == FP80_SUBNORMAL)
+			value1 = x87_float80_make_8087(value1.value);
+		if(fp80classify(value2) == FP80_SUBNORMAL)
+			value2 = x87_float80_make_8087(value2.value);
+
+		if(isinf80(value1) && isinf80(value2) && (emu->x87.cw & X87_CW_IC) == 0)
+		{
+			// infinity control makes inf + inf invalid
+			x87_signal_exception(emu, X87_SW_IE);
+
+			return x87_float80_make_indefinite();
+		}
+	}
+
+	if(isnan80(value1) && isnan80(value2))
+	{
+		// takes NaN of greater magnitude
+		// on 387 and later, quiet NaNs override signaling NaNs, but since quiet NaNs have greater magnitude, this works out the same way
+		if(value1.fraction > value2.fraction)
+			return x87_make_quiet_nan(emu, value1);
+		else
+			return x87_make_quiet_nan(emu, value2);
+	}
+	else if(isnan80(value1))
+	{
+		return x87_make_quiet_nan(emu, value1);
+	}
+	else if(isnan80(value2))
+	{
+		return x87_make_quiet_nan(emu, value2);
+	}
+
+	fesetround(x87_get_std_rounding_mode(emu));
+	feclearexcept(FE_ALL_EXCEPT);
+
+	if(emu->x87.fpu_type < X87_FPU_387)
+	{
+		result = x87_restrict_precision(emu, x87_float80_make_8087(value1.value + value2.value));
+
+		if(fp80classify(value1) == FP80_UNNORMAL || fp80classify(value2) == FP80_UNNORMAL)
+		{
+			result = x87_make_unnormal(result, min(value1.exponent, value2.exponent));
+		}
+	}
+	else
+	{
+		result = x87_restrict_precision(emu, x87_float80_make(value1.value + value2.value));
+	}
+
+	if(fetestexcept(FE_OVERFLOW))
+	{
+		// TODO: 8087/287 behaves differently to the IEEE standard
+		int exp1, exp2;
+		// unmasked response
+		x87_signal_exception_later(emu, X87_SW_OE);
+
+		frexp(value1.value, &exp1);
+		frexp(value2.value, &exp2);
+		if(exp1 >= exp2)
+		{
+			value1.value = ldexp(value1.value, exp1 - 0x6000);
+			value1.exponent -= 0x6000;
+		}
+		else
+		{
+			value2.value = ldexp(value2.value, exp2 - 0x6000);
+			value2.exponent -= 0x6000;
+		}
+
+		feclearexcept(FE_ALL_EXCEPT);
+		result = x87_restrict_precision(emu, x87_float80_make(value1.value + value2.value));
+	}
+
+	if(fetestexcept(FE_UNDERFLOW))
+	{
+		// TODO: 8087/287 behaves differently to the IEEE standard
+		int exp1, exp2;
+		// unmasked response
+		x87_signal_exception_later(emu, X87_SW_UE);
+
+		frexp(value1.value, &exp1);
+		frexp(value2.value, &exp2);
+		if(exp1 >= exp2)
+		{
+			value1.value = ldexp(value1.value, exp1 + 0x6000);
+			value1.exponent += 0x6000;
+		}
+		else
+		{
+			value2.value = ldexp(value2.value, exp2 + 0x6000);
+			value2.exponent += 0x6000;
+		}
+
+		feclearexcept(FE_ALL_EXCEPT);
+		result = x87_restrict_precision(emu, x87_float80_make(value1.value + value2.value));
+	}
+
+	if(fetestexcept(FE_INEXACT))
+		x87_signal_exception_later(emu, X87_SW_PE);
+
+#else
 	// TODO
+	(void) emu;
 	(void) value1;
 	(void) value2;
-	return FLOAT80_ZERO;
+	result = FLOAT80_ZERO;
 #endif
+	return result;
 }
 
-static inline x87_float80_t x87_fmul(x86_state_t * emu, x87_float80_t value1, x87_float80_t value2)
+static inline x87_float80_t x87_fchs(x86_state_t * emu, x87_float80_t value)
 {
 	(void) emu;
 	// TODO: precision/rounding
 #if _SUPPORT_FLOAT80
-	return x87_float80_make(value1.value * value2.value);
+	return x87_float80_make(-value.value);
 #else
 	// TODO
-	(void) value1;
-	(void) value2;
+	(void) value;
 	return FLOAT80_ZERO;
 #endif
 }
 
-static inline x87_float80_t x87_fprem(x86_state_t * emu, x87_float80_t value1, x87_float80_t value2)
+static inline void x87_fcom(x86_state_t * emu, x87_float80_t value1, x87_float80_t value2)
 {
 	(void) emu;
 	// TODO: precision/rounding
 #if _SUPPORT_FLOAT80
+	if(value1.value > value2.value)
+	{
+		emu->x87.sw &= ~(X87_SW_C3 | X87_SW_C0);
+	}
+	else if(value1.value > value2.value)
+	{
+		emu->x87.sw &= ~X87_SW_C3;
+		emu->x87.sw |= X87_SW_C0;
+	}
+	else if(value1.value == value2.value)
+	{
+		emu->x87.sw |= X87_SW_C3;
+		emu->x87.sw &= ~X87_SW_C0;
+	}
+	else
+	{
+		emu->x87.sw |= X87_SW_C3;
+		emu->x87.sw |= X87_SW_C0;
+	}
+#else
+	// TODO
 	(void) value1;
 	(void) value2;
-	return x87_float80_make(0.0); // TODO
+#endif
+}
+
+static inline x87_float80_t x87_fdiv(x86_state_t * emu, x87_float80_t value1, x87_float80_t value2)
+{
+	(void) emu;
+	// TODO: precision/rounding
+#if _SUPPORT_FLOAT80
+	return x87_float80_make(value1.value / value2.value);
 #else
 	// TODO
 	(void) value1;
@@ -1543,28 +3845,28 @@ static inline x87_float80_t x87_fprem(x86_state_t * emu, x87_float80_t value1, x
 #endif
 }
 
-static inline void x87_fptan(x86_state_t * emu, x87_float80_t value, x87_float80_t * result1, x87_float80_t * result2)
+static inline x87_float80_t x87_fmul(x86_state_t * emu, x87_float80_t value1, x87_float80_t value2)
 {
 	(void) emu;
 	// TODO: precision/rounding
 #if _SUPPORT_FLOAT80
-	// TODO: better emulation of FPTAN
-	*result1 = x87_float80_make(1.0);
-	*result2 = x87_float80_make(tanl(value.value));
+	return x87_float80_make(value1.value * value2.value);
 #else
 	// TODO
-	(void) value;
-	(void) result1;
-	(void) result2;
+	(void) value1;
+	(void) value2;
+	return FLOAT80_ZERO;
 #endif
 }
 
-static inline x87_float80_t x87_fpatan(x86_state_t * emu, x87_float80_t value1, x87_float80_t value2)
+static inline x87_float80_t x87_fprem(x86_state_t * emu, x87_float80_t value1, x87_float80_t value2)
 {
 	(void) emu;
 	// TODO: precision/rounding
 #if _SUPPORT_FLOAT80
-	return x87_float80_make(atan2l(value1.value, value2.value));
+	(void) value1;
+	(void) value2;
+	return x87_float80_make(0.0); // TODO
 #else
 	// TODO
 	(void) value1;
@@ -1684,34 +3986,6 @@ static inline void x87_fxtract(x86_state_t * emu, x87_float80_t value, x87_float
 #endif
 }
 
-static inline x87_float80_t x87_fyl2x(x86_state_t * emu, x87_float80_t value1, x87_float80_t value2)
-{
-	(void) emu;
-	// TODO: precision/rounding
-#if _SUPPORT_FLOAT80
-	return x87_float80_make(value2.value * log2l(value1.value));
-#else
-	// TODO
-	(void) value1;
-	(void) value2;
-	return FLOAT80_ZERO;
-#endif
-}
-
-static inline x87_float80_t x87_fyl2xp1(x86_state_t * emu, x87_float80_t value1, x87_float80_t value2)
-{
-	(void) emu;
-	// TODO: precision/rounding
-#if _SUPPORT_FLOAT80
-	return x87_float80_make(value2.value * log2l(value1.value + 1));
-#else
-	// TODO
-	(void) value1;
-	(void) value2;
-	return FLOAT80_ZERO;
-#endif
-}
-
 static inline void x87_state_save_registers(x86_state_t * emu, x86_segnum_t segment, uoff_t x86_offset, uoff_t offset)
 {
 	for(int i = 0; i < 8; i++)
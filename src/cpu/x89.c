@@ -366,6 +366,165 @@ static const char * x89_base_register_name[] =
 #define _REGFLD ((ins >> 5) & 7)
 #define _BASEFLD ((ins >> 8) & 3)
 
+// Bulk transfers, used when a run of elements can be moved without interpreting each one
+// Each run stays within a single page of memory, so that the channel still yields to the other processors
+
+#define X89_BLOCK_SIZE 0x1000
+
+// Number of elements that fit before the next page boundary
+static inline size_t x89_block_count(x89_address_t addr, size_t size)
+{
+	return (X89_BLOCK_SIZE - (addr.address & (X89_BLOCK_SIZE - 1))) / size;
+}
+
+// Returns the index of the first element whose low byte matches (or differs from) the masked compare value, count if there is none
+static inline size_t x89_block_compare(const uint8_t * buffer, size_t size, size_t count, uint16_t mc, bool match)
+{
+	uint64_t lanes = size == 1 ? 0x0101010101010101 : 0x0001000100010001;
+	uint64_t high = lanes * (size == 1 ? 0x80 : 0x8000);
+	uint64_t value = lanes * (mc & 0xFF);
+	uint64_t mask = lanes * ((mc >> 8) & 0xFF);
+	size_t length = count * size;
+	size_t offset;
+
+	// test 8 bytes at a time, the top bit of each lane is set if any of its masked bits differ
+	for(offset = 0; offset + 8 <= length; offset += 8)
+	{
+		uint64_t word;
+		memcpy(&word, buffer + offset, 8);
+		word = (le64toh(word) ^ value) & mask;
+		uint64_t differs = (((word & ~high) + ~high) | word) & high;
+		if(match)
+			differs ^= high;
+		if(differs != 0)
+			return (offset + (_ctz64(differs) >> 3)) / size;
+	}
+
+	for(size_t index = offset / size; index < count; index++)
+	{
+		if((((buffer[index * size] ^ mc) & (mc >> 8) & 0xFF) == 0) == match)
+			return index;
+	}
+	return count;
+}
+
+// Moves a run of elements in one step, returns false if the next element must be transferred individually
+static inline bool x89_channel_transfer_block(x86_state_t * emu, unsigned channel_number, x89_regnum_t gs, x89_regnum_t gd, size_t size)
+{
+	uint16_t cc = emu->x89.channel[channel_number].r[X89_R_CC].address;
+	unsigned termination = (cc >> X89_CC_TSH_SHIFT) & 7;
+	x89_address_t src = emu->x89.channel[channel_number].r[gs];
+	x89_address_t dst = emu->x89.channel[channel_number].r[gd];
+	bool src_increment = (cc & X89_CC_F0) != 0;
+	bool dst_increment = (cc & X89_CC_F1) != 0;
+	const x86_port_handler_t * src_handler = NULL;
+	const x86_port_handler_t * dst_handler = NULL;
+	size_t count = X89_BLOCK_SIZE / size;
+
+	// single transfers and translated bytes are left to the per element path
+	if((cc & (X89_CC_TS | X89_CC_TR)) != 0)
+		return false;
+
+	if(src.tag == 0)
+	{
+		if(!src_increment)
+			return false;
+		count = min(count, x89_block_count(src, size));
+	}
+	else
+	{
+		// a device cannot be read past the element that terminates the transfer
+		if(src_increment || (termination & 3) != 0)
+			return false;
+		src_handler = x86_port_get_block_handler(emu, (uint16_t)src.address, size);
+		if(src_handler == NULL || src_handler->read_block == NULL)
+			return false;
+	}
+
+	if(dst.tag == 0)
+	{
+		if(!dst_increment)
+			return false;
+		count = min(count, x89_block_count(dst, size));
+	}
+	else
+	{
+		if(dst_increment)
+			return false;
+		dst_handler = x86_port_get_block_handler(emu, (uint16_t)dst.address, size);
+		if(dst_handler == NULL || dst_handler->write_block == NULL)
+			return false;
+	}
+
+	if(src.tag == 0 && dst.tag == 0 && src.address < dst.address && (size_t)(dst.address - src.address) < count * size)
+	{
+		// the source must not be read after it was overwritten
+		count = (dst.address - src.address) / size;
+	}
+
+	if((cc & X89_CC_TBC_MASK) != 0)
+		count = min(count, emu->x89.channel[channel_number].r[X89_R_BC].address & 0xFFFF);
+
+	if(count < 2)
+		return false;
+
+	uint8_t buffer[X89_BLOCK_SIZE];
+	if(src_handler == NULL)
+	{
+		x86_memory_read_external(emu, src.address, count * size, buffer);
+	}
+	else
+	{
+		x86_check_breakpoints(emu, X86_ACCESS_IO, (uint16_t)src.address, size);
+		emu->port22_accessed = false;
+		src_handler->read_block(emu, src_handler->data, (uint16_t)src.address, size, count, buffer);
+	}
+
+	bool terminated = false;
+	if((termination & 3) != 0)
+	{
+		size_t index = x89_block_compare(buffer, size, count, emu->x89.channel[channel_number].r[X89_R_MC].address, termination < 4);
+		if(index < count)
+		{
+			count = index + 1;
+			terminated = true;
+		}
+	}
+
+	if(dst_handler == NULL)
+	{
+		x86_memory_write_external(emu, dst.address, count * size, buffer);
+	}
+	else
+	{
+		x86_check_breakpoints(emu, X86_ACCESS_IO, (uint16_t)dst.address, size);
+		emu->port22_accessed = false;
+		dst_handler->write_block(emu, dst_handler->data, (uint16_t)dst.address, size, count, buffer);
+	}
+
+	emu->x89.channel[channel_number].r[X89_R_BC].address = (emu->x89.channel[channel_number].r[X89_R_BC].address - count) & 0xFFFF;
+	if(src_increment)
+		emu->x89.channel[channel_number].r[gs].address += count * size;
+	if(dst_increment)
+		emu->x89.channel[channel_number].r[gd].address += count * size;
+
+	if(terminated)
+	{
+		emu->x89.channel[channel_number].psw &= ~X89_PSW_XF;
+		switch(termination & 3)
+		{
+		case 2:
+			emu->x89.channel[channel_number].r[X89_R_TP].address += 4;
+			break;
+		case 3:
+			emu->x89.channel[channel_number].r[X89_R_TP].address += 8;
+			break;
+		}
+	}
+
+	return true;
+}
+
 static inline bool x89_channel_transfer(x86_state_t * emu, unsigned channel_number)
 {
 	if((emu->x89.channel[channel_number].psw & X89_PSW_XF) == 0)
@@ -397,6 +556,9 @@ static inline bool x89_channel_transfer(x86_state_t * emu, unsigned channel_numb
 		}
 	}
 
+	if(src_size == dst_size && x89_channel_transfer_block(emu, channel_number, gs, gd, src_size))
+		return true;
+
 	// TODO: do we count source or destination?
 	emu->x89.channel[channel_number].r[X89_R_BC].address = (emu->x89.channel[channel_number].r[X89_R_BC].address - 1) & 0xFFFF;
 
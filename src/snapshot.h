@@ -0,0 +1,39 @@
+#ifndef __SNAPSHOT_H
+#define __SNAPSHOT_H
+
+// Machine snapshot format, written by x86emu -s and restored by x86emu -r
+
+#include <stdint.h>
+
+#define SNAPSHOT_MAGIC "X86SNAPS"
+#define SNAPSHOT_VERSION 1
+
+/*
+	The snapshot file is a header, a copy of x86_state_t, the device state of the emulator and a table of memory extents
+	Guest memory follows as the contents of the extents, each starting at a multiple of page_size so that it can be mapped directly
+	Pages that only contain zeros are not stored
+*/
+typedef struct snapshot_header_t
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t page_size; // alignment of the memory extents in the file
+	uint32_t state_size; // size of x86_state_t, snapshots can only be restored by the same build
+	uint32_t device_size; // size of the device state
+	uint64_t extent_count;
+	uint64_t data_offset; // start of the first memory extent
+	int32_t cpu_version; // index into x86_cpu_traits
+	int32_t pc_type;
+	uint32_t system_type;
+	uint32_t address_bits; // physical address width of guest memory
+	uint8_t reserved[16];
+} snapshot_header_t;
+
+typedef struct snapshot_extent_t
+{
+	uint64_t address; // guest physical address
+	uint64_t length; // multiple of page_size
+	uint64_t offset; // position in the file
+} snapshot_extent_t;
+
+#endif // __SNAPSHOT_H
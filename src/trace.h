@@ -0,0 +1,56 @@
+#ifndef __TRACE_H
+#define __TRACE_H
+
+// Binary instruction trace format, written by x86emu -t and rendered by x86trace
+
+#include <stdint.h>
+
+#define TRACE_MAGIC "X86TRACE"
+#define TRACE_VERSION 1
+
+/*
+	The trace file is a header followed by a ring of fixed size records
+	Once the ring is full, the oldest records are overwritten, the oldest surviving record is at index count % capacity
+*/
+typedef struct trace_header_t
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t record_size;
+	uint64_t capacity; // number of records in the ring
+	uint64_t count; // total number of records written
+	int32_t cpu_version; // index into x86_cpu_traits
+	int32_t fpu_type;
+	int32_t fpu_subtype;
+	uint8_t use_nec_syntax;
+	uint8_t x80_cpu_type;
+	uint8_t use_intel8080_syntax;
+	uint8_t reserved[17];
+} trace_header_t;
+
+typedef enum trace_record_type_t
+{
+	TRACE_INSTRUCTION = 1,
+	TRACE_REGISTER,
+	TRACE_MEMORY_WRITE,
+} trace_record_type_t;
+
+// register number used for FLAGS in TRACE_REGISTER records, other numbers are indexes into the general purpose registers
+#define TRACE_REGISTER_FLAGS 0xFF
+
+typedef struct trace_record_t
+{
+	uint8_t type;
+	uint8_t length; // instruction or memory: number of valid bytes in data, register: register number
+	uint8_t code_size; // instruction: SIZE_8BIT (8080 emulation), SIZE_16BIT, SIZE_32BIT or SIZE_64BIT
+	uint8_t reserved;
+	uint32_t offset; // instruction: low 32 bits of the instruction pointer
+	union
+	{
+		uint64_t address; // instruction: linear address, memory: physical address
+		uint64_t value; // register: new value
+	};
+	uint8_t data[16]; // instruction: bytes starting at the instruction pointer, memory: bytes written
+} trace_record_t;
+
+#endif // __TRACE_H
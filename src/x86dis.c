@@ -0,0 +1,498 @@
+// Standalone disassembler for raw binary files, using the instruction parser of the emulator
+
+#include "cpu/cpu.h"
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cpu/x86.list.c"
+
+// amount of input given to a single thread at a time
+#define CHUNK_SIZE (1 << 20)
+
+/*
+	Parser reading directly from the mapped file
+	The parser must be the first member so that the fetch callbacks can recover the structure
+*/
+typedef struct dis_parser_t
+{
+	x86_parser_t parser[1];
+	x89_parser_t parser89[1]; // used instead of parser for 8089 channel programs
+	bool is_8089;
+	const uint8_t * data;
+	uoff_t base_address; // address of data[0]
+	size_t size;
+	uoff_t end_position; // one past the last byte fetched
+} dis_parser_t;
+
+static uint8_t dis_fetch8(x86_parser_t * prs)
+{
+	dis_parser_t * dis = (dis_parser_t *)prs;
+	size_t index = prs->current_position++ - dis->base_address;
+	dis->end_position = prs->current_position;
+	return index < dis->size ? dis->data[index] : 0;
+}
+
+static uint16_t dis_fetch16(x86_parser_t * prs)
+{
+	uint16_t value = dis_fetch8(prs);
+	return value | (dis_fetch8(prs) << 8);
+}
+
+static uint32_t dis_fetch32(x86_parser_t * prs)
+{
+	uint32_t value = dis_fetch16(prs);
+	return value | ((uint32_t)dis_fetch16(prs) << 16);
+}
+
+static uint64_t dis_fetch64(x86_parser_t * prs)
+{
+	uint64_t value = dis_fetch32(prs);
+	return value | ((uint64_t)dis_fetch32(prs) << 32);
+}
+
+static uint8_t dis_fetch8_8089(x89_parser_t * prs)
+{
+	dis_parser_t * dis = (dis_parser_t *)((char *)prs - offsetof(dis_parser_t, parser89));
+	size_t index = prs->current_position++ - dis->base_address;
+	dis->end_position = prs->current_position;
+	return index < dis->size ? dis->data[index] : 0;
+}
+
+static uint16_t dis_fetch16_8089(x89_parser_t * prs)
+{
+	uint16_t value = dis_fetch8_8089(prs);
+	return value | (dis_fetch8_8089(prs) << 8);
+}
+
+// Growable text buffer
+typedef struct text_buffer_t
+{
+	char * text;
+	size_t length;
+	size_t capacity;
+} text_buffer_t;
+
+static char * text_reserve(text_buffer_t * buffer, size_t count)
+{
+	if(buffer->length + count > buffer->capacity)
+	{
+		buffer->capacity = buffer->capacity == 0 ? 0x10000 : buffer->capacity * 2;
+		if(buffer->capacity < buffer->length + count)
+			buffer->capacity = buffer->length + count;
+		buffer->text = realloc(buffer->text, buffer->capacity);
+		if(buffer->text == NULL)
+		{
+			fprintf(stderr, "Out of memory\n");
+			exit(1);
+		}
+	}
+	return &buffer->text[buffer->length];
+}
+
+// Decodes a single instruction at position and appends its textual form to the buffer, returns the length of the instruction
+static size_t disassemble_instruction(dis_parser_t * dis, uoff_t position, text_buffer_t * buffer)
+{
+	static const char hex[] = "0123456789ABCDEF";
+
+	const char * debug_output;
+	size_t text_length;
+	dis->end_position = position;
+	if(dis->is_8089)
+	{
+		x89_parser_t * prs = dis->parser89;
+		prs->current_position = position;
+		prs->debug_output[0] = '\0';
+		prs->debug_length = 0;
+		x89_disassemble(prs, NULL, 0);
+		debug_output = prs->debug_output;
+		text_length = prs->debug_length;
+	}
+	else
+	{
+		x86_parser_t * prs = dis->parser;
+		prs->current_position = position;
+		prs->debug_output[0] = '\0';
+		prs->debug_length = 0;
+		x86_disassemble(prs, NULL);
+		debug_output = prs->debug_output;
+		text_length = prs->debug_length;
+	}
+	size_t length = dis->end_position - position;
+	if(length == 0)
+	{
+		// make sure the disassembly always advances
+		length = 1;
+		dis->end_position = position + 1;
+	}
+
+	int digits = 8;
+	while(digits < 16 && (position >> (4 * digits)) != 0)
+		digits++;
+	char * text = text_reserve(buffer, digits + 1 + 2 * length + 1 + text_length + 1);
+	char * start = text;
+
+	for(int i = digits - 1; i >= 0; i--)
+		*text++ = hex[(position >> (4 * i)) & 0xF];
+	*text++ = '\t';
+	for(size_t i = 0; i < length; i++)
+	{
+		size_t index = position + i - dis->base_address;
+		uint8_t byte = index < dis->size ? dis->data[index] : 0;
+		*text++ = hex[byte >> 4];
+		*text++ = hex[byte & 0xF];
+	}
+	*text++ = '\t';
+	memcpy(text, debug_output, text_length);
+	text += text_length;
+	if(text_length == 0 || text[-1] != '\n')
+		*text++ = '\n';
+
+	buffer->length += text - start;
+	return length;
+}
+
+// Instructions decoded by a thread, independently of the previous chunks
+typedef struct chunk_t
+{
+	dis_parser_t dis;
+	uoff_t start, end; // addresses
+	text_buffer_t output;
+	size_t count;
+	size_t capacity;
+	struct
+	{
+		uoff_t position;
+		size_t length;
+		size_t text_offset;
+	} * instructions;
+	pthread_t thread;
+} chunk_t;
+
+static void * chunk_disassemble(void * arg)
+{
+	chunk_t * chunk = arg;
+	chunk->output.length = 0;
+	chunk->count = 0;
+	for(uoff_t position = chunk->start; position < chunk->end; )
+	{
+		if(chunk->count >= chunk->capacity)
+		{
+			chunk->capacity = chunk->capacity == 0 ? 0x4000 : chunk->capacity * 2;
+			chunk->instructions = realloc(chunk->instructions, chunk->capacity * sizeof chunk->instructions[0]);
+			if(chunk->instructions == NULL)
+			{
+				fprintf(stderr, "Out of memory\n");
+				exit(1);
+			}
+		}
+		chunk->instructions[chunk->count].position = position;
+		chunk->instructions[chunk->count].text_offset = chunk->output.length;
+		size_t length = disassemble_instruction(&chunk->dis, position, &chunk->output);
+		chunk->instructions[chunk->count].length = length;
+		chunk->count++;
+		position += length;
+	}
+	return NULL;
+}
+
+static void usage(char * argv0)
+{
+	printf(
+		"x86dis - Disassembles a raw binary file\n"
+		"\tUsage: %s [options] <input file name>\n"
+		"Options:\n"
+		"\t-c <cpu>\tselect CPU type, write x86emu -hc to display list of all supported types (default: extended)\n"
+		"\t-f <fpu>\tselect FPU type, write x86emu -hf to display list of all supported types (default: depends on CPU)\n"
+		"\t-m <bits>\tselect code size, 16, 32 or 64, or 8089 for Intel 8089 channel programs (default: 16)\n"
+		"\t-o <offset>\tfile offset to start disassembling at (default: 0)\n"
+		"\t-l <length>\tnumber of bytes to disassemble (default: until end of file)\n"
+		"\t-a <address>\taddress of the first byte (default: same as file offset)\n"
+		"\t-j <count>\tnumber of threads to use (default: 1)\n"
+		"\t-h\tdisplay this help page\n"
+		"The output consists of the address, instruction bytes and instruction text, separated by tabs\n"
+		"When using multiple threads, the input is split into chunks that are decoded separately and resynchronized to the same instruction boundaries as a single pass\n",
+		argv0);
+}
+
+int main(int argc, char * argv[])
+{
+	const char * inputfile = NULL;
+	x86_cpu_version_t cpu_version = X86_CPU_TYPE_EXTENDED;
+	x87_fpu_type_t fpu_type = (x87_fpu_type_t)-1;
+	x87_fpu_subtype_t fpu_subtype = 0;
+	int code_size = SIZE_16BIT;
+	uint64_t file_offset = 0;
+	uint64_t length = (uint64_t)-1;
+	uint64_t address = (uint64_t)-1;
+	long thread_count = 1;
+	bool is_8089 = false;
+
+	int argi;
+	for(argi = 1; argi < argc; argi++)
+	{
+		if(argv[argi][0] == '-')
+		{
+			if(argv[argi][1] == 'h')
+			{
+				usage(argv[0]);
+				exit(0);
+			}
+
+			char option = argv[argi][1];
+			char * arg = argv[argi][2] ? &argv[argi][2] : argv[++argi];
+			if(arg == NULL)
+			{
+				fprintf(stderr, "Missing argument for -%c\n", option);
+				exit(1);
+			}
+
+			switch(option)
+			{
+			case 'c':
+				{
+					bool found = false;
+					for(size_t i = 0; i < sizeof supported_cpu_table / sizeof supported_cpu_table[0]; i++)
+					{
+						if(strcmp(supported_cpu_table[i].name, arg) == 0)
+						{
+							cpu_version = supported_cpu_table[i].type;
+							found = true;
+							break;
+						}
+					}
+					if(!found)
+					{
+						fprintf(stderr, "Unknown CPU type: %s\n", arg);
+						exit(1);
+					}
+				}
+				break;
+			case 'f':
+				if(strcasecmp(arg, "none") == 0
+				|| strcasecmp(arg, "no") == 0)
+				{
+					fpu_type = X87_FPU_NONE;
+					fpu_subtype = 0;
+				}
+				else
+				{
+					bool found = false;
+					for(size_t i = 0; i < sizeof supported_fpu_table / sizeof supported_fpu_table[0]; i++)
+					{
+						if(strcmp(supported_fpu_table[i].name, arg) == 0)
+						{
+							fpu_type = supported_fpu_table[i].type;
+							fpu_subtype = supported_fpu_table[i].subtype;
+							found = true;
+							break;
+						}
+					}
+					if(!found)
+					{
+						fprintf(stderr, "Unknown FPU type: %s\n", arg);
+						exit(1);
+					}
+				}
+				break;
+			case 'm':
+				switch(strtol(arg, NULL, 10))
+				{
+				case 16:
+					code_size = SIZE_16BIT;
+					break;
+				case 32:
+					code_size = SIZE_32BIT;
+					break;
+				case 64:
+					code_size = SIZE_64BIT;
+					break;
+				case 8089:
+					is_8089 = true;
+					break;
+				default:
+					fprintf(stderr, "Invalid code size: %s\n", arg);
+					exit(1);
+				}
+				break;
+			case 'o':
+				file_offset = strtoull(arg, NULL, 0);
+				break;
+			case 'l':
+				length = strtoull(arg, NULL, 0);
+				break;
+			case 'a':
+				address = strtoull(arg, NULL, 0);
+				break;
+			case 'j':
+				thread_count = strtol(arg, NULL, 0);
+				if(thread_count <= 0)
+					thread_count = sysconf(_SC_NPROCESSORS_ONLN);
+				if(thread_count <= 0)
+					thread_count = 1;
+				break;
+			default:
+				fprintf(stderr, "Error: Unknown flag `-%c`\n", option);
+				exit(1);
+			}
+		}
+		else
+		{
+			inputfile = argv[argi];
+			break;
+		}
+	}
+
+	if(inputfile == NULL)
+	{
+		fprintf(stderr, "No input file provided\n");
+		exit(1);
+	}
+
+	int fd = open(inputfile, O_RDONLY);
+	struct stat st;
+	if(fd == -1 || fstat(fd, &st) != 0)
+	{
+		fprintf(stderr, "Invalid input file %s\n", inputfile);
+		exit(1);
+	}
+
+	if(file_offset >= (uint64_t)st.st_size)
+	{
+		close(fd);
+		return 0;
+	}
+	if(length > (uint64_t)st.st_size - file_offset)
+		length = (uint64_t)st.st_size - file_offset;
+	if(address == (uint64_t)-1)
+		address = file_offset;
+
+	const uint8_t * mapping = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(mapping == MAP_FAILED)
+	{
+		fprintf(stderr, "Unable to map input file %s\n", inputfile);
+		exit(1);
+	}
+	madvise((void *)mapping, st.st_size, MADV_SEQUENTIAL);
+
+	dis_parser_t dis;
+	memset(&dis, 0, sizeof dis);
+	x86_parser_t * prs = dis.parser;
+	prs->cpu_traits = x86_cpu_traits[cpu_version];
+	prs->use_nec_syntax = x86_is_nec(prs);
+	if((prs->cpu_traits.cpuid1.edx & X86_CPUID1_EDX_FPU) != 0)
+	{
+		prs->fpu_type = X87_FPU_INTEGRATED;
+	}
+	else if(fpu_type == X87_FPU_NONE)
+	{
+		prs->fpu_type = X87_FPU_NONE;
+	}
+	else if(fpu_type != (x87_fpu_type_t)-1 && (prs->cpu_traits.supported_fpu_types & (1 << fpu_type)) != 0)
+	{
+		prs->fpu_type = fpu_type;
+		prs->fpu_subtype = fpu_subtype;
+	}
+	else
+	{
+		prs->fpu_type = prs->cpu_traits.default_fpu;
+	}
+	prs->code_size = code_size;
+	prs->fetch8 = dis_fetch8;
+	prs->fetch16 = dis_fetch16;
+	prs->fetch32 = dis_fetch32;
+	prs->fetch64 = dis_fetch64;
+	static uint8_t opcode_translation_table[256];
+	for(int i = 0; i < 256; i++)
+		opcode_translation_table[i] = i;
+	prs->opcode_translation_table = &opcode_translation_table;
+	dis.is_8089 = is_8089;
+	dis.parser89->fetch8 = dis_fetch8_8089;
+	dis.parser89->fetch16 = dis_fetch16_8089;
+
+	dis.data = mapping + file_offset;
+	dis.base_address = address;
+	dis.size = length;
+
+	uoff_t end = address + length;
+	uoff_t position = address;
+	text_buffer_t output = { NULL, 0, 0 };
+
+	if(thread_count <= 1)
+	{
+		while(position < end)
+		{
+			position += disassemble_instruction(&dis, position, &output);
+			if(output.length >= CHUNK_SIZE)
+			{
+				fwrite(output.text, 1, output.length, stdout);
+				output.length = 0;
+			}
+		}
+		fwrite(output.text, 1, output.length, stdout);
+		return 0;
+	}
+
+	chunk_t * chunks = calloc(thread_count, sizeof(chunk_t));
+	if(chunks == NULL)
+	{
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+
+	while(position < end)
+	{
+		// decode the next thread_count chunks in parallel, each one starting at its first byte
+		long used_chunks = 0;
+		for(uoff_t chunk_start = position; used_chunks < thread_count && chunk_start < end; used_chunks++)
+		{
+			chunk_t * chunk = &chunks[used_chunks];
+			chunk->dis = dis;
+			chunk->start = chunk_start;
+			chunk->end = end - chunk_start > CHUNK_SIZE ? chunk_start + CHUNK_SIZE : end;
+			chunk_start = chunk->end;
+			if(pthread_create(&chunk->thread, NULL, chunk_disassemble, chunk) != 0)
+			{
+				fprintf(stderr, "Unable to create thread\n");
+				exit(1);
+			}
+		}
+
+		for(long i = 0; i < used_chunks; i++)
+		{
+			chunk_t * chunk = &chunks[i];
+			pthread_join(chunk->thread, NULL);
+
+			// the previous chunk may have ended inside an instruction, skip ahead until both decodings agree on an instruction boundary
+			size_t index = 0;
+			while(position < chunk->end)
+			{
+				while(index < chunk->count && chunk->instructions[index].position < position)
+					index++;
+				if(index < chunk->count && chunk->instructions[index].position == position)
+					break;
+				output.length = 0;
+				position += disassemble_instruction(&dis, position, &output);
+				fwrite(output.text, 1, output.length, stdout);
+			}
+
+			if(position < chunk->end)
+			{
+				// from here on, the chunk follows the same instruction boundaries
+				fwrite(&chunk->output.text[chunk->instructions[index].text_offset], 1, chunk->output.length - chunk->instructions[index].text_offset, stdout);
+				position = chunk->instructions[chunk->count - 1].position + chunk->instructions[chunk->count - 1].length;
+			}
+		}
+	}
+
+	return 0;
+}
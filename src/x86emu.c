@@ -1,12 +1,20 @@
 
 #include "cpu/cpu.h"
+#include "snapshot.h"
+#include "trace.h"
 
 #include <assert.h>
+#include <fcntl.h>
 #include <inttypes.h>
 #include <poll.h>
+#include <signal.h>
 #include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/shm.h>
+#include <sys/time.h>
+#include <sys/wait.h>
 #include <termios.h>
 #include <unistd.h>
 
@@ -859,82 +867,257 @@ static inline void kbd_issue(x86_state_t * emu, int key, bool press)
 
 static bool necpc88va_v3_memory_mode = true;
 
-typedef uint8_t page_t[0x1000];
-typedef page_t * page_table_t[0x1000];
+//// Guest physical memory
 
-static page_table_t _directory;
+/*
+	Guest memory is reserved in regions of up to 1 GiB with MAP_NORESERVE, host memory is only committed for pages the guest writes to
+	Untouched pages inside a region are backed by the zero page of the host kernel, and reads from regions that were never written to return zeros without reserving anything
+*/
+#define MEMORY_REGION_SHIFT 30
+// number of 4 KiB pages covered by the memory map, memory above it is always plain RAM
+#define MEMORY_MAP_PAGE_COUNT 0x100
 
-static inline page_t * _get_page(uaddr_t address)
+// alignment of regions, so that they can be backed by 2 MiB host pages
+#define MEMORY_HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+static struct
 {
-	address >>= 12;
-	address &= 0xFFF;
-	if(_directory[address] == NULL)
+	unsigned address_bits;
+	uaddr_t address_mask;
+	unsigned region_shift;
+	uint8_t ** regions;
+	uaddr_t * allocated_regions; // indexes of the regions in regions that are allocated
+	size_t allocated_region_count;
+	bool huge_pages; // ask for transparent huge pages
+	bool hugetlb; // use explicit 2 MiB pages from hugetlbfs
+	uaddr_t prefault_size; // amount of memory to commit before execution
+} _memory;
+
+static void _memory_parse_options(char * arg)
+{
+	for(char * option = strtok(arg, ","); option != NULL; option = strtok(NULL, ","))
 	{
-		_directory[address] = malloc(sizeof(page_t));
-		memset(_directory[address], 0, sizeof(page_t));
+		if(strcasecmp(option, "huge") == 0)
+		{
+			_memory.huge_pages = true;
+		}
+		else if(strcasecmp(option, "hugetlb") == 0)
+		{
+			_memory.hugetlb = true;
+		}
+		else if(strncasecmp(option, "prefault=", 9) == 0)
+		{
+			char * end;
+			_memory.prefault_size = strtoull(option + 9, &end, 0);
+			switch(*end)
+			{
+			case 'k':
+			case 'K':
+				_memory.prefault_size <<= 10;
+				break;
+			case 'm':
+			case 'M':
+				_memory.prefault_size <<= 20;
+				break;
+			case 'g':
+			case 'G':
+				_memory.prefault_size <<= 30;
+				break;
+			}
+		}
+		else if('0' <= option[0] && option[0] <= '9')
+		{
+			_memory.address_bits = strtol(option, NULL, 10);
+			if(_memory.address_bits < 20 || _memory.address_bits > 52)
+			{
+				fprintf(stderr, "Invalid physical address width: %s\n", option);
+				exit(1);
+			}
+		}
+		else
+		{
+			fprintf(stderr, "Unknown memory option: %s\n", option);
+			exit(1);
+		}
 	}
-	return _directory[address];
 }
 
-static void _memory_read_direct(x86_cpu_level_t memory_space, uaddr_t address, void * buffer, size_t size)
+static uint8_t * _memory_get_pointer(uaddr_t address);
+static void _memory_map_remap(uaddr_t address, uaddr_t size, uaddr_t target);
+
+static void _memory_setup(unsigned default_address_bits)
 {
-	(void) memory_space;
-	for(;;)
+	if(_memory.address_bits == 0)
+		_memory.address_bits = default_address_bits;
+	_memory.address_mask = ((uaddr_t)1 << _memory.address_bits) - 1;
+	_memory.region_shift = min(_memory.address_bits, MEMORY_REGION_SHIFT);
+	// large tables are allocated through mmap by the C library, so only the touched parts of the table take up memory
+	_memory.regions = calloc((size_t)1 << (_memory.address_bits - _memory.region_shift), sizeof(uint8_t *));
+	if(_memory.regions == NULL)
+	{
+		fprintf(stderr, "Unable to allocate guest memory\n");
+		exit(1);
+	}
+
+	_memory_map_remap(0, MEMORY_MAP_PAGE_COUNT << 12, 0);
+
+	// commit the start of memory up front, so that the guest does not take page faults on the host later
+	uaddr_t region_size = (uaddr_t)1 << _memory.region_shift;
+	uaddr_t prefault_size = min(_memory.prefault_size, _memory.address_mask);
+	for(uaddr_t address = 0; address < prefault_size; address += region_size)
+	{
+		memset(_memory_get_pointer(address), 0, min(region_size, prefault_size - address));
+	}
+}
+
+static uint8_t * _memory_allocate_region(uaddr_t index)
+{
+	size_t size = (size_t)1 << _memory.region_shift;
+	void * region = MAP_FAILED;
+
+	if(_memory.hugetlb && size >= MEMORY_HUGE_PAGE_SIZE)
 	{
-		page_t * page = _get_page(address);
-		uint16_t offset = address & 0xFFF;
-		if(offset + size <= 0x1000)
+		// the pages are reserved from the pool up front, otherwise running out of huge pages would only be reported by a SIGBUS on first access
+		region = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (21 << MAP_HUGE_SHIFT), -1, 0);
+		if(region == MAP_FAILED)
 		{
-			memcpy(buffer, *page + offset, size);
-			break;
+			fprintf(stderr, "Unable to allocate huge pages, falling back to normal pages\n");
+			_memory.hugetlb = false;
 		}
-		else
+	}
+
+	if(region == MAP_FAILED && _memory.huge_pages && size >= MEMORY_HUGE_PAGE_SIZE)
+	{
+		// over-allocate so that the region can be aligned to a huge page boundary
+		uint8_t * mapping = mmap(NULL, size + MEMORY_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if(mapping != MAP_FAILED)
 		{
-			size_t actual_size = 0x1000 - offset;
-			memcpy(buffer, *page + offset, actual_size);
-			buffer += actual_size;
-			size -= actual_size;
-			address = (address + actual_size) & ~0xFFF;
+			uint8_t * aligned = (uint8_t *)(((uintptr_t)mapping + MEMORY_HUGE_PAGE_SIZE - 1) & ~(MEMORY_HUGE_PAGE_SIZE - 1));
+			if(aligned != mapping)
+				munmap(mapping, aligned - mapping);
+			munmap(aligned + size, mapping + MEMORY_HUGE_PAGE_SIZE - aligned);
+			madvise(aligned, size, MADV_HUGEPAGE);
+			region = aligned;
 		}
 	}
+
+	if(region == MAP_FAILED)
+		region = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+	_memory.allocated_regions = realloc(_memory.allocated_regions, (_memory.allocated_region_count + 1) * sizeof(uaddr_t));
+	if(region == MAP_FAILED || _memory.allocated_regions == NULL)
+	{
+		fprintf(stderr, "Unable to allocate guest memory\n");
+		exit(1);
+	}
+	_memory.allocated_regions[_memory.allocated_region_count++] = index;
+	return _memory.regions[index] = region;
+}
+
+// Returns a host pointer to guest physical memory, the memory is contiguous up to the next 1 GiB boundary
+static uint8_t * _memory_get_pointer(uaddr_t address)
+{
+	address &= _memory.address_mask;
+	uaddr_t index = address >> _memory.region_shift;
+	uint8_t * region = _memory.regions[index];
+	if(region == NULL)
+		region = _memory_allocate_region(index);
+	return region + (address & (((uaddr_t)1 << _memory.region_shift) - 1));
+}
+
+//// Memory map
+
+typedef void (* memory_write_handler_t)(x86_state_t * emu, uaddr_t address, size_t size);
+
+/*
+	Each page of the first megabyte of physical memory records where its contents are stored and an optional handler that is called after every write to it
+	Pages of remapped windows point to the storage of a different page and use the handler of that page
+*/
+typedef struct memory_page_t
+{
+	uint8_t * host;
+	uaddr_t address; // physical address of the storage, passed to the handler
+	memory_write_handler_t write_handler;
+} memory_page_t;
+
+static memory_page_t _memory_map[MEMORY_MAP_PAGE_COUNT];
+// handlers registered for each physical page
+static memory_write_handler_t _memory_page_handlers[MEMORY_MAP_PAGE_COUNT];
+
+static inline memory_write_handler_t _memory_page_handler(uaddr_t address)
+{
+	return address < MEMORY_MAP_PAGE_COUNT << 12 ? _memory_page_handlers[address >> 12] : NULL;
+}
+
+// Redirects accesses to the pages in address...address+size-1 to the pages starting at target
+static void _memory_map_remap(uaddr_t address, uaddr_t size, uaddr_t target)
+{
+	for(uaddr_t offset = 0; offset < size; offset += 0x1000)
+	{
+		memory_page_t * page = &_memory_map[(address + offset) >> 12];
+		page->host = _memory_get_pointer(target + offset);
+		page->address = target + offset;
+		page->write_handler = _memory_page_handler(page->address);
+	}
+}
+
+// Installs a handler that is called after writes to the pages in address...address+size-1
+static void _memory_map_register(uaddr_t address, uaddr_t size, memory_write_handler_t handler)
+{
+	for(uaddr_t offset = 0; offset < size; offset += 0x1000)
+	{
+		_memory_page_handlers[(address + offset) >> 12] = handler;
+	}
+
+	for(size_t index = 0; index < MEMORY_MAP_PAGE_COUNT; index++)
+	{
+		_memory_map[index].write_handler = _memory_page_handler(_memory_map[index].address);
+	}
+}
+
+static void _memory_read_direct(x86_cpu_level_t memory_space, uaddr_t address, void * buffer, size_t size)
+{
+	(void) memory_space;
+	while(size > 0)
+	{
+		address &= _memory.address_mask;
+		uaddr_t offset = address & (((uaddr_t)1 << _memory.region_shift) - 1);
+		size_t actual_size = min(size, ((uaddr_t)1 << _memory.region_shift) - offset);
+		uint8_t * region = _memory.regions[address >> _memory.region_shift];
+		if(region == NULL)
+			memset(buffer, 0, actual_size);
+		else
+			memcpy(buffer, region + offset, actual_size);
+		buffer += actual_size;
+		size -= actual_size;
+		address += actual_size;
+	}
 }
 
 static void _memory_read(x86_state_t * emu, x86_cpu_level_t memory_space, uaddr_t address, void * buffer, size_t size)
 {
 	(void) emu;
 
-	switch(pc_type)
+	address &= _memory.address_mask;
+	while(address < MEMORY_MAP_PAGE_COUNT << 12)
 	{
-	default:
-		_memory_read_direct(memory_space, address, buffer, size);
-		break;
-	case X86_PCTYPE_NEC_PC88_VA:
-		if(!necpc88va_v3_memory_mode)
-		{
-			if(address < 0x1F000)
-			{
-				size_t actual_size = min(size, 0x1F000 - address);
-				_memory_read_direct(memory_space, address + (0xA6000 - 0x1F000), buffer, actual_size);
-				if(actual_size == size)
-					return;
-				buffer += actual_size;
-				size -= actual_size;
-				address = 0x1F000;
-			}
-			if(address < 0x20000)
-			{
-				size_t actual_size = min(size, 0x20000 - address);
-				_memory_read_direct(memory_space, address + (0xA6000 - 0x1F000), buffer, size);
-				if(actual_size == size)
-					return;
-				buffer += actual_size;
-				size -= actual_size;
-				address = 0x20000;
-			}
-		}
-		_memory_read_direct(memory_space, address, buffer, size);
-		break;
+		memory_page_t * page = &_memory_map[address >> 12];
+		size_t offset = address & 0xFFF;
+		size_t actual_size = min(size, 0x1000 - offset);
+		memcpy(buffer, page->host + offset, actual_size);
+		if(actual_size == size)
+			return;
+		buffer += actual_size;
+		size -= actual_size;
+		address += actual_size;
 	}
+	_memory_read_direct(memory_space, address, buffer, size);
+}
+
+static inline x86_state_t * _x80_get_x86_state(x80_state_t * emu)
+{
+	// the separate 8080/Z80 is always the x80 member of the main CPU state
+	return (x86_state_t *)((char *)emu - offsetof(x86_state_t, x80));
 }
 
 static void _x80_memory_read(x80_state_t * emu, uint16_t address, void * buffer, size_t size)
@@ -952,38 +1135,29 @@ static void _x80_memory_read(x80_state_t * emu, uint16_t address, void * buffer,
 	}
 }
 
-static void _memory_write_direct(x86_cpu_level_t memory_space, uaddr_t address, const void * buffer, size_t size)
+static void _memory_write_direct(x86_state_t * emu, x86_cpu_level_t memory_space, uaddr_t address, const void * buffer, size_t size)
 {
 	(void) memory_space;
-	for(;;)
+	x86_dirty_pages_mark(emu, address & _memory.address_mask, size);
+	while(size > 0)
 	{
-		page_t * page = _get_page(address);
-		uint16_t offset = address & 0xFFF;
-		if(offset + size <= 0x1000)
-		{
-			memcpy(*page + offset, buffer, size);
-			break;
-		}
-		else
-		{
-			size_t actual_size = 0x1000 - offset;
-			memcpy(*page + offset, buffer, actual_size);
-			buffer += actual_size;
-			size -= actual_size;
-			address = (address + actual_size) & ~0xFFF;
-		}
+		address &= _memory.address_mask;
+		uaddr_t offset = address & (((uaddr_t)1 << _memory.region_shift) - 1);
+		size_t actual_size = min(size, ((uaddr_t)1 << _memory.region_shift) - offset);
+		memcpy(_memory_get_pointer(address), buffer, actual_size);
+		buffer += actual_size;
+		size -= actual_size;
+		address += actual_size;
 	}
 }
 
 static void _x80_memory_write(x80_state_t * emu, uint16_t address, const void * buffer, size_t size)
 {
-	(void) emu;
-
 	address &= 0xFFFF;
 	while(size > 0)
 	{
 		size_t actual_size = min(0x10000 - address, size);
-		_memory_write_direct(X86_LEVEL_USER, address, buffer, size);
+		_memory_write_direct(_x80_get_x86_state(emu), X86_LEVEL_USER, address, buffer, size);
 		address = 0;
 		buffer = (const char *)buffer + actual_size;
 		size -= actual_size;
@@ -1001,7 +1175,7 @@ static void _display_screen(x86_state_t * emu)
 	{
 	case X86_PCTYPE_IBM_PC_MDA:
 		{
-			uint8_t * memory = *_get_page(0xB0000);
+			uint8_t * memory = _memory_get_pointer(0xB0000);
 			printf("\33[2J");
 			for(int i = 0; i < 25; i++)
 			{
@@ -1020,7 +1194,7 @@ static void _display_screen(x86_state_t * emu)
 	case X86_PCTYPE_IBM_PC_CGA:
 	case X86_PCTYPE_IBM_PCJR:
 		{
-			uint8_t * memory = *_get_page(0xB8000);
+			uint8_t * memory = _memory_get_pointer(0xB8000);
 			printf("\33[2J");
 			for(int i = 0; i < 25; i++)
 			{
@@ -1039,8 +1213,8 @@ static void _display_screen(x86_state_t * emu)
 		break;
 	case X86_PCTYPE_NEC_PC98:
 		{
-			uint8_t * char_memory = *_get_page(0xA0000);
-			uint8_t * attr_memory = *_get_page(0xA2000);
+			uint8_t * char_memory = _memory_get_pointer(0xA0000);
+			uint8_t * attr_memory = _memory_get_pointer(0xA2000);
 			printf("\33[2J");
 			for(int i = 0; i < 25; i++)
 			{
@@ -1063,8 +1237,8 @@ static void _display_screen(x86_state_t * emu)
 		break;
 	case X86_PCTYPE_NEC_PC88_VA:
 		{
-			uint8_t * char_memory = *_get_page(0xA6000);
-			uint8_t * attr_memory = necpc88va_v3_memory_mode ? *_get_page(0xAE000) : NULL;
+			uint8_t * char_memory = _memory_get_pointer(0xA6000);
+			uint8_t * attr_memory = necpc88va_v3_memory_mode ? _memory_get_pointer(0xAE000) : NULL;
 			printf("\33[2J");
 			for(int i = 0; i < 25; i++)
 			{
@@ -1095,7 +1269,7 @@ static void _display_screen(x86_state_t * emu)
 		break;
 	case X86_PCTYPE_APRICOT:
 		{
-			uint16_t * memory = (uint16_t *)*_get_page(0xF0000);
+			uint16_t * memory = (uint16_t *)_memory_get_pointer(0xF0000);
 			printf("\33[2J");
 			for(int i = 0; i < 25; i++)
 			{
@@ -1126,263 +1300,448 @@ static void _display_screen(x86_state_t * emu)
 
 static bool _dos_kbd_int_handler = false;
 
-static void _memory_write_devices(x86_state_t * emu, x86_cpu_level_t memory_space, uaddr_t address, const void * buffer, size_t size)
+static void _memory_write_screen(x86_state_t * emu, uaddr_t address, size_t size)
 {
-//	fprintf(stderr, "W%X:%d=%02X ...\n", address, size, *(char *)buffer);
-	//memcpy(&memory[address & 0xFFFFF], buffer, size);
-	_memory_write_direct(memory_space, address, buffer, size);
+	(void) size;
+	// only the first 80x25 characters are displayed
+	if((address & 0xFFF) < 0xFA0)
+	{
+		_screen_printed = false;
+		_display_screen(emu);
+	}
+}
 
-	int kbd_int_num = -1;
+static void _memory_write_interrupt_table(x86_state_t * emu, uaddr_t address, size_t size)
+{
+	(void) emu;
+	int irq = pc_type == X86_PCTYPE_NEC_PC98 ? X86_NECPC98_IRQ_KEYBOARD : X86_IBMPC_IRQ_KEYBOARD;
+	uaddr_t kbd_int_num = ((i8259[irq >> 3].service_routine_address >> 8) & 0xF8) | (irq & 7);
 
-	switch(pc_type)
+	// very rough check for whether the keyboard interrupt handler has been replaced
+	if(address < kbd_int_num * 4 + 4 && kbd_int_num * 4 < address + size)
 	{
-	case X86_PCTYPE_IBM_PC_MDA:
-		if((address < 0xB0000 && address + size >= 0xB0FA0)
-		|| (0xB0000 <= address && address < 0xB0FA0)
-		|| (0xB0000 < address + size && address + size <= 0xB0FA0))
-		{
-			_screen_printed = false;
-			_display_screen(emu);
-		}
+		_dos_kbd_int_handler = false;
+	}
+}
 
-		kbd_int_num = ((i8259[X86_IBMPC_IRQ_KEYBOARD >> 3].service_routine_address >> 8) & 0xF8) | (X86_IBMPC_IRQ_KEYBOARD & 7);
-		break;
-	case X86_PCTYPE_IBM_PC_CGA:
-	case X86_PCTYPE_IBM_PCJR:
-		if((address < 0xB8000 && address + size >= 0xB8FA0)
-		|| (0xB8000 <= address && address < 0xB8FA0)
-		|| (0xB8000 < address + size && address + size <= 0xB8FA0))
+static void _memory_map_update_necpc88va(void)
+{
+	// in V1/V2 mode, the first 128 KiB are replaced by the memory at 0x87000
+	_memory_map_remap(0, 0x20000, necpc88va_v3_memory_mode ? 0 : 0xA6000 - 0x1F000);
+}
+
+//// Binary instruction trace
+
+static struct
+{
+	bool enabled;
+	bool registers; // record changed registers after each instruction
+	bool memory; // record memory writes
+	const char * file_name;
+	uint64_t capacity;
+
+	trace_header_t * header;
+	trace_record_t * records;
+
+	uoff_t gpr[16];
+	uint64_t flags;
+} _trace =
+{
+	.capacity = 1 << 20,
+};
+
+static inline trace_record_t * _trace_next_record(void)
+{
+	return &_trace.records[_trace.header->count++ % _trace.capacity];
+}
+
+static void _trace_parse_options(char * arg)
+{
+	_trace.enabled = true;
+	_trace.file_name = strtok(arg, ",");
+	for(char * option = strtok(NULL, ","); option != NULL; option = strtok(NULL, ","))
+	{
+		if(strcasecmp(option, "regs") == 0)
 		{
-			_screen_printed = false;
-			_display_screen(emu);
+			_trace.registers = true;
 		}
-
-		kbd_int_num = ((i8259[X86_IBMPC_IRQ_KEYBOARD >> 3].service_routine_address >> 8) & 0xF8) | (X86_IBMPC_IRQ_KEYBOARD & 7);
-		break;
-	case X86_PCTYPE_NEC_PC98:
-		if((address < 0xA0000 && address + size >= 0xA0FA0)
-		|| (0xA0000 <= address && address < 0xA0FA0)
-		|| (0xA0000 < address + size && address + size <= 0xA0FA0)
-		|| (address < 0xA2000 && address + size >= 0xA2FA0)
-		|| (0xA2000 <= address && address < 0xA2FA0)
-		|| (0xA2000 < address + size && address + size <= 0xA2FA0))
-		{
-			_screen_printed = false;
-			_display_screen(emu);
+		else if(strcasecmp(option, "mem") == 0)
+		{
+			_trace.memory = true;
 		}
-
-		kbd_int_num = ((i8259[X86_NECPC98_IRQ_KEYBOARD >> 3].service_routine_address >> 8) & 0xF8) | (X86_NECPC98_IRQ_KEYBOARD & 7);
-		break;
-	case X86_PCTYPE_NEC_PC88_VA:
-		if((address < 0xA6000 && address + size >= 0xA6FA0)
-		|| (0xA6000 <= address && address < 0xA6FA0)
-		|| (0xA6000 < address + size && address + size <= 0xA6FA0)
-		|| (address < 0xAE000 && address + size >= 0xAEFA0)
-		|| (0xAE000 <= address && address < 0xAEFA0)
-		|| (0xAE000 < address + size && address + size <= 0xAEFA0))
-		{
-			_screen_printed = false;
-			_display_screen(emu);
+		else if(strncasecmp(option, "records=", 8) == 0)
+		{
+			_trace.capacity = strtoull(option + 8, NULL, 0);
 		}
-		break;
-	case X86_PCTYPE_APRICOT:
-		if((address < 0xF0000 && address + size >= 0xF0FA0)
-		|| (0xF0000 <= address && address < 0xF0FA0)
-		|| (0xF0000 < address + size && address + size <= 0xF0FA0))
+		else
 		{
-			_screen_printed = false;
-			_display_screen(emu);
+			fprintf(stderr, "Unknown trace option: %s\n", option);
+			exit(1);
 		}
-		break;
-	default:
-		break;
 	}
 
-	// very rough check for whether the keyboard interrupt handler has been replaced
-	if(kbd_int_num != -1
-	&& ((address < (unsigned)kbd_int_num * 4 && address + size >= (unsigned)kbd_int_num * 4 + 4)
-		|| ((unsigned)kbd_int_num * 4 <= address && address < (unsigned)kbd_int_num * 4 + 4)
-		|| ((unsigned)kbd_int_num * 4 < address + size && address + size <= (unsigned)kbd_int_num * 4 + 4)))
+	if(_trace.file_name == NULL || _trace.capacity == 0)
 	{
-		_dos_kbd_int_handler = false;
+		fprintf(stderr, "Invalid trace options\n");
+		exit(1);
 	}
-//	printf("%X:%d\n", address, *(uint16_t*)&memory[address & 0xFFFFE]);
 }
 
-static void _memory_write(x86_state_t * emu, x86_cpu_level_t memory_space, uaddr_t address, const void * buffer, size_t size)
+static void _trace_start(x86_state_t * emu, int cpu_version)
 {
-	switch(pc_type)
+	size_t size = sizeof(trace_header_t) + _trace.capacity * sizeof(trace_record_t);
+
+	int fd = open(_trace.file_name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if(fd == -1 || ftruncate(fd, size) != 0)
 	{
-	default:
-		_memory_write_devices(emu, memory_space, address, buffer, size);
-		break;
-	case X86_PCTYPE_NEC_PC88_VA:
-		if(!necpc88va_v3_memory_mode)
-		{
-			if(address < 0x1F000)
-			{
-				size_t actual_size = min(size, 0x1F000 - address);
-				_memory_write_devices(emu, memory_space, address + (0xA6000 - 0x1F000), buffer, actual_size);
-				if(actual_size == size)
-					return;
-				buffer += actual_size;
-				size -= actual_size;
-				address = 0x1F000;
-			}
-			if(address < 0x20000)
-			{
-				size_t actual_size = min(size, 0x20000 - address);
-				_memory_write_devices(emu, memory_space, address + (0xA6000 - 0x1F000), buffer, size);
-				if(actual_size == size)
-					return;
-				buffer += actual_size;
-				size -= actual_size;
-				address = 0x20000;
-			}
-		}
-		_memory_write_devices(emu, memory_space, address, buffer, size);
-		break;
+		fprintf(stderr, "Unable to create trace file %s\n", _trace.file_name);
+		exit(1);
+	}
+
+	void * mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if(mapping == MAP_FAILED)
+	{
+		fprintf(stderr, "Unable to map trace file %s\n", _trace.file_name);
+		exit(1);
 	}
+
+	_trace.header = mapping;
+	_trace.records = (trace_record_t *)(_trace.header + 1);
+
+	memcpy(_trace.header->magic, TRACE_MAGIC, sizeof _trace.header->magic);
+	_trace.header->version = TRACE_VERSION;
+	_trace.header->record_size = sizeof(trace_record_t);
+	_trace.header->capacity = _trace.capacity;
+	_trace.header->count = 0;
+	_trace.header->cpu_version = cpu_version;
+	_trace.header->fpu_type = emu->x87.fpu_type;
+	_trace.header->fpu_subtype = emu->x87.fpu_subtype;
+	_trace.header->use_nec_syntax = emu->parser->use_nec_syntax;
+	_trace.header->x80_cpu_type = emu->x80.cpu_type;
+	_trace.header->use_intel8080_syntax = emu->x80.parser->use_intel8080_syntax;
+
+	for(int number = 0; number < 16; number++)
+		_trace.gpr[number] = emu->gpr[number];
+	_trace.flags = x86_flags_get64(emu);
 }
 
-static void _port_read(x86_state_t * emu, uint16_t port, void * buffer, size_t count)
+// Records the instruction about to be executed
+static void _trace_before_step(x86_state_t * emu)
 {
-	(void) emu;
-	for(uint16_t offset = 0; offset < count; offset++)
+	// a halted processor does not execute the instruction at CS:IP
+	if(emu->state != X86_STATE_RUNNING)
+		return;
+
+	trace_record_t * record = _trace_next_record();
+	record->type = TRACE_INSTRUCTION;
+	record->code_size = x86_get_code_size(emu);
+	// the instruction length is only determined when decoding
+	record->length = 15;
+	if(record->code_size == SIZE_8BIT)
 	{
-		switch(pc_type)
+		record->offset = emu->x80.pc;
+		record->address = emu->sr[X86_R_CS].base + emu->x80.pc;
+		_memory_read(emu, emu->cpu_level, record->address, record->data, record->length);
+	}
+	else
+	{
+		record->offset = emu->xip;
+		record->address = record->code_size == SIZE_64BIT ? emu->xip : emu->sr[X86_R_CS].base + emu->xip;
+		// the address is linear, only the bytes up to the first unmapped page are recorded
+		if(!x86_memory_read_debug(emu, record->address, record->length, record->data))
 		{
-		case X86_PCTYPE_IBM_PC_MDA:
-		case X86_PCTYPE_IBM_PC_CGA:
-		case X86_PCTYPE_IBM_PCJR:
-			switch(port + offset)
-			{
-			case 0x0060:
-				// 8042 programmable interface data port (keyboard)
-				((uint8_t *)buffer)[offset] = i8042.buffer[0];
-			}
-			break;
-		case X86_PCTYPE_NEC_PC98:
-			switch(port + offset)
-			{
-			case 0x0041:
-				// 8251 receiver/transmitter (keyboard)
-				((uint8_t *)buffer)[offset] = i8251.buffer[0];
-			}
-			break;
-		case X86_PCTYPE_NEC_PC88_VA:
-			switch(port + offset)
+			memset(record->data, 0, record->length);
+			for(record->length = 0; record->length < 15; record->length++)
 			{
-			case 0x0153:
-				// mode select
-				((uint8_t *)buffer)[offset] = necpc88va_v3_memory_mode ? 64 : 0;
+				if(!x86_memory_read_debug(emu, record->address + record->length, 1, &record->data[record->length]))
+					break;
 			}
-			break;
-		default:
-			break;
 		}
 	}
 }
 
-static uint8_t _x80_port_read(x80_state_t * emu, uint16_t port)
+// Records the registers modified by the last instruction
+static void _trace_after_step(x86_state_t * emu)
 {
-	(void) emu;
-	uint8_t value;
-	_port_read(NULL, port, &value, 1);
-	return value;
-}
+	if(!_trace.registers)
+		return;
 
-static void _port_write(x86_state_t * emu, uint16_t port, const void * buffer, size_t count)
-{
-	for(uint16_t offset = 0; offset < count; offset++)
+	for(int number = 0; number < 16; number++)
 	{
-		switch(pc_type)
+		if(emu->gpr[number] != _trace.gpr[number])
 		{
-		case X86_PCTYPE_IBM_PC_MDA:
-		case X86_PCTYPE_IBM_PC_CGA:
-		case X86_PCTYPE_IBM_PCJR:
-			switch(port + offset)
-			{
-			case 0x20:
-				// primary 8259 interrupt controller command port
-				i8259_send_command(emu, 0, ((const uint8_t *)buffer)[offset]);
-				break;
-			case 0x21:
-				// primary 8259 interrupt controller data port
-				i8259_send_data(emu, 0, ((const uint8_t *)buffer)[offset]);
-				break;
-			case 0xA0:
-				// secondary 8259 interrupt controller command port
-				i8259_send_command(emu, 1, ((const uint8_t *)buffer)[offset]);
-				break;
-			case 0xA1:
-				// secondary 8259 interrupt controller data port
-				i8259_send_data(emu, 1, ((const uint8_t *)buffer)[offset]);
-				break;
-			}
-			break;
-		case X86_PCTYPE_NEC_PC98:
-			switch(port + offset)
-			{
-			case 0x0000:
-				// primary 8259 interrupt controller command port
-				i8259_send_command(emu, 0, ((const uint8_t *)buffer)[offset]);
-				break;
-			case 0x0002:
-				// primary 8259 interrupt controller data port
-				i8259_send_data(emu, 0, ((const uint8_t *)buffer)[offset]);
-				break;
-			case 0x0008:
-				// secondary 8259 interrupt controller command port
-				i8259_send_command(emu, 1, ((const uint8_t *)buffer)[offset]);
-				break;
-			case 0x000A:
-				// secondary 8259 interrupt controller data port
-				i8259_send_data(emu, 1, ((const uint8_t *)buffer)[offset]);
-				break;
-			}
-			break;
-		case X86_PCTYPE_NEC_PC88_VA:
-			switch(port + offset)
-			{
-			case 0x0153:
-				// mode select
-				necpc88va_v3_memory_mode = (((const uint8_t *)buffer)[offset] & 64) != 0;
-				break;
-			case 0x0184:
-				// secondary 8259 interrupt controller command port
-				i8259_send_command(emu, 1, ((const uint8_t *)buffer)[offset]);
-				break;
-			case 0x0186:
-				// secondary 8259 interrupt controller data port
-				i8259_send_data(emu, 1, ((const uint8_t *)buffer)[offset]);
-				break;
-			case 0x0188:
-				// primary 8259 interrupt controller command port
-				i8259_send_command(emu, 0, ((const uint8_t *)buffer)[offset]);
-				break;
-			case 0x018A:
-				// primary 8259 interrupt controller data port
-				i8259_send_data(emu, 0, ((const uint8_t *)buffer)[offset]);
-				break;
-			}
-			break;
-		default:
-			break;
+			trace_record_t * record = _trace_next_record();
+			record->type = TRACE_REGISTER;
+			record->length = number;
+			record->value = _trace.gpr[number] = emu->gpr[number];
 		}
 	}
+
+	uint64_t flags = x86_flags_get64(emu);
+	if(flags != _trace.flags)
+	{
+		trace_record_t * record = _trace_next_record();
+		record->type = TRACE_REGISTER;
+		record->length = TRACE_REGISTER_FLAGS;
+		record->value = _trace.flags = flags;
+	}
 }
 
-static void _x80_port_write(x80_state_t * emu, uint16_t port, uint8_t value)
+static void _trace_memory_write(uaddr_t address, const void * buffer, size_t size)
 {
-	(void) emu;
-	_port_write(NULL, port, &value, 1);
+	while(size > 0)
+	{
+		trace_record_t * record = _trace_next_record();
+		record->type = TRACE_MEMORY_WRITE;
+		record->length = min(size, sizeof record->data);
+		record->address = address;
+		memcpy(record->data, buffer, record->length);
+		address += record->length;
+		buffer = (const char *)buffer + record->length;
+		size -= record->length;
+	}
 }
 
-static uint8_t screen_cursor_x = 0, screen_cursor_y = 0;
-//static uint8_t screen_attribute; // TODO
-
-static inline void bios_screen_scroll(int lines)
+static void _memory_write(x86_state_t * emu, x86_cpu_level_t memory_space, uaddr_t address, const void * buffer, size_t size)
+{
+	if(_trace.memory && _trace.header != NULL)
+		_trace_memory_write(address, buffer, size);
+
+	address &= _memory.address_mask;
+	while(address < MEMORY_MAP_PAGE_COUNT << 12)
+	{
+		memory_page_t * page = &_memory_map[address >> 12];
+		size_t offset = address & 0xFFF;
+		size_t actual_size = min(size, 0x1000 - offset);
+		memcpy(page->host + offset, buffer, actual_size);
+		if(page->write_handler != NULL)
+			page->write_handler(emu, page->address + offset, actual_size);
+		if(actual_size == size)
+			return;
+		buffer += actual_size;
+		size -= actual_size;
+		address += actual_size;
+	}
+	_memory_write_direct(emu, memory_space, address, buffer, size);
+}
+
+// Returns a host pointer if address...address+size-1 is stored contiguously and has no write handlers
+static uint8_t * _memory_get_direct_pointer(x86_state_t * emu, uaddr_t address, size_t size)
+{
+	(void) emu;
+
+	if(_trace.memory)
+		// every write must be recorded
+		return NULL;
+
+	address &= _memory.address_mask;
+	if(size == 0 || _memory.address_mask - address < size - 1)
+		return NULL;
+
+	uaddr_t region_size = (uaddr_t)1 << _memory.region_shift;
+	uint8_t * host = NULL;
+	for(size_t offset = 0; offset < size; )
+	{
+		uaddr_t current = address + offset;
+		uint8_t * pointer;
+		if(current < MEMORY_MAP_PAGE_COUNT << 12)
+		{
+			memory_page_t * page = &_memory_map[current >> 12];
+			if(page->write_handler != NULL)
+				return NULL;
+			pointer = page->host + (current & 0xFFF);
+			offset += 0x1000 - (current & 0xFFF);
+		}
+		else
+		{
+			pointer = _memory_get_pointer(current);
+			offset += region_size - (current & (region_size - 1));
+		}
+
+		if(host == NULL)
+			host = pointer;
+		else if(pointer != host + (current - address))
+			// remapped pages or separate regions
+			return NULL;
+	}
+	return host;
+}
+
+// Devices claim their ports in machine_setup, unclaimed ports are ignored
+
+static uint8_t _port_read_i8042(x86_state_t * emu, void * data, uint16_t port)
+{
+	(void) emu;
+	(void) data;
+	(void) port;
+	// 8042 programmable interface data port (keyboard)
+	return i8042.buffer[0];
+}
+
+static const x86_port_handler_t _i8042_ports =
+{
+	.read8 = _port_read_i8042,
+};
+
+static uint8_t _port_read_i8251(x86_state_t * emu, void * data, uint16_t port)
+{
+	(void) emu;
+	(void) data;
+	(void) port;
+	// 8251 receiver/transmitter (keyboard)
+	return i8251.buffer[0];
+}
+
+static const x86_port_handler_t _i8251_ports =
+{
+	.read8 = _port_read_i8251,
+};
+
+static uint8_t _port_read_necpc88va_mode(x86_state_t * emu, void * data, uint16_t port)
+{
+	(void) emu;
+	(void) data;
+	(void) port;
+	return necpc88va_v3_memory_mode ? 64 : 0;
+}
+
+static void _port_write_necpc88va_mode(x86_state_t * emu, void * data, uint16_t port, uint8_t value)
+{
+	(void) emu;
+	(void) data;
+	(void) port;
+	necpc88va_v3_memory_mode = (value & 64) != 0;
+	_memory_map_update_necpc88va();
+}
+
+static const x86_port_handler_t _necpc88va_mode_ports =
+{
+	.read8 = _port_read_necpc88va_mode,
+	.write8 = _port_write_necpc88va_mode,
+};
+
+static void _port_write_i8259_command(x86_state_t * emu, void * data, uint16_t port, uint8_t value)
+{
+	(void) port;
+	i8259_send_command(emu, (intptr_t)data, value);
+}
+
+static void _port_write_i8259_data(x86_state_t * emu, void * data, uint16_t port, uint8_t value)
+{
+	(void) port;
+	i8259_send_data(emu, (intptr_t)data, value);
+}
+
+// command and data ports of the primary and secondary 8259 interrupt controllers
+static const x86_port_handler_t _i8259_ports[2][2] =
+{
+	{
+		{ .data = (void *)0, .write8 = _port_write_i8259_command },
+		{ .data = (void *)0, .write8 = _port_write_i8259_data },
+	},
+	{
+		{ .data = (void *)1, .write8 = _port_write_i8259_command },
+		{ .data = (void *)1, .write8 = _port_write_i8259_data },
+	},
+};
+
+/* A FIFO that returns the bytes written to it, attached with -I to test port I/O
+ * port to port + 3: data, wider accesses move consecutive bytes, reading an empty FIFO returns 0xFF
+ * port + 4: reading returns the number of block transfers served so far, writing empties the FIFO and clears the count
+ */
+#define LOOPBACK_SIZE 0x10000
+
+static struct
+{
+	bool enabled;
+	uint16_t port;
+	uint8_t block_count;
+	size_t first, length;
+	uint8_t buffer[LOOPBACK_SIZE];
+} _loopback;
+
+static uint8_t _port_read_loopback(x86_state_t * emu, void * data, uint16_t port)
+{
+	(void) emu;
+	(void) data;
+	if((uint16_t)(port - _loopback.port) == 4)
+		return _loopback.block_count;
+	if(_loopback.length == 0)
+		return 0xFF;
+	uint8_t value = _loopback.buffer[_loopback.first];
+	_loopback.first = (_loopback.first + 1) % LOOPBACK_SIZE;
+	_loopback.length --;
+	return value;
+}
+
+static void _port_write_loopback(x86_state_t * emu, void * data, uint16_t port, uint8_t value)
+{
+	(void) emu;
+	(void) data;
+	if((uint16_t)(port - _loopback.port) == 4)
+	{
+		_loopback.first = 0;
+		_loopback.length = 0;
+		_loopback.block_count = 0;
+	}
+	else if(_loopback.length < LOOPBACK_SIZE)
+	{
+		_loopback.buffer[(_loopback.first + _loopback.length) % LOOPBACK_SIZE] = value;
+		_loopback.length ++;
+	}
+}
+
+static void _port_read_block_loopback(x86_state_t * emu, void * data, uint16_t port, unsigned size, size_t count, void * buffer)
+{
+	uint8_t * bytes = buffer;
+	_loopback.block_count ++;
+	for(size_t i = 0; i < count * size; i++)
+		bytes[i] = _port_read_loopback(emu, data, port + i % size);
+}
+
+static void _port_write_block_loopback(x86_state_t * emu, void * data, uint16_t port, unsigned size, size_t count, const void * buffer)
+{
+	const uint8_t * bytes = buffer;
+	_loopback.block_count ++;
+	for(size_t i = 0; i < count * size; i++)
+		_port_write_loopback(emu, data, port + i % size, bytes[i]);
+}
+
+static const x86_port_handler_t _loopback_ports =
+{
+	.read8 = _port_read_loopback,
+	.write8 = _port_write_loopback,
+	.read_block = _port_read_block_loopback,
+	.write_block = _port_write_block_loopback,
+};
+
+static uint8_t _x80_port_read(x80_state_t * emu, uint16_t port)
+{
+	uint8_t value = 0;
+	x86_port_input(_x80_get_x86_state(emu), port, 1, &value);
+	return value;
+}
+
+static void _x80_port_write(x80_state_t * emu, uint16_t port, uint8_t value)
+{
+	x86_port_output(_x80_get_x86_state(emu), port, 1, &value);
+}
+
+static size_t _x80_port_read_block(x80_state_t * emu, uint16_t port, size_t count, void * buffer)
+{
+	return x86_port_input_z80_block(_x80_get_x86_state(emu), port, count, buffer);
+}
+
+static size_t _x80_port_write_block(x80_state_t * emu, uint16_t port, size_t count, const void * buffer)
+{
+	return x86_port_output_z80_block(_x80_get_x86_state(emu), port, count, buffer);
+}
+
+static uint8_t screen_cursor_x = 0, screen_cursor_y = 0;
+//static uint8_t screen_attribute; // TODO
+
+static inline void bios_screen_scroll(int lines)
 {
 	if(lines == 0)
 		return;
@@ -1397,7 +1756,7 @@ static inline void bios_screen_scroll(int lines)
 	case X86_PCTYPE_IBM_PC_CGA:
 	case X86_PCTYPE_IBM_PCJR:
 		{
-			uint8_t * memory = *_get_page(pc_type == X86_PCTYPE_IBM_PC_MDA ? 0xB0000 : 0xB8000);
+			uint8_t * memory = _memory_get_pointer(pc_type == X86_PCTYPE_IBM_PC_MDA ? 0xB0000 : 0xB8000);
 			uint16_t offset;
 			for(offset = 0; offset < (25 - lines) * 160; offset++)
 			{
@@ -1412,8 +1771,8 @@ static inline void bios_screen_scroll(int lines)
 		break;
 	case X86_PCTYPE_NEC_PC98:
 		{
-			uint8_t * char_memory = *_get_page(0xA0000);
-			uint8_t * attr_memory = *_get_page(0xA2000);
+			uint8_t * char_memory = _memory_get_pointer(0xA0000);
+			uint8_t * attr_memory = _memory_get_pointer(0xA2000);
 			uint16_t offset;
 			for(offset = 0; offset < (25 - lines) * 160; offset++)
 			{
@@ -1429,8 +1788,8 @@ static inline void bios_screen_scroll(int lines)
 		break;
 	case X86_PCTYPE_NEC_PC88_VA:
 		{
-			uint8_t * char_memory = *_get_page(0xA6000);
-			uint8_t * attr_memory = necpc88va_v3_memory_mode ? *_get_page(0xAE000) : NULL;
+			uint8_t * char_memory = _memory_get_pointer(0xA6000);
+			uint8_t * attr_memory = necpc88va_v3_memory_mode ? _memory_get_pointer(0xAE000) : NULL;
 			uint16_t offset;
 			for(offset = 0; offset < (25 - lines) * 160; offset++)
 			{
@@ -1459,7 +1818,7 @@ static inline void bios_screen_scroll(int lines)
 		break;
 	case X86_PCTYPE_APRICOT:
 		{
-			uint16_t * memory = (uint16_t *)*_get_page(0xF0000);
+			uint16_t * memory = (uint16_t *)_memory_get_pointer(0xF0000);
 			uint16_t offset;
 			for(offset = 0; offset < (25 - lines) * 80; offset++)
 			{
@@ -1503,7 +1862,7 @@ static void bios_screen_putchar(int c)
 	case X86_PCTYPE_IBM_PC_CGA:
 	case X86_PCTYPE_IBM_PCJR:
 		{
-			uint8_t * memory = *_get_page(pc_type == X86_PCTYPE_IBM_PC_MDA ? 0xB0000 : 0xB8000);
+			uint8_t * memory = _memory_get_pointer(pc_type == X86_PCTYPE_IBM_PC_MDA ? 0xB0000 : 0xB8000);
 			bios_screen_fix_cursor_location();
 			memory[screen_cursor_y * 160 + screen_cursor_x * 2] = c;
 			memory[screen_cursor_y * 160 + screen_cursor_x * 2 + 1] = 0x07;
@@ -1513,8 +1872,8 @@ static void bios_screen_putchar(int c)
 		break;
 	case X86_PCTYPE_NEC_PC98:
 		{
-			uint8_t * char_memory = *_get_page(0xA0000);
-			uint8_t * attr_memory = *_get_page(0xA2000);
+			uint8_t * char_memory = _memory_get_pointer(0xA0000);
+			uint8_t * attr_memory = _memory_get_pointer(0xA2000);
 			bios_screen_fix_cursor_location();
 			char_memory[screen_cursor_y * 160 + screen_cursor_x * 2] = c;
 			attr_memory[screen_cursor_y * 160 + screen_cursor_x * 2] = 0xE1;
@@ -1524,8 +1883,8 @@ static void bios_screen_putchar(int c)
 		break;
 	case X86_PCTYPE_NEC_PC88_VA:
 		{
-			uint8_t * char_memory = *_get_page(0xA6000);
-			uint8_t * attr_memory = necpc88va_v3_memory_mode ? *_get_page(0xAE000) : NULL;
+			uint8_t * char_memory = _memory_get_pointer(0xA6000);
+			uint8_t * attr_memory = necpc88va_v3_memory_mode ? _memory_get_pointer(0xAE000) : NULL;
 			bios_screen_fix_cursor_location();
 			if(!necpc88va_v3_memory_mode)
 			{
@@ -1543,7 +1902,7 @@ static void bios_screen_putchar(int c)
 		break;
 	case X86_PCTYPE_APRICOT:
 		{
-			uint16_t * memory = (uint16_t *)*_get_page(0xF0000);
+			uint16_t * memory = (uint16_t *)_memory_get_pointer(0xF0000);
 			bios_screen_fix_cursor_location();
 			memory[screen_cursor_y * 80 + screen_cursor_x] = c + 0x40;
 			screen_cursor_x ++;
@@ -1829,6 +2188,67 @@ void machine_setup(x86_state_t * emu, x86_pc_type_t machine)
 		setup_x89(emu, 0x00500);
 	}
 
+	// I/O ports
+	switch(machine)
+	{
+	case X86_PCTYPE_IBM_PC_MDA:
+	case X86_PCTYPE_IBM_PC_CGA:
+	case X86_PCTYPE_IBM_PCJR:
+		x86_port_register(emu, 0x0020, 1, &_i8259_ports[0][0]);
+		x86_port_register(emu, 0x0021, 1, &_i8259_ports[0][1]);
+		x86_port_register(emu, 0x0060, 1, &_i8042_ports);
+		x86_port_register(emu, 0x00A0, 1, &_i8259_ports[1][0]);
+		x86_port_register(emu, 0x00A1, 1, &_i8259_ports[1][1]);
+		break;
+	case X86_PCTYPE_NEC_PC98:
+		x86_port_register(emu, 0x0000, 1, &_i8259_ports[0][0]);
+		x86_port_register(emu, 0x0002, 1, &_i8259_ports[0][1]);
+		x86_port_register(emu, 0x0008, 1, &_i8259_ports[1][0]);
+		x86_port_register(emu, 0x000A, 1, &_i8259_ports[1][1]);
+		x86_port_register(emu, 0x0041, 1, &_i8251_ports);
+		break;
+	case X86_PCTYPE_NEC_PC88_VA:
+		x86_port_register(emu, 0x0153, 1, &_necpc88va_mode_ports);
+		x86_port_register(emu, 0x0184, 1, &_i8259_ports[1][0]);
+		x86_port_register(emu, 0x0186, 1, &_i8259_ports[1][1]);
+		x86_port_register(emu, 0x0188, 1, &_i8259_ports[0][0]);
+		x86_port_register(emu, 0x018A, 1, &_i8259_ports[0][1]);
+		break;
+	default:
+		break;
+	}
+
+	if(_loopback.enabled)
+		x86_port_register(emu, _loopback.port, 5, &_loopback_ports);
+
+	// memory mapped text screens and the keyboard interrupt vector
+	switch(machine)
+	{
+	case X86_PCTYPE_IBM_PC_MDA:
+		_memory_map_register(0xB0000, 0x1000, _memory_write_screen);
+		_memory_map_register(0x00000, 0x1000, _memory_write_interrupt_table);
+		break;
+	case X86_PCTYPE_IBM_PC_CGA:
+	case X86_PCTYPE_IBM_PCJR:
+		_memory_map_register(0xB8000, 0x1000, _memory_write_screen);
+		_memory_map_register(0x00000, 0x1000, _memory_write_interrupt_table);
+		break;
+	case X86_PCTYPE_NEC_PC98:
+		_memory_map_register(0xA0000, 0x1000, _memory_write_screen);
+		_memory_map_register(0xA2000, 0x1000, _memory_write_screen);
+		_memory_map_register(0x00000, 0x1000, _memory_write_interrupt_table);
+		break;
+	case X86_PCTYPE_NEC_PC88_VA:
+		_memory_map_register(0xA6000, 0x1000, _memory_write_screen);
+		_memory_map_register(0xAE000, 0x1000, _memory_write_screen);
+		break;
+	case X86_PCTYPE_APRICOT:
+		_memory_map_register(0xF0000, 0x1000, _memory_write_screen);
+		break;
+	default:
+		break;
+	}
+
 	// assorted
 	switch(pc_type)
 	{
@@ -1854,6 +2274,7 @@ void machine_setup(x86_state_t * emu, x86_pc_type_t machine)
 		emu->x87.irq_number = X86_NECPC88VA_IRQ_FPU;
 
 		necpc88va_v3_memory_mode = !emu->full_z80_emulation;
+		_memory_map_update_necpc88va();
 
 /*
 	INT 0x91
@@ -1898,6 +2319,814 @@ typedef enum x86_system_type_t
 
 static x86_system_type_t system_type = X86_SYSTEM_TYPE_NONE;
 
+//// Machine snapshots
+
+static struct
+{
+	bool save_pending;
+	const char * save_file_name;
+	bool save_at_address;
+	uaddr_t save_address; // linear address of the instruction to save at
+	bool save_after_steps;
+	uint64_t save_steps; // number of instructions to execute before saving
+	bool save_and_exit;
+	uint64_t steps;
+
+	const char * restore_file_name;
+	int restore_fd;
+	snapshot_header_t header;
+} _snapshot;
+
+// emulator state stored after the CPU state, followed by the targets of the memory map pages
+static const struct
+{
+	void * data;
+	size_t size;
+} _snapshot_devices[] =
+{
+	{ i8259, sizeof i8259 },
+	{ &i8259_count, sizeof i8259_count },
+	{ &i8042, sizeof i8042 },
+	{ &dos_kbd_state, sizeof dos_kbd_state },
+	{ &screen_cursor_x, sizeof screen_cursor_x },
+	{ &screen_cursor_y, sizeof screen_cursor_y },
+	{ &blinking_enabled, sizeof blinking_enabled },
+	{ &necpc88va_v3_memory_mode, sizeof necpc88va_v3_memory_mode },
+	{ &_dos_kbd_int_handler, sizeof _dos_kbd_int_handler },
+};
+
+static size_t _snapshot_device_size(void)
+{
+	size_t size = MEMORY_MAP_PAGE_COUNT * sizeof(uint64_t);
+	for(size_t i = 0; i < sizeof _snapshot_devices / sizeof _snapshot_devices[0]; i++)
+		size += _snapshot_devices[i].size;
+	return size;
+}
+
+static void _snapshot_store_devices(uint8_t * devices)
+{
+	size_t position = 0;
+	for(size_t i = 0; i < sizeof _snapshot_devices / sizeof _snapshot_devices[0]; i++)
+	{
+		memcpy(devices + position, _snapshot_devices[i].data, _snapshot_devices[i].size);
+		position += _snapshot_devices[i].size;
+	}
+	for(size_t index = 0; index < MEMORY_MAP_PAGE_COUNT; index++)
+	{
+		uint64_t address = _memory_map[index].address;
+		memcpy(devices + position, &address, sizeof address);
+		position += sizeof address;
+	}
+}
+
+static void _snapshot_load_devices(const uint8_t * devices)
+{
+	size_t position = 0;
+	for(size_t i = 0; i < sizeof _snapshot_devices / sizeof _snapshot_devices[0]; i++)
+	{
+		memcpy(_snapshot_devices[i].data, devices + position, _snapshot_devices[i].size);
+		position += _snapshot_devices[i].size;
+	}
+	for(size_t index = 0; index < MEMORY_MAP_PAGE_COUNT; index++)
+	{
+		uint64_t address;
+		memcpy(&address, devices + position, sizeof address);
+		position += sizeof address;
+		_memory_map_remap(index << 12, 0x1000, address);
+	}
+}
+
+static void _snapshot_parse_options(char * arg)
+{
+	_snapshot.save_pending = true;
+	_snapshot.save_file_name = strtok(arg, ",");
+	for(char * option = strtok(NULL, ","); option != NULL; option = strtok(NULL, ","))
+	{
+		if(strncasecmp(option, "at=", 3) == 0)
+		{
+			_snapshot.save_at_address = true;
+			_snapshot.save_address = strtoull(option + 3, NULL, 16);
+		}
+		else if(strncasecmp(option, "steps=", 6) == 0)
+		{
+			_snapshot.save_after_steps = true;
+			_snapshot.save_steps = strtoull(option + 6, NULL, 0);
+		}
+		else if(strcasecmp(option, "exit") == 0)
+		{
+			_snapshot.save_and_exit = true;
+		}
+		else
+		{
+			fprintf(stderr, "Unknown snapshot option: %s\n", option);
+			exit(1);
+		}
+	}
+
+	if(_snapshot.save_file_name == NULL || (!_snapshot.save_at_address && !_snapshot.save_after_steps))
+	{
+		fprintf(stderr, "Invalid snapshot options\n");
+		exit(1);
+	}
+}
+
+static void _snapshot_write(int fd, const void * buffer, size_t size, uint64_t offset)
+{
+	while(size > 0)
+	{
+		ssize_t count = pwrite(fd, buffer, size, offset);
+		if(count <= 0)
+		{
+			fprintf(stderr, "Unable to write snapshot file %s\n", _snapshot.save_file_name);
+			exit(1);
+		}
+		buffer += count;
+		size -= count;
+		offset += count;
+	}
+}
+
+static void _snapshot_read(int fd, void * buffer, size_t size, uint64_t offset)
+{
+	while(size > 0)
+	{
+		ssize_t count = pread(fd, buffer, size, offset);
+		if(count <= 0)
+		{
+			fprintf(stderr, "Invalid snapshot file %s\n", _snapshot.restore_file_name);
+			exit(1);
+		}
+		buffer += count;
+		size -= count;
+		offset += count;
+	}
+}
+
+static bool _snapshot_page_is_zero(const uint8_t * page, size_t size)
+{
+	const uint64_t * words = (const uint64_t *)page;
+	for(size_t i = 0; i < size / sizeof(uint64_t); i++)
+	{
+		if(words[i] != 0)
+			return false;
+	}
+	return true;
+}
+
+static int _snapshot_address_compare(const void * a, const void * b)
+{
+	uaddr_t index_a = *(const uaddr_t *)a;
+	uaddr_t index_b = *(const uaddr_t *)b;
+	return index_a < index_b ? -1 : index_a > index_b ? 1 : 0;
+}
+
+static void _snapshot_save(x86_state_t * emu, int cpu_version)
+{
+	size_t page_size = sysconf(_SC_PAGESIZE);
+	size_t region_size = (size_t)1 << _memory.region_shift;
+
+	// regions are visited in address order, so that neighbouring pages can be merged into extents
+	uaddr_t * regions = malloc(_memory.allocated_region_count * sizeof(uaddr_t));
+	if(regions == NULL && _memory.allocated_region_count != 0)
+	{
+		fprintf(stderr, "Unable to allocate memory\n");
+		exit(1);
+	}
+	memcpy(regions, _memory.allocated_regions, _memory.allocated_region_count * sizeof(uaddr_t));
+	qsort(regions, _memory.allocated_region_count, sizeof(uaddr_t), _snapshot_address_compare);
+
+	// collect the pages holding data into extents, pages that were never written to read as zero and are skipped
+	snapshot_extent_t * extents = NULL;
+	size_t extent_count = 0;
+	size_t extent_capacity = 0;
+	for(size_t i = 0; i < _memory.allocated_region_count; i++)
+	{
+		uaddr_t index = regions[i];
+		uint8_t * region = _memory.regions[index];
+		for(size_t offset = 0; offset < region_size; offset += page_size)
+		{
+			if(_snapshot_page_is_zero(region + offset, page_size))
+				continue;
+
+			uint64_t address = ((uint64_t)index << _memory.region_shift) + offset;
+			if(extent_count > 0 && extents[extent_count - 1].address + extents[extent_count - 1].length == address)
+			{
+				extents[extent_count - 1].length += page_size;
+				continue;
+			}
+
+			if(extent_count >= extent_capacity)
+			{
+				extent_capacity = extent_capacity == 0 ? 64 : 2 * extent_capacity;
+				extents = realloc(extents, extent_capacity * sizeof(snapshot_extent_t));
+				if(extents == NULL)
+				{
+					fprintf(stderr, "Unable to allocate memory\n");
+					exit(1);
+				}
+			}
+			extents[extent_count++] = (snapshot_extent_t) { .address = address, .length = page_size };
+		}
+	}
+	free(regions);
+
+	size_t device_size = _snapshot_device_size();
+	uint64_t state_offset = sizeof(snapshot_header_t);
+	uint64_t device_offset = state_offset + sizeof(x86_state_t);
+	uint64_t extent_offset = device_offset + device_size;
+	uint64_t data_offset = (extent_offset + extent_count * sizeof(snapshot_extent_t) + page_size - 1) & ~(uint64_t)(page_size - 1);
+
+	uint64_t offset = data_offset;
+	for(size_t i = 0; i < extent_count; i++)
+	{
+		extents[i].offset = offset;
+		offset += extents[i].length;
+	}
+
+	snapshot_header_t header;
+	memset(&header, 0, sizeof header);
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof header.magic);
+	header.version = SNAPSHOT_VERSION;
+	header.page_size = page_size;
+	header.state_size = sizeof(x86_state_t);
+	header.device_size = device_size;
+	header.extent_count = extent_count;
+	header.data_offset = data_offset;
+	header.cpu_version = cpu_version;
+	header.pc_type = pc_type;
+	header.system_type = system_type;
+	header.address_bits = _memory.address_bits;
+
+	uint8_t * devices = malloc(device_size);
+	if(devices == NULL)
+	{
+		fprintf(stderr, "Unable to allocate memory\n");
+		exit(1);
+	}
+	_snapshot_store_devices(devices);
+
+	int fd = open(_snapshot.save_file_name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(fd == -1)
+	{
+		fprintf(stderr, "Unable to create snapshot file %s\n", _snapshot.save_file_name);
+		exit(1);
+	}
+
+	_snapshot_write(fd, &header, sizeof header, 0);
+	_snapshot_write(fd, emu, sizeof(x86_state_t), state_offset);
+	_snapshot_write(fd, devices, device_size, device_offset);
+	_snapshot_write(fd, extents, extent_count * sizeof(snapshot_extent_t), extent_offset);
+	for(size_t i = 0; i < extent_count; i++)
+	{
+		// extents may cross into the next region, which is a separate host mapping
+		for(uint64_t done = 0; done < extents[i].length; )
+		{
+			uint64_t address = extents[i].address + done;
+			size_t size = min(extents[i].length - done, region_size - (address & (region_size - 1)));
+			_snapshot_write(fd, _memory_get_pointer(address), size, extents[i].offset + done);
+			done += size;
+		}
+	}
+	if(ftruncate(fd, offset) != 0)
+	{
+		fprintf(stderr, "Unable to write snapshot file %s\n", _snapshot.save_file_name);
+		exit(1);
+	}
+	close(fd);
+
+	free(devices);
+	free(extents);
+}
+
+// Saves the snapshot once the requested instruction is reached
+static void _snapshot_before_step(x86_state_t * emu, int cpu_version)
+{
+	if((_snapshot.save_at_address && emu->sr[X86_R_CS].base + emu->xip == _snapshot.save_address)
+	|| (_snapshot.save_after_steps && _snapshot.steps >= _snapshot.save_steps))
+	{
+		_snapshot.save_pending = false;
+		_snapshot_save(emu, cpu_version);
+		if(_snapshot.save_and_exit)
+			exit(0);
+	}
+	_snapshot.steps++;
+}
+
+// Reads the machine configuration of the snapshot, must be called before guest memory and the CPU are set up
+static int _snapshot_open(void)
+{
+	_snapshot.restore_fd = open(_snapshot.restore_file_name, O_RDONLY);
+	if(_snapshot.restore_fd == -1)
+	{
+		fprintf(stderr, "Invalid snapshot file %s\n", _snapshot.restore_file_name);
+		exit(1);
+	}
+
+	snapshot_header_t * header = &_snapshot.header;
+	_snapshot_read(_snapshot.restore_fd, header, sizeof(snapshot_header_t), 0);
+
+	if(memcmp(header->magic, SNAPSHOT_MAGIC, sizeof header->magic) != 0
+	|| header->version != SNAPSHOT_VERSION
+	|| header->page_size < sizeof(uint64_t) || (header->page_size & (header->page_size - 1)) != 0
+	|| header->device_size != _snapshot_device_size()
+	|| header->cpu_version < 0 || (size_t)header->cpu_version >= sizeof x86_cpu_traits / sizeof x86_cpu_traits[0]
+	|| header->address_bits < 20 || header->address_bits > 52)
+	{
+		fprintf(stderr, "Not a snapshot file\n");
+		exit(1);
+	}
+
+	if(header->state_size != sizeof(x86_state_t))
+	{
+		fprintf(stderr, "Snapshot was made by a different build of the emulator\n");
+		exit(1);
+	}
+
+	pc_type = header->pc_type;
+	system_type = header->system_type;
+	_memory.address_bits = header->address_bits;
+	return header->cpu_version;
+}
+
+// Replaces the CPU, device and memory state with the contents of the snapshot, guest memory is mapped copy-on-write from the file
+static void _snapshot_restore(x86_state_t * emu)
+{
+	int fd = _snapshot.restore_fd;
+	snapshot_header_t * header = &_snapshot.header;
+	uint64_t state_offset = sizeof(snapshot_header_t);
+	uint64_t device_offset = state_offset + header->state_size;
+	uint64_t extent_offset = device_offset + header->device_size;
+
+	x86_state_t * saved = malloc(sizeof(x86_state_t));
+	uint8_t * devices = malloc(header->device_size);
+	snapshot_extent_t * extents = malloc(header->extent_count * sizeof(snapshot_extent_t));
+	if(saved == NULL || devices == NULL || (extents == NULL && header->extent_count != 0))
+	{
+		fprintf(stderr, "Unable to allocate memory\n");
+		exit(1);
+	}
+
+	_snapshot_read(fd, saved, sizeof(x86_state_t), state_offset);
+	x86_restore_state(emu, saved);
+	free(saved);
+
+	_snapshot_read(fd, devices, header->device_size, device_offset);
+	_snapshot_load_devices(devices);
+	free(devices);
+
+	// drop everything the reset and the machine setup wrote, pages missing from the snapshot must read as zero
+	size_t region_size = (size_t)1 << _memory.region_shift;
+	for(size_t i = 0; i < _memory.allocated_region_count; i++)
+	{
+		uint8_t * region = _memory.regions[_memory.allocated_regions[i]];
+		if(madvise(region, region_size, MADV_DONTNEED) != 0)
+			memset(region, 0, region_size);
+	}
+
+	// the file cannot be mapped if its pages are smaller than the pages of the host, or for hugetlbfs regions
+	size_t page_size = sysconf(_SC_PAGESIZE);
+	bool can_map = header->page_size % page_size == 0 && !_memory.hugetlb;
+
+	_snapshot_read(fd, extents, header->extent_count * sizeof(snapshot_extent_t), extent_offset);
+	for(size_t i = 0; i < header->extent_count; i++)
+	{
+		if((extents[i].address & (header->page_size - 1)) != 0
+		|| (extents[i].offset & (header->page_size - 1)) != 0
+		|| extents[i].address + extents[i].length - 1 > _memory.address_mask)
+		{
+			fprintf(stderr, "Invalid snapshot file %s\n", _snapshot.restore_file_name);
+			exit(1);
+		}
+
+		for(uint64_t done = 0; done < extents[i].length; )
+		{
+			uint64_t address = extents[i].address + done;
+			size_t size = min(extents[i].length - done, region_size - (address & (region_size - 1)));
+			uint8_t * host = _memory_get_pointer(address);
+			if(!can_map || mmap(host, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, extents[i].offset + done) == MAP_FAILED)
+				_snapshot_read(fd, host, size, extents[i].offset + done);
+			done += size;
+		}
+	}
+	free(extents);
+
+	close(fd);
+}
+
+//// Fuzzing harness
+
+/*
+	Persistent mode harness for AFL and compatible fuzzers
+	The machine is checkpointed once when execution first reaches the start address, then each run writes an input into guest memory, executes until the stop address, the instruction budget, a halt or a crash, and rolls back only the pages the run wrote to
+	When started by a fuzzer, the forkserver protocol is served on file descriptors 198 and 199 and edge coverage is recorded into the shared memory map
+*/
+
+#define FUZZ_FORKSERVER_FD 198
+#define FUZZ_DEFAULT_MAP_SIZE 0x10000
+
+static struct
+{
+	bool enabled;
+	bool started; // the checkpoint has been taken
+	bool start_at_address;
+	uaddr_t start_address; // linear address of the instruction to checkpoint at
+	bool stop_at_address;
+	uaddr_t stop_address; // linear address that ends a run
+	bool input_given;
+	uaddr_t input_address; // physical address the input is written to
+	size_t input_size;
+	bool length_given;
+	uaddr_t length_address; // physical address of a 32-bit little endian input length
+	uint64_t max_steps;
+	uint32_t crash_mask; // exception vectors that count as a crash
+	uint64_t loops; // runs before the forkserver starts a new process
+	const char * file_name;
+
+	bool forkserver;
+	uint64_t runs;
+	uint64_t steps;
+	uint8_t * input;
+
+	x86_state_t * state;
+	uint8_t * devices;
+	size_t region_count; // number of allocated regions at the checkpoint, later regions are cleared by a rollback
+	size_t page_count;
+	uaddr_t * page_addresses; // sorted physical addresses of the 4 KiB pages that were not zero at the checkpoint
+	uint8_t * page_data;
+	uint64_t * dirty_pages;
+} _fuzz =
+{
+	.input_size = 0x1000,
+	.crash_mask = (1 << 0x00) | (1 << 0x06) | (1 << 0x08) | (1 << 0x0C) | (1 << 0x0D) | (1 << 0x0E),
+	.loops = 1000,
+};
+
+static void _fuzz_parse_options(char * arg)
+{
+	_fuzz.enabled = true;
+	for(char * option = strtok(arg, ","); option != NULL; option = strtok(NULL, ","))
+	{
+		if(strncasecmp(option, "input=", 6) == 0)
+		{
+			_fuzz.input_given = true;
+			_fuzz.input_address = strtoull(option + 6, NULL, 16);
+		}
+		else if(strncasecmp(option, "size=", 5) == 0)
+		{
+			_fuzz.input_size = strtoull(option + 5, NULL, 0);
+		}
+		else if(strncasecmp(option, "length=", 7) == 0)
+		{
+			_fuzz.length_given = true;
+			_fuzz.length_address = strtoull(option + 7, NULL, 16);
+		}
+		else if(strncasecmp(option, "at=", 3) == 0)
+		{
+			_fuzz.start_at_address = true;
+			_fuzz.start_address = strtoull(option + 3, NULL, 16);
+		}
+		else if(strncasecmp(option, "stop=", 5) == 0)
+		{
+			_fuzz.stop_at_address = true;
+			_fuzz.stop_address = strtoull(option + 5, NULL, 16);
+		}
+		else if(strncasecmp(option, "steps=", 6) == 0)
+		{
+			_fuzz.max_steps = strtoull(option + 6, NULL, 0);
+		}
+		else if(strncasecmp(option, "crash=", 6) == 0)
+		{
+			_fuzz.crash_mask = strtoul(option + 6, NULL, 16);
+		}
+		else if(strncasecmp(option, "loops=", 6) == 0)
+		{
+			_fuzz.loops = strtoull(option + 6, NULL, 0);
+		}
+		else if(strncasecmp(option, "file=", 5) == 0)
+		{
+			_fuzz.file_name = option + 5;
+		}
+		else
+		{
+			fprintf(stderr, "Unknown fuzzing option: %s\n", option);
+			exit(1);
+		}
+	}
+
+	if(!_fuzz.input_given || _fuzz.input_size == 0 || _fuzz.loops == 0)
+	{
+		fprintf(stderr, "Invalid fuzzing options\n");
+		exit(1);
+	}
+
+	_fuzz.input = malloc(_fuzz.input_size);
+	if(_fuzz.input == NULL)
+	{
+		fprintf(stderr, "Unable to allocate memory\n");
+		exit(1);
+	}
+}
+
+// Uses the shared memory map of the fuzzer, coverage is not recorded when running outside of a fuzzer
+static void _fuzz_setup_coverage(x86_state_t * emu)
+{
+	const char * shm_id = getenv("__AFL_SHM_ID");
+	if(shm_id == NULL)
+		return;
+
+	size_t map_size = FUZZ_DEFAULT_MAP_SIZE;
+	const char * map_size_text = getenv("AFL_MAP_SIZE");
+	if(map_size_text != NULL)
+		map_size = strtoull(map_size_text, NULL, 0);
+	if(map_size == 0 || (map_size & (map_size - 1)) != 0)
+	{
+		fprintf(stderr, "Invalid coverage map size\n");
+		exit(1);
+	}
+
+	void * map = shmat(atoi(shm_id), NULL, 0);
+	if(map == (void *)-1)
+	{
+		fprintf(stderr, "Unable to attach coverage map\n");
+		exit(1);
+	}
+	emu->coverage_map = map;
+	emu->coverage_mask = map_size - 1;
+}
+
+static void _fuzz_checkpoint(x86_state_t * emu)
+{
+	size_t region_size = (size_t)1 << _memory.region_shift;
+
+	_fuzz.state = malloc(sizeof(x86_state_t));
+	_fuzz.devices = malloc(_snapshot_device_size());
+	uaddr_t * regions = malloc(_memory.allocated_region_count * sizeof(uaddr_t));
+	if(_fuzz.state == NULL || _fuzz.devices == NULL || (regions == NULL && _memory.allocated_region_count != 0))
+	{
+		fprintf(stderr, "Unable to allocate memory\n");
+		exit(1);
+	}
+	memcpy(_fuzz.state, emu, sizeof(x86_state_t));
+	_snapshot_store_devices(_fuzz.devices);
+
+	// copy the pages holding data in address order, so that a rollback can find them with a binary search
+	memcpy(regions, _memory.allocated_regions, _memory.allocated_region_count * sizeof(uaddr_t));
+	qsort(regions, _memory.allocated_region_count, sizeof(uaddr_t), _snapshot_address_compare);
+
+	// pages the host never populated are known to be zero without reading them
+	size_t host_page_size = sysconf(_SC_PAGESIZE);
+	unsigned char * resident = malloc((region_size + host_page_size - 1) / host_page_size);
+	if(resident == NULL)
+	{
+		fprintf(stderr, "Unable to allocate memory\n");
+		exit(1);
+	}
+
+	size_t page_capacity = 0;
+	uaddr_t memory_size = 0;
+	for(size_t i = 0; i < _memory.allocated_region_count; i++)
+	{
+		uaddr_t index = regions[i];
+		uint8_t * region = _memory.regions[index];
+		bool check_resident = mincore(region, region_size, resident) == 0;
+		for(size_t offset = 0; offset < region_size; offset += 0x1000)
+		{
+			if((check_resident && (resident[offset / host_page_size] & 1) == 0)
+			|| _snapshot_page_is_zero(region + offset, 0x1000))
+				continue;
+
+			if(_fuzz.page_count >= page_capacity)
+			{
+				page_capacity = page_capacity == 0 ? 256 : 2 * page_capacity;
+				_fuzz.page_addresses = realloc(_fuzz.page_addresses, page_capacity * sizeof(uaddr_t));
+				_fuzz.page_data = realloc(_fuzz.page_data, page_capacity * 0x1000);
+				if(_fuzz.page_addresses == NULL || _fuzz.page_data == NULL)
+				{
+					fprintf(stderr, "Unable to allocate memory\n");
+					exit(1);
+				}
+			}
+			_fuzz.page_addresses[_fuzz.page_count] = ((uaddr_t)index << _memory.region_shift) + offset;
+			memcpy(_fuzz.page_data + _fuzz.page_count * 0x1000, region + offset, 0x1000);
+			_fuzz.page_count++;
+		}
+		memory_size = ((uaddr_t)index + 1) << _memory.region_shift;
+	}
+	free(resident);
+	free(regions);
+	_fuzz.region_count = _memory.allocated_region_count;
+
+	// every region present at the checkpoint is tracked, regions allocated later are cleared as a whole
+	if(!x86_dirty_pages_enable(emu, memory_size))
+	{
+		fprintf(stderr, "Unable to allocate memory\n");
+		exit(1);
+	}
+	_fuzz.dirty_pages = malloc(x86_dirty_pages_size(emu) * sizeof(uint64_t));
+	if(_fuzz.dirty_pages == NULL)
+	{
+		fprintf(stderr, "Unable to allocate memory\n");
+		exit(1);
+	}
+}
+
+// Restores the contents of the storage page at address to the checkpoint
+static void _fuzz_restore_page(uaddr_t address)
+{
+	uaddr_t * found = bsearch(&address, _fuzz.page_addresses, _fuzz.page_count, sizeof(uaddr_t), _snapshot_address_compare);
+	if(found != NULL)
+		memcpy(_memory_get_pointer(address), _fuzz.page_data + (found - _fuzz.page_addresses) * 0x1000, 0x1000);
+	else
+		memset(_memory_get_pointer(address), 0, 0x1000);
+}
+
+static void _fuzz_rollback(x86_state_t * emu)
+{
+	// pages are recorded by the address the CPU wrote to, pages in the memory map are restored where they are stored
+	size_t word_count = x86_dirty_pages_fetch(emu, _fuzz.dirty_pages);
+	for(uaddr_t page = x86_dirty_pages_next(_fuzz.dirty_pages, word_count, 0); page != (uaddr_t)-1; page = x86_dirty_pages_next(_fuzz.dirty_pages, word_count, page + 1))
+	{
+		if(page < MEMORY_MAP_PAGE_COUNT)
+			_fuzz_restore_page(_memory_map[page].address);
+		else
+			_fuzz_restore_page(page << 12);
+	}
+
+	size_t region_size = (size_t)1 << _memory.region_shift;
+	for(size_t i = _fuzz.region_count; i < _memory.allocated_region_count; i++)
+	{
+		uint8_t * region = _memory.regions[_memory.allocated_regions[i]];
+		if(madvise(region, region_size, MADV_DONTNEED) != 0)
+			memset(region, 0, region_size);
+	}
+
+	x86_restore_state(emu, _fuzz.state);
+	_snapshot_load_devices(_fuzz.devices);
+}
+
+static size_t _fuzz_read_input(void)
+{
+	int fd = 0;
+	if(_fuzz.file_name != NULL)
+	{
+		fd = open(_fuzz.file_name, O_RDONLY);
+		if(fd == -1)
+		{
+			fprintf(stderr, "Unable to open fuzzing input %s\n", _fuzz.file_name);
+			exit(1);
+		}
+	}
+	else
+	{
+		// the fuzzer replaces the contents of the same file for every input, this fails harmlessly for pipes
+		lseek(fd, 0, SEEK_SET);
+	}
+
+	size_t length = 0;
+	ssize_t count;
+	while(length < _fuzz.input_size && (count = read(fd, _fuzz.input + length, _fuzz.input_size - length)) > 0)
+		length += count;
+
+	if(fd != 0)
+		close(fd);
+	return length;
+}
+
+static void _fuzz_begin(x86_state_t * emu)
+{
+	size_t length = _fuzz_read_input();
+	x86_memory_write_external(emu, _fuzz.input_address, length, _fuzz.input);
+	if(_fuzz.length_given)
+	{
+		uint8_t buffer[4] = { length, length >> 8, length >> 16, length >> 24 };
+		x86_memory_write_external(emu, _fuzz.length_address, sizeof buffer, buffer);
+	}
+
+	_fuzz.steps = 0;
+}
+
+/*
+	Serves the forkserver protocol, only the child processes return from this function
+	A child stops itself after each run and is resumed for the next input, until it exits after the requested number of runs
+*/
+static void _fuzz_forkserver(void)
+{
+	uint32_t message = 0;
+	if(write(FUZZ_FORKSERVER_FD + 1, &message, sizeof message) != sizeof message)
+		return; // not started by a fuzzer, run a single input
+
+	_fuzz.forkserver = true;
+	pid_t child = -1;
+	bool child_stopped = false;
+	for(;;)
+	{
+		uint32_t was_killed;
+		if(read(FUZZ_FORKSERVER_FD, &was_killed, sizeof was_killed) != sizeof was_killed)
+			exit(0);
+
+		// the fuzzer killed the stopped child after a timeout
+		if(child_stopped && was_killed)
+		{
+			child_stopped = false;
+			waitpid(child, NULL, 0);
+		}
+
+		if(child_stopped)
+		{
+			kill(child, SIGCONT);
+			child_stopped = false;
+		}
+		else
+		{
+			child = fork();
+			if(child == -1)
+				exit(1);
+			if(child == 0)
+			{
+				close(FUZZ_FORKSERVER_FD);
+				close(FUZZ_FORKSERVER_FD + 1);
+				return;
+			}
+		}
+
+		int status;
+		if(write(FUZZ_FORKSERVER_FD + 1, &child, sizeof child) != sizeof child
+		|| waitpid(child, &status, WUNTRACED) == -1)
+			exit(1);
+		child_stopped = WIFSTOPPED(status);
+		if(write(FUZZ_FORKSERVER_FD + 1, &status, sizeof status) != sizeof status)
+			exit(1);
+	}
+}
+
+static void _fuzz_end(x86_state_t * emu, bool crashed)
+{
+	if(crashed)
+	{
+		// the fuzzer recognizes crashes by the signal that terminated the process
+		fprintf(stderr, "Fuzzing: crash at %08"PRIX64"\n", (uint64_t)(emu->sr[X86_R_CS].base + emu->old_xip));
+		abort();
+	}
+
+	if(!_fuzz.forkserver || ++_fuzz.runs >= _fuzz.loops)
+		exit(0);
+
+	raise(SIGSTOP);
+	_fuzz_rollback(emu);
+	_fuzz_begin(emu);
+}
+
+static void _fuzz_before_step(x86_state_t * emu)
+{
+	uaddr_t address = emu->sr[X86_R_CS].base + emu->xip;
+	if(!_fuzz.started)
+	{
+		if(_fuzz.start_at_address && address != _fuzz.start_address)
+			return;
+
+		_fuzz.started = true;
+		_fuzz_setup_coverage(emu);
+		_fuzz_checkpoint(emu);
+		_fuzz_forkserver();
+		_fuzz_begin(emu);
+		return;
+	}
+
+	if((_fuzz.stop_at_address && address == _fuzz.stop_address)
+	|| (_fuzz.max_steps != 0 && _fuzz.steps >= _fuzz.max_steps))
+	{
+		_fuzz_end(emu, false);
+		return;
+	}
+	_fuzz.steps++;
+}
+
+static void _fuzz_after_step(x86_state_t * emu, x86_result_t result)
+{
+	if(!_fuzz.started)
+		return;
+
+	switch(X86_RESULT_TYPE(result))
+	{
+	case X86_RESULT_TRIPLE_FAULT:
+	case X86_RESULT_UNDEFINED:
+		_fuzz_end(emu, true);
+		break;
+	case X86_RESULT_HALT:
+		_fuzz_end(emu, false);
+		break;
+	case X86_RESULT_CPU_INTERRUPT:
+	case X86_RESULT_INTERRUPT:
+		// software interrupts with the same number are not faults
+		if((emu->last_exception & (X86_EXC_FAULT | X86_EXC_ABORT)) != 0
+		&& X86_RESULT_VALUE(result) < 32 && ((_fuzz.crash_mask >> X86_RESULT_VALUE(result)) & 1) != 0)
+			_fuzz_end(emu, true);
+		break;
+	default:
+		break;
+	}
+}
+
 static inline _Noreturn void fread_failed(void)
 {
 	fprintf(stderr, "Premature end of file\n");
@@ -3058,6 +4287,412 @@ uaddr_t load_minix(x86_state_t * emu, FILE * input_file, long file_offset, struc
 	return 0;
 }
 
+//// Guest profiler
+
+/*
+	Samples the guest instruction pointer every few instructions or whenever the SIGPROF timer fires
+	When call tracking is enabled, a shadow call stack is maintained so that samples can be emitted as folded stacks
+	CALL and INT are recognized by the return address they leave on top of the stack, RET and IRET by the stack pointer moving above it
+*/
+
+#define PROFILE_STACK_DEPTH 64
+#define PROFILE_HASH_SIZE 4096
+
+static struct
+{
+	bool enabled;
+	bool track_calls;
+	bool use_timer;
+	uint64_t interval; // number of instructions between samples, 0 if only the timer is used
+	uint64_t countdown;
+	unsigned top_count;
+	const char * folded_file_name;
+
+	uaddr_t old_stack_address; // stack pointer before the last step
+	uaddr_t old_instruction_address; // linear address of the last instruction
+
+	size_t depth;
+	struct
+	{
+		uaddr_t stack_address; // where the return address is stored
+		uaddr_t call_site; // linear address of the calling instruction
+	} stack[PROFILE_STACK_DEPTH];
+
+	uint64_t sample_count;
+} _profile =
+{
+	.top_count = 20,
+};
+
+static volatile sig_atomic_t _profile_timer_expired = 0;
+
+typedef struct profile_symbol_t
+{
+	uaddr_t address;
+	uaddr_t size;
+	char * name;
+} profile_symbol_t;
+
+static profile_symbol_t * _profile_symbols = NULL;
+static size_t _profile_symbol_count = 0;
+static size_t _profile_symbol_capacity = 0;
+static bool _profile_symbols_sorted = true;
+
+typedef struct profile_entry_t
+{
+	struct profile_entry_t * next;
+	uint64_t count; // samples for folded stacks, self samples for functions
+	uint64_t total; // samples where the function appears anywhere on the stack
+	char key[];
+} profile_entry_t;
+
+static profile_entry_t * _profile_stacks[PROFILE_HASH_SIZE];
+static profile_entry_t * _profile_functions[PROFILE_HASH_SIZE];
+
+static void _profile_add_symbol(uaddr_t address, uaddr_t size, const char * name)
+{
+	if(_profile_symbol_count >= _profile_symbol_capacity)
+	{
+		_profile_symbol_capacity = _profile_symbol_capacity == 0 ? 256 : 2 * _profile_symbol_capacity;
+		_profile_symbols = realloc(_profile_symbols, _profile_symbol_capacity * sizeof(profile_symbol_t));
+	}
+	_profile_symbols[_profile_symbol_count].address = address;
+	_profile_symbols[_profile_symbol_count].size = size;
+	_profile_symbols[_profile_symbol_count].name = strdup(name);
+	_profile_symbol_count++;
+	_profile_symbols_sorted = false;
+}
+
+static int _profile_symbol_compare(const void * a, const void * b)
+{
+	uaddr_t address_a = ((const profile_symbol_t *)a)->address;
+	uaddr_t address_b = ((const profile_symbol_t *)b)->address;
+	return address_a < address_b ? -1 : address_a > address_b ? 1 : 0;
+}
+
+// Returns the name of the function containing the address, or its hexadecimal value if there is no such symbol
+static const char * _profile_symbol_name(uaddr_t address, char buffer[20])
+{
+	if(!_profile_symbols_sorted)
+	{
+		qsort(_profile_symbols, _profile_symbol_count, sizeof(profile_symbol_t), _profile_symbol_compare);
+		_profile_symbols_sorted = true;
+	}
+
+	size_t low = 0, high = _profile_symbol_count;
+	while(low < high)
+	{
+		size_t middle = low + (high - low) / 2;
+		if(_profile_symbols[middle].address <= address)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	if(low > 0)
+	{
+		profile_symbol_t * symbol = &_profile_symbols[low - 1];
+		if(symbol->size == 0 || address - symbol->address < symbol->size)
+			return symbol->name;
+	}
+
+	snprintf(buffer, 20, "0x%"PRIX64, (uint64_t)address);
+	return buffer;
+}
+
+static uint32_t _profile_hash(const char * text)
+{
+	uint32_t hash = 2166136261u;
+	for(; *text != '\0'; text++)
+		hash = (hash ^ (uint8_t)*text) * 16777619u;
+	return hash;
+}
+
+static profile_entry_t * _profile_lookup(profile_entry_t ** table, const char * key)
+{
+	profile_entry_t ** link = &table[_profile_hash(key) % PROFILE_HASH_SIZE];
+	for(; *link != NULL; link = &(*link)->next)
+	{
+		if(strcmp((*link)->key, key) == 0)
+			return *link;
+	}
+
+	size_t length = strlen(key);
+	*link = malloc(sizeof(profile_entry_t) + length + 1);
+	(*link)->next = NULL;
+	(*link)->count = (*link)->total = 0;
+	memcpy((*link)->key, key, length + 1);
+	return *link;
+}
+
+static void _profile_timer_handler(int signum)
+{
+	(void) signum;
+	_profile_timer_expired = 1;
+}
+
+static uaddr_t _profile_stack_address(x86_state_t * emu)
+{
+	if(x86_is_64bit_mode(emu))
+		return emu->rsp;
+	else if((emu->sr[X86_R_SS].access & X86_DESC_B) != 0)
+		return emu->sr[X86_R_SS].base + emu->esp;
+	else
+		return emu->sr[X86_R_SS].base + emu->sp;
+}
+
+static inline uaddr_t _profile_instruction_address(x86_state_t * emu)
+{
+	if(emu->x80.cpu_method == X80_CPUMETHOD_SEPARATE)
+		return emu->x80.pc;
+	else if(x86_is_emulation_mode(emu))
+		return emu->sr[X86_R_CS].base + emu->x80.pc;
+	else if(x86_is_64bit_mode(emu))
+		return emu->xip;
+	else
+		return emu->sr[X86_R_CS].base + emu->xip;
+}
+
+static void _profile_before_step(x86_state_t * emu)
+{
+	if(_profile.track_calls && !x86_is_emulation_mode(emu))
+	{
+		_profile.old_stack_address = _profile_stack_address(emu);
+		_profile.old_instruction_address = _profile_instruction_address(emu);
+	}
+}
+
+static void _profile_track_calls(x86_state_t * emu)
+{
+	uaddr_t stack_address = _profile_stack_address(emu);
+
+	// RET, IRET, or anything else that discards the frame
+	while(_profile.depth > 0 && stack_address > _profile.stack[_profile.depth - 1].stack_address)
+		_profile.depth--;
+
+	if(stack_address >= _profile.old_stack_address)
+		return;
+
+	// CALL or INT, the return address points just after the current instruction, but execution continues elsewhere
+	// the stack is read without faulting or triggering breakpoints, since this runs outside of x86_step
+	uoff_t return_address;
+	if(x86_is_64bit_mode(emu))
+	{
+		uint64_t value;
+		if(!x86_memory_read_debug(emu, stack_address, 8, &value))
+			return;
+		return_address = le64toh(value);
+	}
+	else if((emu->sr[X86_R_SS].access & X86_DESC_B) != 0)
+	{
+		uint32_t value;
+		if(!x86_memory_read_debug(emu, stack_address, 4, &value))
+			return;
+		return_address = le32toh(value);
+	}
+	else
+	{
+		uint16_t value;
+		if(!x86_memory_read_debug(emu, stack_address, 2, &value))
+			return;
+		return_address = le16toh(value);
+	}
+
+	if(return_address <= emu->old_xip || return_address - emu->old_xip > 15 || return_address == emu->xip)
+		return;
+
+	if(_profile.depth == PROFILE_STACK_DEPTH)
+	{
+		// drop the outermost frame
+		memmove(&_profile.stack[0], &_profile.stack[1], (PROFILE_STACK_DEPTH - 1) * sizeof _profile.stack[0]);
+		_profile.depth--;
+	}
+
+	_profile.stack[_profile.depth].stack_address = stack_address;
+	_profile.stack[_profile.depth].call_site = _profile.old_instruction_address;
+	_profile.depth++;
+}
+
+static void _profile_sample(x86_state_t * emu)
+{
+	static char folded[PROFILE_STACK_DEPTH * 64];
+	const char * names[PROFILE_STACK_DEPTH + 1];
+	char buffers[PROFILE_STACK_DEPTH + 1][20];
+	size_t count = 0;
+	size_t length = 0;
+
+	for(size_t i = 0; i < _profile.depth; i++)
+	{
+		names[count] = _profile_symbol_name(_profile.stack[i].call_site, buffers[count]);
+		count++;
+	}
+	names[count] = _profile_symbol_name(_profile_instruction_address(emu), buffers[count]);
+	count++;
+
+	for(size_t i = 0; i < count; i++)
+	{
+		length += snprintf(folded + length, sizeof folded - length, i == 0 ? "%s" : ";%s", names[i]);
+		if(length >= sizeof folded)
+		{
+			length = sizeof folded - 1;
+			break;
+		}
+	}
+
+	_profile_lookup(_profile_stacks, folded)->count++;
+	_profile_lookup(_profile_functions, names[count - 1])->count++;
+	for(size_t i = 0; i < count; i++)
+	{
+		// recursive functions are only counted once per sample
+		bool repeated = false;
+		for(size_t j = 0; j < i; j++)
+		{
+			if(strcmp(names[i], names[j]) == 0)
+			{
+				repeated = true;
+				break;
+			}
+		}
+		if(!repeated)
+			_profile_lookup(_profile_functions, names[i])->total++;
+	}
+
+	_profile.sample_count++;
+}
+
+static void _profile_after_step(x86_state_t * emu)
+{
+	if(_profile.track_calls && !x86_is_emulation_mode(emu))
+		_profile_track_calls(emu);
+
+	if(_profile.interval != 0 && --_profile.countdown == 0)
+	{
+		_profile.countdown = _profile.interval;
+		_profile_sample(emu);
+	}
+
+	if(_profile_timer_expired)
+	{
+		_profile_timer_expired = 0;
+		_profile_sample(emu);
+	}
+}
+
+static int _profile_entry_compare(const void * a, const void * b)
+{
+	const profile_entry_t * entry_a = *(const profile_entry_t * const *)a;
+	const profile_entry_t * entry_b = *(const profile_entry_t * const *)b;
+	if(entry_a->count != entry_b->count)
+		return entry_a->count < entry_b->count ? 1 : -1;
+	return strcmp(entry_a->key, entry_b->key);
+}
+
+static void _profile_report(void)
+{
+	if(_profile.folded_file_name != NULL)
+	{
+		FILE * output = fopen(_profile.folded_file_name, "w");
+		if(output == NULL)
+		{
+			fprintf(stderr, "Unable to write profile to %s\n", _profile.folded_file_name);
+		}
+		else
+		{
+			for(size_t i = 0; i < PROFILE_HASH_SIZE; i++)
+			{
+				for(profile_entry_t * entry = _profile_stacks[i]; entry != NULL; entry = entry->next)
+					fprintf(output, "%s %"PRIu64"\n", entry->key, entry->count);
+			}
+			fclose(output);
+		}
+	}
+
+	size_t function_count = 0;
+	for(size_t i = 0; i < PROFILE_HASH_SIZE; i++)
+	{
+		for(profile_entry_t * entry = _profile_functions[i]; entry != NULL; entry = entry->next)
+			function_count++;
+	}
+
+	profile_entry_t ** functions = malloc((function_count + 1) * sizeof(profile_entry_t *));
+	function_count = 0;
+	for(size_t i = 0; i < PROFILE_HASH_SIZE; i++)
+	{
+		for(profile_entry_t * entry = _profile_functions[i]; entry != NULL; entry = entry->next)
+			functions[function_count++] = entry;
+	}
+	qsort(functions, function_count, sizeof(profile_entry_t *), _profile_entry_compare);
+
+	fprintf(stderr, "Profile: %"PRIu64" samples\n", _profile.sample_count);
+	fprintf(stderr, "%12s %7s %12s %7s  %s\n", "self", "", "total", "", "function");
+	for(size_t i = 0; i < function_count && i < _profile.top_count; i++)
+	{
+		fprintf(stderr, "%12"PRIu64" %6.2f%% %12"PRIu64" %6.2f%%  %s\n",
+			functions[i]->count, 100.0 * functions[i]->count / _profile.sample_count,
+			functions[i]->total, 100.0 * functions[i]->total / _profile.sample_count,
+			functions[i]->key);
+	}
+	free(functions);
+}
+
+static void _profile_parse_options(char * arg)
+{
+	_profile.enabled = true;
+	for(char * option = strtok(arg, ","); option != NULL; option = strtok(NULL, ","))
+	{
+		if('0' <= option[0] && option[0] <= '9')
+		{
+			_profile.interval = strtoull(option, NULL, 0);
+		}
+		else if(strcasecmp(option, "timer") == 0)
+		{
+			_profile.use_timer = true;
+		}
+		else if(strcasecmp(option, "stack") == 0)
+		{
+			_profile.track_calls = true;
+		}
+		else if(strncasecmp(option, "top=", 4) == 0)
+		{
+			_profile.top_count = strtoul(option + 4, NULL, 0);
+		}
+		else if(strncasecmp(option, "out=", 4) == 0)
+		{
+			_profile.folded_file_name = option + 4;
+		}
+		else
+		{
+			fprintf(stderr, "Unknown profiler option: %s\n", option);
+			exit(1);
+		}
+	}
+}
+
+static void _profile_start(void)
+{
+	if(_profile.interval == 0 && !_profile.use_timer)
+		_profile.interval = 10000;
+	_profile.countdown = _profile.interval;
+
+	if(_profile.use_timer)
+	{
+		struct sigaction action;
+		memset(&action, 0, sizeof action);
+		action.sa_handler = _profile_timer_handler;
+		action.sa_flags = SA_RESTART;
+		sigaction(SIGPROF, &action, NULL);
+
+		// sample at 1000 Hz of host processor time
+		struct itimerval timer;
+		timer.it_interval.tv_sec = 0;
+		timer.it_interval.tv_usec = 1000;
+		timer.it_value = timer.it_interval;
+		setitimer(ITIMER_PROF, &timer, NULL);
+	}
+
+	atexit(_profile_report);
+}
+
 // for ELF
 
 enum
@@ -3092,6 +4727,16 @@ enum
 	PT_LOAD = 1,
 };
 
+enum
+{
+	SHT_SYMTAB = 2,
+};
+
+enum
+{
+	STT_FUNC = 2,
+};
+
 enum
 {
 	X86_32_SYS_EXIT = 1,
@@ -3125,6 +4770,66 @@ static inline uint64_t freadword(FILE * input)
 	return ei_class == ELFCLASS64 ? fread64le(input) : fread32le(input);
 }
 
+// Collects the function symbols for the profiler, base is added to each symbol value
+static void load_elf_symbols(FILE * input_file, long file_offset, uint64_t shoff, uint16_t shentsize, uint16_t shnum, uint64_t base)
+{
+	for(uint16_t i = 0; i < shnum; i++)
+	{
+		fseek(input_file, file_offset + shoff + i * shentsize + 4, SEEK_SET);
+		if(fread32le(input_file) != SHT_SYMTAB)
+			continue;
+
+		fseek(input_file, ei_class == ELFCLASS32 ? 8 : 16, SEEK_CUR); // skip flags and address
+		uint64_t offset = freadword(input_file);
+		uint64_t size = freadword(input_file);
+		uint32_t link = fread32le(input_file);
+		fseek(input_file, ei_class == ELFCLASS32 ? 8 : 12, SEEK_CUR); // skip info and alignment
+		uint64_t entsize = freadword(input_file);
+
+		if(link >= shnum || entsize == 0)
+			continue;
+
+		// read the associated string table
+		fseek(input_file, file_offset + shoff + link * shentsize + (ei_class == ELFCLASS32 ? 16 : 24), SEEK_SET);
+		uint64_t strtab_offset = freadword(input_file);
+		uint64_t strtab_size = freadword(input_file);
+
+		char * strtab = malloc(strtab_size + 1);
+		fseek(input_file, file_offset + strtab_offset, SEEK_SET);
+		if(fread(strtab, 1, strtab_size, input_file) != strtab_size)
+			fread_failed();
+		strtab[strtab_size] = '\0';
+
+		for(uint64_t entry = 0; entry + entsize <= size; entry += entsize)
+		{
+			fseek(input_file, file_offset + offset + entry, SEEK_SET);
+			uint32_t name = fread32le(input_file);
+			uint64_t value, symbol_size;
+			uint8_t info;
+			if(ei_class == ELFCLASS32)
+			{
+				value = fread32le(input_file);
+				symbol_size = fread32le(input_file);
+				info = fread8(input_file);
+			}
+			else
+			{
+				info = fread8(input_file);
+				fseek(input_file, 3, SEEK_CUR); // skip other and section index
+				value = fread64le(input_file);
+				symbol_size = fread64le(input_file);
+			}
+
+			if((info & 0xF) != STT_FUNC || name >= strtab_size || strtab[name] == '\0')
+				continue;
+
+			_profile_add_symbol(base + value, symbol_size, strtab + name);
+		}
+
+		free(strtab);
+	}
+}
+
 uaddr_t load_elf(x86_state_t * emu, FILE * input_file, long file_offset, struct load_registers * registers)
 {
 	fseek(input_file, file_offset + 4, SEEK_SET);
@@ -3230,7 +4935,6 @@ uaddr_t load_elf(x86_state_t * emu, FILE * input_file, long file_offset, struct
 
 	uint64_t phoff = freadword(input_file);
 	uint64_t shoff = freadword(input_file);
-	(void) shoff;
 
 	uint32_t flags = fread32le(input_file);
 	(void) flags;
@@ -3240,9 +4944,7 @@ uaddr_t load_elf(x86_state_t * emu, FILE * input_file, long file_offset, struct
 	uint16_t phentsize = fread16le(input_file);
 	uint16_t phnum = fread16le(input_file);
 	uint16_t shentsize = fread16le(input_file);
-	(void) shentsize;
 	uint16_t shnum = fread16le(input_file);
-	(void) shnum;
 
 	for(uint16_t i = 0; i < phnum; i++)
 	{
@@ -3302,6 +5004,13 @@ uaddr_t load_elf(x86_state_t * emu, FILE * input_file, long file_offset, struct
 		}
 	}
 
+	if(_profile.enabled && shoff != 0)
+	{
+		// ELKS binaries are loaded relative to the code segment
+		load_elf_symbols(input_file, file_offset, shoff, shentsize, shnum,
+			get_exec_mode_size(registers->exec_mode) <= CODE_16_BIT ? registers->cs : 0);
+	}
+
 	if(get_exec_mode_size(registers->exec_mode) == CODE_8_BIT)
 		system_type |= X86_SYSTEM_TYPE_UZI;
 	else
@@ -3727,7 +5436,38 @@ void usage(char * argv0)
 		"\t-S <sys>\tset system type, write -hS to display list of all supported systems\n"
 		"\t-O blink\tenable blinking (PC specific)\n"
 		"\t-O noblink\tdisable blinking (PC specific)\n"
+		"\t-M <opts>\tguest memory options, memory is only allocated as the guest writes to it, options are a comma separated list of:\n"
+		"\t\t<bits>\tphysical address width, between 20 and 52 (default 52 for 64-bit CPUs, 32 otherwise)\n"
+		"\t\thuge\tback memory with transparent huge pages\n"
+		"\t\thugetlb\tback memory with explicit 2 MiB huge pages, each 1 GiB region of memory the guest uses is reserved from the host pool as a whole\n"
+		"\t\tprefault=<size>\tallocate the first size bytes (K, M or G suffix allowed) before execution\n"
+		"\t-I <port>\tattach a loopback device to the hexadecimal I/O port, it returns the bytes written to it and serves REP INS/OUTS as blocks, reading port + 4 returns the number of blocks\n"
 		"\t-D\tenable disassembly\n"
+		"\t-t <file>[,<opts>]\twrite a binary instruction trace to a ring buffer, read it with x86trace, options are a comma separated list of:\n"
+		"\t\tregs\talso record changed registers\n"
+		"\t\tmem\talso record memory writes\n"
+		"\t\trecords=<n>\tsize of the ring buffer (default 1048576)\n"
+		"\t-s <file>,<opts>\tsave a snapshot of the machine, restore it with -r, options are a comma separated list of:\n"
+		"\t\tat=<adr>\tsave when execution reaches the hexadecimal linear address\n"
+		"\t\tsteps=<n>\tsave after n instructions\n"
+		"\t\texit\tstop the emulator once the snapshot is written\n"
+		"\t-r <file>\tcontinue execution from a snapshot instead of loading an image, guest memory is mapped copy-on-write from the file\n"
+		"\t-z <opts>\trun as a persistent mode fuzzing target for AFL, options are a comma separated list of:\n"
+		"\t\tinput=<adr>\twrite each input to the hexadecimal physical address (required)\n"
+		"\t\tsize=<n>\tmaximum input size (default 4096)\n"
+		"\t\tlength=<adr>\tstore the input length as a 32-bit value at the hexadecimal physical address\n"
+		"\t\tfile=<file>\tread inputs from file instead of the standard input\n"
+		"\t\tat=<adr>\tcheckpoint the machine when execution reaches the hexadecimal linear address (default the first instruction)\n"
+		"\t\tstop=<adr>\tend a run when execution reaches the hexadecimal linear address\n"
+		"\t\tsteps=<n>\tend a run after n instructions\n"
+		"\t\tcrash=<mask>\thexadecimal mask of the exception vectors that count as a crash (default 7141)\n"
+		"\t\tloops=<n>\truns before a new process is started (default 1000)\n"
+		"\t-p <opts>\tprofile guest code, options are a comma separated list of:\n"
+		"\t\t<n>\tsample every n instructions (default 10000)\n"
+		"\t\ttimer\tsample on the SIGPROF timer, 1000 times per second of host time\n"
+		"\t\tstack\ttrack calls and interrupts to record the call stack\n"
+		"\t\ttop=<n>\tnumber of functions to list on exit (default 20)\n"
+		"\t\tout=<file>\twrite samples as folded stacks, suitable for flamegraph.pl\n"
 		"\t-d\tenable single step debugging and disassembly\n"
 		"\t-h\tdisplay this help page\n"
 		"\t-h <id>\tlist options for a command line flag\n",
@@ -3761,6 +5501,13 @@ static inline uint16_t allocate_gdt_entry(x86_state_t * emu, uint32_t base, uint
 	return selector;
 }
 
+#if X86_OPCODE_COUNTERS
+static void _opcode_counters_dump(void)
+{
+	x86_opcode_counters_dump(stderr);
+}
+#endif
+
 int main(int argc, char * argv[], char * envp[])
 {
 	x86_state_t emu[1];
@@ -4227,10 +5974,80 @@ int main(int argc, char * argv[], char * envp[])
 					exit(1);
 				}
 			}
+			else if(argv[argi][1] == 'I')
+			{
+				char * arg = argv[argi][2] ? &argv[argi][2] : argv[++argi];
+				if(arg == NULL)
+				{
+					fprintf(stderr, "Error: Missing argument for `-I`\n");
+					exit(1);
+				}
+				_loopback.enabled = true;
+				_loopback.port = strtol(arg, NULL, 16);
+			}
 			else if(argv[argi][1] == 'D')
 			{
 				emu->option_disassemble = true;
 			}
+			else if(argv[argi][1] == 'M')
+			{
+				char * arg = argv[argi][2] ? &argv[argi][2] : argv[++argi];
+				if(arg == NULL)
+				{
+					fprintf(stderr, "Error: Missing argument for `-M`\n");
+					exit(1);
+				}
+				_memory_parse_options(arg);
+			}
+			else if(argv[argi][1] == 's')
+			{
+				char * arg = argv[argi][2] ? &argv[argi][2] : argv[++argi];
+				if(arg == NULL)
+				{
+					fprintf(stderr, "Error: Missing argument for `-s`\n");
+					exit(1);
+				}
+				_snapshot_parse_options(arg);
+			}
+			else if(argv[argi][1] == 'r')
+			{
+				_snapshot.restore_file_name = argv[argi][2] ? &argv[argi][2] : argv[++argi];
+				if(_snapshot.restore_file_name == NULL)
+				{
+					fprintf(stderr, "Error: Missing argument for `-r`\n");
+					exit(1);
+				}
+			}
+			else if(argv[argi][1] == 'z')
+			{
+				char * arg = argv[argi][2] ? &argv[argi][2] : argv[++argi];
+				if(arg == NULL)
+				{
+					fprintf(stderr, "Error: Missing argument for `-z`\n");
+					exit(1);
+				}
+				_fuzz_parse_options(arg);
+			}
+			else if(argv[argi][1] == 't')
+			{
+				char * arg = argv[argi][2] ? &argv[argi][2] : argv[++argi];
+				if(arg == NULL)
+				{
+					fprintf(stderr, "Error: Missing argument for `-t`\n");
+					exit(1);
+				}
+				_trace_parse_options(arg);
+			}
+			else if(argv[argi][1] == 'p')
+			{
+				char * arg = argv[argi][2] ? &argv[argi][2] : argv[++argi];
+				if(arg == NULL)
+				{
+					fprintf(stderr, "Error: Missing argument for `-p`\n");
+					exit(1);
+				}
+				_profile_parse_options(arg);
+			}
 			else if(argv[argi][1] == 'd')
 			{
 				option_debug = emu->option_disassemble = true;
@@ -4248,7 +6065,11 @@ int main(int argc, char * argv[], char * envp[])
 		}
 	}
 
-	if(inputfile == NULL)
+	if(_snapshot.restore_file_name != NULL)
+	{
+		cpu_version = _snapshot_open();
+	}
+	else if(inputfile == NULL)
 	{
 		fprintf(stderr, "No input file provided\n");
 		exit(1);
@@ -4295,6 +6116,8 @@ int main(int argc, char * argv[], char * envp[])
 	}
 
 	emu->cpu_traits = x86_cpu_traits[cpu_version];
+	_memory_setup(x86_is_long_mode_supported(emu) ? 52 : 32);
+
 	if((emu->cpu_traits.cpuid1.edx & X86_CPUID1_EDX_FPU) != 0)
 	{
 		emu->x87.fpu_type = X87_FPU_INTEGRATED;
@@ -4327,8 +6150,7 @@ int main(int argc, char * argv[], char * envp[])
 
 	emu->memory_read = _memory_read;
 	emu->memory_write = _memory_write;
-	emu->port_read = _port_read;
-	emu->port_write = _port_write;
+	emu->memory_get_pointer = _memory_get_direct_pointer;
 
 	emu->parser->use_nec_syntax = x86_is_nec(emu);
 	emu->x80.parser->use_intel8080_syntax = emu->x80.cpu_type == X80_CPU_I80;
@@ -4345,6 +6167,8 @@ int main(int argc, char * argv[], char * envp[])
 		emu->x80.memory_write = _x80_memory_write;
 		emu->x80.port_read = _x80_port_read;
 		emu->x80.port_write = _x80_port_write;
+		emu->x80.port_read_block = _x80_port_read_block;
+		emu->x80.port_write_block = _x80_port_write_block;
 
 		x80_reset(&emu->x80, true);
 
@@ -4352,6 +6176,13 @@ int main(int argc, char * argv[], char * envp[])
 		registers.cs = registers.ds = registers.ss = 0;
 	}
 
+	if(_snapshot.restore_file_name != NULL)
+	{
+		machine_setup(emu, pc_type);
+		_snapshot_restore(emu);
+		goto start_execution;
+	}
+
 	FILE * input;
 
 	input = fopen(inputfile, "rb");
@@ -4967,11 +6798,26 @@ int main(int argc, char * argv[], char * envp[])
 
 	fclose(input);
 
+start_execution:
 	if(!option_debug)
 	{
 		kbd_init();
 	}
 
+#if X86_OPCODE_COUNTERS
+	atexit(_opcode_counters_dump);
+#endif
+
+	if(_profile.enabled)
+	{
+		_profile_start();
+	}
+
+	if(_trace.enabled)
+	{
+		_trace_start(emu, cpu_version);
+	}
+
 	_display_screen(emu);
 
 	/**** The main loop ****/
@@ -5078,7 +6924,21 @@ int main(int argc, char * argv[], char * envp[])
 		emu->parser->debug_output[0] = '\0';
 		if(wait_for_interrupt == WAIT_NOTHING)
 		{
+			if(_profile.enabled)
+				_profile_before_step(emu);
+			if(_snapshot.save_pending)
+				_snapshot_before_step(emu, cpu_version);
+			if(_fuzz.enabled)
+				_fuzz_before_step(emu);
+			if(_trace.enabled)
+				_trace_before_step(emu);
 			x86_result_t result = x86_step(emu);
+			if(_trace.enabled)
+				_trace_after_step(emu);
+			if(_profile.enabled)
+				_profile_after_step(emu);
+			if(_fuzz.enabled)
+				_fuzz_after_step(emu, result);
 			bool is_cpu_interrupt = false;
 			switch(X86_RESULT_TYPE(result))
 			{
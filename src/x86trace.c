@@ -0,0 +1,262 @@
+// Renders a binary instruction trace written by x86emu -t
+
+#include "cpu/cpu.h"
+#include "trace.h"
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cpu/x86.list.c"
+
+static const char * register_names[][16] =
+{
+	[SIZE_8BIT] =
+	{
+		"ax", "cx", "dx", "bx", "sp", "bp", "si", "di",
+		"r8w", "r9w", "r10w", "r11w", "r12w", "r13w", "r14w", "r15w",
+	},
+	[SIZE_16BIT] =
+	{
+		"ax", "cx", "dx", "bx", "sp", "bp", "si", "di",
+		"r8w", "r9w", "r10w", "r11w", "r12w", "r13w", "r14w", "r15w",
+	},
+	[SIZE_32BIT] =
+	{
+		"eax", "ecx", "edx", "ebx", "esp", "ebp", "esi", "edi",
+		"r8d", "r9d", "r10d", "r11d", "r12d", "r13d", "r14d", "r15d",
+	},
+	[SIZE_64BIT] =
+	{
+		"rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi",
+		"r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15",
+	},
+};
+
+// The parsers read the instruction bytes stored in the current record
+static const trace_record_t * current_record;
+static uoff_t record_start;
+static size_t record_length; // number of bytes consumed by the parser
+
+static inline uint8_t fetch_record_byte(uoff_t position)
+{
+	size_t index = position - record_start;
+	if(index >= current_record->length || index >= sizeof current_record->data)
+		return 0;
+	if(index + 1 > record_length)
+		record_length = index + 1;
+	return current_record->data[index];
+}
+
+static uint8_t trace_fetch8(x86_parser_t * prs)
+{
+	return fetch_record_byte(prs->current_position++);
+}
+
+static uint16_t trace_fetch16(x86_parser_t * prs)
+{
+	uint16_t value = trace_fetch8(prs);
+	return value | (trace_fetch8(prs) << 8);
+}
+
+static uint32_t trace_fetch32(x86_parser_t * prs)
+{
+	uint32_t value = trace_fetch16(prs);
+	return value | ((uint32_t)trace_fetch16(prs) << 16);
+}
+
+static uint64_t trace_fetch64(x86_parser_t * prs)
+{
+	uint64_t value = trace_fetch32(prs);
+	return value | ((uint64_t)trace_fetch32(prs) << 32);
+}
+
+static uint8_t trace_x80_fetch8(x80_parser_t * prs)
+{
+	return fetch_record_byte(prs->current_position++);
+}
+
+static uint16_t trace_x80_fetch16(x80_parser_t * prs)
+{
+	uint16_t value = trace_x80_fetch8(prs);
+	return value | (trace_x80_fetch8(prs) << 8);
+}
+
+static void usage(char * argv0)
+{
+	printf(
+		"x86trace - Displays an instruction trace recorded by x86emu\n"
+		"\tUsage: %s [options] <trace file name>\n"
+		"\t-n <count>\tonly display the last count records\n"
+		"\t-h\tdisplay this help page\n",
+		argv0);
+}
+
+int main(int argc, char * argv[])
+{
+	const char * inputfile = NULL;
+	uint64_t display_count = (uint64_t)-1;
+
+	int argi;
+	for(argi = 1; argi < argc; argi++)
+	{
+		if(argv[argi][0] == '-')
+		{
+			if(argv[argi][1] == 'h')
+			{
+				usage(argv[0]);
+				exit(0);
+			}
+			else if(argv[argi][1] == 'n')
+			{
+				char * arg = argv[argi][2] ? &argv[argi][2] : argv[++argi];
+				if(arg == NULL)
+				{
+					fprintf(stderr, "Missing argument for -n\n");
+					exit(1);
+				}
+				display_count = strtoull(arg, NULL, 0);
+			}
+			else
+			{
+				fprintf(stderr, "Error: Unknown flag `%s`\n", argv[argi]);
+				exit(1);
+			}
+		}
+		else
+		{
+			inputfile = argv[argi];
+			break;
+		}
+	}
+
+	if(inputfile == NULL)
+	{
+		fprintf(stderr, "No input file provided\n");
+		exit(1);
+	}
+
+	int fd = open(inputfile, O_RDONLY);
+	struct stat st;
+	if(fd == -1 || fstat(fd, &st) != 0)
+	{
+		fprintf(stderr, "Invalid input file %s\n", inputfile);
+		exit(1);
+	}
+
+	if((size_t)st.st_size < sizeof(trace_header_t))
+	{
+		fprintf(stderr, "Not a trace file\n");
+		exit(1);
+	}
+
+	const void * mapping = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(mapping == MAP_FAILED)
+	{
+		fprintf(stderr, "Unable to map input file %s\n", inputfile);
+		exit(1);
+	}
+
+	const trace_header_t * header = mapping;
+	const trace_record_t * records = (const trace_record_t *)(header + 1);
+
+	if(memcmp(header->magic, TRACE_MAGIC, sizeof header->magic) != 0
+	|| header->version != TRACE_VERSION
+	|| header->record_size != sizeof(trace_record_t)
+	|| header->capacity == 0
+	|| (size_t)st.st_size < sizeof(trace_header_t) + header->capacity * sizeof(trace_record_t)
+	|| header->cpu_version < 0 || (size_t)header->cpu_version >= sizeof x86_cpu_traits / sizeof x86_cpu_traits[0])
+	{
+		fprintf(stderr, "Not a trace file\n");
+		exit(1);
+	}
+
+	x86_parser_t prs[1];
+	memset(prs, 0, sizeof prs);
+	prs->cpu_traits = x86_cpu_traits[header->cpu_version];
+	prs->use_nec_syntax = header->use_nec_syntax;
+	prs->fpu_type = header->fpu_type;
+	prs->fpu_subtype = header->fpu_subtype;
+	prs->fetch8 = trace_fetch8;
+	prs->fetch16 = trace_fetch16;
+	prs->fetch32 = trace_fetch32;
+	prs->fetch64 = trace_fetch64;
+
+	x80_parser_t prs80[1];
+	memset(prs80, 0, sizeof prs80);
+	prs80->cpu_type = header->x80_cpu_type;
+	prs80->cpu_method = X80_CPUMETHOD_EMULATED;
+	prs80->use_intel8080_syntax = header->use_intel8080_syntax;
+	prs80->fetch8 = trace_x80_fetch8;
+	prs80->fetch16 = trace_x80_fetch16;
+
+	uint64_t first = header->count > header->capacity ? header->count - header->capacity : 0;
+	if(header->count - first > display_count)
+		first = header->count - display_count;
+
+	int code_size = SIZE_16BIT;
+	for(uint64_t index = first; index < header->count; index++)
+	{
+		const trace_record_t * record = &records[index % header->capacity];
+		switch(record->type)
+		{
+		case TRACE_INSTRUCTION:
+			if(record->code_size >= sizeof register_names / sizeof register_names[0] || register_names[record->code_size][0] == NULL)
+			{
+				printf("\t\tinvalid code size %d\n", record->code_size);
+				break;
+			}
+			current_record = record;
+			record_start = record->offset;
+			record_length = 0;
+			code_size = record->code_size;
+			if(code_size == SIZE_8BIT)
+			{
+				prs80->current_position = record->offset;
+				prs80->debug_output[0] = '\0';
+				prs80->index_prefix = NONE;
+				x80_disassemble(prs80);
+			}
+			else
+			{
+				prs->current_position = record->offset;
+				prs->code_size = code_size;
+				prs->debug_output[0] = '\0';
+				x86_disassemble(prs, NULL);
+			}
+			printf("%08"PRIX64"\t", record->address);
+			for(size_t i = 0; i < record_length; i++)
+				printf("%02X", record->data[i]);
+			printf("\t%s", code_size == SIZE_8BIT ? prs80->debug_output : prs->debug_output);
+			break;
+		case TRACE_REGISTER:
+			if(record->length == TRACE_REGISTER_FLAGS)
+			{
+				printf("\t\tflags = %08"PRIX64"\n", record->value);
+			}
+			else if(record->length < 16)
+			{
+				int digits = code_size <= SIZE_16BIT ? 4 : code_size == SIZE_32BIT ? 8 : 16;
+				uint64_t mask = digits == 16 ? (uint64_t)-1 : ((uint64_t)1 << (4 * digits)) - 1;
+				printf("\t\t%s = %0*"PRIX64"\n", register_names[code_size][record->length], digits, record->value & mask);
+			}
+			break;
+		case TRACE_MEMORY_WRITE:
+			printf("\t\t[%08"PRIX64"] <-", record->address);
+			for(size_t i = 0; i < record->length && i < sizeof record->data; i++)
+				printf(" %02X", record->data[i]);
+			printf("\n");
+			break;
+		default:
+			printf("\t\tinvalid record type %d\n", record->type);
+			break;
+		}
+	}
+
+	return 0;
+}
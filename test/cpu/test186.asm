@@ -0,0 +1,123 @@
+
+; Launch using:
+; - x86emu -c 80186 test/cpu/test186.com
+; Tests the on-chip peripherals of the 80186, the peripheral control block is at its reset location
+
+	cpu	186
+	org	0x100
+
+PCB_SEGMENT	equ	0x0FF0
+
+EOI	equ	0x22
+TCUCON	equ	0x32
+T1CNT	equ	0x58
+T1CMPA	equ	0x5A
+T1CON	equ	0x5E
+D0SRCL	equ	0xC0
+D0SRCH	equ	0xC2
+D0DSTL	equ	0xC4
+D0DSTH	equ	0xC6
+D0TC	equ	0xC8
+D0CON	equ	0xCA
+
+TIMER1_VECTOR	equ	0x12
+
+DMA_SOURCE	equ	0x2000
+DMA_DESTINATION	equ	0x3001
+DMA_LENGTH	equ	0x3000
+
+	;;;; Timer 1 interrupts, the CPU halts until each of them arrives
+
+	xor	ax, ax
+	mov	es, ax
+	mov	word [es:TIMER1_VECTOR * 4], timer1_handler
+	mov	[es:TIMER1_VECTOR * 4 + 2], cs
+
+	mov	ax, PCB_SEGMENT
+	mov	es, ax
+	mov	word [es:T1CMPA], 200
+	mov	word [es:T1CNT], 0
+	mov	word [es:T1CON], 0xE001	; enable, interrupt, continuous
+	mov	word [es:TCUCON], 0	; unmasked, priority 0
+
+	sti
+.wait:
+	hlt
+	cmp	word [timer1_count], 5
+	jb	.wait
+	cli
+
+	mov	word [es:T1CON], 0x4000	; disable
+
+	mov	dx, message_timer
+	mov	ah, 0x09
+	int	0x21
+
+	;;;; Memory to memory DMA on channel 0, the destination is not aligned
+
+	mov	ax, DMA_SOURCE
+	mov	es, ax
+	xor	di, di
+	mov	cx, DMA_LENGTH
+.fill:
+	mov	ax, di
+	xor	al, ah
+	stosb
+	loop	.fill
+
+	mov	ax, PCB_SEGMENT
+	mov	es, ax
+	mov	word [es:D0SRCL], (DMA_SOURCE << 4) & 0xFFFF
+	mov	word [es:D0SRCH], DMA_SOURCE >> 12
+	mov	word [es:D0DSTL], (DMA_DESTINATION << 4) & 0xFFFF
+	mov	word [es:D0DSTH], DMA_DESTINATION >> 12
+	mov	word [es:D0TC], DMA_LENGTH
+	mov	word [es:D0CON], 0xB606	; memory to memory, incrementing, terminal count, unsynchronized, start
+.transfer:
+	test	word [es:D0CON], 0x0002
+	jnz	.transfer
+	mov	bx, [es:D0TC]
+
+	mov	ax, DMA_SOURCE
+	mov	ds, ax
+	mov	ax, DMA_DESTINATION
+	mov	es, ax
+	xor	si, si
+	xor	di, di
+	mov	cx, DMA_LENGTH
+	cld
+	repe cmpsb
+	push	cs
+	pop	ds
+
+	mov	dx, message_dma_failed
+	jne	.print
+	test	bx, bx
+	jnz	.print
+	mov	dx, message_dma
+.print:
+	mov	ah, 0x09
+	int	0x21
+
+	mov	ax, 0x4C00
+	int	0x21
+
+timer1_handler:
+	inc	word [cs:timer1_count]
+	push	es
+	push	PCB_SEGMENT
+	pop	es
+	mov	word [es:EOI], 0x8000	; non-specific
+	pop	es
+	iret
+
+timer1_count:
+	dw	0
+
+message_timer:
+	db	"Timer interrupts: OK", 13, 10, '$'
+message_dma:
+	db	"DMA transfer: OK", 13, 10, '$'
+message_dma_failed:
+	db	"DMA transfer: FAIL", 13, 10, '$'
+
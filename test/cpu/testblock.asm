@@ -0,0 +1,131 @@
+
+; Launch using:
+; - x86emu -c 386 -I 300 test/cpu/testblock.com
+; Moves data through the loopback device with REP OUTSB, REP INSW, REP INSD and REP INSB, which the device serves as blocks
+; Prints OK, or FAIL followed by the number of the first failing check
+
+	cpu	386
+	org	0x100
+
+; records the number of the first failing check
+%macro	check	1
+	je	%%ok
+	cmp	byte [failed], 0
+	jne	%%ok
+	mov	byte [failed], %1
+%%ok:
+%endmacro
+
+PORT	equ	0x300
+STATUS	equ	PORT + 4
+
+LENGTH	equ	600
+WORDS	equ	200
+DWORDS	equ	25
+BYTES	equ	LENGTH - 2 * WORDS - 4 * DWORDS
+
+; both buffers cross a 4 KiB boundary when the program is loaded at a segment that is a multiple of 0x100
+SOURCE	equ	0x0F00
+DESTINATION	equ	0x1F00
+
+	push	ds
+	pop	es
+	cld
+
+	mov	dx, STATUS
+	out	dx, al
+
+	mov	di, SOURCE
+	mov	cx, LENGTH
+	mov	al, 3
+.fill:
+	stosb
+	add	al, 7
+	loop	.fill
+
+	mov	di, DESTINATION
+	mov	cx, LENGTH
+	xor	al, al
+	rep stosb
+
+	;;;; REP OUTSB writes the whole buffer
+	mov	dx, PORT
+	mov	si, SOURCE
+	mov	cx, LENGTH
+	rep outsb
+	cmp	si, SOURCE + LENGTH
+	check	1
+	cmp	cx, 0
+	check	2
+
+	;;;; It is read back as words, doublewords and bytes
+	mov	di, DESTINATION
+	mov	cx, WORDS
+	rep insw
+	cmp	di, DESTINATION + 2 * WORDS
+	check	3
+	cmp	cx, 0
+	check	4
+
+	mov	cx, DWORDS
+	rep insd
+	cmp	di, DESTINATION + 2 * WORDS + 4 * DWORDS
+	check	5
+	cmp	cx, 0
+	check	6
+
+	mov	cx, BYTES
+	rep insb
+	cmp	di, DESTINATION + LENGTH
+	check	7
+	cmp	cx, 0
+	check	8
+
+	mov	si, SOURCE
+	mov	di, DESTINATION
+	mov	cx, LENGTH
+	repe cmpsb
+	check	9
+
+	;;;; The FIFO is empty now
+	in	al, dx
+	cmp	al, 0xFF
+	check	10
+
+	;;;; Each of the four instructions used at least one block
+	mov	dx, STATUS
+	in	al, dx
+	cmp	al, 4
+	jb	.few
+	cmp	al, al
+.few:
+	check	11
+
+	mov	dx, message_ok
+	mov	al, [failed]
+	test	al, al
+	jz	print
+	aam
+	add	ax, '00'
+	xchg	al, ah
+	mov	[message_number], ax
+	mov	dx, message_fail
+
+print:
+	mov	ah, 0x09
+	int	0x21
+
+	mov	ax, 0x4C00
+	int	0x21
+
+message_ok:
+	db	"OK", 13, 10, '$'
+
+message_fail:
+	db	"FAIL"
+message_number:
+	db	"00", 13, 10, '$'
+
+failed:
+	db	0
+
@@ -0,0 +1,202 @@
+
+; Launch using:
+; - x86emu -c 286 test/cpu/testloadall.com
+; Loads the registers and the segment descriptor caches with LOADALL
+; Prints OK, or FAIL followed by the number of the first failing check
+
+	cpu	286
+	org	0x100
+
+%macro	loadall286	0
+	db	0x0F, 0x05
+%endmacro
+
+%macro	check	1
+	jne	fail%1
+%endmacro
+
+LOADALL_TABLE	equ	0x800
+LOADALL_LENGTH	equ	0x66
+
+; offsets within the table
+LA_MSW	equ	0x06
+LA_TR	equ	0x16
+LA_FLAGS	equ	0x18
+LA_IP	equ	0x1A
+LA_LDTR	equ	0x1C
+LA_DS	equ	0x1E
+LA_SS	equ	0x20
+LA_CS	equ	0x22
+LA_ES	equ	0x24
+LA_DI	equ	0x26
+LA_SI	equ	0x28
+LA_BP	equ	0x2A
+LA_SP	equ	0x2C
+LA_BX	equ	0x2E
+LA_DX	equ	0x30
+LA_CX	equ	0x32
+LA_AX	equ	0x34
+LA_ES_CACHE	equ	0x36
+LA_CS_CACHE	equ	0x3C
+LA_SS_CACHE	equ	0x42
+LA_DS_CACHE	equ	0x48
+LA_GDTR_CACHE	equ	0x4E
+LA_LDTR_CACHE	equ	0x54
+LA_IDTR_CACHE	equ	0x5A
+LA_TR_CACHE	equ	0x60
+
+; the data segment cache points here, while the selector keeps the value of CS
+HIDDEN_BASE	equ	0x20000
+HIDDEN_MARKER	equ	0x5A3C
+
+; stores a descriptor cache entry: base, access byte, limit
+%macro	cache	4
+	mov	word [es:LOADALL_TABLE + %1], (%2) & 0xFFFF
+	mov	byte [es:LOADALL_TABLE + %1 + 2], (%2) >> 16
+	mov	byte [es:LOADALL_TABLE + %1 + 3], %3
+	mov	word [es:LOADALL_TABLE + %1 + 4], %4
+%endmacro
+
+	mov	ax, HIDDEN_BASE >> 4
+	mov	es, ax
+	mov	word [es:0], HIDDEN_MARKER
+
+	;;;; Build the table, keeping the previous contents of its area
+	xor	ax, ax
+	mov	es, ax
+	mov	si, LOADALL_TABLE
+	mov	di, saved_table
+	mov	cx, LOADALL_LENGTH / 2
+.save:
+	mov	ax, [es:si]
+	mov	[di], ax
+	add	si, 2
+	add	di, 2
+	loop	.save
+
+	mov	di, LOADALL_TABLE
+	mov	cx, LOADALL_LENGTH / 2
+	xor	ax, ax
+	rep stosw
+
+	mov	word [es:LOADALL_TABLE + LA_FLAGS], 0x0003	; carry set
+	mov	word [es:LOADALL_TABLE + LA_IP], loaded
+	mov	[es:LOADALL_TABLE + LA_DS], cs
+	mov	[es:LOADALL_TABLE + LA_SS], ss
+	mov	[es:LOADALL_TABLE + LA_CS], cs
+	mov	[es:LOADALL_TABLE + LA_ES], cs
+	mov	word [es:LOADALL_TABLE + LA_DI], 0x1111
+	mov	word [es:LOADALL_TABLE + LA_SI], 0x2222
+	mov	word [es:LOADALL_TABLE + LA_BP], 0x3333
+	mov	[es:LOADALL_TABLE + LA_SP], sp
+	mov	word [es:LOADALL_TABLE + LA_BX], 0x4444
+	mov	word [es:LOADALL_TABLE + LA_DX], 0x5555
+	mov	word [es:LOADALL_TABLE + LA_CX], 0x6666
+	mov	word [es:LOADALL_TABLE + LA_AX], 0x7777
+
+	mov	ax, cs
+	mov	dx, ax
+	shl	ax, 4
+	shr	dx, 12
+	mov	[es:LOADALL_TABLE + LA_CS_CACHE], ax
+	mov	[es:LOADALL_TABLE + LA_CS_CACHE + 2], dl
+	mov	byte [es:LOADALL_TABLE + LA_CS_CACHE + 3], 0x93
+	mov	word [es:LOADALL_TABLE + LA_CS_CACHE + 4], 0xFFFF
+	mov	[es:LOADALL_TABLE + LA_ES_CACHE], ax
+	mov	[es:LOADALL_TABLE + LA_ES_CACHE + 2], dl
+	mov	byte [es:LOADALL_TABLE + LA_ES_CACHE + 3], 0x93
+	mov	word [es:LOADALL_TABLE + LA_ES_CACHE + 4], 0xFFFF
+
+	mov	ax, ss
+	mov	dx, ax
+	shl	ax, 4
+	shr	dx, 12
+	mov	[es:LOADALL_TABLE + LA_SS_CACHE], ax
+	mov	[es:LOADALL_TABLE + LA_SS_CACHE + 2], dl
+	mov	byte [es:LOADALL_TABLE + LA_SS_CACHE + 3], 0x93
+	mov	word [es:LOADALL_TABLE + LA_SS_CACHE + 4], 0xFFFF
+
+	cache	LA_DS_CACHE, HIDDEN_BASE, 0x93, 0xFFFF
+	cache	LA_GDTR_CACHE, 0, 0x82, 0xFFFF
+	cache	LA_LDTR_CACHE, 0, 0x82, 0xFFFF
+	cache	LA_IDTR_CACHE, 0, 0x82, 0x03FF
+	cache	LA_TR_CACHE, 0, 0x82, 0xFFFF
+
+	cli
+	loadall286
+
+loaded:
+	;;;; The registers come from the table
+	jnc	fail1
+	cmp	ax, 0x7777
+	check	2
+	cmp	cx, 0x6666
+	check	3
+	cmp	dx, 0x5555
+	check	4
+	cmp	bx, 0x4444
+	check	5
+	cmp	bp, 0x3333
+	check	6
+	cmp	si, 0x2222
+	check	7
+	cmp	di, 0x1111
+	check	8
+
+	;;;; The data segment uses the base from its cache, not from its selector
+	mov	ax, ds
+	mov	bx, cs
+	cmp	ax, bx
+	check	9
+	cmp	word [0], HIDDEN_MARKER
+	check	10
+
+	;;;; Reloading the selector also reloads the cache
+	push	cs
+	pop	ds
+	cmp	word [message_ok], 'OK'
+	check	11
+
+	sti
+	xor	ax, ax
+	mov	es, ax
+	mov	si, saved_table
+	mov	di, LOADALL_TABLE
+	mov	cx, LOADALL_LENGTH / 2
+	rep movsw
+
+	mov	dx, message_ok
+	jmp	print
+
+%assign	i 1
+%rep	11
+fail %+ i:
+	mov	ax, (('0' + i % 10) << 8) | ('0' + i / 10)
+	jmp	fail
+%assign	i i + 1
+%endrep
+
+fail:
+	push	cs
+	pop	ds
+	mov	[message_number], ax
+	mov	dx, message_fail
+
+print:
+	mov	ah, 0x09
+	int	0x21
+
+	mov	ax, 0x4C00
+	int	0x21
+
+message_ok:
+	db	"OK", 13, 10, '$'
+
+message_fail:
+	db	"FAIL"
+message_number:
+	db	"00", 13, 10, '$'
+
+saved_table:
+	times LOADALL_LENGTH db 0
+
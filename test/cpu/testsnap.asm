@@ -0,0 +1,117 @@
+
+; Launch using:
+; - x86emu -P none -c 386 -f 387 -s testsnap.snp,at=1102,exit test/cpu/testsnap.com
+; - x86emu -r testsnap.snp
+; The snapshot is taken at ready, linear address 0x1102 when DOS loads the program at segment 0x0100
+; Prints OK, or FAIL followed by the number of the first failing check, also when run without a snapshot
+
+	cpu	386
+	org	0x100
+
+PATTERN_SEGMENT	equ	0x2000
+PATTERN_LENGTH	equ	0x8000
+ZERO_OFFSET	equ	0x4000	; a page inside the pattern that stays zero
+ZERO_LENGTH	equ	0x1000
+
+%macro	check	1
+	jne	fail%1
+%endmacro
+
+	jmp	short setup
+
+ready:
+	;;;; Registers and flags
+	jnc	fail1
+	pushf
+	pop	ax
+	test	ax, 0x0400	; direction flag
+	jz	fail2
+	cld
+	cmp	bp, 0x1234
+	check	3
+	cmp	esi, 0x89ABCDEF
+	check	4
+	mov	ax, es
+	cmp	ax, PATTERN_SEGMENT
+	check	5
+
+	;;;; The x87 registers
+	fstp	qword [value]
+	cmp	dword [value + 4], 0x400921FB
+	check	6
+
+	;;;; Guest memory, including the pages that were zero
+	xor	di, di
+	mov	cx, PATTERN_LENGTH
+.memory:
+	mov	ax, di
+	xor	al, ah
+	or	al, 1
+	cmp	di, ZERO_OFFSET
+	jb	.compare
+	cmp	di, ZERO_OFFSET + ZERO_LENGTH
+	jae	.compare
+	xor	al, al
+.compare:
+	scasb
+	check	7
+	loop	.memory
+
+	mov	dx, message_ok
+	jmp	print
+
+setup:
+	mov	ax, PATTERN_SEGMENT
+	mov	es, ax
+	xor	di, di
+	mov	cx, PATTERN_LENGTH
+.fill:
+	mov	ax, di
+	xor	al, ah
+	or	al, 1
+	stosb
+	loop	.fill
+
+	mov	di, ZERO_OFFSET
+	mov	cx, ZERO_LENGTH
+	xor	al, al
+	rep stosb
+
+	fninit
+	fldpi
+
+	mov	bp, 0x1234
+	mov	esi, 0x89ABCDEF
+	std
+	stc
+	jmp	ready
+
+%assign	i 1
+%rep	7
+fail %+ i:
+	mov	byte [message_number], '0' + i
+	jmp	fail
+%assign	i i + 1
+%endrep
+
+fail:
+	mov	dx, message_fail
+
+print:
+	mov	ah, 0x09
+	int	0x21
+
+	mov	ax, 0x4C00
+	int	0x21
+
+value:
+	dq	0
+
+message_ok:
+	db	"OK", 13, 10, '$'
+
+message_fail:
+	db	"FAIL"
+message_number:
+	db	"0", 13, 10, '$'
+
@@ -0,0 +1,275 @@
+
+; Launch using:
+; - x86emu -c 386 test/cpu/teststack.com
+; Checks the stack frames of PUSHA, POPA, ENTER with a nesting level and a call gate that copies parameters
+; Prints OK, or FAIL followed by the number of the first failing check
+
+	cpu	386
+	org	0x100
+
+; records the number of the first failing check
+%macro	check	1
+	je	%%ok
+	cmp	byte [failed], 0
+	jne	%%ok
+	mov	byte [failed], %1
+%%ok:
+%endmacro
+
+SEL_CODE0	equ	0x08
+SEL_DATA0	equ	0x10
+SEL_TSS	equ	0x18
+SEL_CODE3	equ	0x20 | 3
+SEL_DATA3	equ	0x28 | 3
+SEL_GATE	equ	0x30 | 3
+
+	;;;; PUSHA stores the registers below the stack pointer, SP as it was before the instruction
+	mov	ax, 0x1111
+	mov	cx, 0x2222
+	mov	dx, 0x3333
+	mov	bx, 0x4444
+	mov	bp, 0x5555
+	mov	si, 0x6666
+	mov	di, 0x7777
+	pusha
+	mov	bx, sp
+	cmp	word [bx + 0], 0x7777
+	check	1
+	cmp	word [bx + 2], 0x6666
+	check	2
+	cmp	word [bx + 4], 0x5555
+	check	3
+	lea	ax, [bx + 16]
+	cmp	[bx + 6], ax
+	check	4
+	cmp	word [bx + 8], 0x4444
+	check	5
+	cmp	word [bx + 10], 0x3333
+	check	6
+	cmp	word [bx + 12], 0x2222
+	check	7
+	cmp	word [bx + 14], 0x1111
+	check	8
+
+	;;;; POPA loads them back, except for SP
+	mov	word [bx + 6], 0
+	xor	ax, ax
+	xor	cx, cx
+	xor	dx, dx
+	xor	bx, bx
+	xor	bp, bp
+	xor	si, si
+	xor	di, di
+	popa
+	cmp	ax, 0x1111
+	check	9
+	cmp	cx, 0x2222
+	check	10
+	cmp	dx, 0x3333
+	check	11
+	cmp	bx, 0x4444
+	check	12
+	cmp	bp, 0x5555
+	check	13
+	cmp	si, 0x6666
+	check	14
+	cmp	di, 0x7777
+	check	15
+
+	;;;; ENTER with a nesting level of 3 copies two frame pointers of the outer frame
+	mov	[saved_sp], sp
+	mov	bp, outer_frame + 4
+	enter	8, 3
+	mov	ax, sp
+	mov	bx, [saved_sp]
+	sub	bx, 2
+	cmp	bp, bx
+	check	16
+	cmp	word [bp], outer_frame + 4
+	check	17
+	cmp	word [bp - 2], 0xAAAA
+	check	18
+	cmp	word [bp - 4], 0xBBBB
+	check	19
+	cmp	[bp - 6], bp
+	check	20
+	sub	bx, 6 + 8
+	cmp	ax, bx
+	check	21
+	leave
+	cmp	bp, outer_frame + 4
+	check	22
+	cmp	sp, [saved_sp]
+	check	23
+
+	;;;; A call gate from ring 3 to ring 0 copies its parameters to the inner stack
+	xor	eax, eax
+	mov	ax, cs
+	shl	eax, 4
+	mov	[gdt + SEL_CODE0 + 2], ax
+	mov	[gdt + SEL_DATA0 + 2], ax
+	mov	[gdt + (SEL_CODE3 & ~3) + 2], ax
+	mov	[gdt + (SEL_DATA3 & ~3) + 2], ax
+	mov	ebx, eax
+	shr	ebx, 16
+	mov	[gdt + SEL_CODE0 + 4], bl
+	mov	[gdt + SEL_DATA0 + 4], bl
+	mov	[gdt + (SEL_CODE3 & ~3) + 4], bl
+	mov	[gdt + (SEL_DATA3 & ~3) + 4], bl
+	lea	ebx, [eax + tss]
+	mov	[gdt + SEL_TSS + 2], bx
+	shr	ebx, 16
+	mov	[gdt + SEL_TSS + 4], bl
+	lea	ebx, [eax + gdt]
+	mov	[gdtr + 2], ebx
+	shr	eax, 4
+	mov	[real_mode_segment], ax
+
+	mov	[saved_ss], ss
+	mov	[saved_sp], sp
+	cli
+	lgdt	[gdtr]
+	mov	eax, cr0
+	or	al, 1
+	mov	cr0, eax
+	jmp	SEL_CODE0:protected_mode
+
+protected_mode:
+	mov	ax, SEL_DATA0
+	mov	ds, ax
+	mov	es, ax
+	mov	ss, ax
+	mov	esp, stack0
+	mov	ax, SEL_TSS
+	ltr	ax
+
+	push	SEL_DATA3
+	push	stack3
+	push	SEL_CODE3
+	push	ring3
+	retf
+
+ring3:
+	mov	ax, SEL_DATA3
+	mov	ds, ax
+	mov	es, ax
+	push	0x1111
+	push	0x2222
+	push	0x3333
+	call	SEL_GATE:0
+.return:
+	; the gate does not return
+
+gate:
+	mov	bx, sp
+	cmp	bx, stack0 - 14
+	check	24
+	cmp	word [ss:bx + 0], ring3.return
+	check	25
+	cmp	word [ss:bx + 2], SEL_CODE3
+	check	26
+	cmp	word [ss:bx + 4], 0x3333
+	check	27
+	cmp	word [ss:bx + 6], 0x2222
+	check	28
+	cmp	word [ss:bx + 8], 0x1111
+	check	29
+	cmp	word [ss:bx + 10], stack3 - 6
+	check	30
+	cmp	word [ss:bx + 12], SEL_DATA3
+	check	31
+
+	;;;; Back to real mode
+	mov	ax, SEL_DATA0
+	mov	ds, ax
+	mov	es, ax
+	mov	ss, ax
+	mov	eax, cr0
+	and	al, ~1
+	mov	cr0, eax
+	jmp	far [real_mode_jump]
+
+real_mode:
+	mov	ax, cs
+	mov	ds, ax
+	mov	es, ax
+	mov	ss, [saved_ss]
+	mov	sp, [saved_sp]
+	sti
+
+	mov	dx, message_ok
+	mov	al, [failed]
+	test	al, al
+	jz	print
+	aam
+	add	ax, '00'
+	xchg	al, ah
+	mov	[message_number], ax
+	mov	dx, message_fail
+
+print:
+	mov	ah, 0x09
+	int	0x21
+
+	mov	ax, 0x4C00
+	int	0x21
+
+message_ok:
+	db	"OK", 13, 10, '$'
+
+message_fail:
+	db	"FAIL"
+message_number:
+	db	"00", 13, 10, '$'
+
+failed:
+	db	0
+
+	align	2
+saved_ss:
+	dw	0
+saved_sp:
+	dw	0
+
+outer_frame:
+	dw	0xBBBB, 0xAAAA
+
+real_mode_jump:
+	dw	real_mode
+real_mode_segment:
+	dw	0
+
+	align	8
+gdt:
+	dq	0
+	dw	0xFFFF, 0
+	db	0, 0x9A, 0x00, 0	; SEL_CODE0
+	dw	0xFFFF, 0
+	db	0, 0x92, 0x00, 0	; SEL_DATA0
+	dw	0x0067, 0
+	db	0, 0x89, 0x00, 0	; SEL_TSS
+	dw	0xFFFF, 0
+	db	0, 0xFA, 0x00, 0	; SEL_CODE3
+	dw	0xFFFF, 0
+	db	0, 0xF2, 0x00, 0	; SEL_DATA3
+	dw	gate, SEL_CODE0
+	db	3, 0xE4, 0, 0	; SEL_GATE, 16-bit call gate with 3 parameters
+gdt_end:
+
+gdtr:
+	dw	gdt_end - gdt - 1
+	dd	0
+
+	align	4
+tss:
+	dd	0
+	dd	stack0	; ESP0
+	dd	SEL_DATA0	; SS0
+	times	0x66 - ($ - tss) db 0
+	dw	0x68	; no I/O permission bitmap
+
+	times	256 db 0
+stack0:
+	times	256 db 0
+stack3:
+
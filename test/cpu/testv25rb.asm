@@ -0,0 +1,243 @@
+
+; Launch using:
+; - x86emu -c v25 test/cpu/testv25rb.img
+; Switches between register banks with BRKCS, RETRBI, TSKSW, MOVSPA and MOVSPB, the program starts in bank 7
+; Prints each checked value, followed by the number of failed checks, which should be 0000
+
+%macro	brkcs	1
+%ifidn	%1, ax
+	db	0x0F, 0x2D, 0xC0
+%elifidn	%1, bx
+	db	0x0F, 0x2D, 0xC3
+%else
+%error Unknown register %1
+%endif
+%endmacro
+
+%macro	tsksw	1
+%ifidn	%1, ax
+	db	0x0F, 0x94, 0xF8
+%elifidn	%1, bx
+	db	0x0F, 0x94, 0xFB
+%else
+%error Unknown register %1
+%endif
+%endmacro
+
+%macro	movspb	1
+%ifidn	%1, ax
+	db	0x0F, 0x95, 0xF8
+%elifidn	%1, bx
+	db	0x0F, 0x95, 0xFB
+%else
+%error Unknown register %1
+%endif
+%endmacro
+
+%macro	movspa	0
+	db	0x0F, 0x25
+%endmacro
+
+%macro	retrbi	0
+	db	0x0F, 0x91
+%endmacro
+
+; compares a word with the expected value and prints it, uses AX
+%macro	expect	2
+	mov	ax, %1
+	cmp	ax, %2
+	call	check
+%endmacro
+
+; internal RAM segment, each register bank takes 32 bytes
+BANKS	equ	0xFFE0
+
+BANK_VECTOR_PC	equ	0x02
+BANK_PSW_SAVE	equ	0x04
+BANK_PC_SAVE	equ	0x06
+BANK_DS0	equ	0x08
+BANK_SS	equ	0x0A
+BANK_PS	equ	0x0C
+BANK_DS1	equ	0x0E
+BANK_SP	equ	0x16
+BANK_DW	equ	0x1A
+BANK_AW	equ	0x1E
+
+	org	0x7C00
+
+	jmp	0:start
+start:
+	xor	ax, ax
+	cli
+	mov	ss, ax
+	mov	sp, 0x7C00
+	mov	ds, ax
+
+	mov	ax, 0xB800
+	mov	es, ax
+	xor	di, di
+	mov	dh, 0x1E
+
+	;;;; MOVSPB stores SS:SP into another bank
+
+	mov	bx, sp
+	mov	sp, 0x6000
+	mov	ax, 2
+	movspb	ax
+	mov	sp, bx
+	push	es
+	mov	ax, BANKS
+	mov	es, ax
+	mov	cx, [es:2 * 32 + BANK_SP]
+	mov	si, [es:2 * 32 + BANK_SS]
+	pop	es
+	expect	cx, 0x6000
+	expect	si, 0x0000
+
+	;;;; BRKCS enters bank 1, MOVSPA takes the stack of bank 7, RETRBI returns to bank 7
+
+	push	es
+	mov	ax, BANKS
+	mov	es, ax
+	mov	word [es:1 * 32 + BANK_VECTOR_PC], bank1
+	mov	word [es:1 * 32 + BANK_DS0], ds
+	mov	word [es:1 * 32 + BANK_SS], 0x1234
+	mov	word [es:1 * 32 + BANK_PS], cs
+	mov	word [es:1 * 32 + BANK_DS1], 0xB800
+	mov	word [es:1 * 32 + BANK_SP], 0x5678
+	mov	word [es:1 * 32 + BANK_DW], 0x1E00
+	mov	word [es:1 * 32 + BANK_AW], 0x1111
+	pop	es
+
+	mov	[main_sp], sp
+	mov	[main_di], di
+	mov	ax, 0xAAAA
+	mov	bx, 1
+	brkcs	bx
+
+	; the other banks continue printing where bank 7 left off
+	mov	di, [main_di]
+	expect	ax, 0xAAAA
+	expect	bx, 1
+
+	push	es
+	mov	ax, BANKS
+	mov	es, ax
+	mov	cx, [es:1 * 32 + BANK_AW]
+	pop	es
+	expect	cx, 0x2222
+
+	;;;; TSKSW switches to bank 3 and back, saving the flags and the return address of the bank it leaves
+
+	push	es
+	mov	ax, BANKS
+	mov	es, ax
+	mov	word [es:3 * 32 + BANK_PSW_SAVE], 0x0002
+	mov	word [es:3 * 32 + BANK_PC_SAVE], bank3
+	mov	word [es:3 * 32 + BANK_DS0], ds
+	mov	word [es:3 * 32 + BANK_SS], ss
+	mov	word [es:3 * 32 + BANK_PS], cs
+	mov	word [es:3 * 32 + BANK_DS1], 0xB800
+	mov	word [es:3 * 32 + BANK_SP], 0x5000
+	mov	word [es:3 * 32 + BANK_DW], 0x1E00
+	mov	word [es:3 * 32 + BANK_AW], 0x3333
+	pop	es
+
+	mov	[main_di], di
+	mov	ax, 0xBBBB
+	mov	bx, 3
+	tsksw	bx
+
+	mov	di, [main_di]
+	expect	ax, 0xBBBB
+
+	push	es
+	mov	ax, BANKS
+	mov	es, ax
+	mov	cx, [es:3 * 32 + BANK_AW]
+	mov	si, [es:3 * 32 + BANK_PC_SAVE]
+	pop	es
+	expect	cx, 0x4444
+	expect	si, bank3.return
+
+	mov	ax, [cs:failures]
+	call	put_word
+
+.0:
+	hlt
+	jmp	.0
+
+bank1:
+	mov	di, [main_di]
+	expect	ax, 0x1111
+	expect	ss, 0x1234
+	expect	sp, 0x5678
+	movspa
+	expect	ss, 0x0000
+	expect	sp, [main_sp]
+	mov	[main_di], di
+	mov	ax, 0x2222
+	retrbi
+
+bank3:
+	mov	di, [main_di]
+	expect	ax, 0x3333
+	expect	sp, 0x5000
+	mov	[main_di], di
+	mov	ax, 0x4444
+	mov	bx, 7
+	tsksw	bx
+.return:
+	hlt
+	jmp	.return
+
+check:
+	pushf
+	call	put_word
+	popf
+	je	.ok
+	inc	word [cs:failures]
+.ok:
+	ret
+
+put_word:
+	push	ax
+	mov	al, ah
+	call	put_byte
+	pop	ax
+	push	ax
+	call	put_byte
+	mov	al, ' '
+	call	put_char
+	pop	ax
+	ret
+
+put_byte:
+	push	ax
+	push	cx
+	mov	cl, 4
+	shr	al, cl
+	pop	cx
+	call	put_nibble
+	pop	ax
+
+put_nibble:
+	and	al, 0xF
+	cmp	al, 10
+	jc	.1
+	add	al, 'A' - '0' - 10
+.1:
+	add	al, '0'
+
+put_char:
+	mov	ah, dh
+	stosw
+	ret
+
+main_sp:
+	dw	0
+main_di:
+	dw	0
+failures:
+	dw	0
+
@@ -0,0 +1,196 @@
+
+; Launch using:
+; - x86emu -c 386 -f 387 test/cpu/testx87t.com
+; Compares the results of the transcendental instructions with the bit patterns produced by 387 compatible hardware
+; Prints OK, or FAIL followed by the number of the first failing check
+
+	cpu	386
+	org	0x100
+
+; records the number of the first failing check
+%macro	check	1
+	je	%%ok
+	cmp	byte [failed], 0
+	jne	%%ok
+	mov	byte [failed], %1
+%%ok:
+%endmacro
+
+; pops ST(0) and compares it with an expected value
+%macro	expect	1
+	mov	si, %1
+	call	compare
+%endmacro
+
+; an extended precision value given by its significand and its sign and exponent
+%macro	extended	2
+	dq	%1
+	dw	%2
+%endmacro
+
+	push	ds
+	pop	es
+	cld
+	fninit
+
+	;;;; FSIN and FCOS
+	fld	tword [half]
+	fsin
+	expect	sin_half
+	check	1
+	fld	tword [half]
+	fcos
+	expect	cos_half
+	check	2
+
+	;;;; FSIN of a negative value, produced by another instruction
+	fld1
+	fchs
+	fsin
+	expect	sin_minus_one
+	check	3
+
+	;;;; FSIN of a value that needs the reduction by pi
+	fld	tword [ten_billion]
+	fsin
+	expect	sin_ten_billion
+	check	4
+
+	;;;; FPTAN pushes 1.0 after the tangent
+	fld	tword [half]
+	fptan
+	expect	one
+	check	5
+	expect	tan_half
+	check	6
+
+	;;;; FSINCOS pushes the cosine after the sine
+	fld	tword [two]
+	fsincos
+	expect	cos_two
+	check	7
+	expect	sin_two
+	check	8
+
+	;;;; FPATAN takes the angle of ST(1) / ST(0) in the quadrant of both operands
+	fld1
+	fld	tword [minus_three]
+	fpatan
+	expect	atan_one_minus_three
+	check	9
+
+	;;;; F2XM1
+	fld	tword [minus_three_quarters]
+	f2xm1
+	expect	exp2m1_minus_three_quarters
+	check	10
+
+	;;;; FYL2X and FYL2XP1 multiply ST(1) with the logarithm of ST(0)
+	fld	tword [three]
+	fld	tword [ten]
+	fyl2x
+	expect	three_log2_ten
+	check	11
+	fld	tword [minus_two]
+	fld	tword [quarter]
+	fyl2xp1
+	expect	minus_two_log2_five_quarters
+	check	12
+
+	;;;; Operands from 2^63 are left unchanged and set C2
+	fld	tword [two_to_63]
+	fsin
+	fnstsw	ax
+	and	ah, 0x04
+	cmp	ah, 0x04
+	check	13
+	expect	two_to_63
+	check	14
+
+	mov	dx, message_ok
+	mov	al, [failed]
+	test	al, al
+	jz	print
+	aam
+	add	ax, '00'
+	xchg	al, ah
+	mov	[message_number], ax
+	mov	dx, message_fail
+
+print:
+	mov	ah, 0x09
+	int	0x21
+
+	mov	ax, 0x4C00
+	int	0x21
+
+; sets ZF if the popped value has the bit pattern at SI
+compare:
+	fstp	tword [result]
+	mov	di, result
+	mov	cx, 5
+	repe cmpsw
+	ret
+
+message_ok:
+	db	"OK", 13, 10, '$'
+
+message_fail:
+	db	"FAIL"
+message_number:
+	db	"00", 13, 10, '$'
+
+failed:
+	db	0
+
+result:
+	dt	0.0
+
+half:
+	dt	0.5
+quarter:
+	dt	0.25
+minus_three_quarters:
+	dt	-0.75
+two:
+	dt	2.0
+minus_two:
+	dt	-2.0
+three:
+	dt	3.0
+minus_three:
+	dt	-3.0
+ten:
+	dt	10.0
+ten_billion:
+	dt	1.0e10
+
+one:
+	extended	0x8000000000000000, 0x3FFF
+two_to_63:
+	extended	0x8000000000000000, 0x403E
+
+; results of the hardware
+sin_half:
+	extended	0xF57743A2582F7F44, 0x3FFD
+cos_half:
+	extended	0xE0A94032DBEA7CEE, 0x3FFE
+sin_minus_one:
+	extended	0xD76AA47848677021, 0xBFFE
+sin_ten_billion:
+	extended	0xF99A63C49C6F2B1A, 0xBFFD
+tan_half:
+	extended	0x8BDA7ADF9A3A5219, 0x3FFE
+sin_two:
+	extended	0xE8C7B7568DA22EFD, 0x3FFE
+cos_two:
+	extended	0xD51132BA9B902522, 0xBFFD
+atan_one_minus_three:
+	extended	0xB4784AFEFAC9E110, 0x4000
+exp2m1_minus_three_quarters:
+	extended	0xCF901F5CE48EAD21, 0xBFFD
+three_log2_ten:
+	extended	0x9F73DA38D9D4A83F, 0x4002
+minus_two_log2_five_quarters:
+	extended	0xA4D3C25E68DC57F2, 0xBFFE
+
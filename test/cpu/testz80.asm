@@ -0,0 +1,170 @@
+
+; Launch using:
+; - x86emu -c 8086 -f z80 -m z80 -S cpm80 test/cpu/testz80.com
+; Prints OK, or FAIL followed by the number of the first failing check
+; Unclaimed ports read as 0 and ignore writes
+
+%include 'i8080.inc'
+
+; Z80 instructions that have no 8080 mnemonic
+
+%macro	exaf	0
+	db	0x08
+%endmacro
+
+%macro	bits	1
+	db	0xCB, %1
+%endmacro
+
+%macro	ldix	1
+	db	0xDD, 0x21
+	dw	%1
+%endmacro
+
+%macro	ldiy	1
+	db	0xFD, 0x21
+	dw	%1
+%endmacro
+
+%macro	bitsix	2
+	db	0xDD, 0xCB, %1, %2
+%endmacro
+
+%macro	bitsiy	2
+	db	0xFD, 0xCB, %1, %2
+%endmacro
+
+%macro	inir	0
+	db	0xED, 0xB2
+%endmacro
+
+%macro	indr	0
+	db	0xED, 0xBA
+%endmacro
+
+%macro	otir	0
+	db	0xED, 0xB3
+%endmacro
+
+%macro	otdr	0
+	db	0xED, 0xBB
+%endmacro
+
+%macro	check	2
+	cpi	%1
+	jnz	fail%2
+%endmacro
+
+	code8080
+	org	0x100
+
+	;;;; The accumulator and flags follow EX AF,AF'
+	mvi	a, 0x81
+	exaf
+	mvi	a, 0x40
+	bits	0x07	; rlc a
+	check	0x80, 1
+	exaf
+	check	0x81, 2
+
+	;;;; (IX+d) and (IY+d) operands
+	ldix	data - 2
+	bitsix	2, 0x06	; rlc (ix+2)
+	lda	data
+	check	0x02, 3
+
+	ldiy	data + 3
+	bitsiy	-3, 0xFE	; set 7,(iy-3)
+	lda	data
+	check	0x82, 4
+
+	;;;; Without a prefix, H, L and (HL) are not replaced
+	lxi	h, data
+	bits	0xC6	; set 0,(hl)
+	bits	0xFC	; set 7,h
+	bits	0xBC	; res 7,h
+	bits	0x7E	; bit 7,(hl)
+	jz	fail5
+	mov	a, m
+	check	0x83, 6
+
+	;;;; A prefixed operation on (IX+d) also copies the result to the selected register
+	ldix	data - 2
+	bitsix	2, 0x00	; rlc (ix+2),b
+	mov	a, b
+	check	0x07, 7
+	lda	data
+	check	0x07, 8
+
+	;;;; Block input and output, one byte per port
+	lxi	h, buffer
+	mvi	b, 4
+	mvi	c, 0x10
+	inir
+	mov	a, b
+	check	0x00, 9
+	mov	a, m
+	check	0x55, 10
+	dcx	h
+	mov	a, m
+	check	0x00, 11
+
+	lxi	h, buffer + 7
+	mvi	b, 2
+	indr
+	mov	a, m
+	check	0x55, 12
+	inx	h
+	mov	a, m
+	check	0x00, 13
+
+	lxi	h, buffer
+	mvi	b, 3
+	otir
+	mov	a, b
+	check	0x00, 14
+	mov	a, l
+	check	(buffer + 3) & 0xFF, 15
+
+	lxi	h, buffer + 7
+	mvi	b, 3
+	otdr
+	mov	a, b
+	check	0x00, 16
+	mov	a, l
+	check	(buffer + 4) & 0xFF, 17
+
+	lxi	d, message_ok
+	jmp	print
+
+%assign	i 1
+%rep	17
+fail %+ i:
+	lxi	h, (('0' + i % 10) << 8) | ('0' + i / 10)
+	jmp	fail
+%assign	i i + 1
+%endrep
+
+fail:
+	shld	message_number
+	lxi	d, message_fail
+
+print:
+	mvi	c, 9
+	call	5
+	rst	0
+
+message_ok:
+	db	"OK", 13, 10, '$'
+
+message_fail:
+	db	"FAIL"
+message_number:
+	db	"00", 13, 10, '$'
+
+data:
+	db	0x01
+
+buffer:
+	times 8 db 0x55
+